@@ -45,20 +45,28 @@ SimulationMaster::SimulationMaster(hemelb::configuration::CommandLine & options,
   propertyDataSource = NULL;
   visualisationControl = NULL;
   propertyExtractor = NULL;
+  checkpointWriter = NULL;
   simulationState = NULL;
   stepManager = NULL;
   netConcern = NULL;
   neighbouringDataManager = NULL;
+  timingTrace = NULL;
+  kernelCounters = NULL;
   imagesPerSimulation = options.NumberOfImages();
   steeringSessionId = options.GetSteeringSessionId();
 
   fileManager = new hemelb::io::PathManager(options, IsCurrentProcTheIOProc(), GetProcessorCount());
-  simConfig = hemelb::configuration::SimConfig::New(fileManager->GetInputFile());
+  simConfig = hemelb::configuration::SimConfig::New(fileManager->GetInputFile(), ioComms);
   unitConverter = &simConfig->GetUnitConverter();
   monitoringConfig = simConfig->GetMonitoringConfiguration();
 
   fileManager->SaveConfiguration(simConfig);
   Initialise();
+#if HEMELB_TIMING_TRACE_STEPS > 0
+  timingTrace = new hemelb::reporting::TimingTrace(ioComms,
+                                                   fileManager->GetTimingTracePath(),
+                                                   HEMELB_TIMING_TRACE_STEPS);
+#endif
   if (IsCurrentProcTheIOProc())
   {
     reporter = new hemelb::reporting::Reporter(fileManager->GetReportPath(),
@@ -69,6 +77,10 @@ SimulationMaster::SimulationMaster(hemelb::configuration::CommandLine & options,
       reporter->AddReportable(incompressibilityChecker);
     }
     reporter->AddReportable(&timings);
+    if (kernelCounters != NULL)
+    {
+      reporter->AddReportable(kernelCounters);
+    }
     reporter->AddReportable(latticeData);
     reporter->AddReportable(simulationState);
   }
@@ -95,12 +107,15 @@ SimulationMaster::~SimulationMaster()
   delete steeringCpt;
   delete visualisationControl;
   delete propertyExtractor;
+  delete checkpointWriter;
   delete propertyDataSource;
   delete stabilityTester;
   delete entropyTester;
   delete simulationState;
   delete incompressibilityChecker;
   delete neighbouringDataManager;
+  delete timingTrace;
+  delete kernelCounters;
 
   delete simConfig;
   delete fileManager;
@@ -144,17 +159,30 @@ void SimulationMaster::Initialise()
   hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("Initialising LatticeData.");
 
   timings[hemelb::reporting::Timers::latDatInitialise].Start();
-  // Use a reader to read in the file.
-  hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("Loading file and decomposing geometry.");
+  if (simConfig->GetDecompositionFilePath().empty())
+  {
+    // Use a reader to read in the file.
+    hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("Loading file and decomposing geometry.");
+
+    hemelb::geometry::GeometryReader reader(hemelb::steering::SteeringComponent::RequiresSeparateSteeringCore(),
+                                            latticeType::GetLatticeInfo(),
+                                            timings, ioComms);
+    hemelb::geometry::Geometry readGeometryData =
+        reader.LoadAndDecompose(simConfig->GetDataFilePath());
 
-  hemelb::geometry::GeometryReader reader(hemelb::steering::SteeringComponent::RequiresSeparateSteeringCore(),
-                                          latticeType::GetLatticeInfo(),
-                                          timings, ioComms);
-  hemelb::geometry::Geometry readGeometryData =
-      reader.LoadAndDecompose(simConfig->GetDataFilePath());
+    // Create a new lattice based on that info and return it.
+    latticeData = new hemelb::geometry::LatticeData(latticeType::GetLatticeInfo(), readGeometryData, ioComms);
+  }
+  else
+  {
+    // The saved decomposition holds each rank's lattice data, so the
+    // geometry file isn't read at all.
+    hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("Loading the saved decomposition.");
 
-  // Create a new lattice based on that info and return it.
-  latticeData = new hemelb::geometry::LatticeData(latticeType::GetLatticeInfo(), readGeometryData, ioComms);
+    latticeData = new hemelb::geometry::LatticeData(latticeType::GetLatticeInfo(),
+                                                    simConfig->GetDecompositionFilePath(),
+                                                    ioComms);
+  }
 
   timings[hemelb::reporting::Timers::latDatInitialise].Stop();
 
@@ -176,8 +204,8 @@ void SimulationMaster::Initialise()
   {
     timings[hemelb::reporting::Timers::colloidInitialisation].Start();
     hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("Loading Colloid config.");
-    std::string colloidConfigPath = simConfig->GetColloidConfigPath();
-    hemelb::io::xml::Document xml(colloidConfigPath);
+    // The colloids are configured in the same file as the rest, which has already been read.
+    hemelb::io::xml::Document& xml = simConfig->GetXmlDocument();
 
     hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("Creating Body Forces.");
     hemelb::colloids::BodyForces::InitBodyForces(xml);
@@ -189,7 +217,6 @@ void SimulationMaster::Initialise()
     colloidController =
         new hemelb::colloids::ColloidController(*latticeData,
                                                 *simulationState,
-                                                readGeometryData,
                                                 xml,
                                                 propertyCache,
                                                 latticeBoltzmannModel->GetLbmParams(),
@@ -268,6 +295,10 @@ void SimulationMaster::Initialise()
                                                         *unitConverter);
 
   latticeBoltzmannModel->Initialise(visualisationControl, inletValues, outletValues, unitConverter);
+#ifdef HEMELB_USE_KERNEL_COUNTERS
+  kernelCounters = new hemelb::reporting::KernelCounters(ioComms, latticeType::NUMVECTORS);
+  latticeBoltzmannModel->SetKernelCounters(kernelCounters);
+#endif
   latticeBoltzmannModel->SetInitialConditions(ioComms);
   neighbouringDataManager->ShareNeeds();
   neighbouringDataManager->TransferNonFieldDependentInformation();
@@ -304,6 +335,17 @@ void SimulationMaster::Initialise()
                                                               timings, ioComms);
   }
 
+  if (simConfig->GetCheckpointOutput() != NULL)
+  {
+    simConfig->GetCheckpointOutput()->filename = fileManager->GetDataExtractionPath()
+        + simConfig->GetCheckpointOutput()->filename;
+
+    checkpointWriter = new hemelb::extraction::CheckpointActor(*simulationState,
+                                                               *latticeData,
+                                                               *simConfig->GetCheckpointOutput(),
+                                                               timings, ioComms);
+  }
+
   imagesPeriod = OutputPeriod(imagesPerSimulation);
 
   stepManager = new hemelb::net::phased::StepManager(2,
@@ -335,11 +377,11 @@ void SimulationMaster::Initialise()
   {
     stepManager->RegisterIteratedActorSteps(*propertyExtractor, 1);
   }
-
-  if (ioComms.OnIORank())
+  if (checkpointWriter != NULL)
   {
-    stepManager->RegisterIteratedActorSteps(*network, 1);
+    stepManager->RegisterIteratedActorSteps(*checkpointWriter, 1);
   }
+
   stepManager->RegisterCommsForAllPhases(*netConcern);
 }
 
@@ -463,7 +505,15 @@ void SimulationMaster::RunSimulation()
 void SimulationMaster::Finalise()
 {
   timings[hemelb::reporting::Timers::total].Stop();
+  if (timingTrace != NULL)
+  {
+    timingTrace->Flush();
+  }
   timings.Reduce();
+  if (kernelCounters != NULL)
+  {
+    kernelCounters->Reduce();
+  }
   if (IsCurrentProcTheIOProc())
   {
     reporter->FillDictionary();
@@ -571,6 +621,11 @@ void SimulationMaster::DoTimeStep()
   {
     fflush(NULL);
   }
+
+  if (timingTrace != NULL)
+  {
+    timingTrace->Record(simulationState->GetTimeStep(), timings);
+  }
   simulationState->Increment();
 }
 
@@ -8,6 +8,7 @@
 #define HEMELB_SIMULATIONMASTER_H
 #include "lb/lattices/Lattices.h"
 #include "extraction/PropertyActor.h"
+#include "extraction/CheckpointActor.h"
 #include "lb/lb.hpp"
 #include "lb/StabilityTester.h"
 #include "net/net.h"
@@ -20,6 +21,8 @@
 #include "io/PathManager.h"
 #include "reporting/Reporter.h"
 #include "reporting/Timers.h"
+#include "reporting/TimingTrace.h"
+#include "reporting/KernelCounters.h"
 #include "reporting/BuildInfo.h"
 #include "lb/IncompressibilityChecker.hpp"
 #include "colloids/ColloidController.h"
@@ -57,6 +60,7 @@ class SimulationMaster
     hemelb::lb::LBM<latticeType>* latticeBoltzmannModel;
     hemelb::geometry::neighbouring::NeighbouringDataManager *neighbouringDataManager;
     const hemelb::net::IOCommunicator& ioComms;
+    const hemelb::util::UnitConverter* unitConverter;
 
   private:
     void Initialise();
@@ -80,6 +84,8 @@ class SimulationMaster
     hemelb::configuration::SimConfig *simConfig;
     hemelb::io::PathManager* fileManager;
     hemelb::reporting::Timers timings;
+    hemelb::reporting::TimingTrace* timingTrace;
+    hemelb::reporting::KernelCounters* kernelCounters;
     hemelb::reporting::Reporter* reporter;
     hemelb::reporting::BuildInfo build_info;
     typedef std::multimap<unsigned long, unsigned long> MapType;
@@ -103,11 +109,10 @@ class SimulationMaster
     hemelb::colloids::ColloidController* colloidController;
     hemelb::net::Net communicationNet;
 
-    const hemelb::util::UnitConverter* unitConverter;
-
     hemelb::vis::Control* visualisationControl;
     hemelb::extraction::IterableDataSource* propertyDataSource;
     hemelb::extraction::PropertyActor* propertyExtractor;
+    hemelb::extraction::CheckpointActor* checkpointWriter;
 
     hemelb::net::phased::StepManager* stepManager;
     hemelb::net::phased::NetConcern* netConcern;
@@ -0,0 +1,50 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "benchmarks/KernelBenchmark.h"
+
+#include <iomanip>
+
+namespace hemelb
+{
+  namespace benchmarks
+  {
+    namespace
+    {
+      // Chosen to give a relaxation time of about one, where every kernel is stable.
+      const PhysicalTime timeStepLength = 5e-4;
+      const PhysicalDistance voxelSize = 1e-4;
+    }
+
+    void KernelBenchmarkResult::Write(std::ostream& out) const
+    {
+      out << "{\"geometry\": \"" << geometry << "\", \"lattice\": \"" << lattice
+          << "\", \"kernel\": \"" << kernel << "\", \"streamer\": \"" << streamer
+          << "\", \"sites\": " << sites << ", \"steps\": " << steps << ", \"seconds\": "
+          << std::setprecision(6) << seconds << ", \"mlups\": " << GetMlups()
+          << ", \"min_bytes_per_site\": " << GetMinBytesPerSite() << ", \"bytes_per_site\": ";
+      // JSON has no NaN, so bytes that weren't measured are null.
+      if (GetBytesPerSite() < 0.0)
+      {
+        out << "null";
+      }
+      else
+      {
+        out << GetBytesPerSite();
+      }
+      out << "}" << std::endl;
+    }
+
+    KernelBenchmark::KernelBenchmark(const net::IOCommunicator& comms,
+                                     site_t sitesPerSide,
+                                     unsigned long steps,
+                                     std::ostream& out) :
+        comms(comms), sitesPerSide(sitesPerSide), steps(steps), out(out),
+            simState(timeStepLength, steps + 1), lbmParams(timeStepLength, voxelSize)
+    {
+    }
+  }
+}
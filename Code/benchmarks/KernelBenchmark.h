@@ -0,0 +1,295 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_BENCHMARKS_KERNELBENCHMARK_H
+#define HEMELB_BENCHMARKS_KERNELBENCHMARK_H
+
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include "units.h"
+#include "lb/LbmParameters.h"
+#include "lb/MacroscopicPropertyCache.h"
+#include "lb/SimulationState.h"
+#include "lb/kernels/BaseKernel.h"
+#include "lb/lattices/Lattices.h"
+#include "net/IOCommunicator.h"
+#include "reporting/HardwareCounters.h"
+#include "util/utilityFunctions.h"
+
+#include "benchmarks/PeriodicCubeLatticeData.h"
+#include "tests/helpers/FourCubeLatticeData.h"
+
+namespace hemelb
+{
+  namespace benchmarks
+  {
+    /**
+     * The name each lattice is reported under.
+     */
+    template<class LatticeType>
+    struct LatticeName;
+
+    template<>
+    struct LatticeName<lb::lattices::D3Q15>
+    {
+        static const char* Get()
+        {
+          return "D3Q15";
+        }
+    };
+
+    template<>
+    struct LatticeName<lb::lattices::D3Q15i>
+    {
+        static const char* Get()
+        {
+          return "D3Q15i";
+        }
+    };
+
+    template<>
+    struct LatticeName<lb::lattices::D3Q19>
+    {
+        static const char* Get()
+        {
+          return "D3Q19";
+        }
+    };
+
+    template<>
+    struct LatticeName<lb::lattices::D3Q27>
+    {
+        static const char* Get()
+        {
+          return "D3Q27";
+        }
+    };
+
+    /**
+     * The measurements of one streamer over one geometry.
+     */
+    struct KernelBenchmarkResult
+    {
+        std::string geometry;
+        std::string lattice;
+        std::string kernel;
+        std::string streamer;
+        unsigned int numVectors;
+        site_t sites; //!< Sites updated in each step
+        unsigned long steps;
+        double seconds;
+        //! Last level cache misses over the timed steps, or negative if they weren't counted.
+        double cacheMisses;
+
+        double GetMlups() const
+        {
+          return seconds > 0.0 ?
+            double(sites) * double(steps) / seconds / 1e6 :
+            0.0;
+        }
+
+        /**
+         * The least memory traffic of a site update: reading one set of distributions and
+         * writing another.
+         */
+        double GetMinBytesPerSite() const
+        {
+          return 2.0 * numVectors * sizeof(distribn_t);
+        }
+
+        /**
+         * The memory traffic per site update from the cache misses, or negative if they
+         * weren't counted.
+         */
+        double GetBytesPerSite() const
+        {
+          return (cacheMisses < 0.0 || sites == 0) ?
+            -1.0 :
+            cacheMisses * reporting::HardwareCounters::cacheLineLength
+                / (double(sites) * double(steps));
+        }
+
+        /**
+         * Write as one line of JSON.
+         * @param out
+         */
+        void Write(std::ostream& out) const;
+    };
+
+    /**
+     * Times the stream-and-collide of each streamer, on a periodic cube that is all bulk
+     * fluid and on the four cube test geometry with its walls and iolets, on this process
+     * alone. Each result is written as a line of JSON as soon as it's measured.
+     */
+    class KernelBenchmark
+    {
+      public:
+        /**
+         * @param comms
+         * @param sitesPerSide The sites along each side of both cubes
+         * @param steps The time steps to measure each streamer over
+         * @param out Where to write the results
+         */
+        KernelBenchmark(const net::IOCommunicator& comms,
+                        site_t sitesPerSide,
+                        unsigned long steps,
+                        std::ostream& out);
+
+        /**
+         * Measure a streamer over the whole of the periodic cube.
+         * @param kernelName
+         * @param streamerName
+         */
+        template<class StreamerType>
+        void RunPeriodicCube(const std::string& kernelName, const std::string& streamerName)
+        {
+          typedef typename StreamerType::CollisionType::CKernel::LatticeType LatticeType;
+          std::unique_ptr<PeriodicCubeLatticeData>
+              latDat(PeriodicCubeLatticeData::Create<LatticeType>(comms, sitesPerSide));
+
+          Run<StreamerType>(*latDat,
+                            0,
+                            latDat->GetLocalFluidSiteCount(),
+                            "periodic cube",
+                            kernelName,
+                            streamerName);
+        }
+
+        /**
+         * Measure a streamer over the sites of one collision type of the four cube, e.g. the
+         * mid fluid sites for a bulk streamer or the wall sites for a wall streamer.
+         * @param kernelName
+         * @param streamerName
+         * @param collisionType
+         */
+        template<class StreamerType>
+        void RunFourCube(const std::string& kernelName,
+                         const std::string& streamerName,
+                         unsigned int collisionType)
+        {
+          typedef typename StreamerType::CollisionType::CKernel::LatticeType LatticeType;
+          // The four cube puts a layer of solid sites around its fluid.
+          std::unique_ptr<tests::FourCubeLatticeData>
+              latDat(tests::FourCubeLatticeData::Create<LatticeType>(comms, sitesPerSide + 2));
+
+          site_t firstSite = 0;
+          for (unsigned int type = 0; type < collisionType; ++type)
+          {
+            firstSite += latDat->GetMidDomainCollisionCount(type);
+          }
+
+          Run<StreamerType>(*latDat,
+                            firstSite,
+                            latDat->GetMidDomainCollisionCount(collisionType),
+                            "four cube",
+                            kernelName,
+                            streamerName);
+        }
+
+      private:
+        template<class StreamerType, class LatticeDataType>
+        void Run(LatticeDataType& latDat,
+                 site_t firstSite,
+                 site_t siteCount,
+                 const std::string& geometryName,
+                 const std::string& kernelName,
+                 const std::string& streamerName)
+        {
+          typedef typename StreamerType::CollisionType::CKernel::LatticeType LatticeType;
+
+          // Start at rest, so that every kernel has a stable state to work on. Both sets of
+          // distributions are set, as sites outside the range measured are never updated.
+          distribn_t fEq[LatticeType::NUMVECTORS];
+          for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+          {
+            fEq[direction] = LatticeType::EQMWEIGHTS[direction];
+          }
+          for (unsigned int swap = 0; swap < 2; ++swap)
+          {
+            for (site_t site = 0; site < latDat.GetLocalFluidSiteCount(); ++site)
+            {
+              latDat.template SetFOld<LatticeType>(site, fEq);
+            }
+            latDat.SwapOldAndNew();
+          }
+
+          lb::MacroscopicPropertyCache propertyCache(simState, latDat);
+
+          lb::kernels::InitParams initParams;
+          initParams.latDat = &latDat;
+          initParams.siteCount = latDat.GetLocalFluidSiteCount();
+          initParams.siteRanges.push_back(std::make_pair(firstSite, firstSite + siteCount));
+          initParams.boundaryObject = NULL;
+          initParams.lbmParams = &lbmParams;
+          initParams.neighbouringDataManager = NULL;
+          initParams.propertyCache = &propertyCache;
+          StreamerType streamer(initParams);
+
+          // One step untimed, to fault in the memory and warm the caches.
+          Step(streamer, latDat, firstSite, siteCount, propertyCache);
+
+          uint64_t startCounts[reporting::HardwareCounters::numberOfEvents];
+          uint64_t endCounts[reporting::HardwareCounters::numberOfEvents];
+          hardware.Read(startCounts);
+          const double startTime = util::myClock();
+          for (unsigned long step = 0; step < steps; ++step)
+          {
+            Step(streamer, latDat, firstSite, siteCount, propertyCache);
+          }
+          const double endTime = util::myClock();
+          hardware.Read(endCounts);
+
+          KernelBenchmarkResult result;
+          result.geometry = geometryName;
+          result.lattice = LatticeName<LatticeType>::Get();
+          result.kernel = kernelName;
+          result.streamer = streamerName;
+          result.numVectors = LatticeType::NUMVECTORS;
+          result.sites = siteCount;
+          result.steps = steps;
+          result.seconds = endTime - startTime;
+          result.cacheMisses = hardware.IsCounting(reporting::HardwareCounters::cacheMisses) ?
+            double(endCounts[reporting::HardwareCounters::cacheMisses]
+                - startCounts[reporting::HardwareCounters::cacheMisses]) :
+            -1.0;
+          result.Write(out);
+        }
+
+        template<class StreamerType>
+        void Step(StreamerType& streamer,
+                  geometry::LatticeData& latDat,
+                  site_t firstSite,
+                  site_t siteCount,
+                  lb::MacroscopicPropertyCache& propertyCache)
+        {
+          streamer.template StreamAndCollide<false>(firstSite,
+                                                    siteCount,
+                                                    &lbmParams,
+                                                    &latDat,
+                                                    propertyCache);
+          streamer.template PostStep<false>(firstSite,
+                                            siteCount,
+                                            &lbmParams,
+                                            &latDat,
+                                            propertyCache);
+          latDat.SwapOldAndNew();
+        }
+
+        const net::IOCommunicator& comms;
+        const site_t sitesPerSide;
+        const unsigned long steps;
+        std::ostream& out;
+
+        lb::SimulationState simState;
+        lb::LbmParameters lbmParams;
+        reporting::HardwareCounters hardware;
+    };
+  }
+}
+
+#endif /* HEMELB_BENCHMARKS_KERNELBENCHMARK_H */
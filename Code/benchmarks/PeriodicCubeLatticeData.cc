@@ -0,0 +1,75 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "benchmarks/PeriodicCubeLatticeData.h"
+
+#include "geometry/Geometry.h"
+#include "lb/lattices/Lattices.h"
+#include "util/Vector3D.h"
+
+namespace hemelb
+{
+  namespace benchmarks
+  {
+    template<class LatticeType>
+    PeriodicCubeLatticeData* PeriodicCubeLatticeData::Create(const net::IOCommunicator& comm,
+                                                             site_t sitesPerSide)
+    {
+      // The whole cube is a single block, so every site is mid domain.
+      geometry::Geometry readResult(util::Vector3D<site_t>::Ones(), sitesPerSide);
+      geometry::BlockReadResult& block = readResult.Blocks[0];
+      geometry::GeometrySite fluidSite(true);
+      fluidSite.targetProcessor = 0;
+      fluidSite.links.resize(LatticeType::NUMVECTORS - 1);
+      block.Sites.resize(readResult.GetSitesPerBlock(), fluidSite);
+
+      PeriodicCubeLatticeData* returnable =
+          new PeriodicCubeLatticeData(LatticeType::GetLatticeInfo(), readResult, comm);
+      returnable->WrapNeighbourLocations();
+      return returnable;
+    }
+
+    template PeriodicCubeLatticeData* PeriodicCubeLatticeData::Create<lb::lattices::D3Q15>(const net::IOCommunicator&,
+                                                                                          site_t);
+    template PeriodicCubeLatticeData* PeriodicCubeLatticeData::Create<lb::lattices::D3Q15i>(const net::IOCommunicator&,
+                                                                                           site_t);
+    template PeriodicCubeLatticeData* PeriodicCubeLatticeData::Create<lb::lattices::D3Q19>(const net::IOCommunicator&,
+                                                                                          site_t);
+    template PeriodicCubeLatticeData* PeriodicCubeLatticeData::Create<lb::lattices::D3Q27>(const net::IOCommunicator&,
+                                                                                          site_t);
+
+    PeriodicCubeLatticeData::PeriodicCubeLatticeData(const lb::lattices::LatticeInfo& latticeInfo,
+                                                     const geometry::Geometry& readResult,
+                                                     const net::IOCommunicator& comms) :
+        geometry::LatticeData(latticeInfo, readResult, comms)
+    {
+    }
+
+    void PeriodicCubeLatticeData::WrapNeighbourLocations()
+    {
+      const site_t sitesPerSide = GetBlockSize();
+      const Direction numVectors = latticeInfo.GetNumVectors();
+
+      for (site_t siteIndex = 0; siteIndex < GetLocalFluidSiteCount(); ++siteIndex)
+      {
+        const util::Vector3D<site_t>& location = GetGlobalSiteCoords(siteIndex);
+        for (Direction direction = 1; direction < numVectors; ++direction)
+        {
+          util::Vector3D<site_t> neighbour = location
+              + util::Vector3D<site_t>(latticeInfo.GetVector(direction));
+          for (unsigned int axis = 0; axis < 3; ++axis)
+          {
+            neighbour[axis] = (neighbour[axis] + sitesPerSide) % sitesPerSide;
+          }
+
+          SetNeighbourLocation(siteIndex,
+                               direction,
+                               GetContiguousSiteId(neighbour) * numVectors + direction);
+        }
+      }
+    }
+  }
+}
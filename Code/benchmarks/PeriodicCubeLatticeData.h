@@ -0,0 +1,63 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_BENCHMARKS_PERIODICCUBELATTICEDATA_H
+#define HEMELB_BENCHMARKS_PERIODICCUBELATTICEDATA_H
+
+#include "units.h"
+#include "geometry/LatticeData.h"
+#include "net/IOCommunicator.h"
+
+namespace hemelb
+{
+  namespace benchmarks
+  {
+    /**
+     * A cube of fluid sites with every face joined to the one opposite, so that every site is
+     * a bulk site with a full set of fluid neighbours. It has no walls or iolets, which makes
+     * it the geometry for measuring the collision kernels and bulk streaming on their own.
+     */
+    class PeriodicCubeLatticeData : public geometry::LatticeData
+    {
+      public:
+        /**
+         * Make a cube of sitesPerSide^3 fluid sites, all on this process.
+         * @param comm
+         * @param sitesPerSide
+         * @return
+         */
+        template<class LatticeType>
+        static PeriodicCubeLatticeData* Create(const net::IOCommunicator& comm, site_t sitesPerSide);
+
+        /**
+         * Set the distributions at a site before streaming.
+         * @param site
+         * @param fOldIn
+         */
+        template<class LatticeType>
+        void SetFOld(site_t site, const distribn_t* fOldIn)
+        {
+          for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+          {
+            *GetFOld(site * LatticeType::NUMVECTORS + direction) = fOldIn[direction];
+          }
+        }
+
+      protected:
+        PeriodicCubeLatticeData(const lb::lattices::LatticeInfo& latticeInfo,
+                                const geometry::Geometry& readResult,
+                                const net::IOCommunicator& comms);
+
+      private:
+        /**
+         * Point the streaming off each face of the cube at the site on the opposite face.
+         */
+        void WrapNeighbourLocations();
+    };
+  }
+}
+
+#endif /* HEMELB_BENCHMARKS_PERIODICCUBELATTICEDATA_H */
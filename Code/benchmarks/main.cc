@@ -0,0 +1,131 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "Exception.h"
+#include "net/mpi.h"
+#include "net/IOCommunicator.h"
+#include "lb/BuildSystemInterface.h"
+#include "log/Logger.h"
+
+#include "benchmarks/KernelBenchmark.h"
+
+namespace hemelb
+{
+  namespace benchmarks
+  {
+    /**
+     * Measure a kernel with the bulk streamer on the periodic cube and on the four cube's
+     * mid fluid sites, then with each wall streamer on the four cube's wall sites.
+     *
+     * The Guo-Zheng-Shi streamer collides a made up site in the wall, which kernels that keep
+     * state for each site (the non-Newtonian and entropic ones) can't do, so it can be left
+     * out.
+     */
+    template<class LatticeType, template<class > class KernelType>
+    void RunKernel(KernelBenchmark& benchmark,
+                   const std::string& kernelName,
+                   bool withGuoZhengShi = true)
+    {
+      typedef lb::collisions::Normal<typename KernelType<LatticeType>::Type> Collision;
+
+      benchmark.RunPeriodicCube<lb::streamers::SimpleCollideAndStream<Collision> >(kernelName,
+                                                                                  "SimpleCollideAndStream");
+      benchmark.RunFourCube<lb::streamers::SimpleCollideAndStream<Collision> >(kernelName,
+                                                                              "SimpleCollideAndStream",
+                                                                              0);
+      benchmark.RunFourCube<typename lb::SIMPLEBOUNCEBACK<Collision>::Type>(kernelName,
+                                                                            "SimpleBounceBack",
+                                                                            1);
+      benchmark.RunFourCube<typename lb::BFL<Collision>::Type>(kernelName,
+                                                               "BouzidiFirdaousLallemand",
+                                                               1);
+      if (withGuoZhengShi)
+      {
+        benchmark.RunFourCube<typename lb::GZS<Collision>::Type>(kernelName, "GuoZhengShi", 1);
+      }
+      benchmark.RunFourCube<typename lb::JUNKYANG<Collision>::Type>(kernelName, "JunkYang", 1);
+    }
+
+    template<class LatticeType>
+    void RunLattice(KernelBenchmark& benchmark)
+    {
+      RunKernel<LatticeType, lb::LBGK>(benchmark, "LBGK");
+      RunKernel<LatticeType, lb::NNCY>(benchmark, "LBGKNN", false);
+      RunKernel<LatticeType, lb::TRT>(benchmark, "TRT");
+      RunKernel<LatticeType, lb::EntropicAnsumali>(benchmark, "EntropicAnsumali", false);
+      RunKernel<LatticeType, lb::EntropicChik>(benchmark, "EntropicChik", false);
+    }
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  // MPI is only brought up for the lattice data, so this runs as a single process without
+  // an MPI launcher.
+  hemelb::net::MpiEnvironment mpi(argc, argv);
+  hemelb::log::Logger::Init();
+  try
+  {
+    hemelb::net::IOCommunicator comms(hemelb::net::MpiCommunicator::World());
+    if (comms.Size() != 1)
+    {
+      throw hemelb::Exception() << "The kernel benchmarks run on a single process";
+    }
+
+    hemelb::site_t sitesPerSide = 32;
+    unsigned long steps = 20;
+    std::ofstream outFile;
+    for (int ii = 1; ii + 1 < argc; ii += 2)
+    {
+      if (std::strcmp(argv[ii], "-size") == 0)
+      {
+        sitesPerSide = std::strtol(argv[ii + 1], NULL, 10);
+      }
+      else if (std::strcmp(argv[ii], "-steps") == 0)
+      {
+        steps = std::strtoul(argv[ii + 1], NULL, 10);
+      }
+      else if (std::strcmp(argv[ii], "-out") == 0)
+      {
+        outFile.open(argv[ii + 1]);
+      }
+      else
+      {
+        throw hemelb::Exception() << "Unknown option: " << argv[ii]
+            << "\nUsage: hemelb-benchmarks [-size SITES_PER_SIDE] [-steps STEPS] [-out FILE]";
+      }
+    }
+    if (sitesPerSide < 2 || steps == 0)
+    {
+      throw hemelb::Exception() << "Need at least two sites per side and one step";
+    }
+
+    hemelb::benchmarks::KernelBenchmark benchmark(comms,
+                                                  sitesPerSide,
+                                                  steps,
+                                                  outFile.is_open() ?
+                                                    outFile :
+                                                    std::cout);
+
+    using namespace hemelb::lb::lattices;
+    hemelb::benchmarks::RunLattice<D3Q15>(benchmark);
+    hemelb::benchmarks::RunKernel<D3Q15, hemelb::lb::MRT>(benchmark, "MRT");
+    hemelb::benchmarks::RunLattice<D3Q15i>(benchmark);
+    hemelb::benchmarks::RunLattice<D3Q19>(benchmark);
+    hemelb::benchmarks::RunKernel<D3Q19, hemelb::lb::MRT>(benchmark, "MRT");
+    hemelb::benchmarks::RunLattice<D3Q27>(benchmark);
+  }
+  catch (std::exception& e)
+  {
+    hemelb::log::Logger::Log<hemelb::log::Critical, hemelb::log::OnePerCore>(e.what());
+    mpi.Abort(-1);
+  }
+}
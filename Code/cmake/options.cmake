@@ -74,16 +74,19 @@ hemelb_option(HEMELB_VALIDATE_GEOMETRY "Validate geometry" OFF)
 hemelb_option(HEMELB_BUILD_TESTS_ALL "Build all the tests" ON)
 hemelb_option(HEMELB_BUILD_TESTS_UNIT "Build the unit-tests (HEMELB_BUILD_TESTS_ALL takes precedence)" ON)
 hemelb_option(HEMELB_BUILD_TESTS_FUNCTIONAL "Build the functional tests (HEMELB_BUILD_TESTS_ALL takes precedence)" ON)
+hemelb_option(HEMELB_BUILD_BENCHMARKS "Build the lattice Boltzmann kernel benchmarks" OFF)
 hemelb_option(HEMELB_USE_ALL_WARNINGS_GNU "Show all compiler warnings on development builds (gnu-style-compilers)" ON)
 hemelb_option(HEMELB_USE_STREAKLINES "Calculate streakline images" OFF)
 hemelb_option(HEMELB_DEPENDENCIES_SET_RPATH "Set runtime RPATH" ON)
 hemelb_option(HEMELB_WAIT_ON_CONNECT "Wait for steering client" OFF)
 hemelb_option(HEMELB_BUILD_MULTISCALE "Build HemeLB Multiscale functionality" OFF)
+hemelb_option(HEMELB_BUILD_REDUCED_ORDER "Build HemeLB coupled in-process to reduced order vascular models" OFF)
 hemelb_option(HEMELB_IMAGES_TO_NULL "Write images to null" OFF)
 hemelb_option(HEMELB_USE_SSE3 "Use SSE3 intrinsics" ON)
 hemelb_option(HEMELB_USE_VELOCITY_WEIGHTS_FILE "Use Velocity weights file" OFF)
 hemelb_option(UBUNTU_BUG_WORKAROUND "Work around the faulty HAVE_ISNAN value in Ubuntu 16.04." OFF)
 hemelb_option(HEMELB_SEPARATE_CONCERNS "Communicate for each concern separately" OFF)
+hemelb_option(HEMELB_USE_KERNEL_COUNTERS "Measure the lattice Boltzmann kernels with hardware performance counters" OFF)
 
 #
 # Specify the variables
@@ -92,8 +95,18 @@ hemelb_cachevar(HEMELB_EXECUTABLE "hemelb"
   STRING "File name of executable to produce")
 hemelb_cachevar(HEMELB_READING_GROUP_SIZE 5
   STRING "Number of cores to use to read geometry file.")
+hemelb_cachevar(HEMELB_VIS_THREADS 1
+  STRING "Number of threads each core uses to ray trace images (1 renders on the calling thread only)")
+hemelb_cachevar(HEMELB_VIS_RENDER_LAG 0
+  STRING "Number of timesteps images are rendered in the background from a snapshot before compositing (0 renders synchronously)")
 hemelb_cachevar(HEMELB_LOG_LEVEL Info
   STRING "Log level, choose 'Critical', 'Error', 'Warning', 'Info', 'Debug' or 'Trace'" )
+hemelb_cachevar(HEMELB_LOG_BUFFER 0
+  STRING "Number of log messages each core buffers for writing on a background thread (0 writes synchronously)")
+hemelb_cachevar(HEMELB_TIMING_TRACE_STEPS 0
+  STRING "Number of timesteps of per-rank timings buffered between writes of the timing trace (0 disables the trace)")
+hemelb_cachevar(HEMELB_PEAK_MEMORY_BANDWIDTH 0
+  STRING "Memory bandwidth available to each core (GB/s), against which the kernel counters report bandwidth achieved (0 if unknown)")
 hemelb_cachevar(HEMELB_STEERING_LIB basic
   STRING "Steering library, choose 'basic' or 'none'" )
 hemelb_cachevar(HEMELB_DEPENDENCIES_PATH "${HEMELB_ROOT_DIR}/dependencies"
@@ -108,7 +121,7 @@ hemelb_cachevar(HEMELB_OPTIMISATION "-O3"
 hemelb_cachevar(HEMELB_LATTICE "D3Q15"
   STRING "Select the lattice type to use (D3Q15,D3Q19,D3Q27,D3Q15i)")
 hemelb_cachevar(HEMELB_KERNEL "LBGK"
-  STRING "Select the kernel to use (LBGK,EntropicAnsumali,EntropicChik,MRT,TRT,NNCY,NNCYMOUSE,NNC,NNTPL)")
+  STRING "Select the kernel to use (LBGK,GuoForcingLBGK,EntropicAnsumali,EntropicChik,MRT,TRT,NNCY,NNCYMOUSE,NNC,NNTPL)")
 hemelb_cachevar(HEMELB_WALL_BOUNDARY "SIMPLEBOUNCEBACK"
   STRING "Select the boundary conditions to be used at the walls (BFL,GZS,SIMPLEBOUNCEBACK,JUNKYANG)")
 hemelb_cachevar(HEMELB_INLET_BOUNDARY "NASHZEROTHORDERPRESSUREIOLET"
@@ -13,6 +13,7 @@ include(CheckCXXSymbolExists)
 CHECK_CXX_SOURCE_COMPILES("#include <cmath>\n int main(int c,char** v){ return isnan(1.0); }" HAVE_ISNAN)
 CHECK_CXX_SOURCE_COMPILES("#include <cmath>\n int main(int c,char** v){ return std::isnan(1.0); }" HAVE_STD_ISNAN)
 CHECK_CXX_SOURCE_COMPILES("#include <sys/time.h>\n#include <sys/resource.h>\nint main(int c,char** v){ rusage usage;\ngetrusage(RUSAGE_SELF, &usage);\nreturn usage.ru_maxrss; }" HAVE_RUSAGE)
+CHECK_CXX_SOURCE_COMPILES("#include <linux/perf_event.h>\n#include <sys/syscall.h>\nint main(int c,char** v){ perf_event_attr attr;\nattr.config = PERF_COUNT_HW_CACHE_MISSES;\nreturn __NR_perf_event_open; }" HAVE_PERF_EVENTS)
 
 CHECK_CXX_SOURCE_COMPILES("
 #include <stdint.h>
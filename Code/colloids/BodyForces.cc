@@ -13,7 +13,6 @@ namespace hemelb
   namespace colloids
   {
     std::map<std::string, const BodyForce* const > BodyForces::bodyForces;
-    std::map<site_t, LatticeForceVector> BodyForces::forceForEachSite;
 
     const void BodyForces::InitBodyForces(io::xml::Document& xml)
     {
@@ -49,21 +49,6 @@ namespace hemelb
         /** accumulates the effects of all known body forces on the particle */
         static const LatticeForceVector GetBodyForcesForParticle(const Particle& particle);
 
-        static void ClearBodyForcesForAllSiteIds()
-        {
-          forceForEachSite.clear();
-        }
-
-        static void SetBodyForcesForSiteId(const site_t siteId, const LatticeForceVector force)
-        {
-          forceForEachSite[siteId] = force;
-        }
-
-        static const LatticeForceVector GetBodyForcesForSiteId(const site_t siteId)
-        {
-          return forceForEachSite[siteId];
-        }
-
       private:
         /**
          * stores the details of all known body forces
@@ -71,7 +56,6 @@ namespace hemelb
          * as only pointers are type-compatible in C++
          */
         static std::map<std::string, const BodyForce* const> bodyForces;
-        static std::map<site_t, LatticeForceVector> forceForEachSite;
     };
   }
 }
@@ -29,7 +29,6 @@ namespace hemelb
     // constructor - called by SimulationMaster::Initialise()
     ColloidController::ColloidController(const geometry::LatticeData& latDatLBM,
                                          const lb::SimulationState& simulationState,
-                                         const geometry::Geometry& gmyResult,
                                          io::xml::Document& xml,
                                          lb::MacroscopicPropertyCache& propertyCache,
                                          const hemelb::lb::LbmParameters *lbmParams,
@@ -39,16 +38,15 @@ namespace hemelb
       ioComms(ioComms_), simulationState(simulationState), timers(timers)
     {
       // The neighbourhood used here is different to the latticeInfo used to create latDatLBM
-      // The portion of the geometry input file that was read in by this proc, i.e. gmyResult
-      // contains more information than was used when creating the LB lattice, i.e. latDatLBM
       // so, we traverse mLatDat to find local fluid sites but then get neighbour information
-      // from the geometry file using a neighbour lattice definition appropriate for colloids
+      // from the ranks of its blocks' sites using a neighbour lattice definition appropriate
+      // for colloids
 
       // get the description of the colloid neighbourhood (as a vector of Vector3D of site_t)
       const Neighbourhood neighbourhood = GetNeighbourhoodVectors(REGION_OF_INFLUENCE);
 
       // determine information about neighbour sites and processors for all local fluid sites
-      InitialiseNeighbourList(latDatLBM, gmyResult, neighbourhood);
+      InitialiseNeighbourList(latDatLBM, neighbourhood);
 
       bool allGood = ioComms.OnIORank() || (neighbourProcessors.size() > 0);
       log::Logger::Log<log::Debug, log::OnePerCore>(
@@ -58,19 +56,21 @@ namespace hemelb
       io::xml::Element particlesElem = xml.GetRoot().GetChildOrThrow("colloids").GetChildOrThrow("particles");
       particleSet = new ParticleSet(latDatLBM, particlesElem, propertyCache,
                                     lbmParams,
-                                    neighbourProcessors, ioComms, outputPath);
+                                    neighbourProcessors, haloRanks, ioComms, outputPath);
     }
 
     void ColloidController::InitialiseNeighbourList(
             const geometry::LatticeData& latDatLBM,
-            const geometry::Geometry& gmyResult,
             const Neighbourhood& neighbourhood)
     {
       // PLAN
-      // foreach block in gmyResult (i.e. each block that may have been read from the input file)
+      // (as well as the list of neighbour ranks, this records which neighbour ranks are
+      //  within the region of influence of each local site, in haloRanks, so particles
+      //  can be sent only to the ranks whose sites they can affect)
+      // foreach block in latDatLBM (i.e. each block that was read from the input file)
       //   if block has sites (i.e. if this process _has_ read this block in from the input file)
       //     foreach site in block (i.e. each site, which may be local or remote, fluid or solid)
-      //       if site is local (i.e. if the targetProcessor for this site is equal to localRank)
+      //       if site is local (i.e. if the rank for this site is equal to localRank)
       //         foreach neighbour of site (i.e. follow each direction vector in the LatticeInfo)
       //           if neighbour is valid (i.e. neighbour site is within the geometry & not solid)
       //             if neighbour is remote (i.e. targetProcessor for neighbour is not localRank)
@@ -83,11 +83,12 @@ namespace hemelb
            blockTraverser.TraverseOne())
       {
         util::Vector3D<site_t> globalLocationForBlock =
-              blockTraverser.GetCurrentLocation() * gmyResult.GetBlockSize();
+              blockTraverser.GetCurrentLocation() * latDatLBM.GetBlockSize();
 
         // if block has sites
         site_t blockId = blockTraverser.GetCurrentIndex();
-        if (gmyResult.Blocks[blockId].Sites.size() == 0)
+        const geometry::Block& block = latDatLBM.GetBlock(blockId);
+        if (block.IsEmpty())
         {
           log::Logger::Log<log::Trace, log::OnePerCore>(
             "ColloidController: block with id %i and coords (%i,%i,%i) is solid.\n",
@@ -108,7 +109,7 @@ namespace hemelb
 
           // if site is local
           site_t siteId = siteTraverser.GetCurrentIndex();
-          if (gmyResult.Blocks[blockId].Sites[siteId].targetProcessor != this->ioComms.Rank())
+          if (block.GetProcessorRankForSite(siteId) != this->ioComms.Rank())
           {
             log::Logger::Log<log::Trace, log::OnePerCore>(
               "ColloidController: site with id %i and coords (%i,%i,%i) has proc %i (non-local).\n",
@@ -116,7 +117,7 @@ namespace hemelb
               siteTraverser.GetCurrentLocation().x,
               siteTraverser.GetCurrentLocation().y,
               siteTraverser.GetCurrentLocation().z,
-              gmyResult.Blocks[blockId].Sites[siteId].targetProcessor);
+              block.GetProcessorRankForSite(siteId));
             continue;
           }
 
@@ -127,6 +128,9 @@ namespace hemelb
             siteTraverser.GetCurrentLocation().y,
             siteTraverser.GetCurrentLocation().z);
 
+          // the neighbour ranks that own a site within the region of influence of this site
+          std::vector<proc_t> siteHaloRanks;
+
           // foreach neighbour of site
           for (Neighbourhood::const_iterator itDirectionVector = neighbourhood.begin();
                itDirectionVector != neighbourhood.end();
@@ -139,13 +143,17 @@ namespace hemelb
             site_t neighbourBlockId, neighbourSiteId;
             proc_t neighbourRank;
             bool isValid = GetLocalInformationForGlobalSite(
-                  gmyResult, globalLocationForNeighbourSite,
+                  latDatLBM, globalLocationForNeighbourSite,
                   &neighbourBlockId, &neighbourSiteId, &neighbourRank);
 
             // if neighbour is remote
             if (!isValid || neighbourRank == this->ioComms.Rank())
               continue;
 
+            // remember that particles near this site are of interest to the neighbour
+            if (std::count(siteHaloRanks.begin(), siteHaloRanks.end(), neighbourRank) == 0)
+              siteHaloRanks.push_back(neighbourRank);
+
             // if new neighbourRank
             int addedAlready = std::count(neighbourProcessors.begin(),
                                           neighbourProcessors.end(),
@@ -165,46 +173,42 @@ namespace hemelb
                 (*itDirectionVector).x, (*itDirectionVector).y, (*itDirectionVector).z);
 
           } // end for itDirectionVector
+
+          if (!siteHaloRanks.empty())
+            haloRanks[latDatLBM.GetContiguousSiteId(globalLocationForSite)] = siteHaloRanks;
         } // end for siteTraverser
       } // end for blockTraverser
 
     }
 
-    //DJH// this function should probably be in geometry::ReadResult
+    //DJH// this function should probably be in geometry::LatticeData
     bool ColloidController::GetLocalInformationForGlobalSite(
-                                      const geometry::Geometry& gmyResult,
+                                      const geometry::LatticeData& latDatLBM,
                                       const util::Vector3D<site_t>& globalLocationForSite,
                                       site_t* blockIdForSite,
                                       site_t* localSiteIdForSite,
                                       proc_t* ownerRankForSite)
     {
-      // obtain block information (3D location vector and 1D id number) for the site
-      util::Vector3D<site_t> blockLocationForSite = globalLocationForSite / gmyResult.GetBlockSize();
       // check for global location being outside the simulation entirely
-      if (!gmyResult.AreBlockCoordinatesValid(blockLocationForSite))
+      if (!latDatLBM.IsValidLatticeSite(globalLocationForSite))
         return false;
 
-      *blockIdForSite = gmyResult.GetBlockIdFromBlockCoordinates(blockLocationForSite.x,
-                                                                 blockLocationForSite.y,
-                                                                 blockLocationForSite.z);
+      // obtain block information (3D location vector and 1D id number) for the site
+      util::Vector3D<site_t> blockLocationForSite = globalLocationForSite / latDatLBM.GetBlockSize();
+      *blockIdForSite = latDatLBM.GetBlockIdFromBlockCoords(blockLocationForSite);
 
       // if the block does not contain any sites then return invalid
-      if (gmyResult.Blocks[*blockIdForSite].Sites.empty())
+      const geometry::Block& block = latDatLBM.GetBlock(*blockIdForSite);
+      if (block.IsEmpty())
         return false;
 
       // obtain site information (3D location vector and 1D id number)
       // note: these are both local to the block that contains the site
-      util::Vector3D<site_t> localSiteLocation = globalLocationForSite % gmyResult.GetBlockSize();
-
-      if (!gmyResult.AreLocalSiteCoordinatesValid(localSiteLocation))
-        return false;
-
-      *localSiteIdForSite = gmyResult.GetSiteIdFromSiteCoordinates(localSiteLocation.x,
-                                                                   localSiteLocation.y,
-                                                                   localSiteLocation.z);
+      util::Vector3D<site_t> localSiteLocation = globalLocationForSite % latDatLBM.GetBlockSize();
+      *localSiteIdForSite = latDatLBM.GetLocalSiteIdFromLocalSiteCoords(localSiteLocation);
 
       // obtain the rank of the processor responsible for simulating the fluid at this site
-      *ownerRankForSite = gmyResult.Blocks[*blockIdForSite].Sites[*localSiteIdForSite].targetProcessor;
+      *ownerRankForSite = block.GetProcessorRankForSite(*localSiteIdForSite);
 
       // site is solid not fluid so return invalid
       if (*ownerRankForSite == SITE_OR_BLOCK_SOLID)
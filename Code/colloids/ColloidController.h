@@ -11,7 +11,6 @@
 #include "net/net.h"
 #include "net/IteratedAction.h"
 #include "geometry/LatticeData.h"
-#include "geometry/Geometry.h"
 #include "io/xml/XmlAbstractionLayer.h"
 #include "lb/MacroscopicPropertyCache.h"
 #include "colloids/ParticleSet.h"
@@ -29,7 +28,6 @@ namespace hemelb
         /** constructor - currently only initialises the neighbour list */
         ColloidController(const geometry::LatticeData& latDatLBM,
                           const lb::SimulationState& simulationState,
-                          const geometry::Geometry& gmyResult,
                           io::xml::Document& xml,
                           lb::MacroscopicPropertyCache& propertyCache,
                           const hemelb::lb::LbmParameters *lbmParams,
@@ -67,6 +65,10 @@ namespace hemelb
             particles near the edge of this processor's sub-domain */
         std::vector<proc_t> neighbourProcessors;
 
+        /** the neighbour processors within the region of influence of each local site
+            that has any, keyed by the contiguous index of the local site */
+        ParticleSet::HaloRanks haloRanks;
+
         /** a list of relative 3D vectors that defines the sites within a region of influence */
         typedef std::vector<util::Vector3D<site_t> > Neighbourhood;
 
@@ -77,11 +79,10 @@ namespace hemelb
             i.e. processors that are within the region of influence of the local domain's edge
             i.e. processors that own at least one site in the neighbourhood of a local site */
         void InitialiseNeighbourList(const geometry::LatticeData& latDatLBM,
-                                     const geometry::Geometry& gmyResult,
                                      const Neighbourhood& neighbourhood);
 
         /** get local coordinates and the owner rank for a site from its global coordinates */
-        bool GetLocalInformationForGlobalSite(const geometry::Geometry& gmyResult,
+        bool GetLocalInformationForGlobalSite(const geometry::LatticeData& latDatLBM,
                                               const util::Vector3D<site_t>& globalLocationForSite,
                                               site_t* blockIdForSite,
                                               site_t* localSiteIdForSite,
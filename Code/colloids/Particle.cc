@@ -18,21 +18,25 @@ namespace hemelb
                        const hemelb::lb::LbmParameters *lbmParams,
                        io::xml::Element& xml) :
       PersistedParticle(xml),
-      lbmParams(lbmParams)
+      lbmParams(lbmParams),
+      stencilOrigin(SITE_OR_BLOCK_SOLID)
     {
       // updating position with zero velocity and zero body force is necessary
       // because of the side-effect that sets owner rank from the new position
       ownerRank = SITE_OR_BLOCK_SOLID;
       velocity *= 0.0;
       bodyForces *= 0.0;
+      lubricationVelocityAdjustment = LatticeVelocity::Zero();
       UpdatePosition(latDatLBM);
 
       OutputInformation();
       if (log::Logger::ShouldDisplay<log::Trace>())
+      {
         log::Logger::Log<log::Trace, log::OnePerCore>(
           "In colloids::Particle::ctor, id: %i, a0: %g, ah: %g, position: {%g,%g,%g}\n",
           particleId, smallRadius_a0, largeRadius_ah,
           globalPosition.x, globalPosition.y, globalPosition.z);
+      }
     }
 
 //    const bool Particle::operator<(const Particle& other) const
@@ -60,11 +64,14 @@ namespace hemelb
 
     const void Particle::OutputInformation() const
     {
+      if (log::Logger::ShouldDisplay<log::Trace>())
+      {
         log::Logger::Log<log::Trace, log::OnePerCore>(
           "In colloids::Particle::OutputInformation, id: %i, owner: %i, drag %g, mass %g, position: {%g,%g,%g}, velocity: {%g,%g,%g}, bodyForces: {%g,%g,%g}\n",
           particleId, ownerRank, CalculateDragCoefficient(), mass,
           globalPosition.x, globalPosition.y, globalPosition.z,
           velocity.x, velocity.y, velocity.z, bodyForces.x, bodyForces.y, bodyForces.z);
+      }
     }
 
     // this is the exact size that the xdr data produced for this particle will occupy
@@ -77,10 +84,11 @@ namespace hemelb
     {
       lastCheckpointTimestep = currentTimestep;
 
-      writer << (uint64_t)ownerRank;
-      writer << (uint64_t)particleId;
-      writer << smallRadius_a0 << largeRadius_ah;
-      writer << globalPosition.x << globalPosition.y << globalPosition.z;
+      const uint64_t ids[2] = { (uint64_t)ownerRank, (uint64_t)particleId };
+      writer.writeArray(ids, 2);
+      const LatticeDistance geometry[5] = { smallRadius_a0, largeRadius_ah,
+                                            globalPosition.x, globalPosition.y, globalPosition.z };
+      writer.writeArray(geometry, 5);
 
       // if the following code line is ever uncommented
       // change io::formats::colloids::RecordLength to 80
@@ -93,10 +101,12 @@ namespace hemelb
       // then,  update the owner rank for the particle based on its new position
 
       if (log::Logger::ShouldDisplay<log::Trace>())
+      {
         log::Logger::Log<log::Trace, log::OnePerCore>(
           "In colloids::Particle::UpdatePosition, id: %i,\nposition: {%g,%g,%g}\nvelocity: {%g,%g,%g}\nbodyForces: {%g,%g,%g}\n",
           particleId, globalPosition.x, globalPosition.y, globalPosition.z,
           velocity.x, velocity.y, velocity.z, bodyForces.x, bodyForces.y, bodyForces.z);
+      }
 
       globalPosition += GetVelocity();
 
@@ -118,9 +128,11 @@ namespace hemelb
       }
 
       if (log::Logger::ShouldDisplay<log::Trace>())
+      {
         log::Logger::Log<log::Trace, log::OnePerCore>(
           "In colloids::Particle::UpdatePosition, id: %i, position is now: {%g,%g,%g}\n",
           particleId, globalPosition.x, globalPosition.y, globalPosition.z);
+      }
     }
 
     const Dimensionless Particle::GetViscosity() const
@@ -139,41 +151,86 @@ namespace hemelb
 
     const void Particle::CalculateBodyForces()
     {
-      log::Logger::Log<log::Trace, log::OnePerCore>(
-        "In colloids::Particle::CalculateBodyForces, id: %i, position: {%g,%g,%g}\n",
-        particleId, globalPosition.x, globalPosition.y, globalPosition.z);
+      if (log::Logger::ShouldDisplay<log::Trace>())
+      {
+        log::Logger::Log<log::Trace, log::OnePerCore>(
+          "In colloids::Particle::CalculateBodyForces, id: %i, position: {%g,%g,%g}\n",
+          particleId, globalPosition.x, globalPosition.y, globalPosition.z);
+      }
 
       // delegate the calculation of body forces to the BodyForces class
       bodyForces = BodyForces::GetBodyForcesForParticle(*this);
 
-      log::Logger::Log<log::Trace, log::OnePerCore>(
-        "In colloids::Particle::CalculateBodyForces, id: %i, position: {%g,%g,%g}, bodyForces: {%g,%g,%g}\n",
-        particleId, globalPosition.x, globalPosition.y, globalPosition.z,
-        bodyForces.x, bodyForces.y, bodyForces.z);
+      if (log::Logger::ShouldDisplay<log::Trace>())
+      {
+        log::Logger::Log<log::Trace, log::OnePerCore>(
+          "In colloids::Particle::CalculateBodyForces, id: %i, position: {%g,%g,%g}, bodyForces: {%g,%g,%g}\n",
+          particleId, globalPosition.x, globalPosition.y, globalPosition.z,
+          bodyForces.x, bodyForces.y, bodyForces.z);
+      }
     }
 
-    /** modified dirac delta function according to Peskin */
-    const Dimensionless diracOperation(const LatticePosition& relativePosition)
+    /**
+     * modified dirac delta function according to Peskin, for one axis
+     *
+     * the three dimensional delta function is the product of this function
+     * evaluated for each component of the relative position of the site
+     */
+    inline Dimensionless diracOperation1D(const LatticeDistance relativePosition)
     {
-      Dimensionless delta = 1.0;
-      for (int xyz=0;xyz<3;xyz++)
-      {
-        const LatticeDistance rmod = fabs(relativePosition[xyz]);
+      const LatticeDistance rmod = fabs(relativePosition);
+
+      if (rmod <= 1.0)
+        return 0.125*(3.0 - 2.0*rmod + sqrt(1.0 + 4.0*rmod - 4.0*rmod*rmod));
+      else if (rmod <= 2.0)
+        return 0.125*(5.0 - 2.0*rmod - sqrt(-7.0 + 12.0*rmod  - 4.0*rmod*rmod));
+      else
+        return 0.0;
+    }
 
-        if (rmod <= 1.0)
-          delta *= 0.125*(3.0 - 2.0*rmod + sqrt(1.0 + 4.0*rmod - 4.0*rmod*rmod));
-        else if (rmod <= 2.0)
-          delta *= 0.125*(5.0 - 2.0*rmod - sqrt(-7.0 + 12.0*rmod  - 4.0*rmod*rmod));
-        else
-          delta = 0.0;
+    const void Particle::UpdateStencil(const geometry::LatticeData& latDatLBM)
+    {
+      // the stencil covers the semi-open interval [-2, +2) around the particle
+      // in each direction, so it only changes when the particle changes cell
+      const util::Vector3D<site_t> origin((site_t)globalPosition.x - 1,
+                                          (site_t)globalPosition.y - 1,
+                                          (site_t)globalPosition.z - 1);
+      if (origin == stencilOrigin)
+        return;
+
+      stencilOrigin = origin;
+      unsigned int index = 0;
+      for (site_t x = origin.x; x < origin.x + StencilWidth; x++)
+        for (site_t y = origin.y; y < origin.y + StencilWidth; y++)
+          for (site_t z = origin.z; z < origin.z + StencilWidth; z++, index++)
+          {
+            // convert the global coordinates of the site into a local site index
+            proc_t procId;
+            site_t siteId;
+            const bool isSiteValid = latDatLBM.GetContiguousSiteId(util::Vector3D<site_t>(x, y, z),
+                                                                   procId,
+                                                                   siteId);
 
+            /** TODO: implement boundary conditions for invalid/solid sites */
+            stencilSiteIds[index] = (isSiteValid && procId == latDatLBM.GetLocalRank()) ?
+              siteId :
+              SITE_OR_BLOCK_SOLID;
+          }
+    }
+
+    const void Particle::CalculateStencilWeights(Dimensionless* weights) const
+    {
+      for (int xyz = 0; xyz < 3; xyz++)
+      {
+        const LatticeDistance offset = stencilOrigin[xyz] - globalPosition[xyz];
+        for (int i = 0; i < StencilWidth; i++)
+          weights[xyz * StencilWidth + i] = diracOperation1D(offset + i);
       }
-      return delta;
     }
 
     const void Particle::CalculateFeedbackForces(
-                           const geometry::LatticeData& latDatLBM) const
-                           //lb::MacroscopicPropertyCache& propertyCache) const
+                           const geometry::LatticeData& latDatLBM,
+                           lb::MacroscopicPropertyCache& propertyCache)
     {
       /** CalculateFeedbackForces
        *    For each local neighbour lattice site
@@ -181,216 +238,94 @@ namespace hemelb
        *    - set feedback force values into the body forces cache object
        */
 
-      log::Logger::Log<log::Debug, log::OnePerCore>(
-        "In colloids::Particle::CalculateFeedbackForces, id: %i, position: {%g,%g,%g}\n",
-        particleId, globalPosition.x, globalPosition.y, globalPosition.z);
-
-      // determine the global coordinates of the next neighbour site:
-      // nested loop - x, y, z directions semi-open interval [-2, +2)
-      for (site_t x = ((site_t)globalPosition.x)-1;
-                  x < ((site_t)globalPosition.x)+3; x++)
-        for (site_t y = ((site_t)globalPosition.y)-1;
-                    y < ((site_t)globalPosition.y)+3; y++)
-          for (site_t z = ((site_t)globalPosition.z)-1;
-                      z < ((site_t)globalPosition.z)+3; z++)
-          {
-            const util::Vector3D<site_t> siteGlobalPosition(x, y, z);
-
-            log::Logger::Log<log::Trace, log::OnePerCore>(
-              "In colloids::Particle::CalculateFeedbackForces, particleId: %i, position: {%g,%g,%g}, siteGlobalPosition: {%i,%i,%i}, getting siteId ...\n",
-              particleId, globalPosition.x, globalPosition.y, globalPosition.z,
-              siteGlobalPosition.x, siteGlobalPosition.y, siteGlobalPosition.z);
+      if (log::Logger::ShouldDisplay<log::Debug>())
+      {
+        log::Logger::Log<log::Debug, log::OnePerCore>(
+          "In colloids::Particle::CalculateFeedbackForces, id: %i, position: {%g,%g,%g}\n",
+          particleId, globalPosition.x, globalPosition.y, globalPosition.z);
+      }
 
-            // convert the global coordinates of the site into a local site index
-            proc_t procId;
-            site_t siteId;
-            bool isSiteValid = latDatLBM.GetContiguousSiteId(siteGlobalPosition, procId, siteId);
-            bool isSiteLocal = (procId == latDatLBM.GetLocalRank());
+      UpdateStencil(latDatLBM);
 
-            log::Logger::Log<log::Trace, log::OnePerCore>(
-              "In colloids::Particle::CalculateFeedbackForces, particleId: %i, position: {%g,%g,%g}, siteGlobalPosition: {%i,%i,%i}, got siteId: %i, isSiteValid: %s, isSiteLocal: %s, procId: %i\n",
-              particleId, globalPosition.x, globalPosition.y, globalPosition.z,
-              siteGlobalPosition.x, siteGlobalPosition.y, siteGlobalPosition.z,
-              siteId, isSiteValid ? "TRUE" : "FALSE", isSiteLocal ? "TRUE" : "FALSE", procId);
+      Dimensionless weights[3 * StencilWidth];
+      CalculateStencilWeights(weights);
 
-            /** TODO: implement boundary conditions for invalid/solid sites */
-            if (!isSiteValid || !isSiteLocal)
+      unsigned int index = 0;
+      for (int x = 0; x < StencilWidth; x++)
+        for (int y = 0; y < StencilWidth; y++)
+        {
+          const Dimensionless weightXY = weights[x] * weights[StencilWidth + y];
+          for (int z = 0; z < StencilWidth; z++, index++)
+          {
+            const site_t siteId = stencilSiteIds[index];
+            if (siteId == SITE_OR_BLOCK_SOLID)
               continue;
 
-            // calculate term of the interpolation sum
-            LatticePosition relativePosition(siteGlobalPosition);
-            relativePosition -= globalPosition;
-            LatticeForceVector contribution = bodyForces * diracOperation(relativePosition);
-
-            log::Logger::Log<log::Trace, log::OnePerCore>(
-              "In colloids::Particle::CalculateFeedbackForces, particleId: %i, siteIndex: %i, bodyForces: {%g,%g,%g}, contribution: {%g,%g,%g}, reading cache ...\n",
-              particleId, siteId, bodyForces.x, bodyForces.y, bodyForces.z,
-              contribution.x, contribution.y, contribution.z);
-
-            // read value of force for site index from macroscopic cache
-            //LatticeForceVector partialInterpolation = propertyCache.bodyForcesCache.Get(siteId) +
-            LatticeForceVector partialInterpolation = BodyForces::GetBodyForcesForSiteId(siteId) +
-                                                      contribution;
-
-            // read value of force for site index from macroscopic cache
-            //propertyCache.bodyForcesCache.Put(siteId, partialInterpolation);
-            BodyForces::SetBodyForcesForSiteId(siteId, partialInterpolation);
-
-            log::Logger::Log<log::Trace, log::OnePerCore>(
-              "In colloids::Particle::CalculateFeedbackForces, particleId: %i, siteIndex: %i, bodyForces: {%g,%g,%g}, contribution: {%g,%g,%g}, forceOnSiteSoFar: {%g,%g,%g}\n",
-              particleId, siteId, bodyForces.x, bodyForces.y, bodyForces.z,
-              contribution.x, contribution.y, contribution.z,
-              partialInterpolation.x, partialInterpolation.y, partialInterpolation.z);
+            // accumulate the force for the site index in the macroscopic cache
+            propertyCache.bodyForces[siteId] += bodyForces
+                * (weightXY * weights[2 * StencilWidth + z]);
           }
-
-      log::Logger::Log<log::Trace, log::OnePerCore>(
-        "In colloids::Particle::CalculateFeedbackForces, particleId: %i, bodyForces: {%g,%g,%g}, finished\n",
-        particleId, bodyForces.x, bodyForces.y, bodyForces.z);
+        }
     }
 
-    const void Particle::InterpolateFluidVelocity(
-                           const geometry::LatticeData& latDatLBM,
-                           const lb::MacroscopicPropertyCache& propertyCache)
+    const void Particle::InterpolateFluidVelocities(std::vector<Particle>& particles,
+                                                    const geometry::LatticeData& latDatLBM,
+                                                    const lb::MacroscopicPropertyCache& propertyCache)
     {
-      /** InterpolateFluidVelocity
-       *    For each local neighbour lattice site
+      /** InterpolateFluidVelocities
+       *    For each particle, for each local neighbour lattice site
        *    - get velocity for the site from the macroscopic cache object
        *    - calculate site's contribution to the velocity interpolation
        *    - increment particle velocity property with this contribution
        *    - will require communication to transmit remote contributions
+       *
+       *  The stencils and the delta function weights for all the particles
+       *  are computed up front so the weights can be evaluated in one tight
+       *  loop, separately from the gather of the fluid velocities.
        */
 
-      log::Logger::Log<log::Debug, log::OnePerCore>(
-        "In colloids::Particle::InterpolateFluidVelocity, id: %i, position: {%g,%g,%g}\n",
-        particleId, globalPosition.x, globalPosition.y, globalPosition.z);
+      const size_t weightsPerParticle = 3 * StencilWidth;
+      std::vector<Dimensionless> weights(weightsPerParticle * particles.size());
+      for (size_t i = 0; i < particles.size(); i++)
+      {
+        particles[i].UpdateStencil(latDatLBM);
+        particles[i].CalculateStencilWeights(&weights[i * weightsPerParticle]);
+      }
 
-      velocity *= 0.0;
-      // determine the global coordinates of the next neighbour site:
-      // nested loop - x, y, z directions semi-open interval [-2, +2)
-      for (site_t x = ((site_t)globalPosition.x)-1;
-                  x < ((site_t)globalPosition.x)+3; x++)
-        for (site_t y = ((site_t)globalPosition.y)-1;
-                    y < ((site_t)globalPosition.y)+3; y++)
-          for (site_t z = ((site_t)globalPosition.z)-1;
-                      z < ((site_t)globalPosition.z)+3; z++)
+      for (size_t i = 0; i < particles.size(); i++)
+      {
+        Particle& particle = particles[i];
+        const Dimensionless* particleWeights = &weights[i * weightsPerParticle];
+
+        // TODO: should be LatticeVelocity == Vector3D<LatticeSpeed> (fix as part of #437)
+        util::Vector3D<double> velocity = util::Vector3D<double>::Zero();
+        unsigned int index = 0;
+        for (int x = 0; x < StencilWidth; x++)
+          for (int y = 0; y < StencilWidth; y++)
           {
-            const util::Vector3D<site_t> siteGlobalPosition(x, y, z);
-
-            // convert the global coordinates of the site into a local site index
-            proc_t procId;
-            site_t siteId;
-            bool isSiteValid = latDatLBM.GetContiguousSiteId(siteGlobalPosition, procId, siteId);
-            bool isSiteLocal = (procId == latDatLBM.GetLocalRank());
-
-            if (log::Logger::ShouldDisplay<log::Trace>())
+            const Dimensionless weightXY = particleWeights[x] * particleWeights[StencilWidth + y];
+            for (int z = 0; z < StencilWidth; z++, index++)
             {
-              log::Logger::Log<log::Trace, log::OnePerCore>("WAIT A MINUTE 1 ...\n");
-
-              int globalStatus = 0; // valid && local fluid
-              int blockStatus = 0; // valid && non-empty
-              int siteStatus = 0; // valid && fluid
-
-              util::Vector3D<site_t> blockCoords, localSiteCoords;
-              latDatLBM.GetBlockAndLocalSiteCoords(siteGlobalPosition, blockCoords, localSiteCoords);
-              log::Logger::Log<log::Trace, log::OnePerCore>("WAIT A MINUTE 2 ...\n");
-              if (!latDatLBM.IsValidBlock(blockCoords))
-                blockStatus = 1; // invalid - out of range
-              else if (latDatLBM.GetBlock(latDatLBM.GetBlockIdFromBlockCoords(blockCoords)).IsEmpty())
-                blockStatus = 2; // empty - entire block is solid
-
-              log::Logger::Log<log::Trace, log::OnePerCore>("WAIT A MINUTE 3 ...\n");
-
-              if (!latDatLBM.IsValidLatticeSite(localSiteCoords))
-                siteStatus = 1; // invalid - out of range
-              else if (blockStatus == 2)
-                siteStatus = 2; // deemed solid because block is empty
-              else if (blockStatus == 0)
-              {
-                if (latDatLBM.GetBlock(latDatLBM.GetBlockIdFromBlockCoords(blockCoords)).GetProcessorRankForSite(latDatLBM.GetLocalSiteIdFromLocalSiteCoords(localSiteCoords)) == SITE_OR_BLOCK_SOLID)
-                {
-                  siteStatus = 3; // individual site is not simulated, i.e. must be solid
-                }
-                else if (latDatLBM.GetBlock(latDatLBM.GetBlockIdFromBlockCoords(blockCoords)).GetProcessorRankForSite(latDatLBM.GetLocalSiteIdFromLocalSiteCoords(localSiteCoords)) == latDatLBM.GetLocalRank())
-                {
-                  if (latDatLBM.GetBlock(latDatLBM.GetBlockIdFromBlockCoords(blockCoords)).SiteIsSolid(latDatLBM.GetLocalSiteIdFromLocalSiteCoords(localSiteCoords)))
-                  siteStatus = 4; // individual site is local but solid (should not happen?)
-                }
-              }
-              log::Logger::Log<log::Trace, log::OnePerCore>("WAIT A MINUTE 4 ...\n");
-
-              if (blockStatus == 1 || (siteStatus == 1))
-                globalStatus = 1; // invalid - out of range
-              else if (blockStatus == 2 || (siteStatus == 3) | (siteStatus == 4))
-                globalStatus = 2; // solid
-              else if (latDatLBM.GetBlock(latDatLBM.GetBlockIdFromBlockCoords(blockCoords)).GetProcessorRankForSite(latDatLBM.GetLocalSiteIdFromLocalSiteCoords(localSiteCoords)) != latDatLBM.GetLocalRank())
-                globalStatus = 3; // remote fluid
-
-              log::Logger::Log<log::Trace, log::OnePerCore>("ABOUT TO DO STUFF\n");
-              log::Logger::Log<log::Trace, log::OnePerCore>(
-                "In colloids::Particle::InterpolateFluidVelocity, particleId: %i, siteGlobalPosition: {%i,%i,%i} - %s \n",
-                particleId, siteGlobalPosition.x, siteGlobalPosition.y, siteGlobalPosition.z,
-                globalStatus == 0 ? "valid && local fluid" :
-                (globalStatus == 1 ? "invalid - out-of-range" :
-                (globalStatus == 2 ? "solid" :
-                (globalStatus == 3 ? "remote fluid" : "unknown status"))));
-              log::Logger::Log<log::Trace, log::OnePerCore>("ABOUT TO DO MORE STUFF\n");
-              log::Logger::Log<log::Trace, log::OnePerCore>(
-                "In colloids::Particle::InterpolateFluidVelocity, particleId: %i, blockCoords: {%i,%i,%i} - %s\n",
-                particleId, blockCoords.x, blockCoords.y, blockCoords.z,
-                blockStatus == 0 ? "valid && non-empty" :
-                (blockStatus == 1 ? "invalid - out-of-range" :
-                (blockStatus == 2 ? "empty - entire block is solid" : "unknown status")));
-              log::Logger::Log<log::Trace, log::OnePerCore>("ABOUT TO DO EVEN MORE STUFF\n");
-              log::Logger::Log<log::Trace, log::OnePerCore>(
-                "In colloids::Particle::InterpolateFluidVelocity, particleId: %i, localSiteCoords: {%i,%i,%i} - %s\n",
-                particleId, localSiteCoords.x, localSiteCoords.y, localSiteCoords.z,
-                siteStatus == 0 ? "valid && fluid" :
-                (siteStatus == 1 ? "invalid - out of range" :
-                (siteStatus == 2 ? "deemed solid because block is empty" :
-                (siteStatus == 3 ? "deemed solid because not simulated" :
-                (siteStatus == 4 ? "local but solid (should not happen?)" : "unknown status")))));
-//*/
-              if (siteStatus == 0)
-              log::Logger::Log<log::Trace, log::OnePerCore>("ABOUT TO DO ONE LAST THING\n");
-              if (siteStatus == 0)
-              log::Logger::Log<log::Trace, log::OnePerCore>(
-                "In colloids::Particle::InterpolateFluidVelocity, particleId: %i, procIdForSite: %i\n",
-                particleId, latDatLBM.GetBlock(latDatLBM.GetBlockIdFromBlockCoords(blockCoords)).GetProcessorRankForSite(latDatLBM.GetLocalSiteIdFromLocalSiteCoords(localSiteCoords)));
-              log::Logger::Log<log::Trace, log::OnePerCore>("DONE LOTS OF STUFF\n");
-
-              if (!isSiteValid || !isSiteLocal)
-                if (globalStatus == 0)
-                {
-                  log::Logger::Log<log::Trace, log::OnePerCore>("MAJOR PROBLEM! isValid: %s, isLocal: %s, procIdForSite: %i, localRank: %i\n", isSiteValid ? "T": "F", isSiteLocal ? "T" : "F",
-                    latDatLBM.GetBlock(latDatLBM.GetBlockIdFromBlockCoords(blockCoords)).GetProcessorRankForSite(latDatLBM.GetLocalSiteIdFromLocalSiteCoords(localSiteCoords)),
-                    latDatLBM.GetLocalRank());
-                }
-            }
+              const site_t siteId = particle.stencilSiteIds[index];
+              if (siteId == SITE_OR_BLOCK_SOLID)
+                continue;
 
-            /** TODO: implement boundary conditions for invalid/solid sites */
-            if (!isSiteValid || !isSiteLocal)
-              continue;
-
-            // read value of velocity for site index from macroscopic cache
-            // TODO: should be LatticeVelocity == Vector3D<LatticeSpeed> (fix as part of #437)
-            util::Vector3D<double> siteFluidVelocity = propertyCache.velocityCache.Get(siteId);
-
-            // calculate term of the interpolation sum
-            LatticePosition relativePosition(siteGlobalPosition);
-            relativePosition -= globalPosition;
-            // TODO: should be LatticeVelocity == Vector3D<LatticeSpeed> (fix as part of #437)
-            util::Vector3D<double> partialInterpolation = siteFluidVelocity *
-              diracOperation(relativePosition);
-
-            // accumulate each term of the interpolation
-            velocity += partialInterpolation;
-
-            log::Logger::Log<log::Trace, log::OnePerCore>(
-              "In colloids::Particle::InterpolateFluidVelocity, particleId: %i, siteIndex: %i, fluidVelocity: {%g,%g,%g}, partialInterpolation: {%g,%g,%g}, velocitySoFar: {%g,%g,%g}\n",
-              particleId, siteId, siteFluidVelocity.x, siteFluidVelocity.y, siteFluidVelocity.z,
-              partialInterpolation.x, partialInterpolation.y, partialInterpolation.z,
-              velocity.x, velocity.y, velocity.z);
+              // accumulate each term of the interpolation
+              velocity += propertyCache.velocityCache.Get(siteId)
+                  * (weightXY * particleWeights[2 * StencilWidth + z]);
+            }
           }
+        particle.velocity = velocity;
+
+        if (log::Logger::ShouldDisplay<log::Trace>())
+        {
+          log::Logger::Log<log::Trace, log::OnePerCore>(
+            "In colloids::Particle::InterpolateFluidVelocities, id: %i, position: {%g,%g,%g}, velocity: {%g,%g,%g}\n",
+            particle.particleId,
+            particle.globalPosition.x, particle.globalPosition.y, particle.globalPosition.z,
+            velocity.x, velocity.y, velocity.z);
+        }
+      }
     }
 
   }
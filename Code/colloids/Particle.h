@@ -36,7 +36,10 @@ namespace hemelb
                  io::xml::Element& xml);
 
         /** constructor - gets an invalid particle for making MPI data types */
-        Particle() {};
+        Particle() : stencilOrigin(SITE_OR_BLOCK_SOLID) {};
+
+        /** the number of lattice sites along each axis of the interpolation stencil */
+        static const int StencilWidth = 4;
 
         /** property getter for particleId */
         const unsigned long GetParticleId() const { return particleId; }
@@ -139,13 +142,15 @@ namespace hemelb
         /** calculates the effects of all body forces on this particle */
         const void CalculateBodyForces();
 
-        /** calculates the effects of this particle on each lattice site */
-        const void CalculateFeedbackForces(const geometry::LatticeData& latDatLBM) const;
+        /** adds the effects of this particle on each local lattice site to the cache's body forces */
+        const void CalculateFeedbackForces(const geometry::LatticeData& latDatLBM,
+                                           lb::MacroscopicPropertyCache& propertyCache);
 
-        /** interpolates the fluid velocity to the location of each particle */
-        const void InterpolateFluidVelocity(
-                     const geometry::LatticeData& latDatLBM,
-                     const lb::MacroscopicPropertyCache& propertyCache);
+        /** interpolates the fluid velocity to the location of each of the particles */
+        static const void InterpolateFluidVelocities(
+                            std::vector<Particle>& particles,
+                            const geometry::LatticeData& latDatLBM,
+                            const lb::MacroscopicPropertyCache& propertyCache);
 
         /** accumulate contributions to velocity from remote processes */
         const void AccumulateVelocity(util::Vector3D<double>& contribution)
@@ -176,6 +181,16 @@ namespace hemelb
         const MPI_Datatype CreateMpiDatatypeWithVelocity() const;
 
       private:
+        /** refreshes the stencil site indices if the particle has changed lattice cell */
+        const void UpdateStencil(const geometry::LatticeData& latDatLBM);
+
+        /**
+         * calculates the one dimensional delta function weights of the stencil
+         * sites along each axis: weights[xyz * StencilWidth + i] is the weight
+         * of the i-th site along axis xyz
+         */
+        const void CalculateStencilWeights(Dimensionless* weights) const;
+
         /** partial interpolation of fluid velocity - temporary value only */
         LatticeVelocity velocity;
 
@@ -191,6 +206,17 @@ namespace hemelb
         proc_t ownerRank;
 
         bool isValid;
+
+        /** global coordinates of the lowest corner of the cached stencil */
+        util::Vector3D<site_t> stencilOrigin;
+
+        /**
+         * contiguous index of each site of the cached stencil, z fastest,
+         * or SITE_OR_BLOCK_SOLID for sites that are not local fluid sites
+         * (this depends only on stencilOrigin, not on which particle owns it)
+         */
+        site_t stencilSiteIds[StencilWidth * StencilWidth * StencilWidth];
+
         // Allow the sorter class to see our private members.
         friend struct ParticleSorter;
     };
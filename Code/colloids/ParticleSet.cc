@@ -43,9 +43,11 @@ namespace hemelb
                              lb::MacroscopicPropertyCache& propertyCache,
                              const hemelb::lb::LbmParameters *lbmParams,
                              std::vector<proc_t>& neighbourProcessors,
+                             const HaloRanks& haloRanks,
                              const net::IOCommunicator& ioComms_,
                              const std::string& outputPath) :
-        ioComms(ioComms_), localRank(ioComms.Rank()), latDatLBM(latDatLBM), propertyCache(propertyCache), path(outputPath), net(ioComms)
+        ioComms(ioComms_), localRank(ioComms.Rank()), haloRanks(haloRanks), latDatLBM(latDatLBM),
+        propertyCache(propertyCache), path(outputPath), net(ioComms)
     {
       /**
        * Open the file, unless it already exists, for writing only, creating it if it doesn't exist.
@@ -60,10 +62,10 @@ namespace hemelb
         writer << (uint32_t) io::formats::HemeLbMagicNumber;
         writer << (uint32_t) io::formats::colloids::MagicNumber;
         writer << (uint32_t) io::formats::colloids::VersionNumber;
-        file.Write(buffer);
+        file.WriteAt(0, buffer);
+        buffer.clear();
       }
-
-      HEMELB_MPI_CALL(MPI_File_seek_shared, (file, 0, MPI_SEEK_END));
+      fileOffset = io::formats::colloids::MagicLength;
 
       // add an element into scanMap for each neighbour rank with zero for both counts
       // sorting the list of neighbours allows the position in the map to be predicted
@@ -101,21 +103,48 @@ namespace hemelb
 
     ParticleSet::~ParticleSet()
     {
+      FlushOutput();
       particles.clear();
+      for (std::map<proc_t, MPI_Datatype>::iterator iterType = sendTypes.begin(); iterType != sendTypes.end(); iterType++)
+        HEMELB_MPI_CALL(MPI_Type_free, (&iterType->second));
     }
 
-    const void ParticleSet::OutputInformation(const LatticeTimeStep timestep)
+    const void ParticleSet::UpdateSendType(const proc_t neighbourRank, const std::vector<int>& indices)
     {
-      // Ensure the buffer is large enough.
-      const unsigned int maxSize = io::formats::colloids::RecordLength * particles.size()
-          + io::formats::colloids::HeaderLength;
-      if (buffer.size() < maxSize)
+      std::vector<int>& currentIndices = sendIndices[neighbourRank];
+      std::map<proc_t, MPI_Datatype>::iterator iterType = sendTypes.find(neighbourRank);
+      if (iterType != sendTypes.end() && indices == currentIndices)
+        return;
+
+      if (iterType != sendTypes.end())
       {
-        buffer.resize(maxSize);
+        HEMELB_MPI_CALL(MPI_Type_free, (&iterType->second));
+        sendTypes.erase(iterType);
       }
 
+      currentIndices = indices;
+      if (currentIndices.empty())
+        return;
+
+      // the displacements are in whole particles, relative to the start of the particles
+      // vector, so the type stays valid when the vector is reallocated
+      MPI_Datatype sendType;
+      HEMELB_MPI_CALL(MPI_Type_create_indexed_block,
+                      (currentIndices.size(), 1, &currentIndices.front(),
+                       net::MpiDataType<PersistedParticle>(), &sendType));
+      HEMELB_MPI_CALL(MPI_Type_commit, (&sendType));
+      sendTypes[neighbourRank] = sendType;
+    }
+
+    const void ParticleSet::OutputInformation(const LatticeTimeStep timestep)
+    {
+      // Make room at the end of the buffer for this time step's records.
+      const size_t bufferedBytes = buffer.size();
+      const unsigned int maxSize = io::formats::colloids::RecordLength * particles.size();
+      buffer.resize(bufferedBytes + maxSize);
+
       // Create an XDR writer and write all the particles for this processor.
-      io::writers::xdr::XdrMemWriter writer(&buffer.front(), maxSize);
+      io::writers::xdr::XdrMemWriter writer(buffer.data() + bufferedBytes, maxSize);
 
       for (std::vector<Particle>::iterator iter = particles.begin(); iter != particles.end(); iter++)
       {
@@ -129,38 +158,14 @@ namespace hemelb
 
       // And get the number of bytes written.
       const unsigned int count = writer.getCurrentStreamPosition();
+      buffer.resize(bufferedBytes + count);
+      bufferedRecordBytes.push_back(count);
+      bufferedTimesteps.push_back(timestep);
 
-      // Find how far we currently are into the file.
-      MPI_Offset positionBeforeWriting;
-      HEMELB_MPI_CALL(MPI_File_get_position_shared, (file, &positionBeforeWriting));
-
-      log::Logger::Log<log::Debug, log::OnePerCore>("from offsetEOF: %i\n", positionBeforeWriting);
-
-      // Go past the header (which we'll write at the end)
-      unsigned int sizeOfHeader = io::formats::colloids::HeaderLength;
-      HEMELB_MPI_CALL(MPI_File_seek_shared, (file, sizeOfHeader, MPI_SEEK_END));
-
-      // Collective write: the effect is as though all writes are done
-      // in serialised order, i.e. as if rank 0 writes first, followed
-      // by rank 1, and so on, until all ranks have written their data
-      HEMELB_MPI_CALL(MPI_File_write_ordered, (file, &buffer.front(), count, MPI_CHAR, MPI_STATUS_IGNORE));
-
-      // the collective ordered write modifies the shared file pointer
-      // it should point to the byte following the highest rank's data
-      // (should be true for all ranks but) we only need it for rank 0
-      MPI_Offset positionAferWriting;
-      HEMELB_MPI_CALL(MPI_File_get_position_shared, (file, &positionAferWriting));
-
-      log::Logger::Log<log::Debug, log::OnePerCore>("new offsetEOF: %i\n", positionBeforeWriting);
-
-      // Now write the header section, only on rank 0.
-      if (ioComms.OnIORank())
+      // Every rank outputs at the same time steps, so they all flush together.
+      if (bufferedTimesteps.size() >= OutputBufferSteps)
       {
-        writer << (uint32_t) io::formats::colloids::HeaderLength;
-        writer << (uint32_t) io::formats::colloids::RecordLength;
-        writer << (uint64_t) (positionAferWriting - positionBeforeWriting - io::formats::colloids::HeaderLength);
-        writer << (uint64_t) timestep;
-        HEMELB_MPI_CALL(MPI_File_write_at, (file, positionBeforeWriting, &buffer[count], sizeOfHeader, MPI_CHAR, MPI_STATUS_IGNORE));
+        FlushOutput();
       }
 
       for (scanMapConstIterType iterMap = scanMap.begin(); iterMap != scanMap.end(); iterMap++)
@@ -175,6 +180,47 @@ namespace hemelb
       }
     }
 
+    const void ParticleSet::FlushOutput()
+    {
+      if (bufferedTimesteps.empty())
+      {
+        return;
+      }
+
+      // Each time step's block is a header followed by the records of every rank, in rank
+      // order, so each rank's records go at the sum of the sizes from the lower ranks.
+      const std::vector<uint64_t> rankOffsets = ioComms.ExScan(bufferedRecordBytes, MPI_SUM);
+      const std::vector<uint64_t> blockLengths = ioComms.AllReduce(bufferedRecordBytes, MPI_SUM);
+
+      const char* records = buffer.data();
+      for (size_t step = 0; step < bufferedTimesteps.size(); step++)
+      {
+        if (ioComms.OnIORank())
+        {
+          std::vector<char> header(io::formats::colloids::HeaderLength);
+          io::writers::xdr::XdrMemWriter writer(&header[0], io::formats::colloids::HeaderLength);
+          writer << (uint32_t) io::formats::colloids::HeaderLength;
+          writer << (uint32_t) io::formats::colloids::RecordLength;
+          writer << (uint64_t) blockLengths[step];
+          writer << (uint64_t) bufferedTimesteps[step];
+          file.WriteAt(fileOffset, header);
+        }
+
+        log::Logger::Log<log::Debug, log::OnePerCore>("colloid output for step %lu at offset: %li\n",
+                                                      bufferedTimesteps[step],
+                                                      (long) fileOffset);
+
+        const MPI_Offset recordsStart = fileOffset + io::formats::colloids::HeaderLength;
+        file.WriteAtAll(recordsStart + rankOffsets[step], records, bufferedRecordBytes[step]);
+        records += bufferedRecordBytes[step];
+        fileOffset = recordsStart + blockLengths[step];
+      }
+
+      buffer.clear();
+      bufferedRecordBytes.clear();
+      bufferedTimesteps.clear();
+    }
+
     const void ParticleSet::UpdatePositions()
     {
       if (log::Logger::ShouldDisplay<log::Debug>())
@@ -245,22 +291,20 @@ namespace hemelb
 
     const void ParticleSet::CalculateFeedbackForces()
     {
-      BodyForces::ClearBodyForcesForAllSiteIds();
-      for (std::vector<Particle>::const_iterator iter = particles.begin(); iter != particles.end(); iter++)
+      std::fill(propertyCache.bodyForces.begin(),
+                propertyCache.bodyForces.end(),
+                LatticeForceVector::Zero());
+      for (std::vector<Particle>::iterator iter = particles.begin(); iter != particles.end(); iter++)
       {
-        const Particle& particle = *iter;
+        Particle& particle = *iter;
         if (particle.GetOwnerRank() == localRank)
-          particle.CalculateFeedbackForces(latDatLBM);
+          particle.CalculateFeedbackForces(latDatLBM, propertyCache);
       }
     }
 
     const void ParticleSet::InterpolateFluidVelocity()
     {
-      for (std::vector<Particle>::iterator iter = particles.begin(); iter != particles.end(); iter++)
-      {
-        Particle& particle = *iter;
-        particle.InterpolateFluidVelocity(latDatLBM, propertyCache);
-      }
+      Particle::InterpolateFluidVelocities(particles, latDatLBM, propertyCache);
       propertyCache.velocityCache.SetRefreshFlag();
     }
 
@@ -269,30 +313,74 @@ namespace hemelb
       /** CommunicateParticlePositions
        *    For each neighbour rank p
        *    - MPI_Irecv( number_of_remote_particles )
+       *    - MPI_Isend( number_of_local_particles_for_p )
+       *    MPI_Waitall()
+       *    For each neighbour rank p
        *    - MPI_Irecv( list_of_remote_particles )
-       *    - MPI_Isend( number_of_local_particles )
-       *    - MPI_Isend list_of_local_particles )
+       *    - MPI_Isend( list_of_local_particles_for_p )
        *    MPI_Waitall()
        *
        *  The global position of each particle is updated by the ownerRank process.
        *  The ownerRank for each particle is verified when its position is updated.
        *  Some (previously locally owned) particles may no longer be locally owned.
-       *  
+       *
+       *  A particle is only sent to the neighbours that own a site within the region
+       *  of influence of the site nearest to it, i.e. to the ranks whose halo it is in.
+       *  Particles that have just left this rank are sent to all the neighbours.
+       *  The particles for each neighbour are picked out of the particles vector by an
+       *  indexed MPI datatype built on the PersistedParticle one, so are not copied.
+       *  The datatype is kept from step to step and only rebuilt when the indices change.
        */
 
-      unsigned int& numberOfParticlesToSend = scanMap[localRank].first;
+      const unsigned int numberOfLocalParticles = scanMap[localRank].first;
       if (scanMap.size() < 2)
       {
         return;
       }
 
+      std::map<proc_t, std::vector<int> > particlesToSend;
+      for (scanMapIterType iterMap = scanMap.begin(); iterMap != scanMap.end(); iterMap++)
+        if (iterMap->first != localRank)
+          particlesToSend[iterMap->first];
+
+      for (unsigned int index = 0; index < numberOfLocalParticles; index++)
+      {
+        const LatticePosition& position = particles[index].GetGlobalPosition();
+        const util::Vector3D<site_t> siteGlobalPosition((site_t)(0.5+position.x),
+                                                        (site_t)(0.5+position.y),
+                                                        (site_t)(0.5+position.z));
+        proc_t procId;
+        site_t siteId;
+        if (latDatLBM.GetContiguousSiteId(siteGlobalPosition, procId, siteId) && procId == localRank)
+        {
+          HaloRanks::const_iterator iterHalo = haloRanks.find(siteId);
+          if (iterHalo == haloRanks.end())
+            continue;
+          for (std::vector<proc_t>::const_iterator iterRank = iterHalo->second.begin();
+               iterRank != iterHalo->second.end(); iterRank++)
+            particlesToSend[*iterRank].push_back(index);
+        }
+        else
+        {
+          for (scanMapConstIterType iterMap = scanMap.begin(); iterMap != scanMap.end(); iterMap++)
+            if (iterMap->first != localRank)
+              particlesToSend[iterMap->first].push_back(index);
+        }
+      }
+
+      for (std::map<proc_t, std::vector<int> >::const_iterator iterSend = particlesToSend.begin();
+           iterSend != particlesToSend.end(); iterSend++)
+        UpdateSendType(iterSend->first, iterSend->second);
+
+      std::map<proc_t, unsigned int> numberOfParticlesToSend;
       for (scanMapIterType iterMap = scanMap.begin(); iterMap != scanMap.end(); iterMap++)
       {
         const proc_t& neighbourRank = iterMap->first;
         if (neighbourRank != localRank)
         {
           unsigned int& numberOfParticlesToRecv = iterMap->second.first;
-          net.RequestSendR(numberOfParticlesToSend, neighbourRank);
+          numberOfParticlesToSend[neighbourRank] = sendIndices[neighbourRank].size();
+          net.RequestSendR(numberOfParticlesToSend[neighbourRank], neighbourRank);
           net.RequestReceiveR(numberOfParticlesToRecv, neighbourRank);
         }
       }
@@ -303,18 +391,20 @@ namespace hemelb
         numberOfParticles += iterMap->second.first;
       particles.resize(numberOfParticles);
 
-      std::vector<Particle>::iterator iterSendBegin = particles.begin();
-      std::vector<Particle>::iterator iterRecvBegin = particles.begin() + numberOfParticlesToSend;
+      std::vector<Particle>::iterator iterRecvBegin = particles.begin() + numberOfLocalParticles;
       for (scanMapConstIterType iterMap = scanMap.begin(); iterMap != scanMap.end(); iterMap++)
       {
         const proc_t& neighbourRank = iterMap->first;
-        if (neighbourRank != localRank)
-        {
-          const unsigned int& numberOfParticlesToRecv = iterMap->second.first;
-          net.RequestSend(& ((PersistedParticle&) *iterSendBegin), numberOfParticlesToSend, neighbourRank);
+        if (neighbourRank == localRank)
+          continue;
+
+        if (!sendIndices[neighbourRank].empty())
+          net.RequestSend(& ((PersistedParticle&) particles.front()), sendTypes[neighbourRank], neighbourRank);
+
+        const unsigned int& numberOfParticlesToRecv = iterMap->second.first;
+        if (numberOfParticlesToRecv > 0)
           net.RequestReceive(& ((PersistedParticle&) * (iterRecvBegin)), numberOfParticlesToRecv, neighbourRank);
-          iterRecvBegin += numberOfParticlesToRecv;
-        }
+        iterRecvBegin += numberOfParticlesToRecv;
       }
       net.Dispatch();
 
@@ -372,8 +462,9 @@ namespace hemelb
         numberOfIncomingVelocities += iterMap->second.second;
       velocityBuffer.resize(numberOfIncomingVelocities);
 
-      // exchange velocities
-      std::vector<Particle>::iterator iterSendBegin = particles.begin();
+      // exchange velocities - the particles are sorted by owner rank, after the local
+      // ones, so the velocities for each neighbour are a contiguous range of particles
+      std::vector<Particle>::iterator iterSendBegin = particles.begin() + scanMap[localRank].first;
       std::vector<std::pair<unsigned long, util::Vector3D<double> > >::iterator iterRecvBegin = velocityBuffer.begin();
       for (scanMapConstIterType iterMap = scanMap.begin(); iterMap != scanMap.end(); iterMap++)
       {
@@ -382,8 +473,11 @@ namespace hemelb
         {
           const unsigned int& numberOfVelocitiesToSend = iterMap->second.first;
           const unsigned int& numberOfVelocitiesToRecv = iterMap->second.second;
-          net.RequestSend(& ((Particle&) *iterSendBegin), numberOfVelocitiesToSend, neighbourRank);
-          net.RequestReceive(& (* (iterRecvBegin)), numberOfVelocitiesToRecv, neighbourRank);
+          if (numberOfVelocitiesToSend > 0)
+            net.RequestSend(& ((Particle&) *iterSendBegin), numberOfVelocitiesToSend, neighbourRank);
+          if (numberOfVelocitiesToRecv > 0)
+            net.RequestReceive(& (* (iterRecvBegin)), numberOfVelocitiesToRecv, neighbourRank);
+          iterSendBegin += numberOfVelocitiesToSend;
           iterRecvBegin += numberOfVelocitiesToRecv;
         }
       }
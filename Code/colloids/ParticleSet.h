@@ -24,12 +24,16 @@ namespace hemelb
     class ParticleSet
     {
       public:
+        /** map localSiteId -> neighbour ranks owning a site within the region of influence of that site */
+        typedef std::map<site_t, std::vector<proc_t> > HaloRanks;
+
         /** constructor - gets local particle information from xml config file */
         ParticleSet(const geometry::LatticeData& latDatLBM,
                     io::xml::Element& xml,
                     lb::MacroscopicPropertyCache& propertyCache,
                     const hemelb::lb::LbmParameters *lbmParams,
                     std::vector<proc_t>& neighbourProcessors,
+                    const HaloRanks& haloRanks,
                     const net::IOCommunicator& ioComms_,
                     const std::string& outputPath);
 
@@ -52,15 +56,34 @@ namespace hemelb
         /** interpolates the fluid velocity to the location of each particle */
         const void InterpolateFluidVelocity();
 
-        /** communicates the positions of all particles to&from all neighbours */
+        /** communicates the positions of particles to&from the neighbours whose sites they affect */
         const void CommunicateParticlePositions();
 
-        /** communicates the partial fluid interpolations to&from all neighbours */
+        /** communicates the partial fluid interpolations to the owners of the particles */
         const void CommunicateFluidVelocities();
 
+        /**
+         * buffers the records of the local particles for this time step, and writes out
+         * all the buffered records once OutputBufferSteps time steps have been buffered
+         */
         const void OutputInformation(const LatticeTimeStep timestep);
 
+        /** writes out all the buffered particle records - collective */
+        const void FlushOutput();
+
+        /** the number of output time steps to buffer in memory before writing them */
+        static const unsigned int OutputBufferSteps = 16;
+
+        /** the particles known to this process, local ones first - used in unit tests */
+        const std::vector<Particle>& GetParticles() const
+        {
+          return particles;
+        }
+
       private:
+        /** rebuilds the datatype for sending particles to a neighbour if the indices have changed */
+        const void UpdateSendType(const proc_t neighbourRank, const std::vector<int>& indices);
+
         const net::IOCommunicator& ioComms;
         /** cached copy of local rank (obtained from topology) */
         const proc_t localRank;
@@ -78,6 +101,15 @@ namespace hemelb
         typedef std::map<proc_t, scanMapElementType>::iterator scanMapIterType;
         typedef std::pair<proc_t, scanMapElementType> scanMapContentType;
         
+        /** neighbour ranks that need a copy of a particle, keyed by the particle's local site */
+        const HaloRanks& haloRanks;
+
+        /** map neighbourRank -> indices of the local particles to send to that rank */
+        std::map<proc_t, std::vector<int> > sendIndices;
+
+        /** map neighbourRank -> indexed datatype picking sendIndices out of the particles vector */
+        std::map<proc_t, MPI_Datatype> sendTypes;
+
         /** contiguous buffer into which MPI can write all the velocities from neighbours */
         std::vector<std::pair<unsigned long, util::Vector3D<double> > > velocityBuffer;
 
@@ -97,9 +129,18 @@ namespace hemelb
         /** abstracts communication via MPI */
         net::Net net;
         /**
-         * Reusable output buffer.
+         * Buffered particle records for the output time steps not yet written.
          */
         std::vector<char> buffer;
+        /**
+         * The number of bytes of records and the time step for each buffered output.
+         */
+        std::vector<uint64_t> bufferedRecordBytes;
+        std::vector<LatticeTimeStep> bufferedTimesteps;
+        /**
+         * The offset into the file at which the next output block starts.
+         */
+        MPI_Offset fileOffset;
         /**
          * Path to write to.
          */
@@ -0,0 +1,98 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+
+#include "configuration/InputFiles.h"
+#include "Exception.h"
+#include "io/writers/xdr/XdrMemReader.h"
+#include "io/writers/xdr/XdrVectorWriter.h"
+#include "net/MpiCommunicator.h"
+
+namespace hemelb
+{
+  namespace configuration
+  {
+    InputFiles::InputFiles() :
+        readFromDisk(true)
+    {
+    }
+
+    const std::string& InputFiles::Read(const std::string& path)
+    {
+      std::map<std::string, std::string>::const_iterator it = contents.find(path);
+      if (it != contents.end())
+      {
+        return it->second;
+      }
+
+      if (!readFromDisk)
+      {
+        throw Exception() << "Input file '" << path << "' was not among those broadcast";
+      }
+
+      std::ifstream file(path.c_str(), std::ios_base::in | std::ios_base::binary);
+      if (!file)
+      {
+        throw Exception() << "Cannot open input file '" << path << "'";
+      }
+      std::ostringstream text;
+      text << file.rdbuf();
+      return contents[path] = text.str();
+    }
+
+    bool InputFiles::Has(const std::string& path) const
+    {
+      return contents.count(path) != 0;
+    }
+
+    std::vector<char> InputFiles::Serialise() const
+    {
+      io::writers::xdr::XdrVectorWriter writer;
+      writer << static_cast<uint32_t>(contents.size());
+      for (std::map<std::string, std::string>::const_iterator it = contents.begin();
+          it != contents.end(); ++it)
+      {
+        writer << it->first << it->second;
+      }
+      return writer.GetBuf();
+    }
+
+    void InputFiles::Deserialise(const std::vector<char>& buffer)
+    {
+      io::writers::xdr::XdrMemReader reader(buffer);
+      contents.clear();
+      const uint32_t count = reader.read<uint32_t>();
+      for (uint32_t file = 0; file < count; ++file)
+      {
+        const std::string path = reader.read<std::string>();
+        reader.read(contents[path]);
+      }
+      readFromDisk = false;
+    }
+
+    void InputFiles::Broadcast(const net::MpiCommunicator& comms, int root)
+    {
+      std::vector<char> buffer;
+      if (comms.Rank() == root)
+      {
+        buffer = Serialise();
+      }
+
+      uint64_t size = buffer.size();
+      comms.Broadcast(size, root);
+      buffer.resize(size);
+      comms.Broadcast(buffer, root);
+
+      if (comms.Rank() != root)
+      {
+        Deserialise(buffer);
+      }
+    }
+  }
+}
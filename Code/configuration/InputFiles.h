@@ -0,0 +1,78 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_CONFIGURATION_INPUTFILES_H
+#define HEMELB_CONFIGURATION_INPUTFILES_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace hemelb
+{
+  namespace net
+  {
+    class MpiCommunicator;
+  }
+  namespace configuration
+  {
+    /**
+     * The contents of the input files a simulation is configured from: the XML file and any files
+     * it refers to, such as iolet profiles.
+     *
+     * One rank reads the files and broadcasts them all in a single buffer, so the other ranks
+     * never touch the file system for them, however many of them there are.
+     */
+    class InputFiles
+    {
+      public:
+        /**
+         * Start empty, reading files from disk as they are asked for.
+         */
+        InputFiles();
+
+        /**
+         * The contents of a file, read from disk the first time they are asked for. Once the
+         * files have been received from another rank, asking for any file it did not send is an
+         * error.
+         * @param path
+         * @return
+         */
+        const std::string& Read(const std::string& path);
+
+        /**
+         * @param path
+         * @return Whether the file's contents are held
+         */
+        bool Has(const std::string& path) const;
+
+        /**
+         * Pack the files into an XDR buffer.
+         * @return
+         */
+        std::vector<char> Serialise() const;
+
+        /**
+         * Replace the files with those packed into an XDR buffer by Serialise.
+         * @param buffer
+         */
+        void Deserialise(const std::vector<char>& buffer);
+
+        /**
+         * Hand the files read on the root to every other rank, replacing whatever they held.
+         * @param comms
+         * @param root
+         */
+        void Broadcast(const net::MpiCommunicator& comms, int root);
+
+      private:
+        std::map<std::string, std::string> contents;
+        bool readFromDisk;
+    };
+  }
+}
+
+#endif /* HEMELB_CONFIGURATION_INPUTFILES_H */
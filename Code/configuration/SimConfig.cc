@@ -14,6 +14,7 @@
 #include "log/Logger.h"
 #include "util/fileutils.h"
 #include "lb/InitialCondition.h"
+#include "net/IOCommunicator.h"
 
 namespace hemelb
 {
@@ -42,9 +43,15 @@ namespace hemelb
       return ans;
     }
 
+    SimConfig* SimConfig::New(const std::string& path, const net::IOCommunicator& comms)
+    {
+      SimConfig* ans = new SimConfig(path);
+      ans->Init(comms);
+      return ans;
+    }
 
     SimConfig::SimConfig(const std::string& path) :
-      xmlFilePath(path), rawXmlDoc(NULL), hasColloidSection(false), warmUpSteps(0), unitConverter(NULL)
+      xmlFilePath(path), rawXmlDoc(NULL), checkpointOutput(NULL), hasColloidSection(false), warmUpSteps(0), unitConverter(NULL)
     {
     }
 
@@ -54,8 +61,44 @@ namespace hemelb
       {
         throw Exception() << "Config file '" << xmlFilePath << "' does not exist";
       }
-      rawXmlDoc = new io::xml::Document(xmlFilePath);
-      colloidConfigPath = xmlFilePath;
+      Load();
+    }
+
+    void SimConfig::Init(const net::IOCommunicator& comms)
+    {
+      // The IO rank reads and checks everything first, so that the others learn of any problem
+      // rather than waiting for files that will never come.
+      int loaded = 1;
+      if (comms.OnIORank())
+      {
+        try
+        {
+          Init();
+        }
+        catch (...)
+        {
+          loaded = 0;
+          comms.Broadcast(loaded, comms.GetIORank());
+          throw;
+        }
+      }
+      comms.Broadcast(loaded, comms.GetIORank());
+      if (!loaded)
+      {
+        throw Exception() << "Config file '" << xmlFilePath << "' failed to load on the IO rank";
+      }
+
+      inputFiles.Broadcast(comms, comms.GetIORank());
+      if (!comms.OnIORank())
+      {
+        Load();
+      }
+    }
+
+    void SimConfig::Load()
+    {
+      rawXmlDoc = new io::xml::Document();
+      rawXmlDoc->LoadString(inputFiles.Read(xmlFilePath));
       DoIO(rawXmlDoc->GetRoot());
       dataFilePath = util::NormalizePathRelativeToPath(dataFilePath, xmlFilePath);
     }
@@ -66,6 +109,7 @@ namespace hemelb
       {
         delete propertyOutputs[outputNumber];
       }
+      delete checkpointOutput;
 
       delete rawXmlDoc;
       rawXmlDoc = NULL;
@@ -171,11 +215,20 @@ namespace hemelb
       // Required element
       // <geometry>
       //  <datafile path="relative path to GMY" />
+      //  <decomposition path="relative path to saved decomposition" /> (optional)
       // </geometry>
       dataFilePath = geometryEl.GetChildOrThrow("datafile").GetAttributeOrThrow("path");
       // Convert to a full path
       dataFilePath = util::NormalizePathRelativeToPath(dataFilePath, xmlFilePath);
 
+      const io::xml::Element decompositionEl = geometryEl.GetChildOrNull("decomposition");
+      if (decompositionEl != io::xml::Element::Missing())
+      {
+        decompositionFilePath =
+            util::NormalizePathRelativeToPath(decompositionEl.GetAttributeOrThrow("path"),
+                                              xmlFilePath);
+      }
+
     }
 
     void SimConfig::CreateUnitConverter()
@@ -332,6 +385,22 @@ namespace hemelb
       {
         propertyOutputs.push_back(DoIOForPropertyOutputFile(*poPtr));
       }
+
+      // Optional element <checkpoint file="..." period="..."/>
+      io::xml::Element checkpointEl = propertiesEl.GetChildOrNull("checkpoint");
+      if (checkpointEl != io::xml::Element::Missing())
+        checkpointOutput = DoIOForCheckpointOutputFile(checkpointEl);
+    }
+
+    extraction::CheckpointOutputFile* SimConfig::DoIOForCheckpointOutputFile(
+        const io::xml::Element& checkpointEl)
+    {
+      extraction::CheckpointOutputFile* file = new extraction::CheckpointOutputFile();
+      file->filename = checkpointEl.GetAttributeOrThrow("file");
+      checkpointEl.GetAttributeOrThrow("period", file->frequency);
+      if (file->frequency == 0)
+        throw Exception() << "Checkpoint period must be positive in element " << checkpointEl.GetPath();
+      return file;
     }
 
     extraction::PropertyOutputFile* SimConfig::DoIOForPropertyOutputFile(
@@ -342,6 +411,30 @@ namespace hemelb
 
       propertyoutputEl.GetAttributeOrThrow("period", file->frequency);
 
+      // Optional attribute format="rows|columnar|compressed"
+      const std::string* format = propertyoutputEl.GetAttributeOrNull("format");
+      if (format != NULL)
+      {
+        if (*format == "columnar")
+        {
+          file->format = extraction::PropertyOutputFile::Columnar;
+        }
+        else if (*format == "compressed")
+        {
+          file->format = extraction::PropertyOutputFile::Compressed;
+          // Optional attribute tolerance, the error bound for lossy compression
+          if (propertyoutputEl.GetAttributeOrNull("tolerance") != NULL)
+          {
+            propertyoutputEl.GetAttributeOrThrow("tolerance", file->tolerance);
+          }
+        }
+        else if (*format != "rows")
+        {
+          throw Exception() << "Unrecognised property output format '" << *format
+              << "' in element " << propertyoutputEl.GetPath();
+        }
+      }
+
       io::xml::Element geometryEl = propertyoutputEl.GetChildOrThrow("geometry");
       const std::string& type = geometryEl.GetAttributeOrThrow("type");
 
@@ -587,6 +680,7 @@ namespace hemelb
       const io::xml::Element conditionEl = ioletEl.GetChildOrThrow("condition");
       const io::xml::Element pathEl = conditionEl.GetChildOrThrow("path");
       newIolet->SetFilePath(pathEl.GetAttributeOrThrow("value"));
+      newIolet->SetFileContents(inputFiles.Read(newIolet->GetFilePath()));
 
       return newIolet;
     }
@@ -606,6 +700,28 @@ namespace hemelb
       GetDimensionalValue(velocityEl, "m/s", newIolet->GetVelocityReference());
 
       newIolet->GetLabel() = conditionEl.GetChildOrThrow("label").GetAttributeOrThrow("value");
+
+      // Optionally, e.g. <lag value="2" units="lattice" extrapolation="linear" />
+      const io::xml::Element lagEl = conditionEl.GetChildOrNull("lag");
+      if (lagEl != io::xml::Element::Missing())
+      {
+        unsigned int lag;
+        GetDimensionalValue(lagEl, "lattice", lag);
+
+        lb::iolets::InOutLetMultiscale::LagExtrapolation extrapolation =
+            lb::iolets::InOutLetMultiscale::HOLD;
+        const std::string* extrapolationName = lagEl.GetAttributeOrNull("extrapolation");
+        if (extrapolationName != NULL && *extrapolationName == "linear")
+        {
+          extrapolation = lb::iolets::InOutLetMultiscale::LINEAR;
+        }
+        else if (extrapolationName != NULL && *extrapolationName != "hold")
+        {
+          throw Exception() << "Invalid extrapolation '" << *extrapolationName << "' for "
+              << lagEl.GetPath() << ": expected 'hold' or 'linear'";
+        }
+        newIolet->SetCouplingLag(lag, extrapolation);
+      }
       return newIolet;
     }
 
@@ -668,6 +784,12 @@ namespace hemelb
 
       velocityFilePath = util::NormalizePathRelativeToPath(velocityFilePath, xmlFilePath);
       newIolet->SetFilePath(velocityFilePath);
+#ifdef HEMELB_USE_VELOCITY_WEIGHTS_FILE
+      newIolet->SetFileContents(inputFiles.Read(velocityFilePath),
+                                inputFiles.Read(velocityFilePath + ".weights.txt"));
+#else
+      newIolet->SetFileContents(inputFiles.Read(velocityFilePath), "");
+#endif
 
       const io::xml::Element radiusEl = conditionEl.GetChildOrThrow("radius");
       newIolet->SetRadius(GetDimensionalValueInLatticeUnits<LatticeDistance>(radiusEl, "m"));
@@ -16,10 +16,16 @@
 #include "lb/iolets/InOutLets.h"
 #include "extraction/GeometrySelectors.h"
 #include "extraction/PropertyOutputFile.h"
+#include "extraction/CheckpointOutputFile.h"
 #include "io/xml/XmlAbstractionLayer.h"
+#include "configuration/InputFiles.h"
 
 namespace hemelb
 {
+  namespace net
+  {
+    class IOCommunicator;
+  }
   namespace configuration
   {
     template<typename T>
@@ -82,10 +88,20 @@ namespace hemelb
         };
 
 	static SimConfig* New(const std::string& path);
+        /**
+         * Load the configuration on every rank of comms, which must all call this. Only the IO
+         * rank reads the XML file and the files it refers to; it broadcasts their contents to
+         * the others, which parse them from memory.
+         * @param path
+         * @param comms
+         * @return
+         */
+        static SimConfig* New(const std::string& path, const net::IOCommunicator& comms);
 
       protected:
 	SimConfig(const std::string& path);
         void Init();
+        void Init(const net::IOCommunicator& comms);
 
       public:
         virtual ~SimConfig();
@@ -137,6 +153,14 @@ namespace hemelb
         {
           return dataFilePath;
         }
+        /**
+         * The file hemelb-decompose saved each rank's lattice data to, or empty if none is given.
+         * @return
+         */
+        const std::string& GetDecompositionFilePath() const
+        {
+          return decompositionFilePath;
+        }
         LatticeTimeStep GetTotalTimeSteps() const
         {
           return totalTimeSteps;
@@ -169,15 +193,27 @@ namespace hemelb
         {
           return propertyOutputs;
         }
-        const std::string GetColloidConfigPath() const
+        /**
+         * The binary checkpoint output, or NULL if none was requested.
+         * @return
+         */
+        extraction::CheckpointOutputFile* GetCheckpointOutput() const
         {
-          return colloidConfigPath;
+          return checkpointOutput;
         }
         /**
          * True if the XML file has a section specifying colloids.
          * @return
          */
         bool HasColloidSection() const;
+        /**
+         * The parsed XML file, for the parts of the simulation that read their own sections.
+         * @return
+         */
+        io::xml::Document& GetXmlDocument() const
+        {
+          return *rawXmlDoc;
+        }
 
         // Get the initial condtion config
         inline const ICConfig& GetInitialCondition() const {
@@ -223,6 +259,10 @@ namespace hemelb
         }
 
       private:
+        /**
+         * Parse the XML file, reading it and the files it refers to through inputFiles.
+         */
+        void Load();
         void DoIO(const io::xml::Element xmlNode);
         void DoIOForSimulation(const io::xml::Element simEl);
         void DoIOForGeometry(const io::xml::Element geometryEl);
@@ -263,6 +303,9 @@ namespace hemelb
         void DoIOForProperties(const io::xml::Element& xmlNode);
         void DoIOForProperty(io::xml::Element xmlNode, bool isLoading);
         extraction::OutputField DoIOForPropertyField(const io::xml::Element& xmlNode);
+        extraction::CheckpointOutputFile* DoIOForCheckpointOutputFile(
+            const io::xml::Element& checkpointEl);
+
         extraction::PropertyOutputFile* DoIOForPropertyOutputFile(
             const io::xml::Element& propertyoutputEl);
         extraction::StraightLineGeometrySelector* DoIOForLineGeometry(
@@ -297,7 +340,9 @@ namespace hemelb
 
         const std::string& xmlFilePath;
         io::xml::Document* rawXmlDoc;
+        InputFiles inputFiles;
         std::string dataFilePath;
+        std::string decompositionFilePath;
 
         util::Vector3D<float> visualisationCentre;
         float visualisationLongitude;
@@ -308,7 +353,7 @@ namespace hemelb
         float maxStress;
         lb::StressTypes stressType;
         std::vector<extraction::PropertyOutputFile*> propertyOutputs;
-        std::string colloidConfigPath;
+        extraction::CheckpointOutputFile* checkpointOutput;
         /**
          * True if the file has a colloids section.
          */
@@ -96,6 +96,13 @@ namespace hemelb
           return;
         }
 
+        /**
+         * Moves the iterator to the given site.
+         */
+        void SeekTo(site_t siteIndex) {
+          return;
+        }
+
         /**
          * Returns true iff the passed location is within the lattice.
          *
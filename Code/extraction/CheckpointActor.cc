@@ -0,0 +1,36 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "extraction/CheckpointActor.h"
+
+namespace hemelb
+{
+  namespace extraction
+  {
+    CheckpointActor::CheckpointActor(const lb::SimulationState& simulationState,
+                                     const geometry::LatticeData& latDat,
+                                     const CheckpointOutputFile& outputSpec,
+                                     reporting::Timers& timers,
+                                     const net::IOCommunicator& ioComms) :
+        simulationState(simulationState), timers(timers)
+    {
+      checkpointOutput = new LocalCheckpointOutput(latDat, outputSpec, ioComms);
+    }
+
+    CheckpointActor::~CheckpointActor()
+    {
+      delete checkpointOutput;
+    }
+
+    void CheckpointActor::EndIteration()
+    {
+      timers[reporting::Timers::extractionWriting].Start();
+      checkpointOutput->Write(simulationState.GetTimeStep());
+      timers[reporting::Timers::extractionWriting].Stop();
+    }
+
+  }
+}
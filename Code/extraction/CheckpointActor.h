@@ -0,0 +1,47 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_EXTRACTION_CHECKPOINTACTOR_H
+#define HEMELB_EXTRACTION_CHECKPOINTACTOR_H
+
+#include "extraction/LocalCheckpointOutput.h"
+#include "lb/SimulationState.h"
+#include "net/IteratedAction.h"
+#include "reporting/Timers.h"
+
+namespace hemelb
+{
+  namespace extraction
+  {
+    /**
+     * Periodically writes a binary-exact checkpoint of the distributions. Must be
+     * registered after the LBM so that EndIteration sees the swapped arrays.
+     */
+    class CheckpointActor : public net::IteratedAction
+    {
+      public:
+        CheckpointActor(const lb::SimulationState& simulationState,
+                        const geometry::LatticeData& latDat,
+                        const CheckpointOutputFile& outputSpec,
+                        reporting::Timers& timers,
+                        const net::IOCommunicator& ioComms);
+
+        ~CheckpointActor();
+
+        /**
+         * Override the iterated actor end of iteration method to perform writing.
+         */
+        void EndIteration();
+
+      private:
+        const lb::SimulationState& simulationState;
+        LocalCheckpointOutput* checkpointOutput;
+        reporting::Timers& timers;
+    };
+  }
+}
+
+#endif /* HEMELB_EXTRACTION_CHECKPOINTACTOR_H */
@@ -0,0 +1,24 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_EXTRACTION_CHECKPOINTOUTPUTFILE_H
+#define HEMELB_EXTRACTION_CHECKPOINTOUTPUTFILE_H
+
+#include <string>
+
+namespace hemelb
+{
+  namespace extraction
+  {
+    struct CheckpointOutputFile
+    {
+        std::string filename;
+        unsigned long frequency;
+    };
+  }
+}
+
+#endif // HEMELB_EXTRACTION_CHECKPOINTOUTPUTFILE_H
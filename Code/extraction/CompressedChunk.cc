@@ -0,0 +1,165 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <zlib.h>
+
+#include "extraction/CompressedChunk.h"
+#include "io/formats/extraction.h"
+#include "Exception.h"
+
+namespace hemelb
+{
+  namespace extraction
+  {
+    namespace fmt = io::formats::extraction;
+
+    namespace
+    {
+      // Byte-shuffle 4 byte values: the low byte of every value, then the next byte of every
+      // value, and so on. Neighbouring values share their high bytes, so this gives deflate
+      // long runs to work with.
+      template<typename T>
+      void Shuffle(const std::vector<T>& values, std::vector<Bytef>& shuffled)
+      {
+        const size_t n = values.size();
+        shuffled.resize(4 * n);
+        for (size_t i = 0; i < n; ++i)
+        {
+          uint32_t bits;
+          std::memcpy(&bits, &values[i], 4);
+          for (unsigned byte = 0; byte < 4; ++byte)
+          {
+            shuffled[byte * n + i] = Bytef(bits >> (8 * byte));
+          }
+        }
+      }
+
+      template<typename T>
+      void Unshuffle(const std::vector<Bytef>& shuffled, std::vector<T>& values)
+      {
+        const size_t n = values.size();
+        for (size_t i = 0; i < n; ++i)
+        {
+          uint32_t bits = 0;
+          for (unsigned byte = 0; byte < 4; ++byte)
+          {
+            bits |= uint32_t(shuffled[byte * n + i]) << (8 * byte);
+          }
+          std::memcpy(&values[i], &bits, 4);
+        }
+      }
+
+      // Round every value to a multiple of quantum; false if any will not fit or, once decoded
+      // back to a float, would be further than tolerance from the original.
+      bool Quantise(const std::vector<float>& values, double quantum, double tolerance,
+                    std::vector<int32_t>& quantised)
+      {
+        quantised.resize(values.size());
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+          const double q = std::round(values[i] / quantum);
+          if (! (std::abs(q) <= std::numeric_limits<int32_t>::max())
+              || std::abs(double(float(q * quantum)) - values[i]) > tolerance)
+          {
+            return false;
+          }
+          quantised[i] = int32_t(q);
+        }
+        return true;
+      }
+    }
+
+    void CompressChunk(const std::vector<float>& values, double tolerance,
+                       std::vector<char>& chunk)
+    {
+      fmt::ChunkCodec codec = fmt::ShuffleDeflate;
+      // Rounding to a multiple of the tolerance leaves half of it for the error in converting
+      // back to float.
+      const double quantum = tolerance;
+      std::vector<Bytef> shuffled;
+      std::vector<int32_t> quantised;
+      if (tolerance > 0.0 && Quantise(values, quantum, tolerance, quantised))
+      {
+        codec = fmt::QuantisedShuffleDeflate;
+        Shuffle(quantised, shuffled);
+      }
+      else
+      {
+        Shuffle(values, shuffled);
+      }
+
+      const size_t start = chunk.size();
+      uLongf compressedLength = compressBound(shuffled.size());
+      chunk.resize(start + fmt::ChunkHeaderLength + compressedLength);
+      char* header = chunk.data() + start;
+      header = fmt::PutLittleEndian(uint32_t(codec), header);
+      header = fmt::PutLittleEndian(uint32_t(values.size()), header);
+      fmt::PutLittleEndian(codec == fmt::QuantisedShuffleDeflate ?
+        quantum :
+        0.0,
+                           header);
+
+      const int ret = compress2(reinterpret_cast<Bytef*>(chunk.data() + start
+                                    + fmt::ChunkHeaderLength),
+                                &compressedLength,
+                                shuffled.data(),
+                                shuffled.size(),
+                                Z_DEFAULT_COMPRESSION);
+      if (ret != Z_OK)
+      {
+        throw Exception() << "Compression of extraction chunk failed with zlib error " << ret;
+      }
+      chunk.resize(start + fmt::ChunkHeaderLength + compressedLength);
+    }
+
+    std::vector<float> DecompressChunk(const char* chunk, size_t length)
+    {
+      if (length < fmt::ChunkHeaderLength)
+      {
+        throw Exception() << "Extraction chunk of " << length << " bytes is too short";
+      }
+      const uint32_t codec = fmt::GetLittleEndian<uint32_t>(chunk);
+      const uint32_t count = fmt::GetLittleEndian<uint32_t>(chunk + 4);
+      const double quantum = fmt::GetLittleEndian<double>(chunk + 8);
+
+      std::vector<Bytef> shuffled(4 * size_t(count));
+      uLongf shuffledLength = shuffled.size();
+      const int ret = uncompress(shuffled.data(),
+                                 &shuffledLength,
+                                 reinterpret_cast<const Bytef*>(chunk + fmt::ChunkHeaderLength),
+                                 length - fmt::ChunkHeaderLength);
+      if (ret != Z_OK || shuffledLength != shuffled.size())
+      {
+        throw Exception() << "Decompression of extraction chunk failed with zlib error " << ret;
+      }
+
+      std::vector<float> values(count);
+      switch (codec)
+      {
+        case fmt::ShuffleDeflate:
+          Unshuffle(shuffled, values);
+          break;
+        case fmt::QuantisedShuffleDeflate:
+        {
+          std::vector<int32_t> quantised(count);
+          Unshuffle(shuffled, quantised);
+          for (size_t i = 0; i < count; ++i)
+          {
+            values[i] = float(quantised[i] * quantum);
+          }
+          break;
+        }
+        default:
+          throw Exception() << "Unknown extraction chunk codec " << codec;
+      }
+      return values;
+    }
+  }
+}
@@ -0,0 +1,42 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_EXTRACTION_COMPRESSEDCHUNK_H
+#define HEMELB_EXTRACTION_COMPRESSEDCHUNK_H
+
+#include <cstddef>
+#include <vector>
+
+namespace hemelb
+{
+  namespace extraction
+  {
+    /**
+     * Encode one rank's values for a record of a compressed extraction file (see
+     * io/formats/extraction.h), appending it to chunk.
+     *
+     * With a tolerance of zero the values are stored exactly. Otherwise each is rounded to the
+     * nearest multiple of the tolerance, so is stored to within the tolerance; if any value is
+     * too large, too finely resolved or not finite for this, the chunk is stored exactly
+     * instead.
+     * @param values
+     * @param tolerance
+     * @param chunk
+     */
+    void CompressChunk(const std::vector<float>& values, double tolerance,
+                       std::vector<char>& chunk);
+
+    /**
+     * Decode a chunk written by CompressChunk.
+     * @param chunk
+     * @param length
+     * @return the values
+     */
+    std::vector<float> DecompressChunk(const char* chunk, size_t length);
+  }
+}
+
+#endif /* HEMELB_EXTRACTION_COMPRESSEDCHUNK_H */
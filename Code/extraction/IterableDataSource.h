@@ -103,6 +103,14 @@ namespace hemelb
          */
         virtual void Reset() = 0;
 
+        /**
+         * Moves the iterator straight to a site, identified by how many calls to ReadNext
+         * after Reset it would take to reach it. Lets clients that have already selected the
+         * sites they need visit only those.
+         * @param siteIndex
+         */
+        virtual void SeekTo(site_t siteIndex) = 0;
+
         /**
          * Returns true iff the passed location is within the lattice.
          *
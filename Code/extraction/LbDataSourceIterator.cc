@@ -87,6 +87,11 @@ namespace hemelb
       position = -1;
     }
 
+    void LbDataSourceIterator::SeekTo(site_t siteIndex)
+    {
+      position = siteIndex;
+    }
+
     bool LbDataSourceIterator::IsValidLatticeSite(const util::Vector3D<site_t>& location) const
     {
       return data.IsValidLatticeSite(location);
@@ -103,6 +103,12 @@ namespace hemelb
          */
         void Reset();
 
+        /**
+         * Moves the iterator to the given local fluid site.
+         * @param siteIndex
+         */
+        void SeekTo(site_t siteIndex);
+
         /**
          * Returns true iff the passed location is within the lattice.
          *
@@ -0,0 +1,377 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+#include "extraction/LocalCheckpointInput.h"
+#include "geometry/LatticeData.h"
+#include "io/formats/formats.h"
+#include "io/formats/checkpoint.h"
+#include "io/writers/xdr/XdrMemReader.h"
+#include "log/Logger.h"
+
+namespace hemelb
+{
+  namespace extraction
+  {
+    namespace fmt = hemelb::io::formats;
+    namespace xdr = hemelb::io::writers::xdr;
+
+    LocalCheckpointInput::LocalCheckpointInput(const std::string& dataFilePath,
+                                               const net::IOCommunicator& ioComms) :
+        comms(ioComms), filePath(dataFilePath), nRanks(0), totalSites(0), coordinateOffset(0),
+            firstRecordOffset(0), recordLength(0)
+    {
+    }
+
+    LocalCheckpointInput::~LocalCheckpointInput()
+    {
+    }
+
+    bool LocalCheckpointInput::IsCheckpointFile(const std::string& dataFilePath,
+                                                const net::IOCommunicator& ioComms)
+    {
+      int isCheckpoint = 0;
+      if (ioComms.OnIORank())
+      {
+        std::ifstream file(dataFilePath, std::ios::binary);
+        std::vector<char> magicBuf(8);
+        if (file.read(magicBuf.data(), magicBuf.size()))
+        {
+          xdr::XdrMemReader magicReader(magicBuf);
+          uint32_t hlbMagicNumber, chkMagicNumber;
+          magicReader.read(hlbMagicNumber);
+          magicReader.read(chkMagicNumber);
+          isCheckpoint = (hlbMagicNumber == fmt::HemeLbMagicNumber)
+              && (chkMagicNumber == fmt::checkpoint::MagicNumber);
+        }
+      }
+      ioComms.Broadcast(isCheckpoint, ioComms.GetIORank());
+      return isCheckpoint;
+    }
+
+    void LocalCheckpointInput::LoadDistribution(geometry::LatticeData* latDat,
+                                                boost::optional<LatticeTimeStep>& targetTime)
+    {
+      auto inputFile = net::MpiFile::Open(comms, filePath, MPI_MODE_RDONLY);
+      inputFile.SetView(0, MPI_CHAR, MPI_CHAR, "native");
+      ReadHeaders(inputFile);
+
+      const uint64_t recordStart = FindRecord(inputFile, targetTime);
+
+      // Every rank must agree before anyone commits to the fast path.
+      const int matches = comms.AllReduce(int(LayoutMatches(*latDat)), MPI_MIN);
+      log::Logger::Log<log::Info, log::Singleton>("Reading checkpoint to resume at timestep %d (%s)",
+                                                  *targetTime,
+                                                  matches ?
+                                                    "same decomposition" :
+                                                    "redistributing sites");
+      if (matches)
+      {
+        ReadSameLayout(inputFile, recordStart, latDat);
+      }
+      else
+      {
+        ReadRemapped(inputFile, recordStart, latDat);
+      }
+
+      // Both arrays must hold the state, as for the other initial conditions.
+      const site_t localDistributions = latDat->GetLocalFluidSiteCount() * LatticeType::NUMVECTORS;
+      std::copy(latDat->GetFOld(0), latDat->GetFOld(0) + localDistributions, latDat->GetFNew(0));
+    }
+
+    void LocalCheckpointInput::ReadHeaders(net::MpiFile& inputFile)
+    {
+      std::vector<uint64_t> offsets(4);
+      if (comms.OnIORank())
+      {
+        std::vector<char> preambleBuf(fmt::checkpoint::PreambleLength);
+        inputFile.ReadAt(0, preambleBuf);
+        xdr::XdrMemReader preambleReader(preambleBuf);
+
+        uint32_t hlbMagicNumber, chkMagicNumber, version, byteOrder, numVectors;
+        preambleReader.read(hlbMagicNumber);
+        preambleReader.read(chkMagicNumber);
+        preambleReader.read(version);
+        preambleReader.read(byteOrder);
+        preambleReader.read(numVectors);
+        preambleReader.read(nRanks);
+        uint64_t signature;
+        preambleReader.read(totalSites);
+        preambleReader.read(signature);
+        preambleReader.read(coordinateOffset);
+        preambleReader.read(firstRecordOffset);
+
+        if (hlbMagicNumber != fmt::HemeLbMagicNumber)
+          throw Exception() << "This file does not start with the HemeLB magic number."
+              << " Expected: " << unsigned(fmt::HemeLbMagicNumber) << " Actual: " << hlbMagicNumber;
+
+        if (chkMagicNumber != fmt::checkpoint::MagicNumber)
+          throw Exception() << "This file does not have the checkpoint magic number."
+              << " Expected: " << unsigned(fmt::checkpoint::MagicNumber) << " Actual: "
+              << chkMagicNumber;
+
+        if (version != fmt::checkpoint::VersionNumber)
+          throw Exception() << "Version number incorrect." << " Supported: "
+              << unsigned(fmt::checkpoint::VersionNumber) << " Input: " << version;
+
+        // The marker is stored unswapped, so compare the raw bytes.
+        std::memcpy(&byteOrder, preambleBuf.data() + 12, sizeof(byteOrder));
+        if (byteOrder != fmt::checkpoint::ByteOrderMarker)
+          throw Exception() << "Checkpoint file was written on a machine with a different byte order";
+
+        if (numVectors != LatticeType::NUMVECTORS)
+          throw Exception() << "Checkpoint file contains " << numVectors
+              << " distributions per site but this build of HemeLB requires "
+              << LatticeType::NUMVECTORS;
+
+        if (coordinateOffset != fmt::checkpoint::GetCoordinateSectionOffset(nRanks)
+            || firstRecordOffset != fmt::checkpoint::GetFirstRecordOffset(nRanks, totalSites))
+          throw Exception() << "Checkpoint file section offsets are inconsistent with its header";
+
+        offsets[0] = nRanks;
+        offsets[1] = totalSites;
+        offsets[2] = coordinateOffset;
+        offsets[3] = firstRecordOffset;
+      }
+      comms.Broadcast(offsets, comms.GetIORank());
+      nRanks = offsets[0];
+      totalSites = offsets[1];
+      coordinateOffset = offsets[2];
+      firstRecordOffset = offsets[3];
+      recordLength = fmt::checkpoint::GetRecordLength(LatticeType::NUMVECTORS, totalSites);
+
+      siteCounts.resize(nRanks);
+      layoutHashes.resize(nRanks);
+      if (comms.OnIORank())
+      {
+        std::vector<char> rankTableBuf(nRanks * fmt::checkpoint::RankRecordLength);
+        inputFile.ReadAt(fmt::checkpoint::PreambleLength, rankTableBuf);
+        xdr::XdrMemReader rankTableReader(rankTableBuf);
+        for (uint32_t rank = 0; rank < nRanks; ++rank)
+        {
+          rankTableReader.read(siteCounts[rank]);
+          rankTableReader.read(layoutHashes[rank]);
+        }
+      }
+      comms.Broadcast(siteCounts, comms.GetIORank());
+      comms.Broadcast(layoutHashes, comms.GetIORank());
+    }
+
+    uint64_t LocalCheckpointInput::FindRecord(net::MpiFile& inputFile,
+                                              boost::optional<LatticeTimeStep>& targetTime)
+    {
+      const uint64_t fileSize = inputFile.GetSize();
+      if (fileSize < firstRecordOffset || (fileSize - firstRecordOffset) % recordLength)
+        throw Exception() << "Checkpoint file length not consistent with integer number of checkpoints";
+
+      const uint64_t nTimes = (fileSize - firstRecordOffset) / recordLength;
+      if (nTimes == 0)
+        throw Exception() << "Checkpoint file " << filePath << " contains no checkpoints";
+
+      auto ReadTimeByIndex = [&](uint64_t iTS)
+      {
+        std::vector<uint64_t> tsbuf(1);
+        inputFile.ReadAt(firstRecordOffset + iTS * recordLength, tsbuf);
+        return tsbuf[0];
+      };
+
+      uint64_t iTS = 0, timestep = 0;
+      if (comms.OnIORank())
+      {
+        if (targetTime)
+        {
+          // Records are appended in time order, so bisect.
+          uint64_t len = nTimes;
+          while (len != 0)
+          {
+            auto l2 = len / 2;
+            auto m = iTS + l2;
+            if (ReadTimeByIndex(m) < *targetTime)
+            {
+              iTS = m + 1;
+              len -= l2 + 1;
+            }
+            else
+            {
+              len = l2;
+            }
+          }
+
+          if (iTS == nTimes || (timestep = ReadTimeByIndex(iTS)) != *targetTime)
+            throw Exception() << "Target timestep " << *targetTime << " not found in checkpoint file.";
+        }
+        else
+        {
+          iTS = nTimes - 1;
+          timestep = ReadTimeByIndex(iTS);
+        }
+      }
+      comms.Broadcast(timestep, comms.GetIORank());
+      comms.Broadcast(iTS, comms.GetIORank());
+
+      targetTime = timestep;
+      return firstRecordOffset + iTS * recordLength;
+    }
+
+    bool LocalCheckpointInput::LayoutMatches(const geometry::LatticeData& latDat) const
+    {
+      if (nRanks != uint32_t(comms.Size()))
+        return false;
+
+      const uint64_t localSites = latDat.GetLocalFluidSiteCount();
+      if (siteCounts[comms.Rank()] != localSites)
+        return false;
+
+      fmt::checkpoint::LayoutHash localHash;
+      localHash.Add(localSites);
+      for (site_t i = 0; i < latDat.GetLocalFluidSiteCount(); ++i)
+      {
+        const util::Vector3D<site_t>& pos = latDat.GetSite(i).GetGlobalSiteCoords();
+        localHash.Add(pos.x);
+        localHash.Add(pos.y);
+        localHash.Add(pos.z);
+      }
+      return localHash.Get() == layoutHashes[comms.Rank()];
+    }
+
+    void LocalCheckpointInput::ReadSameLayout(net::MpiFile& inputFile, uint64_t recordStart,
+                                              geometry::LatticeData* latDat)
+    {
+      uint64_t firstSite = 0;
+      for (int rank = 0; rank < comms.Rank(); ++rank)
+        firstSite += siteCounts[rank];
+
+      inputFile.ReadAtAll(recordStart + sizeof(uint64_t)
+                              + firstSite * LatticeType::NUMVECTORS * sizeof(distribn_t),
+                          latDat->GetFOld(0),
+                          latDat->GetLocalFluidSiteCount() * LatticeType::NUMVECTORS);
+    }
+
+    void LocalCheckpointInput::ReadRemapped(net::MpiFile& inputFile, uint64_t recordStart,
+                                            geometry::LatticeData* latDat)
+    {
+      const int size = comms.Size();
+      const unsigned Q = LatticeType::NUMVECTORS;
+
+      const site_t localSites = latDat->GetLocalFluidSiteCount();
+      if (comms.AllReduce(uint64_t(localSites), MPI_SUM) != totalSites)
+        throw Exception() << "Checkpoint file holds " << totalSites
+            << " sites, which does not match the current geometry";
+
+      auto HomeRank = [&](site_t globalId)
+      {
+        return int(globalId % size);
+      };
+
+      // Read an equal slice of the file on each rank.
+      const uint64_t sliceStart = totalSites * comms.Rank() / size;
+      const uint64_t sliceEnd = totalSites * (comms.Rank() + 1) / size;
+      const uint64_t sliceSites = sliceEnd - sliceStart;
+
+      std::vector<uint32_t> sliceCoords(3 * sliceSites);
+      inputFile.ReadAtAll(coordinateOffset + sliceStart * fmt::checkpoint::CoordinateRecordLength,
+                          sliceCoords);
+      std::vector<distribn_t> sliceFs(Q * sliceSites);
+      inputFile.ReadAtAll(recordStart + sizeof(uint64_t) + sliceStart * Q * sizeof(distribn_t),
+                          sliceFs);
+
+      // Send each site's distributions to its home rank.
+      std::vector<site_t> sliceIds(sliceSites);
+      std::vector<int> sendCounts(size, 0);
+      for (uint64_t i = 0; i < sliceSites; ++i)
+      {
+        util::Vector3D<site_t> pos(sliceCoords[3 * i], sliceCoords[3 * i + 1], sliceCoords[3 * i + 2]);
+        sliceIds[i] = latDat->GetGlobalNoncontiguousSiteIdFromGlobalCoords(pos);
+        ++sendCounts[HomeRank(sliceIds[i])];
+      }
+
+      std::vector<int> sendStarts(size, 0);
+      for (int rank = 1; rank < size; ++rank)
+        sendStarts[rank] = sendStarts[rank - 1] + sendCounts[rank - 1];
+
+      std::vector<site_t> sendIds(sliceSites);
+      std::vector<distribn_t> sendFs(Q * sliceSites);
+      {
+        std::vector<int> next(sendStarts);
+        for (uint64_t i = 0; i < sliceSites; ++i)
+        {
+          const int pos = next[HomeRank(sliceIds[i])]++;
+          sendIds[pos] = sliceIds[i];
+          std::copy(sliceFs.data() + Q * i, sliceFs.data() + Q * (i + 1), sendFs.data() + Q * pos);
+        }
+      }
+      sliceFs.clear();
+
+      std::vector<int> sendFCounts(size);
+      for (int rank = 0; rank < size; ++rank)
+        sendFCounts[rank] = Q * sendCounts[rank];
+
+      std::vector<int> recvCounts, recvFCounts;
+      const std::vector<site_t> homeIds = comms.AllToAllV(sendIds, sendCounts, recvCounts);
+      const std::vector<distribn_t> homeFs = comms.AllToAllV(sendFs, sendFCounts, recvFCounts);
+
+      std::unordered_map<site_t, site_t> homeIndex(homeIds.size());
+      for (site_t i = 0; i < site_t(homeIds.size()); ++i)
+        homeIndex[homeIds[i]] = i;
+
+      // Ask the home ranks for this rank's sites.
+      std::vector<site_t> localIds(localSites);
+      std::vector<int> requestCounts(size, 0);
+      for (site_t i = 0; i < localSites; ++i)
+      {
+        localIds[i] =
+            latDat->GetGlobalNoncontiguousSiteIdFromGlobalCoords(latDat->GetSite(i).GetGlobalSiteCoords());
+        ++requestCounts[HomeRank(localIds[i])];
+      }
+
+      std::vector<int> requestStarts(size, 0);
+      for (int rank = 1; rank < size; ++rank)
+        requestStarts[rank] = requestStarts[rank - 1] + requestCounts[rank - 1];
+
+      std::vector<site_t> requestIds(localSites);
+      std::vector<site_t> requestSite(localSites);
+      {
+        std::vector<int> next(requestStarts);
+        for (site_t i = 0; i < localSites; ++i)
+        {
+          const int pos = next[HomeRank(localIds[i])]++;
+          requestIds[pos] = localIds[i];
+          requestSite[pos] = i;
+        }
+      }
+
+      std::vector<int> incomingCounts;
+      const std::vector<site_t> incomingIds = comms.AllToAllV(requestIds, requestCounts, incomingCounts);
+
+      // Answer in the order asked.
+      std::vector<distribn_t> replyFs(Q * incomingIds.size());
+      for (size_t i = 0; i < incomingIds.size(); ++i)
+      {
+        auto found = homeIndex.find(incomingIds[i]);
+        if (found == homeIndex.end())
+          throw Exception() << "Site with global id " << incomingIds[i]
+              << " is not present in checkpoint file " << filePath;
+        std::copy(homeFs.data() + Q * found->second, homeFs.data() + Q * (found->second + 1), replyFs.data() + Q * i);
+      }
+
+      std::vector<int> replyCounts(size);
+      for (int rank = 0; rank < size; ++rank)
+        replyCounts[rank] = Q * incomingCounts[rank];
+
+      std::vector<int> answerCounts;
+      const std::vector<distribn_t> answerFs = comms.AllToAllV(replyFs, replyCounts, answerCounts);
+
+      for (site_t pos = 0; pos < localSites; ++pos)
+      {
+        std::copy(answerFs.data() + Q * pos, answerFs.data() + Q * (pos + 1), latDat->GetFOld(requestSite[pos] * Q));
+      }
+    }
+  }
+}
@@ -0,0 +1,93 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_EXTRACTION_LOCALCHECKPOINTINPUT_H
+#define HEMELB_EXTRACTION_LOCALCHECKPOINTINPUT_H
+
+#include <string>
+#include <vector>
+#include <boost/optional.hpp>
+
+#include "lb/lattices/Lattices.h"
+#include "net/mpi.h"
+#include "net/MpiFile.h"
+#include "net/IOCommunicator.h"
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    class LatticeData;
+  }
+  namespace extraction
+  {
+    /**
+     * Restores the distributions from a binary-exact checkpoint written by
+     * LocalCheckpointOutput.
+     *
+     * If this run has the same decomposition as the one that wrote the file,
+     * each rank reads its distributions straight into the lattice. Otherwise
+     * every rank reads an equal slice of the file and the sites are routed to
+     * their new owners via a rendezvous rank (the global site id modulo the
+     * number of ranks), so no rank needs to know the whole decomposition.
+     */
+    class LocalCheckpointInput
+    {
+      public:
+        LocalCheckpointInput(const std::string& dataFilePath, const net::IOCommunicator& ioComms);
+
+        ~LocalCheckpointInput();
+
+        /**
+         * True if the file starts with the checkpoint magic numbers. Collective
+         * on ioComms; only the IO rank touches the file.
+         * @param dataFilePath
+         * @param ioComms
+         * @return
+         */
+        static bool IsCheckpointFile(const std::string& dataFilePath,
+                                     const net::IOCommunicator& ioComms);
+
+        /**
+         * Fill fOld and fNew from the record whose resume time step equals
+         * targetTime or, if that is unset, from the last record. On return
+         * targetTime holds the time step at which to resume. Collective.
+         * @param latDat
+         * @param targetTime
+         */
+        void LoadDistribution(geometry::LatticeData* latDat,
+                              boost::optional<LatticeTimeStep>& targetTime);
+
+      private:
+        typedef hemelb::lb::lattices:: HEMELB_LATTICE LatticeType;
+
+        void ReadHeaders(net::MpiFile& inputFile);
+        uint64_t FindRecord(net::MpiFile& inputFile, boost::optional<LatticeTimeStep>& targetTime);
+        bool LayoutMatches(const geometry::LatticeData& latDat) const;
+        void ReadSameLayout(net::MpiFile& inputFile, uint64_t recordStart,
+                            geometry::LatticeData* latDat);
+        void ReadRemapped(net::MpiFile& inputFile, uint64_t recordStart,
+                          geometry::LatticeData* latDat);
+
+        const net::IOCommunicator& comms;
+
+        /**
+         * The path to the file to read from.
+         */
+        const std::string filePath;
+
+        uint32_t nRanks;
+        uint64_t totalSites;
+        uint64_t coordinateOffset;
+        uint64_t firstRecordOffset;
+        uint64_t recordLength;
+        std::vector<uint64_t> siteCounts;
+        std::vector<uint64_t> layoutHashes;
+    };
+  }
+}
+
+#endif /* HEMELB_EXTRACTION_LOCALCHECKPOINTINPUT_H */
@@ -0,0 +1,153 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <cassert>
+#include "extraction/LocalCheckpointOutput.h"
+#include "geometry/LatticeData.h"
+#include "io/formats/formats.h"
+#include "io/formats/checkpoint.h"
+#include "io/writers/xdr/XdrVectorWriter.h"
+#include "net/IOCommunicator.h"
+
+namespace hemelb
+{
+  namespace extraction
+  {
+    namespace fmt = hemelb::io::formats;
+
+    LocalCheckpointOutput::LocalCheckpointOutput(const geometry::LatticeData& latDat,
+                                                 const CheckpointOutputFile& outputSpec,
+                                                 const net::IOCommunicator& ioComms) :
+        latDat(latDat), outputSpec(outputSpec), comms(ioComms)
+    {
+      // As for extraction files, never overwrite an existing checkpoint.
+      outputFile = net::MpiFile::Open(comms, outputSpec.filename,
+                                      MPI_MODE_WRONLY | MPI_MODE_CREATE | MPI_MODE_EXCL);
+
+      const uint64_t localSites = latDat.GetLocalFluidSiteCount();
+      fmt::checkpoint::LayoutHash localHash;
+      localHash.Add(localSites);
+      for (site_t i = 0; i < latDat.GetLocalFluidSiteCount(); ++i)
+      {
+        const util::Vector3D<site_t>& pos = latDat.GetSite(i).GetGlobalSiteCoords();
+        localHash.Add(pos.x);
+        localHash.Add(pos.y);
+        localHash.Add(pos.z);
+      }
+
+      siteCounts = comms.AllGather(localSites);
+      layoutHashes = comms.AllGather(localHash.Get());
+
+      firstSite = 0;
+      totalSites = 0;
+      fmt::checkpoint::LayoutHash signatureHash;
+      signatureHash.Add(comms.Size());
+      signatureHash.Add(LatticeType::NUMVECTORS);
+      for (int rank = 0; rank < comms.Size(); ++rank)
+      {
+        if (rank == comms.Rank())
+        {
+          firstSite = totalSites;
+        }
+        totalSites += siteCounts[rank];
+        signatureHash.Add(siteCounts[rank]);
+        signatureHash.Add(layoutHashes[rank]);
+      }
+      signature = signatureHash.Get();
+
+      recordOffset = fmt::checkpoint::GetFirstRecordOffset(comms.Size(), totalSites);
+      recordLength = fmt::checkpoint::GetRecordLength(LatticeType::NUMVECTORS, totalSites);
+
+      WriteHeaders();
+      WriteCoordinates();
+    }
+
+    LocalCheckpointOutput::~LocalCheckpointOutput()
+    {
+    }
+
+    bool LocalCheckpointOutput::ShouldWrite(unsigned long timestepNumber) const
+    {
+      return (timestepNumber % outputSpec.frequency) == 0;
+    }
+
+    uint64_t LocalCheckpointOutput::GetSignature() const
+    {
+      return signature;
+    }
+
+    void LocalCheckpointOutput::WriteHeaders()
+    {
+      if (!comms.OnIORank())
+      {
+        return;
+      }
+
+      io::writers::xdr::XdrVectorWriter headerWriter;
+      headerWriter << uint32_t(fmt::HemeLbMagicNumber) << uint32_t(fmt::checkpoint::MagicNumber)
+          << uint32_t(fmt::checkpoint::VersionNumber);
+      // Placeholder for the byte order marker, which must not be byte swapped.
+      headerWriter << uint32_t(0);
+      headerWriter << uint32_t(LatticeType::NUMVECTORS) << uint32_t(comms.Size());
+      headerWriter << totalSites << signature
+          << fmt::checkpoint::GetCoordinateSectionOffset(comms.Size()) << recordOffset;
+      assert(headerWriter.GetBuf().size() == fmt::checkpoint::PreambleLength);
+
+      for (int rank = 0; rank < comms.Size(); ++rank)
+      {
+        headerWriter << siteCounts[rank] << layoutHashes[rank];
+      }
+
+      std::vector<char> buf = headerWriter.GetBuf();
+      const uint32_t marker = fmt::checkpoint::ByteOrderMarker;
+      std::copy(reinterpret_cast<const char*>(&marker),
+                reinterpret_cast<const char*>(&marker) + sizeof(marker),
+                buf.begin() + 12);
+
+      outputFile.WriteAt(0, buf);
+    }
+
+    void LocalCheckpointOutput::WriteCoordinates()
+    {
+      std::vector<uint32_t> coords;
+      coords.reserve(3 * latDat.GetLocalFluidSiteCount());
+      for (site_t i = 0; i < latDat.GetLocalFluidSiteCount(); ++i)
+      {
+        const util::Vector3D<site_t>& pos = latDat.GetSite(i).GetGlobalSiteCoords();
+        coords.push_back(pos.x);
+        coords.push_back(pos.y);
+        coords.push_back(pos.z);
+      }
+
+      outputFile.WriteAtAll(fmt::checkpoint::GetCoordinateSectionOffset(comms.Size())
+                                + firstSite * fmt::checkpoint::CoordinateRecordLength,
+                            coords);
+    }
+
+    void LocalCheckpointOutput::Write(unsigned long timestepNumber)
+    {
+      if (!ShouldWrite(timestepNumber))
+      {
+        return;
+      }
+
+      // The distributions now held in fOld are the input to the next
+      // iteration, which is where a restart must pick up.
+      if (comms.OnIORank())
+      {
+        outputFile.WriteAt(recordOffset, std::vector<uint64_t>(1, timestepNumber + 1));
+      }
+
+      const site_t localSites = latDat.GetLocalFluidSiteCount();
+      outputFile.WriteAtAll(recordOffset + sizeof(uint64_t)
+                                + firstSite * LatticeType::NUMVECTORS * sizeof(distribn_t),
+                            latDat.GetFOld(0),
+                            localSites * LatticeType::NUMVECTORS);
+
+      recordOffset += recordLength;
+    }
+  }
+}
@@ -0,0 +1,106 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_EXTRACTION_LOCALCHECKPOINTOUTPUT_H
+#define HEMELB_EXTRACTION_LOCALCHECKPOINTOUTPUT_H
+
+#include <string>
+#include <vector>
+
+#include "extraction/CheckpointOutputFile.h"
+#include "lb/lattices/Lattices.h"
+#include "net/mpi.h"
+#include "net/MpiFile.h"
+
+namespace hemelb
+{
+  namespace net
+  {
+    class IOCommunicator;
+  }
+  namespace geometry
+  {
+    class LatticeData;
+  }
+  namespace extraction
+  {
+    /**
+     * Writes this core's part of a binary-exact checkpoint (see
+     * io/formats/checkpoint.h). Unlike LocalPropertyOutput, the distributions are
+     * written as doubles, without conversion, in the local site order.
+     */
+    class LocalCheckpointOutput
+    {
+      public:
+        /**
+         * Opens the file and writes the preamble, rank table and site coordinates.
+         * Collective on ioComms.
+         * @param latDat
+         * @param outputSpec
+         * @param ioComms
+         */
+        LocalCheckpointOutput(const geometry::LatticeData& latDat,
+                              const CheckpointOutputFile& outputSpec,
+                              const net::IOCommunicator& ioComms);
+
+        ~LocalCheckpointOutput();
+
+        /**
+         * True if a checkpoint should be written on the current iteration.
+         * @param timestepNumber
+         * @return
+         */
+        bool ShouldWrite(unsigned long timestepNumber) const;
+
+        /**
+         * Append a record holding the current distributions. This must be called
+         * after the LBM has swapped its distribution arrays, i.e. once the iteration
+         * has completed. Collective on ioComms.
+         * @param timestepNumber the completed iteration
+         */
+        void Write(unsigned long timestepNumber);
+
+        /**
+         * The decomposition signature stored in the file.
+         * @return
+         */
+        uint64_t GetSignature() const;
+
+      private:
+        typedef hemelb::lb::lattices:: HEMELB_LATTICE LatticeType;
+
+        void WriteHeaders();
+        void WriteCoordinates();
+
+        const geometry::LatticeData& latDat;
+        const CheckpointOutputFile& outputSpec;
+        const net::IOCommunicator& comms;
+
+        net::MpiFile outputFile;
+
+        /**
+         * Fluid site counts and layout hashes of every rank.
+         */
+        std::vector<uint64_t> siteCounts;
+        std::vector<uint64_t> layoutHashes;
+
+        /**
+         * Index of this rank's first site in the global (file) site order.
+         */
+        uint64_t firstSite;
+        uint64_t totalSites;
+        uint64_t signature;
+
+        /**
+         * Where the next record starts.
+         */
+        uint64_t recordOffset;
+        uint64_t recordLength;
+    };
+  }
+}
+
+#endif /* HEMELB_EXTRACTION_LOCALCHECKPOINTOUTPUT_H */
@@ -141,11 +141,11 @@ namespace hemelb
 	// distField.numberOfFloats is read on IO rank and checked to
 	// be equal to LatticeType::NUMVECTORS so we use that instead
 	// of broadcasting and storing.
+	float field_vals[LatticeType::NUMVECTORS];
+	dataReader.readArray(field_vals, LatticeType::NUMVECTORS);
 	for (int i = 0; i < LatticeType::NUMVECTORS; i++) {
-	  float field_val;
-	  dataReader.read(field_val);
-	  field_val += distField.offset;
-	  f_new_p[i] = f_old_p[i] = field_val;
+	  field_vals[i] += distField.offset;
+	  f_new_p[i] = f_old_p[i] = field_vals[i];
 	}
       }
 
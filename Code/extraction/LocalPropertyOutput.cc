@@ -4,8 +4,10 @@
 // file AUTHORS. This software is provided under the terms of the
 // license in the file LICENSE.
 
+#include <algorithm>
 #include <cassert>
 #include "extraction/LocalPropertyOutput.h"
+#include "extraction/CompressedChunk.h"
 #include "io/formats/formats.h"
 #include "io/formats/extraction.h"
 #include "io/formats/offset.h"
@@ -45,8 +47,10 @@ namespace hemelb
     LocalPropertyOutput::LocalPropertyOutput(IterableDataSource& dataSource,
                                              const PropertyOutputFile* outputSpec,
                                              const net::IOCommunicator& ioComms) :
-      comms(ioComms), dataSource(dataSource), outputSpec(outputSpec)
+      comms(ioComms), dataSource(dataSource), outputSpec(outputSpec), localSiteOffset(0),
+          totalSiteCount(0), recordsWritten(0), currentBuffer(0)
     {
+
       // Open the file as write-only, create it if it doesn't exist, don't create if the file
       // already exists.
       outputFile = net::MpiFile::Open(comms, outputSpec->filename,
@@ -60,22 +64,26 @@ namespace hemelb
       offsetFile = net::MpiFile::Open(comms, offsetFileName,
 				      MPI_MODE_WRONLY | MPI_MODE_CREATE | MPI_MODE_EXCL);
 
-      // Count sites on this task
-      uint64_t siteCount = 0;
+      // Find the sites on this task to be written. The selection never changes so do it
+      // once here, rather than on every write.
       dataSource.Reset();
-      while (dataSource.ReadNext())
+      for (site_t siteIndex = 0; dataSource.ReadNext(); ++siteIndex)
       {
-        if (outputSpec->geometry->Include(dataSource, dataSource.GetPosition()))
+        const util::Vector3D<site_t> position = dataSource.GetPosition();
+        if (outputSpec->geometry->Include(dataSource, position))
         {
-          ++siteCount;
+          selectedSites.push_back(siteIndex);
+          selectedPositions.push_back(util::Vector3D<uint32_t>(position.x, position.y, position.z));
         }
       }
+      const uint64_t siteCount = selectedSites.size();
 
       // Calculate how long local writes need to be.
 
       // First get the length per-site
-      // Always have 3 uint32's for the position of a site
-      writeLength = 3 * 4;
+      // Row files have 3 uint32's for the position of a site; columnar and compressed files
+      // store positions once, in the header.
+      writeLength = outputSpec->format == PropertyOutputFile::Rows ? 3 * 4 : 0;
 
       // Then get add each field's length
       for (unsigned outputNumber = 0; outputNumber < outputSpec->fields.size(); ++outputNumber)
@@ -103,32 +111,30 @@ namespace hemelb
       uint64_t allSiteCount = comms.Reduce(siteCount, MPI_SUM,
                                            comms.GetIORank());
 
-      unsigned totalHeaderLength = 0;
+      // Compute the length of the field header
+      unsigned fieldHeaderLength = 0;
+      for (unsigned outputNumber = 0; outputNumber < outputSpec->fields.size(); ++outputNumber)
+      {
+        // Name
+        fieldHeaderLength
+            += io::formats::extraction::GetStoredLengthOfString(outputSpec->fields[outputNumber].name);
+        // Uint32 for number of fields
+        fieldHeaderLength += 4;
+        // Double for the offset in each field
+        fieldHeaderLength += 8;
+      }
+
+      unsigned totalHeaderLength = io::formats::extraction::MainHeaderLength + fieldHeaderLength;
 
       // Write the header information on the IO proc.
       if (comms.OnIORank())
       {
-        // Compute the length of the field header
-        unsigned fieldHeaderLength = 0;
-        for (unsigned outputNumber = 0; outputNumber < outputSpec->fields.size(); ++outputNumber)
-        {
-          // Name
-          fieldHeaderLength
-              += io::formats::extraction::GetStoredLengthOfString(outputSpec->fields[outputNumber].name);
-          // Uint32 for number of fields
-          fieldHeaderLength += 4;
-          // Double for the offset in each field
-          fieldHeaderLength += 8;
-        }
-
-        totalHeaderLength = io::formats::extraction::MainHeaderLength + fieldHeaderLength;
-
 	io::writers::xdr::XdrVectorWriter headerWriter;
 
 	// Encoder for ONLY the main header (note shorter length)
 	headerWriter << uint32_t(io::formats::HemeLbMagicNumber)
 		     << uint32_t(io::formats::extraction::MagicNumber)
-		     << uint32_t(io::formats::extraction::VersionNumber);
+		     << GetVersionNumber(outputSpec->format);
 	headerWriter << double(dataSource.GetVoxelSize());
 	const util::Vector3D<distribn_t> &origin = dataSource.GetOrigin();
 	headerWriter << double(origin[0]) << double(origin[1]) << double(origin[2]);
@@ -149,8 +155,39 @@ namespace hemelb
         outputFile.WriteAt(0, headerWriter.GetBuf());
       }
 
+      if (outputSpec->format != PropertyOutputFile::Rows)
+      {
+        // Every core writes into every record, so they all start from the same place, after
+        // the coordinates.
+        const std::vector<uint64_t> siteCounts = comms.AllGather(siteCount);
+        for (int rank = 0; rank < comms.Size(); ++rank)
+        {
+          if (rank == comms.Rank())
+          {
+            localSiteOffset = totalSiteCount;
+          }
+          totalSiteCount += siteCounts[rank];
+        }
+
+        // Write this core's coordinates, once.
+        if (siteCount > 0)
+        {
+          std::vector<char> coordinates(3 * sizeof(uint32_t) * siteCount);
+          char* out = coordinates.data();
+          for (size_t selected = 0; selected < selectedPositions.size(); ++selected)
+          {
+            out = io::formats::extraction::PutLittleEndian(selectedPositions[selected].x, out);
+            out = io::formats::extraction::PutLittleEndian(selectedPositions[selected].y, out);
+            out = io::formats::extraction::PutLittleEndian(selectedPositions[selected].z, out);
+          }
+          outputFile.WriteAt(totalHeaderLength + 3 * sizeof(uint32_t) * localSiteOffset,
+                             coordinates);
+        }
+
+        localDataOffsetIntoFile = totalHeaderLength + 3 * sizeof(uint32_t) * totalSiteCount;
+      }
       // Calculate where each core should start writing
-      if (comms.OnIORank())
+      else if (comms.OnIORank())
       {
         // For core 0 this is easy: it passes the value for core 1 to the core.
         localDataOffsetIntoFile = totalHeaderLength;
@@ -172,15 +209,21 @@ namespace hemelb
         }
       }
 
-      // Create the buffer that we'll write each iteration's data into.
-      buffer.resize(writeLength);
+      // Create the buffers that we'll write each iteration's data into. Compressed writes
+      // size theirs as they go.
+      if (outputSpec->format != PropertyOutputFile::Compressed)
+      {
+        buffers[0].resize(writeLength);
+        buffers[1].resize(writeLength);
+      }
 
       WriteOffsetFile();
     }
 
     LocalPropertyOutput::~LocalPropertyOutput()
     {
-
+      // The buffers and file must outlive any write still in progress.
+      Flush();
     }
 
     bool LocalPropertyOutput::ShouldWrite(unsigned long timestepNumber) const
@@ -193,6 +236,29 @@ namespace hemelb
       return outputSpec;
     }
 
+    void LocalPropertyOutput::WaitForBuffer(unsigned long timestepNumber)
+    {
+      if (ShouldWrite(timestepNumber))
+      {
+        WaitForWrites(pendingWrites[currentBuffer]);
+      }
+    }
+
+    void LocalPropertyOutput::Flush()
+    {
+      WaitForWrites(pendingWrites[0]);
+      WaitForWrites(pendingWrites[1]);
+    }
+
+    void LocalPropertyOutput::WaitForWrites(std::vector<MPI_Request>& requests)
+    {
+      if (!requests.empty())
+      {
+        HEMELB_MPI_CALL(MPI_Waitall, (requests.size(), requests.data(), MPI_STATUSES_IGNORE));
+        requests.clear();
+      }
+    }
+
     void LocalPropertyOutput::Write(unsigned long timestepNumber)
     {
       // Don't write if we shouldn't this iteration.
@@ -201,14 +267,37 @@ namespace hemelb
         return;
       }
 
-      // Don't write if this core doesn't do anything.
-      if (writeLength <= 0)
+      // Don't write if this core doesn't do anything. Compressed records are of varying
+      // length, so every core has to help work out where they go.
+      if (writeLength <= 0 && outputSpec->format != PropertyOutputFile::Compressed)
       {
         return;
       }
 
+      // Make sure the buffer's previous write has finished before we overwrite it.
+      WaitForBuffer(timestepNumber);
+      std::vector<char>& buffer = buffers[currentBuffer];
+
+      // Each of these sets the offset to the right place for writing on the next iteration.
+      switch (outputSpec->format)
+      {
+        case PropertyOutputFile::Rows:
+          WriteRows(timestepNumber, buffer);
+          break;
+        case PropertyOutputFile::Columnar:
+          WriteColumns(timestepNumber, buffer);
+          break;
+        case PropertyOutputFile::Compressed:
+          WriteCompressed(timestepNumber, buffer);
+          break;
+      }
+      currentBuffer = 1 - currentBuffer;
+    }
+
+    void LocalPropertyOutput::WriteRows(unsigned long timestepNumber, std::vector<char>& buffer)
+    {
       // Create the buffer.
-      auto xdrWriter = io::MakeXdrWriter(buffer.begin(), buffer.end());
+      auto xdrWriter = io::MakeXdrWriter(buffer.data(), buffer.data() + buffer.size());
 
       // Firstly, the IO proc must write the iteration number.
       if (comms.OnIORank())
@@ -216,94 +305,243 @@ namespace hemelb
         xdrWriter << (uint64_t) timestepNumber;
       }
 
-      dataSource.Reset();
+      std::vector<WrittenDataType> values(GetMaxFieldLength());
+      for (size_t selected = 0; selected < selectedSites.size(); ++selected)
+      {
+        dataSource.SeekTo(selectedSites[selected]);
+        // Write the position
+        const util::Vector3D<uint32_t>& position = selectedPositions[selected];
+        xdrWriter << position.x << position.y << position.z;
+
+        // Write for each field.
+        for (unsigned outputNumber = 0; outputNumber < outputSpec->fields.size(); ++outputNumber)
+        {
+          const unsigned length = GetFieldValues(outputSpec->fields[outputNumber].type, values.data());
+          xdrWriter.writeArray(values.data(), length);
+        }
+      }
+
+      // Start the MPI writing; it is waited for when this buffer is next used.
+      pendingWrites[currentBuffer].push_back(outputFile.IWriteAt(localDataOffsetIntoFile, buffer));
+
+      localDataOffsetIntoFile += allCoresWriteLength;
+    }
 
-      while (dataSource.ReadNext())
+    void LocalPropertyOutput::FillColumns()
+    {
+      const size_t localSiteCount = selectedSites.size();
+      std::vector<WrittenDataType*> columns(outputSpec->fields.size());
       {
-        const util::Vector3D<site_t>& position = dataSource.GetPosition();
-        if (outputSpec->geometry->Include(dataSource, position))
+        size_t columnStart = 0;
+        for (unsigned outputNumber = 0; outputNumber < outputSpec->fields.size(); ++outputNumber)
         {
-          // Write the position
-          xdrWriter << (uint32_t) position.x << (uint32_t) position.y << (uint32_t) position.z;
+          columnStart += GetFieldLength(outputSpec->fields[outputNumber].type) * localSiteCount;
+        }
+        columnValues.resize(columnStart);
 
-          // Write for each field.
-          for (unsigned outputNumber = 0; outputNumber < outputSpec->fields.size(); ++outputNumber)
-          {
-            switch (outputSpec->fields[outputNumber].type)
-            {
-              case OutputField::Pressure:
-                xdrWriter << static_cast<WrittenDataType> (dataSource.GetPressure()
-                    - REFERENCE_PRESSURE_mmHg);
-                break;
-              case OutputField::Velocity:
-                xdrWriter << static_cast<WrittenDataType> (dataSource.GetVelocity().x)
-                    << static_cast<WrittenDataType> (dataSource.GetVelocity().y)
-                    << static_cast<WrittenDataType> (dataSource.GetVelocity().z);
-                break;
-                //! @TODO: Work out how to handle the different stresses.
-              case OutputField::VonMisesStress:
-                xdrWriter << static_cast<WrittenDataType> (dataSource.GetVonMisesStress());
-                break;
-              case OutputField::ShearStress:
-                xdrWriter << static_cast<WrittenDataType> (dataSource.GetShearStress());
-                break;
-              case OutputField::ShearRate:
-                xdrWriter << static_cast<WrittenDataType> (dataSource.GetShearRate());
-                break;
-              case OutputField::StressTensor:
-              {
-                util::Matrix3D tensor = dataSource.GetStressTensor();
-                // Only the upper triangular part of the symmetric tensor is stored. Storage is row-wise.
-                xdrWriter << static_cast<WrittenDataType> (tensor[0][0])
-                    << static_cast<WrittenDataType> (tensor[0][1])
-                    << static_cast<WrittenDataType> (tensor[0][2])
-                    << static_cast<WrittenDataType> (tensor[1][1])
-                    << static_cast<WrittenDataType> (tensor[1][2])
-                    << static_cast<WrittenDataType> (tensor[2][2]);
-                break;
-              }
-              case OutputField::Traction:
-                xdrWriter << static_cast<WrittenDataType> (dataSource.GetTraction().x)
-                    << static_cast<WrittenDataType> (dataSource.GetTraction().y)
-                    << static_cast<WrittenDataType> (dataSource.GetTraction().z);
-                break;
-              case OutputField::TangentialProjectionTraction:
-                xdrWriter
-                    << static_cast<WrittenDataType> (dataSource.GetTangentialProjectionTraction().x)
-                    << static_cast<WrittenDataType> (dataSource.GetTangentialProjectionTraction().y)
-                    << static_cast<WrittenDataType> (dataSource.GetTangentialProjectionTraction().z);
-                break;
-              case OutputField::Distributions:
-                unsigned numComponents;
-                const distribn_t *d_ptr;
-                numComponents = dataSource.GetNumVectors();
-                d_ptr = dataSource.GetDistribution();
-                for (int i = 0; i < numComponents; i++)
-		{
-                  xdrWriter << static_cast<WrittenDataType> (*d_ptr);
-		  d_ptr++;
-		}
-                break;
-              case OutputField::MpiRank:
-                xdrWriter
-		  << static_cast<WrittenDataType> (comms.Rank());
-                break;
-              default:
-                // This should never trip. It only occurs when a new OutputField field is added and no
-                // implementation is provided for its serialisation.
-                assert(false);
-            }
-          }
+        columnStart = 0;
+        for (unsigned outputNumber = 0; outputNumber < outputSpec->fields.size(); ++outputNumber)
+        {
+          columns[outputNumber] = columnValues.data() + columnStart;
+          columnStart += GetFieldLength(outputSpec->fields[outputNumber].type) * localSiteCount;
         }
       }
 
-      // Actually do the MPI writing.
-      outputFile.WriteAt(localDataOffsetIntoFile, buffer);
+      for (size_t selected = 0; selected < localSiteCount; ++selected)
+      {
+        dataSource.SeekTo(selectedSites[selected]);
+        for (unsigned outputNumber = 0; outputNumber < outputSpec->fields.size(); ++outputNumber)
+        {
+          columns[outputNumber] += GetFieldValues(outputSpec->fields[outputNumber].type,
+                                                  columns[outputNumber]);
+        }
+      }
+    }
+
+    void LocalPropertyOutput::WriteColumns(unsigned long timestepNumber, std::vector<char>& buffer)
+    {
+      namespace fmt = io::formats::extraction;
+      const size_t localSiteCount = selectedSites.size();
+
+      // The IO proc writes the iteration number at the start of the buffer, followed by
+      // this core's part of each field's column.
+      char* const columnsStart = buffer.data() + (comms.OnIORank() ?
+        sizeof(uint64_t) :
+        0);
+      if (comms.OnIORank())
+      {
+        fmt::PutLittleEndian(uint64_t(timestepNumber), buffer.data());
+      }
+
+      FillColumns();
+      char* out = columnsStart;
+      for (size_t i = 0; i < columnValues.size(); ++i)
+      {
+        out = fmt::PutLittleEndian(columnValues[i], out);
+      }
+
+      // Start the MPI writing, one piece per column; they are waited for when this buffer is
+      // next used.
+      std::vector<MPI_Request>& requests = pendingWrites[currentBuffer];
+      if (comms.OnIORank())
+      {
+        requests.push_back(outputFile.IWriteAt(localDataOffsetIntoFile, buffer.data(), sizeof(uint64_t)));
+      }
+      uint64_t columnOffset = localDataOffsetIntoFile + sizeof(uint64_t);
+      const char* column = columnsStart;
+      for (unsigned outputNumber = 0; outputNumber < outputSpec->fields.size(); ++outputNumber)
+      {
+        const uint64_t bytesPerSite = sizeof(WrittenDataType)
+            * GetFieldLength(outputSpec->fields[outputNumber].type);
+        if (localSiteCount > 0)
+        {
+          requests.push_back(outputFile.IWriteAt(columnOffset + bytesPerSite * localSiteOffset,
+                                                 column,
+                                                 bytesPerSite * localSiteCount));
+        }
+        column += bytesPerSite * localSiteCount;
+        columnOffset += bytesPerSite * totalSiteCount;
+      }
 
-      // Set the offset to the right place for writing on the next iteration.
       localDataOffsetIntoFile += allCoresWriteLength;
     }
 
+    void LocalPropertyOutput::WriteCompressed(unsigned long timestepNumber,
+                                              std::vector<char>& buffer)
+    {
+      namespace fmt = io::formats;
+
+      // The IO proc writes the iteration number, then every core with sites compresses its
+      // part of the columns.
+      buffer.clear();
+      if (comms.OnIORank())
+      {
+        buffer.resize(sizeof(uint64_t));
+        fmt::extraction::PutLittleEndian(uint64_t(timestepNumber), buffer.data());
+      }
+      const size_t chunkStart = buffer.size();
+      if (!selectedSites.empty())
+      {
+        FillColumns();
+        CompressChunk(columnValues, outputSpec->tolerance, buffer);
+      }
+      const uint64_t chunkLength = buffer.size() - chunkStart;
+
+      // The chunks follow the iteration number in rank order.
+      const uint64_t chunkOffset = localDataOffsetIntoFile + sizeof(uint64_t)
+          + comms.ExScan(chunkLength, MPI_SUM);
+      const uint64_t recordEnd = localDataOffsetIntoFile + sizeof(uint64_t)
+          + comms.AllReduce(chunkLength, MPI_SUM);
+
+      std::vector<MPI_Request>& requests = pendingWrites[currentBuffer];
+      if (comms.OnIORank())
+      {
+        requests.push_back(outputFile.IWriteAt(localDataOffsetIntoFile, buffer.data(), sizeof(uint64_t)));
+      }
+      if (chunkLength > 0)
+      {
+        requests.push_back(outputFile.IWriteAt(chunkOffset, buffer.data() + chunkStart, chunkLength));
+      }
+
+      // Record where the chunk went in this record's row of the offset file.
+      const uint64_t rowLength = (comms.Size() + 1) * fmt::offset::RecordLength;
+      const uint64_t rowOffset = fmt::offset::HeaderLength + rowLength * (1 + recordsWritten)
+          + comms.Rank() * fmt::offset::RecordLength;
+      std::vector<char>& entries = offsetEntries[currentBuffer];
+      entries = comms.Rank() == comms.Size() - 1 ?
+        quick_encode(chunkOffset, recordEnd) :
+        quick_encode(chunkOffset);
+      requests.push_back(offsetFile.IWriteAt(rowOffset, entries));
+
+      ++recordsWritten;
+      localDataOffsetIntoFile = recordEnd;
+    }
+
+    unsigned LocalPropertyOutput::GetMaxFieldLength() const
+    {
+      unsigned maxLength = dataSource.GetNumVectors();
+      for (unsigned outputNumber = 0; outputNumber < outputSpec->fields.size(); ++outputNumber)
+      {
+        maxLength = std::max(maxLength, GetFieldLength(outputSpec->fields[outputNumber].type));
+      }
+      return maxLength;
+    }
+
+    unsigned LocalPropertyOutput::GetFieldValues(OutputField::FieldType field,
+                                                 WrittenDataType* values) const
+    {
+      switch (field)
+      {
+        case OutputField::Pressure:
+          values[0] = static_cast<WrittenDataType> (dataSource.GetPressure() - REFERENCE_PRESSURE_mmHg);
+          return 1;
+        case OutputField::Velocity:
+        {
+          const util::Vector3D<FloatingType> velocity = dataSource.GetVelocity();
+          values[0] = static_cast<WrittenDataType> (velocity.x);
+          values[1] = static_cast<WrittenDataType> (velocity.y);
+          values[2] = static_cast<WrittenDataType> (velocity.z);
+          return 3;
+        }
+          //! @TODO: Work out how to handle the different stresses.
+        case OutputField::VonMisesStress:
+          values[0] = static_cast<WrittenDataType> (dataSource.GetVonMisesStress());
+          return 1;
+        case OutputField::ShearStress:
+          values[0] = static_cast<WrittenDataType> (dataSource.GetShearStress());
+          return 1;
+        case OutputField::ShearRate:
+          values[0] = static_cast<WrittenDataType> (dataSource.GetShearRate());
+          return 1;
+        case OutputField::StressTensor:
+        {
+          util::Matrix3D tensor = dataSource.GetStressTensor();
+          // Only the upper triangular part of the symmetric tensor is stored. Storage is row-wise.
+          values[0] = static_cast<WrittenDataType> (tensor[0][0]);
+          values[1] = static_cast<WrittenDataType> (tensor[0][1]);
+          values[2] = static_cast<WrittenDataType> (tensor[0][2]);
+          values[3] = static_cast<WrittenDataType> (tensor[1][1]);
+          values[4] = static_cast<WrittenDataType> (tensor[1][2]);
+          values[5] = static_cast<WrittenDataType> (tensor[2][2]);
+          return 6;
+        }
+        case OutputField::Traction:
+        {
+          const util::Vector3D<PhysicalStress> traction = dataSource.GetTraction();
+          values[0] = static_cast<WrittenDataType> (traction.x);
+          values[1] = static_cast<WrittenDataType> (traction.y);
+          values[2] = static_cast<WrittenDataType> (traction.z);
+          return 3;
+        }
+        case OutputField::TangentialProjectionTraction:
+        {
+          const util::Vector3D<PhysicalStress> traction = dataSource.GetTangentialProjectionTraction();
+          values[0] = static_cast<WrittenDataType> (traction.x);
+          values[1] = static_cast<WrittenDataType> (traction.y);
+          values[2] = static_cast<WrittenDataType> (traction.z);
+          return 3;
+        }
+        case OutputField::Distributions:
+        {
+          const unsigned numComponents = dataSource.GetNumVectors();
+          const distribn_t* d_ptr = dataSource.GetDistribution();
+          for (unsigned i = 0; i < numComponents; i++)
+          {
+            values[i] = static_cast<WrittenDataType> (d_ptr[i]);
+          }
+          return numComponents;
+        }
+        case OutputField::MpiRank:
+          values[0] = static_cast<WrittenDataType> (comms.Rank());
+          return 1;
+        default:
+          // This should never trip. It only occurs when a new OutputField field is added and no
+          // implementation is provided for its serialisation.
+          assert(false);
+          return 0;
+      }
+    }
+
     // Write the offset file.
     void LocalPropertyOutput::WriteOffsetFile() {
       namespace fmt = io::formats;
@@ -313,6 +551,8 @@ namespace hemelb
 	auto buf = quick_encode(
 				uint32_t(fmt::HemeLbMagicNumber),
 				uint32_t(fmt::offset::MagicNumber),
+				outputSpec->format == PropertyOutputFile::Compressed ?
+				uint32_t(fmt::offset::CompressedVersionNumber) :
 				uint32_t(fmt::offset::VersionNumber),
 				uint32_t(comms.Size())
 				);
@@ -322,12 +562,31 @@ namespace hemelb
       // Every rank writes its offset
       uint64_t offsetForOffset = comms.Rank() * sizeof(localDataOffsetIntoFile)
 	+ fmt::offset::HeaderLength;
-      offsetFile.WriteAt(offsetForOffset, quick_encode(localDataOffsetIntoFile));
+      // Columnar and compressed files record where each rank's sites start instead
+      const bool bySite = outputSpec->format != PropertyOutputFile::Rows;
+      const uint64_t localBegin = bySite ? localSiteOffset : localDataOffsetIntoFile;
+      const uint64_t localEnd = bySite ?
+	localSiteOffset + selectedSites.size() :
+	localDataOffsetIntoFile + writeLength;
+      offsetFile.WriteAt(offsetForOffset, quick_encode(localBegin));
 
       // Last process writes total
       if (comms.Rank() == (comms.Size()-1)) {
-	offsetFile.WriteAt(offsetForOffset + sizeof(localDataOffsetIntoFile),
-			   quick_encode(localDataOffsetIntoFile + writeLength));
+	offsetFile.WriteAt(offsetForOffset + sizeof(localBegin),
+			   quick_encode(localEnd));
+      }
+    }
+
+    uint32_t LocalPropertyOutput::GetVersionNumber(PropertyOutputFile::Format format)
+    {
+      switch (format)
+      {
+        case PropertyOutputFile::Columnar:
+          return io::formats::extraction::ColumnarVersionNumber;
+        case PropertyOutputFile::Compressed:
+          return io::formats::extraction::CompressedVersionNumber;
+        default:
+          return io::formats::extraction::VersionNumber;
       }
     }
 
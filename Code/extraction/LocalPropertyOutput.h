@@ -55,10 +55,26 @@ namespace hemelb
 
         /**
          * Write this core's section of the data file. Only writes if appropriate for the current
-         * iteration number
+         * iteration number.
+         *
+         * The data are serialised into one of two buffers and the write is only started; it
+         * completes in the background while the simulation carries on. A buffer is reused
+         * only once its previous write has finished.
          */
         void Write(unsigned long timestepNumber);
 
+        /**
+         * Block until the buffer the next Write will fill is free, if this output is due to be
+         * written on the current iteration. Calling this first lets the I/O wait be timed
+         * separately from serialisation.
+         */
+        void WaitForBuffer(unsigned long timestepNumber);
+
+        /**
+         * Block until all outstanding writes have completed.
+         */
+        void Flush();
+
 	/**
 	 * Write the offset file
 	 */
@@ -70,6 +86,12 @@ namespace hemelb
          */
         static unsigned GetFieldLength(OutputField::FieldType field);
 
+        /**
+         * Returns the extraction format version number for a variant of the format.
+         * @param format
+         */
+        static uint32_t GetVersionNumber(PropertyOutputFile::Format format);
+
         /**
          * Returns the offset to the field, as it should be written to file.
          * @param field
@@ -101,6 +123,30 @@ namespace hemelb
          */
         uint64_t localDataOffsetIntoFile;
 
+        /**
+         * Indices (in data source order) of the local sites the geometry selector includes,
+         * resolved once at construction since the geometry does not change.
+         */
+        std::vector<site_t> selectedSites;
+
+        /**
+         * Grid coordinates of each selected site, as written to file.
+         */
+        std::vector<util::Vector3D<uint32_t> > selectedPositions;
+
+        /**
+         * For columnar files, the index in the file's site order of this core's first site, and
+         * the number of sites written by all cores.
+         */
+        uint64_t localSiteOffset;
+        uint64_t totalSiteCount;
+
+        /**
+         * For compressed files, the number of records written so far, to find this core's
+         * entry in the offset file.
+         */
+        uint64_t recordsWritten;
+
         /**
          * The length, in bytes, of the local write.
          */
@@ -112,9 +158,26 @@ namespace hemelb
         uint64_t allCoresWriteLength;
 
         /**
-         * Buffer to write into before writing to disk.
+         * Buffers to write into before writing to disk, used alternately so one can be filled
+         * while the other is being written.
          */
-        std::vector<char> buffer;
+        std::vector<char> buffers[2];
+
+        /**
+         * The outstanding writes from each buffer. Row files post one per write; columnar files
+         * post one per field.
+         */
+        std::vector<MPI_Request> pendingWrites[2];
+
+        /**
+         * For compressed files, each buffer's entries for the offset file.
+         */
+        std::vector<char> offsetEntries[2];
+
+        /**
+         * The buffer the next Write will use.
+         */
+        unsigned currentBuffer;
 
         /**
          * The MPI file to write the offsets into.
@@ -125,6 +188,54 @@ namespace hemelb
          * Type of written values
          */
         typedef float WrittenDataType;
+
+        /**
+         * Scratch space for FillColumns.
+         */
+        std::vector<WrittenDataType> columnValues;
+
+        /**
+         * Serialise the selected sites as rows of position and field values and start writing
+         * them.
+         */
+        void WriteRows(unsigned long timestepNumber, std::vector<char>& buffer);
+
+        /**
+         * Serialise the selected sites as one little-endian column per field and start writing
+         * each column into its place in the record.
+         */
+        void WriteColumns(unsigned long timestepNumber, std::vector<char>& buffer);
+
+        /**
+         * Compress this core's part of the columns into a single chunk and start writing it
+         * after those of the lower ranks, recording its position in the offset file.
+         * Collective.
+         */
+        void WriteCompressed(unsigned long timestepNumber, std::vector<char>& buffer);
+
+        /**
+         * Fill columnValues with the values of each field at the selected sites, one column per
+         * field.
+         */
+        void FillColumns();
+
+        /**
+         * Wait for, then forget, a buffer's outstanding writes.
+         */
+        static void WaitForWrites(std::vector<MPI_Request>& requests);
+
+        /**
+         * The largest number of values any output field has at a site.
+         */
+        unsigned GetMaxFieldLength() const;
+
+        /**
+         * Get the values of a field at the data source's current site.
+         * @param field
+         * @param values must have room for GetMaxFieldLength() values
+         * @return the number of values
+         */
+        unsigned GetFieldValues(OutputField::FieldType field, WrittenDataType* values) const;
     };
   }
 }
@@ -87,6 +87,10 @@ namespace hemelb
 
     void PropertyActor::EndIteration()
     {
+      timers[reporting::Timers::extractionWaiting].Start();
+      propertyWriter->WaitForBuffers(simulationState.GetTimeStep());
+      timers[reporting::Timers::extractionWaiting].Stop();
+
       timers[reporting::Timers::extractionWriting].Start();
       propertyWriter->Write(simulationState.GetTimeStep());
       timers[reporting::Timers::extractionWriting].Stop();
@@ -24,6 +24,20 @@ namespace hemelb
         unsigned long frequency;
         std::unique_ptr<GeometrySelector> geometry;
         std::vector<OutputField> fields;
+        /**
+         * The variant of the format to write (see io/formats/extraction.h).
+         */
+        enum Format
+        {
+          Rows,
+          Columnar,
+          Compressed
+        };
+        Format format = Rows;
+        /**
+         * For compressed files, the largest error allowed in a stored value; zero for lossless.
+         */
+        double tolerance = 0.0;
     };
   }
 }
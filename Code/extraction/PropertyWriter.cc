@@ -40,5 +40,13 @@ namespace hemelb
         localPropertyOutputs[outputNumber]->Write((uint64_t) iterationNumber);
       }
     }
+
+    void PropertyWriter::WaitForBuffers(unsigned long iterationNumber) const
+    {
+      for (unsigned outputNumber = 0; outputNumber < localPropertyOutputs.size(); ++outputNumber)
+      {
+        localPropertyOutputs[outputNumber]->WaitForBuffer((uint64_t) iterationNumber);
+      }
+    }
   }
 }
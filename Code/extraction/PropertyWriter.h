@@ -39,6 +39,12 @@ namespace hemelb
          */
         void Write(unsigned long iterationNumber) const;
 
+        /**
+         * Waits until every output due on this iteration has a free buffer to write into.
+         * @param iterationNumber
+         */
+        void WaitForBuffers(unsigned long iterationNumber) const;
+
         /**
          * Returns a vector of all the LocalPropertyOutputs.
          * @return
@@ -7,8 +7,14 @@
 #include <map>
 #include <limits>
 
+#include "Exception.h"
+#include "io/formats/decomposition.h"
+#include "io/formats/formats.h"
+#include "io/writers/xdr/XdrMemReader.h"
+#include "io/writers/xdr/XdrVectorWriter.h"
 #include "log/Logger.h"
 #include "net/IOCommunicator.h"
+#include "net/MpiFile.h"
 #include "geometry/BlockTraverser.h"
 #include "geometry/LatticeData.h"
 #include "geometry/neighbouring/NeighbouringLatticeData.h"
@@ -18,6 +24,8 @@ namespace hemelb
 {
   namespace geometry
   {
+    namespace dcmp = io::formats::decomposition;
+
     LatticeData::LatticeData(const lb::lattices::LatticeInfo& latticeInfo, const net::IOCommunicator& comms_) :
         latticeInfo(latticeInfo), neighbouringData(new neighbouring::NeighbouringLatticeData(latticeInfo)), comms(comms_)
     {
@@ -54,6 +62,15 @@ namespace hemelb
       InitialiseNeighbourLookups();
     }
 
+    LatticeData::LatticeData(const lb::lattices::LatticeInfo& latticeInfo, const std::string& decompositionFilePath, const net::IOCommunicator& comms_) :
+        latticeInfo(latticeInfo), neighbouringData(new neighbouring::NeighbouringLatticeData(latticeInfo)), comms(comms_)
+    {
+      LoadDecomposition(decompositionFilePath);
+
+      CollectFluidSiteDistribution();
+      CollectGlobalSiteExtrema();
+    }
+
     void LatticeData::SetBasicDetails(util::Vector3D<site_t> blocksIn,
                                       site_t blockSizeIn)
     {
@@ -271,6 +288,164 @@ namespace hemelb
                            domainEdgeWallDistance);
     }
 
+    void LatticeData::LoadDecomposition(const std::string& decompositionFilePath)
+    {
+      const unsigned vectorCount = latticeInfo.GetNumVectors();
+      net::MpiFile file = net::MpiFile::Open(comms, decompositionFilePath, MPI_MODE_RDONLY);
+
+      // The preamble, the lattice and the rank table are read on one rank and broadcast.
+      std::vector<char> preambleBuffer(dcmp::PreambleLength);
+      if (comms.OnIORank())
+      {
+        file.ReadAt(0, preambleBuffer);
+      }
+      comms.Broadcast(preambleBuffer, comms.GetIORank());
+
+      io::writers::xdr::XdrMemReader preambleReader(preambleBuffer);
+      uint32_t hlbMagicNumber, magicNumber, version, rankCount, fileVectorCount, fileBlockSize;
+      uint32_t fileBlockCounts[3];
+      preambleReader.read(hlbMagicNumber);
+      preambleReader.read(magicNumber);
+      preambleReader.read(version);
+      preambleReader.read(rankCount);
+      preambleReader.read(fileVectorCount);
+      preambleReader.read(fileBlockSize);
+      preambleReader.readArray(fileBlockCounts, 3);
+
+      if (hlbMagicNumber != io::formats::HemeLbMagicNumber || magicNumber != dcmp::MagicNumber)
+      {
+        throw Exception() << "The file " << decompositionFilePath << " is not a decomposition file";
+      }
+      if (version != dcmp::VersionNumber)
+      {
+        throw Exception() << "Version number of " << decompositionFilePath << " incorrect."
+            << " Supported: " << unsigned(dcmp::VersionNumber) << " Input: " << version;
+      }
+      if (rankCount != uint32_t(comms.Size()))
+      {
+        throw Exception() << "The decomposition in " << decompositionFilePath << " is over " << rankCount
+            << " ranks, but this run has " << comms.Size();
+      }
+
+      std::vector<char> tableBuffer(dcmp::GetRankSectionsOffset(fileVectorCount, rankCount) - dcmp::PreambleLength);
+      if (comms.OnIORank())
+      {
+        file.ReadAt(dcmp::PreambleLength, tableBuffer);
+      }
+      comms.Broadcast(tableBuffer, comms.GetIORank());
+
+      io::writers::xdr::XdrMemReader tableReader(tableBuffer);
+      bool sameLattice = fileVectorCount == vectorCount;
+      for (unsigned direction = 0; direction < fileVectorCount; ++direction)
+      {
+        int32_t vector[3];
+        tableReader.readArray(vector, 3);
+        sameLattice = sameLattice && direction < vectorCount
+            && util::Vector3D<int>(vector[0], vector[1], vector[2]) == latticeInfo.GetVector(direction);
+      }
+      if (!sameLattice)
+      {
+        throw Exception() << "The decomposition in " << decompositionFilePath << " was saved with a lattice of "
+            << fileVectorCount << " vectors, not the " << vectorCount << " of this run's";
+      }
+
+      uint64_t sectionOffset = 0, sectionLength = 0;
+      for (proc_t rank = 0; rank <= comms.Rank(); ++rank)
+      {
+        tableReader.read(sectionOffset);
+        tableReader.read(sectionLength);
+      }
+
+      // This rank's section, whole.
+      std::vector<char> section(sectionLength);
+      file.ReadAtAll(sectionOffset, section);
+      file.Close();
+
+      SetBasicDetails(util::Vector3D<site_t>(fileBlockCounts[0], fileBlockCounts[1], fileBlockCounts[2]),
+                      fileBlockSize);
+
+      io::writers::xdr::XdrMemReader reader(section);
+      localFluidSites = 0;
+      for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; collisionType++)
+      {
+        midDomainProcCollisions[collisionType] = reader.read<uint64_t>();
+        localFluidSites += midDomainProcCollisions[collisionType];
+      }
+      for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; collisionType++)
+      {
+        domainEdgeProcCollisions[collisionType] = reader.read<uint64_t>();
+        localFluidSites += domainEdgeProcCollisions[collisionType];
+      }
+
+      totalSharedFs = reader.read<uint64_t>();
+      neighbouringProcs.resize(reader.read<uint32_t>());
+      site_t totalSharedDistributionsSoFar = 0;
+      for (std::vector<NeighbouringProcessor>::iterator neighbour = neighbouringProcs.begin();
+          neighbour != neighbouringProcs.end(); ++neighbour)
+      {
+        neighbour->Rank = reader.read<uint32_t>();
+        neighbour->SharedDistributionCount = reader.read<uint64_t>();
+        neighbour->FirstSharedDistribution = localFluidSites * vectorCount + 1 + totalSharedDistributionsSoFar;
+        totalSharedDistributionsSoFar += neighbour->SharedDistributionCount;
+      }
+
+      blocks.resize(blockCount);
+      const uint32_t knownBlockCount = reader.read<uint32_t>();
+      std::vector<int32_t> siteRanks(sitesPerBlockVolumeUnit);
+      for (uint32_t knownBlock = 0; knownBlock < knownBlockCount; ++knownBlock)
+      {
+        const uint64_t blockId = reader.read<uint64_t>();
+        if (blockId >= uint64_t(blockCount))
+        {
+          throw Exception() << "Invalid block " << blockId << " in " << decompositionFilePath;
+        }
+        reader.readArray(siteRanks.data(), siteRanks.size());
+        blocks[blockId] = Block(sitesPerBlockVolumeUnit);
+        for (site_t localSiteId = 0; localSiteId < sitesPerBlockVolumeUnit; ++localSiteId)
+        {
+          blocks[blockId].SetProcessorRankForSite(localSiteId, siteRanks[localSiteId]);
+        }
+      }
+
+      siteData.resize(localFluidSites);
+      wallNormalAtSite.resize(localFluidSites);
+      distanceToWall.resize(localFluidSites * (vectorCount - 1));
+      globalSiteCoords.resize(localFluidSites);
+      for (site_t site = 0; site < localFluidSites; ++site)
+      {
+        uint32_t coords[3];
+        reader.readArray(coords, 3);
+        globalSiteCoords[site] = util::Vector3D<site_t>(coords[0], coords[1], coords[2]);
+
+        const site_t blockId = GetBlockIdFromBlockCoords(globalSiteCoords[site] / blockSize);
+        if (!IsValidLatticeSite(globalSiteCoords[site]) || blocks[blockId].IsEmpty())
+        {
+          throw Exception() << "The sites in " << decompositionFilePath << " do not match its blocks";
+        }
+        blocks[blockId].SetLocalContiguousIndexForSite(GetLocalSiteIdFromLocalSiteCoords(globalSiteCoords[site]
+                                                                                             % blockSize),
+                                                       site);
+
+        reader.read(siteData[site].GetWallIntersectionData());
+        reader.read(siteData[site].GetIoletIntersectionData());
+        siteData[site].GetSiteType() = SiteType(reader.read<uint32_t>());
+        siteData[site].GetIoletId() = reader.read<int32_t>();
+
+        double normal[3];
+        reader.readArray(normal, 3);
+        wallNormalAtSite[site] = util::Vector3D<distribn_t>(normal[0], normal[1], normal[2]);
+        reader.readArray(&distanceToWall[site * (vectorCount - 1)], vectorCount - 1);
+      }
+
+      neighbourIndices.resize(localFluidSites * vectorCount);
+      reader.readArray(neighbourIndices.data(), neighbourIndices.size());
+      streamingIndicesForReceivedDistributions.resize(totalSharedFs);
+      reader.readArray(streamingIndicesForReceivedDistributions.data(), totalSharedFs);
+
+      oldDistributions.resize(localFluidSites * vectorCount + 1 + totalSharedFs);
+      newDistributions.resize(localFluidSites * vectorCount + 1 + totalSharedFs);
+    }
+
     void LatticeData::CollectFluidSiteDistribution()
     {
       hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::Singleton>("Gathering lattice info.");
@@ -692,6 +867,97 @@ namespace hemelb
         proc.SetIntValue("SITES", fluidSitesOnEachProcessor[n]);
       }
     }
+
+    void LatticeData::SaveDecomposition(const std::string& decompositionFilePath) const
+    {
+      const unsigned vectorCount = latticeInfo.GetNumVectors();
+
+      io::writers::xdr::XdrVectorWriter sectionWriter;
+      for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; collisionType++)
+      {
+        sectionWriter << uint64_t(midDomainProcCollisions[collisionType]);
+      }
+      for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; collisionType++)
+      {
+        sectionWriter << uint64_t(domainEdgeProcCollisions[collisionType]);
+      }
+
+      sectionWriter << uint64_t(totalSharedFs) << uint32_t(neighbouringProcs.size());
+      for (std::vector<NeighbouringProcessor>::const_iterator neighbour = neighbouringProcs.begin();
+          neighbour != neighbouringProcs.end(); ++neighbour)
+      {
+        sectionWriter << uint32_t(neighbour->Rank) << uint64_t(neighbour->SharedDistributionCount);
+      }
+
+      uint32_t knownBlockCount = 0;
+      for (site_t blockId = 0; blockId < blockCount; ++blockId)
+      {
+        knownBlockCount += blocks[blockId].IsEmpty() ? 0 : 1;
+      }
+      sectionWriter << knownBlockCount;
+      for (site_t blockId = 0; blockId < blockCount; ++blockId)
+      {
+        if (blocks[blockId].IsEmpty())
+        {
+          continue;
+        }
+        sectionWriter << uint64_t(blockId);
+        for (site_t localSiteId = 0; localSiteId < sitesPerBlockVolumeUnit; ++localSiteId)
+        {
+          sectionWriter << int32_t(blocks[blockId].GetProcessorRankForSite(localSiteId));
+        }
+      }
+
+      for (site_t site = 0; site < localFluidSites; ++site)
+      {
+        sectionWriter << uint32_t(globalSiteCoords[site].x) << uint32_t(globalSiteCoords[site].y)
+            << uint32_t(globalSiteCoords[site].z);
+        sectionWriter << siteData[site].GetWallIntersectionData() << siteData[site].GetIoletIntersectionData()
+            << uint32_t(siteData[site].GetSiteType()) << int32_t(siteData[site].GetIoletId());
+        sectionWriter << wallNormalAtSite[site].x << wallNormalAtSite[site].y << wallNormalAtSite[site].z;
+        sectionWriter.writeArray(&distanceToWall[site * (vectorCount - 1)], vectorCount - 1);
+      }
+
+      sectionWriter.writeArray(neighbourIndices.data(), neighbourIndices.size());
+      sectionWriter.writeArray(streamingIndicesForReceivedDistributions.data(),
+                               streamingIndicesForReceivedDistributions.size());
+
+      // Lay the sections out in rank order.
+      const std::vector<uint64_t> sectionLengths = comms.AllGather(uint64_t(sectionWriter.GetBuf().size()));
+      std::vector<uint64_t> sectionOffsets(comms.Size());
+      uint64_t offset = dcmp::GetRankSectionsOffset(vectorCount, comms.Size());
+      for (proc_t rank = 0; rank < comms.Size(); ++rank)
+      {
+        sectionOffsets[rank] = offset;
+        offset += sectionLengths[rank];
+      }
+
+      net::MpiFile file = net::MpiFile::Open(comms, decompositionFilePath, MPI_MODE_WRONLY | MPI_MODE_CREATE);
+      // Drop anything left from a longer file at the same path.
+      HEMELB_MPI_CALL(MPI_File_set_size, (file, 0));
+
+      if (comms.OnIORank())
+      {
+        io::writers::xdr::XdrVectorWriter headerWriter;
+        headerWriter << uint32_t(io::formats::HemeLbMagicNumber) << uint32_t(dcmp::MagicNumber)
+            << uint32_t(dcmp::VersionNumber) << uint32_t(comms.Size()) << uint32_t(vectorCount)
+            << uint32_t(blockSize) << uint32_t(blockCounts.x) << uint32_t(blockCounts.y) << uint32_t(blockCounts.z);
+        for (unsigned direction = 0; direction < vectorCount; ++direction)
+        {
+          const util::Vector3D<int>& vector = latticeInfo.GetVector(direction);
+          headerWriter << int32_t(vector.x) << int32_t(vector.y) << int32_t(vector.z);
+        }
+        for (proc_t rank = 0; rank < comms.Size(); ++rank)
+        {
+          headerWriter << sectionOffsets[rank] << sectionLengths[rank];
+        }
+        file.WriteAt(0, headerWriter.GetBuf());
+      }
+
+      file.WriteAtAll(sectionOffsets[comms.Rank()], sectionWriter.GetBuf());
+      file.Close();
+    }
+
     neighbouring::NeighbouringLatticeData &LatticeData::GetNeighbouringData()
     {
       return *neighbouringData;
@@ -8,6 +8,7 @@
 #define HEMELB_GEOMETRY_LATTICEDATA_H
 
 #include <cstdio>
+#include <string>
 #include <vector>
 
 #include "net/net.h"
@@ -26,6 +27,12 @@
 
 namespace hemelb
 {
+  namespace extraction
+  {
+    class LocalCheckpointInput;
+    class LocalCheckpointOutput;
+  }
+
   namespace lb
   {
     // Ugly forward definition is currently necessary.
@@ -39,6 +46,8 @@ namespace hemelb
     class LatticeData : public reporting::Reportable
     {
         friend class extraction::LocalDistributionInput; //! Give access to the methods GetFOld and GetFNew.
+        friend class extraction::LocalCheckpointInput; //! Give access to the methods GetFOld and GetFNew.
+        friend class extraction::LocalCheckpointOutput; //! Give access to the method GetFOld.
         friend lb::InitialConditionBase;
       public:
         template<class Lattice>
@@ -49,6 +58,17 @@ namespace hemelb
 
         LatticeData(const lb::lattices::LatticeInfo& latticeInfo, const Geometry& readResult, const net::IOCommunicator& comms);
 
+        /**
+         * Load the lattice data saved by SaveDecomposition, in place of reading and decomposing
+         * the geometry. Each rank reads its own section of the file with one collective read.
+         * The file must have been saved over the same number of ranks, with the same lattice.
+         *
+         * @param latticeInfo
+         * @param decompositionFilePath
+         * @param comms
+         */
+        LatticeData(const lb::lattices::LatticeInfo& latticeInfo, const std::string& decompositionFilePath, const net::IOCommunicator& comms);
+
         virtual ~LatticeData();
 
         /**
@@ -335,6 +355,14 @@ namespace hemelb
 
         void Report(reporting::Dict& dictionary);
 
+        /**
+         * Save every rank's lattice data, for later runs over the same number of ranks to load
+         * with the constructor above. Collective.
+         *
+         * @param decompositionFilePath
+         */
+        void SaveDecomposition(const std::string& decompositionFilePath) const;
+
         neighbouring::NeighbouringLatticeData &GetNeighbouringData();
         neighbouring::NeighbouringLatticeData const &GetNeighbouringData() const;
 
@@ -352,6 +380,8 @@ namespace hemelb
 
         void ProcessReadSites(const Geometry& readResult);
 
+        void LoadDecomposition(const std::string& decompositionFilePath);
+
         void PopulateWithReadData(const std::vector<site_t> midDomainBlockNumbers[COLLISION_TYPES],
                                   const std::vector<site_t> midDomainSiteNumbers[COLLISION_TYPES],
                                   const std::vector<SiteData> midDomainSiteData[COLLISION_TYPES],
@@ -27,6 +27,7 @@ namespace hemelb
       imageDirectory = outputDir + "/Images/";
       dataPath = outputDir + "/Extracted/";
       colloidFile = outputDir + "/ColloidOutput.xdr";
+      timingTraceFile = outputDir + "/timings.trace";
 
       if (doIo)
       {
@@ -52,6 +53,10 @@ namespace hemelb
     {
       return colloidFile;
     }
+    const std::string & PathManager::GetTimingTracePath() const
+    {
+      return timingTraceFile;
+    }
     const std::string & PathManager::GetReportPath() const
     {
       return reportName;
@@ -55,6 +55,11 @@ namespace hemelb
          * @return
          */
         const std::string & GetColloidPath() const;
+        /**
+         * Path of the file to write the per time step timing trace to.
+         * @return
+         */
+        const std::string & GetTimingTracePath() const;
         /**
          * Path to where a run report file should be created.
          * @return Reference to path to where a run report file should be created.
@@ -89,6 +94,7 @@ namespace hemelb
         std::string inputFile;
         std::string imageDirectory;
         std::string colloidFile;
+        std::string timingTraceFile;
         std::string configLeafName;
         std::string reportName;
         std::string dataPath;
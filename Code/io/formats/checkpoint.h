@@ -0,0 +1,154 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_IO_FORMATS_CHECKPOINT_H
+#define HEMELB_IO_FORMATS_CHECKPOINT_H
+
+#include <cstdint>
+
+namespace hemelb
+{
+  namespace io
+  {
+    namespace formats
+    {
+      namespace checkpoint
+      {
+        /* Binary-exact distribution checkpoints.
+         *
+         * The preamble and rank table are XDR encoded, so any tool can
+         * identify the file. Everything after them is raw, native-endian
+         * data laid out in the rank-local site order of the writing run,
+         * so a restart with the same decomposition is one bulk read per
+         * rank.
+         *
+         * Preamble (hex file position, type, description)
+         * 00   uint       HemeLB magic number (see formats.h)
+         * 04   uint       Checkpoint magic number (see below)
+         * 08   uint       Version number
+         * 12   uint       Byte order marker, written NATIVE (see below)
+         * 16   uint       Number of distributions per site
+         * 20   uint       Number of ranks that wrote the file
+         * 24   uhyper     Total number of fluid sites
+         * 32   uhyper     Decomposition signature
+         * 40   uhyper     Offset of the coordinate section (bytes)
+         * 48   uhyper     Offset of the first record (bytes)
+         * Preamble length = 56 bytes
+         *
+         * Rank table, one entry per writing rank, in rank order
+         * uhyper       Number of fluid sites on the rank
+         * uhyper       Hash of the rank's site coordinates, in local order
+         *
+         * Coordinate section, one entry per site, rank by rank
+         * 3 x uint     Global site coordinates (native)
+         * Padded with zeros to a multiple of 8 bytes.
+         *
+         * Records, one per checkpoint, each of RecordLength bytes
+         * uhyper       Time step at which to resume (native)
+         * Q x double   Distributions for each site, rank by rank (native)
+         */
+
+        /**
+         * Magic number to identify checkpoint files.
+         * ASCII for 'chk' + EOF
+         */
+        enum
+        {
+          MagicNumber = 0x63686b04
+        };
+
+        /**
+         * The version number of the file format.
+         */
+        enum
+        {
+          VersionNumber = 1
+        };
+
+        /**
+         * Written without byte swapping, so a reader on a machine with a
+         * different byte order sees 0x04030201.
+         */
+        enum
+        {
+          ByteOrderMarker = 0x01020304
+        };
+
+        enum
+        {
+          PreambleLength = 56
+        };
+
+        enum
+        {
+          RankRecordLength = 16
+        };
+
+        enum
+        {
+          CoordinateRecordLength = 12
+        };
+
+        /**
+         * Round a file position up to the next 8 byte boundary, so every
+         * double in the file is aligned.
+         * @param pos
+         * @return
+         */
+        inline uint64_t AlignUp(uint64_t pos)
+        {
+          return (pos + 7) & ~uint64_t(7);
+        }
+
+        inline uint64_t GetCoordinateSectionOffset(uint32_t nRanks)
+        {
+          return AlignUp(PreambleLength + uint64_t(nRanks) * RankRecordLength);
+        }
+
+        inline uint64_t GetFirstRecordOffset(uint32_t nRanks, uint64_t totalSites)
+        {
+          return AlignUp(GetCoordinateSectionOffset(nRanks) + totalSites * CoordinateRecordLength);
+        }
+
+        inline uint64_t GetRecordLength(uint32_t numVectors, uint64_t totalSites)
+        {
+          return sizeof(uint64_t) + totalSites * numVectors * sizeof(double);
+        }
+
+        /**
+         * Hash a rank's site layout (FNV-1a, 64 bit). Feed the site count
+         * first, then each site's coordinates in local order.
+         */
+        class LayoutHash
+        {
+          public:
+            LayoutHash() :
+                value(0xcbf29ce484222325ULL)
+            {
+            }
+
+            void Add(uint64_t x)
+            {
+              for (unsigned byte = 0; byte < 8; ++byte)
+              {
+                value ^= (x >> (8 * byte)) & 0xff;
+                value *= 0x100000001b3ULL;
+              }
+            }
+
+            uint64_t Get() const
+            {
+              return value;
+            }
+
+          private:
+            uint64_t value;
+        };
+      }
+    }
+  }
+}
+#endif /* HEMELB_IO_FORMATS_CHECKPOINT_H */
@@ -0,0 +1,130 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_IO_FORMATS_DECOMPOSITION_H
+#define HEMELB_IO_FORMATS_DECOMPOSITION_H
+
+#include <cstdint>
+
+namespace hemelb
+{
+  namespace io
+  {
+    namespace formats
+    {
+      namespace decomposition
+      {
+        /* The lattice data for each rank of a domain decomposition of a
+         * geometry file (*.gmy), made once for a given number of ranks and
+         * lattice so that runs on that many ranks with that lattice need
+         * neither read nor decompose the geometry.
+         *
+         * Ranks are all of HemeLB's ranks, including any core reserved for
+         * steering, which has no sites. Blocks are numbered as in the
+         * geometry file and local sites in the order LatticeData keeps
+         * them: by collision type, mid-domain sites before domain-edge ones.
+         * Everything is XDR encoded.
+         *
+         * Preamble (hex file position, type, description)
+         * 00   uint       HemeLB magic number (see formats.h)
+         * 04   uint       Decomposition magic number (see below)
+         * 08   uint       Version number
+         * 12   uint       Number of ranks decomposed over
+         * 16   uint       Number of lattice vectors, Q
+         * 20   uint       Number of sites along the side of a block
+         * 24   uint       Number of blocks in x
+         * 28   uint       Number of blocks in y
+         * 32   uint       Number of blocks in z
+         * Preamble length = 36 bytes
+         *
+         * Lattice, one entry per vector, in the lattice's order
+         * 3 x int      The vector's components
+         *
+         * Rank table, one entry per rank, in rank order
+         * uhyper       Offset of the rank's section (bytes)
+         * uhyper       Length of the rank's section (bytes)
+         *
+         * Rank sections, in rank order, each read whole by its rank
+         * 6 x uhyper   Number of mid-domain sites of each collision type
+         * 6 x uhyper   Number of domain-edge sites of each collision type
+         * uhyper       Number of distributions shared with other ranks
+         * uint         Number of neighbouring ranks
+         *   Per neighbouring rank, in the order their shared
+         *   distributions are stored
+         *   uint       The rank
+         *   uhyper     Number of distributions shared with it
+         * uint         Number of blocks with fluid sites
+         *   Per block, ascending
+         *   uhyper     Block id
+         *   int        The rank of each site on the block, in the geometry
+         *              file's site order; 2^31 - 1 for solid sites
+         * Per local site, in collision order
+         *   3 x uint   Global site coordinates
+         *   uint       Wall intersection data
+         *   uint       Iolet intersection data
+         *   uint       Site type
+         *   int        Iolet id
+         *   3 x double Wall normal
+         *   (Q-1) x double Distance to the wall along each vector but the
+         *              first
+         * Per local site, Q x hyper
+         *              Where each distribution streams to
+         * Per distribution shared with another rank, hyper
+         *              Where the distribution received streams to
+         */
+
+        /**
+         * Magic number to identify decomposition files.
+         * ASCII for 'dcp' + EOF
+         */
+        enum
+        {
+          MagicNumber = 0x64637004
+        };
+
+        /**
+         * The version number of the file format.
+         */
+        enum
+        {
+          VersionNumber = 2
+        };
+
+        enum
+        {
+          PreambleLength = 36
+        };
+
+        enum
+        {
+          RankRecordLength = 16
+        };
+
+        /**
+         * The offset of the rank table.
+         * @param vectorCount
+         * @return
+         */
+        inline uint64_t GetRankTableOffset(uint32_t vectorCount)
+        {
+          return PreambleLength + uint64_t(12) * vectorCount;
+        }
+
+        /**
+         * The offset of the first rank's section.
+         * @param vectorCount
+         * @param rankCount
+         * @return
+         */
+        inline uint64_t GetRankSectionsOffset(uint32_t vectorCount, uint32_t rankCount)
+        {
+          return GetRankTableOffset(vectorCount) + uint64_t(RankRecordLength) * rankCount;
+        }
+      }
+    }
+  }
+}
+#endif // HEMELB_IO_FORMATS_DECOMPOSITION_H
@@ -7,6 +7,11 @@
 #ifndef HEMELB_IO_FORMATS_EXTRACTION_H
 #define HEMELB_IO_FORMATS_EXTRACTION_H
 
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
 namespace hemelb
 {
   namespace io
@@ -32,6 +37,65 @@ namespace hemelb
           VersionNumber = 4
         };
 
+        /**
+         * The version number of the columnar variant of the format.
+         *
+         * The main and field headers are as for VersionNumber. They are
+         * followed by the grid coordinates of every site, stored once:
+         * uint x 3 x (total number of sites), little-endian
+         *
+         * Then one record per time step:
+         * uhyper - The time step, little-endian
+         * For each field, in field header order:
+         *   float x (field length) x (total number of sites), little-endian,
+         *   with a site's components adjacent. Sites are in the same order
+         *   as the coordinates.
+         */
+        enum
+        {
+          ColumnarVersionNumber = 5
+        };
+
+        /**
+         * The version number of the compressed variant of the format.
+         *
+         * The headers and coordinates are as for ColumnarVersionNumber.
+         * Records are of varying length, one per time step:
+         * uhyper - The time step, little-endian
+         * For each rank with sites, in rank order, a chunk holding that
+         * rank's part of every column, compressed independently:
+         *   uint - the chunk codec, little-endian
+         *   uint - the number of values, little-endian
+         *   double - the quantum for QuantisedShuffleDeflate, else 0, little-endian
+         *   the compressed values
+         *
+         * The byte offsets of the chunks are recorded in the offset file
+         * (see offset.h).
+         */
+        enum
+        {
+          CompressedVersionNumber = 6
+        };
+
+        /**
+         * The length of the header at the start of each compressed chunk.
+         */
+        enum
+        {
+          ChunkHeaderLength = 16
+        };
+
+        /**
+         * How the values in a compressed chunk are encoded. In both cases
+         * the 4 byte values are byte-shuffled (all the first bytes, then
+         * all the second bytes, ...) and then deflated with zlib.
+         */
+        enum ChunkCodec
+        {
+          ShuffleDeflate = 1, //!< The float values themselves; lossless
+          QuantisedShuffleDeflate = 2 //!< Each value as a 32 bit integer multiple of the quantum
+        };
+
         /**
          * The length of the main header. Made up of:
          * uint - HemeLbMagicNumber
@@ -66,6 +130,47 @@ namespace hemelb
           }
           return len + 4;
         }
+
+        /**
+         * Store a 4 or 8 byte value as little-endian, whatever the byte order
+         * of the host. Compiles to a plain store on little-endian machines.
+         * @param value
+         * @param dest
+         * @return The position just past the stored value
+         */
+        template<typename T>
+        inline char* PutLittleEndian(const T& value, char* dest)
+        {
+          static_assert(sizeof(T) == 4 || sizeof(T) == 8, "Only 4 and 8 byte values are supported");
+          typedef typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type Bits;
+          Bits bits;
+          std::memcpy(&bits, &value, sizeof(T));
+          for (unsigned byte = 0; byte < sizeof(T); ++byte)
+          {
+            dest[byte] = char(bits >> (8 * byte));
+          }
+          return dest + sizeof(T);
+        }
+
+        /**
+         * Load a 4 or 8 byte value stored little-endian by PutLittleEndian.
+         * @param src
+         * @return The value
+         */
+        template<typename T>
+        inline T GetLittleEndian(const char* src)
+        {
+          static_assert(sizeof(T) == 4 || sizeof(T) == 8, "Only 4 and 8 byte values are supported");
+          typedef typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type Bits;
+          Bits bits = 0;
+          for (unsigned byte = 0; byte < sizeof(T); ++byte)
+          {
+            bits |= Bits(static_cast<unsigned char>(src[byte])) << (8 * byte);
+          }
+          T value;
+          std::memcpy(&value, &bits, sizeof(T));
+          return value;
+        }
       }
     }
   }
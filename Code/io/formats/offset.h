@@ -7,6 +7,10 @@
 #ifndef HEMELB_IO_FORMATS_OFFSET_H
 #define HEMELB_IO_FORMATS_OFFSET_H
 
+#include <cstdint>
+#include <string>
+#include "Exception.h"
+
 namespace hemelb
 {
   namespace io
@@ -32,6 +36,18 @@ namespace hemelb
           VersionNumber = 1
         };
 
+        /**
+         * The version number for the offset files of compressed extraction
+         * files. After the site index table of version 1 there is, for each
+         * record, an array of size (number of ranks + 1) giving the byte
+         * offset of each rank's chunk and, last, the end of the record. A
+         * rank with no sites has a chunk of zero length.
+         */
+        enum
+        {
+          CompressedVersionNumber = 2
+        };
+
 	// Header contains:
 	// - HemeLb magic - uint32
 	// - Offset magic - uint32
@@ -43,7 +59,10 @@ namespace hemelb
 
 	// Body contains, an array of size (number of ranks + 1),
 	// where elem[i] contains the offset for rank i and elem[i+1]
-	// contains the past the end element for that rank.
+	// contains the past the end element for that rank. For
+	// columnar and compressed extraction files these are site
+	// indices, since a rank's data is not contiguous; otherwise
+	// they are byte offsets into the first record.
 	enum {
 	  RecordLength = sizeof(uint64_t)
 	};
@@ -0,0 +1,109 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_IO_FORMATS_TRACE_H
+#define HEMELB_IO_FORMATS_TRACE_H
+
+#include <cstdint>
+
+namespace hemelb
+{
+  namespace io
+  {
+    namespace formats
+    {
+      namespace trace
+      {
+        /* Per time step, per rank timings.
+         *
+         * The preamble is XDR encoded, so any tool can identify the file.
+         * Blocks are raw, native-endian data, each rank writing its slab
+         * straight from its buffer.
+         *
+         * Preamble (hex file position, type, description)
+         * 00   uint       HemeLB magic number (see formats.h)
+         * 04   uint       Trace magic number (see below)
+         * 08   uint       Version number
+         * 12   uint       Byte order marker, written NATIVE (see below)
+         * 16   uint       Number of ranks that wrote the file
+         * 20   uint       Number of timers, T
+         * 24   uint       Number of time steps per block, S
+         * 28   uint       Zero
+         * Preamble length = 32 bytes
+         *
+         * Timer names, T of them, each NameLength bytes of ASCII padded
+         * with NULs.
+         *
+         * Blocks, each of BlockLength bytes
+         * uhyper       First time step of the block (native)
+         * uint         Number of time steps recorded in the block, at most S
+         *              (native)
+         * uint         Zero
+         * For each rank, in rank order, S x T floats: the seconds spent in
+         * each timer during each time step, step by step (native). Steps
+         * beyond the number recorded are zero.
+         */
+
+        /**
+         * Magic number to identify trace files.
+         * ASCII for 'trc' + EOF
+         */
+        enum
+        {
+          MagicNumber = 0x74726304
+        };
+
+        /**
+         * The version number of the file format.
+         */
+        enum
+        {
+          VersionNumber = 1
+        };
+
+        /**
+         * Written without byte swapping, so a reader on a machine with a
+         * different byte order sees 0x04030201.
+         */
+        enum
+        {
+          ByteOrderMarker = 0x01020304
+        };
+
+        enum
+        {
+          PreambleLength = 32
+        };
+
+        enum
+        {
+          NameLength = 32
+        };
+
+        enum
+        {
+          BlockHeaderLength = 16
+        };
+
+        inline uint64_t GetFirstBlockOffset(uint32_t nTimers)
+        {
+          return PreambleLength + uint64_t(nTimers) * NameLength;
+        }
+
+        inline uint64_t GetSlabLength(uint32_t nTimers, uint32_t stepsPerBlock)
+        {
+          return uint64_t(stepsPerBlock) * nTimers * sizeof(float);
+        }
+
+        inline uint64_t GetBlockLength(uint32_t nRanks, uint32_t nTimers, uint32_t stepsPerBlock)
+        {
+          return BlockHeaderLength + nRanks * GetSlabLength(nTimers, stepsPerBlock);
+        }
+      }
+    }
+  }
+}
+#endif /* HEMELB_IO_FORMATS_TRACE_H */
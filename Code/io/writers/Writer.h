@@ -7,6 +7,7 @@
 #ifndef HEMELB_IO_WRITERS_WRITER_H
 #define HEMELB_IO_WRITERS_WRITER_H
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
@@ -38,6 +39,15 @@ namespace hemelb
             return *this;
           }
 
+          // Write count contiguous values, as for operator<< on each in
+          // turn but with one virtual call for the lot.
+          template<typename T>
+          Writer& writeArray(T const* values, size_t count)
+          {
+            _writeArray(values, count);
+            return *this;
+          }
+
           // Function to get the current position of writing in the stream.
           virtual unsigned int getCurrentStreamPosition() const = 0;
 
@@ -62,6 +72,54 @@ namespace hemelb
           virtual void _write(float const& floatToWrite) = 0;
 
           virtual void _write(const std::string& floatToWrite) = 0;
+
+          // Write arrays of the basic types. By default each value is
+          // written and separated in turn; writers that can do better
+          // override these.
+          virtual void _writeArray(int16_t const* intsToWrite, size_t count)
+          {
+            writeEach(intsToWrite, count);
+          }
+          virtual void _writeArray(uint16_t const* uIntsToWrite, size_t count)
+          {
+            writeEach(uIntsToWrite, count);
+          }
+          virtual void _writeArray(int32_t const* intsToWrite, size_t count)
+          {
+            writeEach(intsToWrite, count);
+          }
+          virtual void _writeArray(uint32_t const* uIntsToWrite, size_t count)
+          {
+            writeEach(uIntsToWrite, count);
+          }
+          virtual void _writeArray(int64_t const* intsToWrite, size_t count)
+          {
+            writeEach(intsToWrite, count);
+          }
+          virtual void _writeArray(uint64_t const* uIntsToWrite, size_t count)
+          {
+            writeEach(uIntsToWrite, count);
+          }
+
+          virtual void _writeArray(double const* doublesToWrite, size_t count)
+          {
+            writeEach(doublesToWrite, count);
+          }
+          virtual void _writeArray(float const* floatsToWrite, size_t count)
+          {
+            writeEach(floatsToWrite, count);
+          }
+
+        private:
+          template<typename T>
+          void writeEach(T const* values, size_t count)
+          {
+            for (size_t i = 0; i < count; ++i)
+            {
+              _write(values[i]);
+              writeFieldSeparator();
+            }
+          }
       };
 
     /*template <>
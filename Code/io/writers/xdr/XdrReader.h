@@ -38,6 +38,14 @@ namespace hemelb
 	    return true;
 	  }
 
+	  // Read count contiguous values, converting them in bulk
+	  template<class T>
+	  bool readArray(T* vals, size_t count) {
+	    auto buf = get_bytes(count * detail::xdr_serialised_size<T>());
+	    detail::xdr_deserialise_array(vals, count, buf);
+	    return true;
+	  }
+
 	  template <class T>
 	  T read() {
 	    T ans;
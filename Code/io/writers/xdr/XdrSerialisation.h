@@ -7,8 +7,13 @@
 #ifndef HEMELB_IO_WRITERS_XDR_SERIALISATION_H
 #define HEMELB_IO_WRITERS_XDR_SERIALISATION_H
 
+#include <cstdint>
+#include <cstring>
 #include <boost/optional.hpp>
 #include <arpa/inet.h>
+#ifdef HEMELB_USE_SSE3
+  #include <immintrin.h>
+#endif
 
 namespace hemelb
 {
@@ -105,8 +110,87 @@ namespace hemelb
 	    xdr_deserialise(*out, src_buf);
 	  }
 	  // End of xdr_serialise overloads
-	  
-	  
+
+	  // Copy nwords words of WordSize (4 or 8) bytes from src to
+	  // dest, reversing the bytes of each, i.e. converting between
+	  // host and XDR (big endian) order on a little endian host.
+	  // Neither pointer need be aligned.
+	  template <size_t WordSize>
+	  void xdr_swap_words(const char* src, char* dest, size_t nwords)
+	  {
+	    static_assert(WordSize == 4 || WordSize == 8, "XDR words are 4 or 8 bytes");
+	    size_t i = 0;
+#ifdef HEMELB_USE_SSE3
+	    // Sixteen bytes at a time: swap the bytes of each 16 bit
+	    // lane, then reverse the order of the lanes in each word.
+	    constexpr int laneOrder = WordSize == 4 ? _MM_SHUFFLE(2, 3, 0, 1) : _MM_SHUFFLE(0, 1, 2, 3);
+	    constexpr size_t wordsPerVector = 16 / WordSize;
+	    for (; i + wordsPerVector <= nwords; i += wordsPerVector) {
+	      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * WordSize));
+	      v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+	      v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, laneOrder), laneOrder);
+	      _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i * WordSize), v);
+	    }
+#endif
+	    for (; i < nwords; ++i) {
+	      if (WordSize == 4) {
+		uint32_t word;
+		std::memcpy(&word, src + i * 4, 4);
+		word = __builtin_bswap32(word);
+		std::memcpy(dest + i * 4, &word, 4);
+	      } else {
+		uint64_t word;
+		std::memcpy(&word, src + i * 8, 8);
+		word = __builtin_bswap64(word);
+		std::memcpy(dest + i * 8, &word, 8);
+	      }
+	    }
+	  }
+
+	  // Serialise n contiguous values into a buffer of
+	  // n * xdr_serialised_size<T>() bytes. Values of a whole XDR
+	  // word or two are just the host bytes in network order, so
+	  // are converted as one buffer; smaller ones are widened one
+	  // at a time.
+	  template <typename T>
+	  typename std::enable_if< std::is_arithmetic<T>::value && (sizeof(T) == 4 || sizeof(T) == 8) >::type
+	  xdr_serialise_array(const T* vals, size_t n, char* dest_buf)
+	  {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	    std::memcpy(dest_buf, vals, n * sizeof(T));
+#else
+	    xdr_swap_words<sizeof(T)>(reinterpret_cast<const char*>(vals), dest_buf, n);
+#endif
+	  }
+
+	  template <typename T>
+	  typename std::enable_if< std::is_integral<T>::value && sizeof(T) < 4 >::type
+	  xdr_serialise_array(const T* vals, size_t n, char* dest_buf)
+	  {
+	    for (size_t i = 0; i < n; ++i)
+	      xdr_serialise(vals[i], dest_buf + 4 * i);
+	  }
+
+	  // The inverse, from n * xdr_serialised_size<T>() bytes
+	  template <typename T>
+	  typename std::enable_if< std::is_arithmetic<T>::value && (sizeof(T) == 4 || sizeof(T) == 8) >::type
+	  xdr_deserialise_array(T* vals, size_t n, const char* src_buf)
+	  {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	    std::memcpy(vals, src_buf, n * sizeof(T));
+#else
+	    xdr_swap_words<sizeof(T)>(src_buf, reinterpret_cast<char*>(vals), n);
+#endif
+	  }
+
+	  template <typename T>
+	  typename std::enable_if< std::is_integral<T>::value && sizeof(T) < 4 >::type
+	  xdr_deserialise_array(T* vals, size_t n, const char* src_buf)
+	  {
+	    for (size_t i = 0; i < n; ++i)
+	      xdr_deserialise(vals[i], src_buf + 4 * i);
+	  }
+
 	  // A completely empty struct to be used as a placeholder
 	  struct Null {
 	    template <typename... Ts>
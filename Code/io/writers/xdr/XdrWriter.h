@@ -7,6 +7,9 @@
 #ifndef HEMELB_IO_WRITERS_XDR_XDRWRITER_H
 #define HEMELB_IO_WRITERS_XDR_XDRWRITER_H
 
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
 #include <boost/optional.hpp>
 #include "io/writers/Writer.h"
 #include "io/writers/xdr/XdrSerialisation.h"
@@ -155,6 +158,34 @@ namespace hemelb
 	    bytes_written += 4*req_nwords;
 	  }
 
+	  // Arrays are byte swapped in bulk rather than value by value
+	  // (XDR has no separators to write between them).
+	  virtual void _writeArray(int16_t const* intsToWrite, size_t count) {
+	    write(intsToWrite, count);
+	  }
+	  virtual void _writeArray(uint16_t const* uIntsToWrite, size_t count) {
+	    write(uIntsToWrite, count);
+	  }
+	  virtual void _writeArray(int32_t const* intsToWrite, size_t count) {
+	    write(intsToWrite, count);
+	  }
+	  virtual void _writeArray(uint32_t const* uIntsToWrite, size_t count) {
+	    write(uIntsToWrite, count);
+	  }
+	  virtual void _writeArray(int64_t const* intsToWrite, size_t count) {
+	    write(intsToWrite, count);
+	  }
+	  virtual void _writeArray(uint64_t const* uIntsToWrite, size_t count) {
+	    write(uIntsToWrite, count);
+	  }
+
+	  virtual void _writeArray(double const* doublesToWrite, size_t count) {
+	    write(doublesToWrite, count);
+	  }
+	  virtual void _writeArray(float const* floatsToWrite, size_t count) {
+	    write(floatsToWrite, count);
+	  }
+
 	  template <typename T>
 	  void write(T const& valToWrite) {
 	    constexpr auto buf_size = detail::xdr_serialised_size<T>();
@@ -166,6 +197,37 @@ namespace hemelb
 	    current = std::copy(buf, buf + buf_size, current);
 	    bytes_written += buf_size;
 	  }
+
+	  template <typename T>
+	  void write(T const* valsToWrite, size_t count) {
+	    constexpr auto val_size = detail::xdr_serialised_size<T>();
+	    assert(boi_traits::check_space(end, current, count * val_size));
+	    write(valsToWrite, count, std::is_pointer<ByteOutputIterator>());
+	    bytes_written += count * val_size;
+	  }
+
+	private:
+	  // When the output is a plain pointer, serialise straight into it
+	  template <typename T>
+	  void write(T const* valsToWrite, size_t count, std::true_type) {
+	    detail::xdr_serialise_array(valsToWrite, count, &*current);
+	    current += count * detail::xdr_serialised_size<T>();
+	  }
+
+	  // Otherwise go through a buffer on the stack, a chunk at a time
+	  template <typename T>
+	  void write(T const* valsToWrite, size_t count, std::false_type) {
+	    constexpr auto val_size = detail::xdr_serialised_size<T>();
+	    constexpr size_t chunk_count = 256;
+	    char buf[chunk_count * val_size];
+	    while (count) {
+	      const auto n = std::min(count, chunk_count);
+	      detail::xdr_serialise_array(valsToWrite, n, buf);
+	      current = std::copy(buf, buf + n * val_size, current);
+	      valsToWrite += n;
+	      count -= n;
+	    }
+	  }
 	};
 
       } // namespace xdr
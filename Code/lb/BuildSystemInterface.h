@@ -28,6 +28,17 @@ namespace hemelb
         typedef kernels::LBGK<Lattice> Type;
     };
 
+    /**
+     * LBGK with Guo forcing, driven by the body forces in the MacroscopicPropertyCache (e.g.
+     * the feedback from colloids).
+     */
+    template<class Lattice>
+    class GuoForcingLBGK
+    {
+      public:
+        typedef kernels::GuoForcingLBGK<Lattice> Type;
+    };
+
     /**
      * The entropic implementation by Ansumali et al.
      */
@@ -6,6 +6,8 @@
 #ifndef HEMELB_LB_INITIALCONDITION_HPP
 #define HEMELB_LB_INITIALCONDITION_HPP
 
+#include "extraction/LocalCheckpointInput.h"
+
 
 namespace hemelb {
   namespace lb {
@@ -44,6 +46,13 @@ namespace hemelb {
 
     template<class LatticeType>
     void CheckpointInitialCondition::SetFs(geometry::LatticeData* latDat, const net::IOCommunicator& ioComms) const {
+      // Binary checkpoints are recognised by their magic number; anything
+      // else is treated as an extraction file holding the distributions.
+      if (extraction::LocalCheckpointInput::IsCheckpointFile(cpFile, ioComms)) {
+	extraction::LocalCheckpointInput checkpointInput(cpFile, ioComms);
+	checkpointInput.LoadDistribution(latDat, initial_time);
+	return;
+      }
       auto distributionInputPtr = std::make_unique<extraction::LocalDistributionInput>(cpFile, ioComms);
       distributionInputPtr->LoadDistribution(latDat, initial_time);
     }
@@ -21,6 +21,7 @@ namespace hemelb
       tractionCache(simState, latticeData.GetLocalFluidSiteCount()),
       tangentialProjectionTractionCache(simState, latticeData.GetLocalFluidSiteCount()),
       velDistributionsCache(simState, latticeData.GetLocalFluidSiteCount()),
+      bodyForces(latticeData.GetLocalFluidSiteCount(), LatticeForceVector::Zero()),
       siteCount(latticeData.GetLocalFluidSiteCount())
     {
       ResetRequirements();
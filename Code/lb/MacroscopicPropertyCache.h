@@ -88,6 +88,13 @@ namespace hemelb
          */
         util::RefreshableCache<util::Vector3D<LatticeStress> > velDistributionsCache;
 
+        /**
+         * The body force on each fluid site on this core, indexed by local contiguous site id.
+         * Unlike the caches above this is an input to the LB step (read by forcing kernels),
+         * so it is always allocated and its values persist until changed.
+         */
+        std::vector<LatticeForceVector> bodyForces;
+
       private:
         /**
          * The state of the simulation, including the number of timesteps passed.
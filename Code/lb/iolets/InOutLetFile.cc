@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <fstream>
+#include <sstream>
 
 #include "lb/iolets/InOutLetFile.h"
 #include "log/Logger.h"
@@ -53,8 +54,16 @@ namespace hemelb
 
         double timeTemp, valueTemp;
 
-        util::check_file(pressureFilePath.c_str());
-        std::ifstream datafile(pressureFilePath.c_str());
+        // Unless the configuration handed over the file's contents, read them now.
+        if (pressureFileContents.empty())
+        {
+          util::check_file(pressureFilePath.c_str());
+          std::ifstream file(pressureFilePath.c_str());
+          std::ostringstream text;
+          text << file.rdbuf();
+          pressureFileContents = text.str();
+        }
+        std::istringstream datafile(pressureFileContents);
         log::Logger::Log<log::Debug, log::OnePerCore>("Reading iolet values from file:");
         while (datafile.good())
         {
@@ -63,7 +72,6 @@ namespace hemelb
           timeValuePairs[timeTemp] = valueTemp;
         }
 
-        datafile.close();
         // the default iterator for maps traverses in key order, so no sort is needed.
 
         std::vector<double> times(0);
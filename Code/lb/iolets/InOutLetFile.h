@@ -44,6 +44,14 @@ namespace hemelb
           {
             pressureFilePath = path;
           }
+          /**
+           * Hand over the contents of the file, so that it need not be read from disk.
+           * @param contents
+           */
+          void SetFileContents(const std::string& contents)
+          {
+            pressureFileContents = contents;
+          }
 
           LatticeDensity GetDensityMin() const
           {
@@ -64,6 +72,7 @@ namespace hemelb
           LatticeDensity densityMin;
           LatticeDensity densityMax;
           std::string pressureFilePath;
+          std::string pressureFileContents;
           const util::UnitConverter* units;
       };
 
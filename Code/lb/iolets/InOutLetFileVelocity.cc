@@ -6,6 +6,7 @@
 #include "lb/iolets/InOutLetFileVelocity.h"
 #include <algorithm>
 #include <fstream>
+#include <sstream>
 #include "log/Logger.h"
 #include "util/fileutils.h"
 #include "util/utilityFunctions.h"
@@ -39,8 +40,16 @@ namespace hemelb
 
         double timeTemp, valueTemp;
 
-        util::check_file(velocityFilePath.c_str());
-        std::ifstream datafile(velocityFilePath.c_str());
+        // Unless the configuration handed over the file's contents, read them now.
+        if (velocityFileContents.empty())
+        {
+          util::check_file(velocityFilePath.c_str());
+          std::ifstream file(velocityFilePath.c_str());
+          std::ostringstream text;
+          text << file.rdbuf();
+          velocityFileContents = text.str();
+        }
+        std::istringstream datafile(velocityFileContents);
         log::Logger::Log<log::Debug, log::OnePerCore>("Reading iolet values from file:");
         while (datafile.good())
         {
@@ -49,7 +58,6 @@ namespace hemelb
           timeValuePairs[timeTemp] = valueTemp;
         }
 
-        datafile.close();
         // the default iterator for maps traverses in key order, so no sort is needed.
 
         std::vector<PhysicalTime> times(0);
@@ -294,11 +302,17 @@ namespace hemelb
         if(useWeightsFromFile) {
           //if the new velocity approximation is enabled, then we want to create a lookup table here.
           const std::string in_name = velocityFilePath + ".weights.txt";
-          util::check_file(in_name.c_str());
+          if (velocityWeightsFileContents.empty())
+          {
+            util::check_file(in_name.c_str());
+            std::ifstream file(in_name.c_str());
+            std::ostringstream text;
+            text << file.rdbuf();
+            velocityWeightsFileContents = text.str();
+          }
 
           /* Load and read file. */
-          std::fstream myfile;
-          myfile.open(in_name.c_str(), std::ios_base::in);
+          std::istringstream myfile(velocityWeightsFileContents);
           log::Logger::Log<log::Warning, log::OnePerCore>("Loading weights file: %s",
                                                         in_name.c_str());
 
@@ -326,7 +340,6 @@ namespace hemelb
             z,
             weights_table[xyz]);
           }
-          myfile.close();
         }
       }
 
@@ -35,6 +35,17 @@ namespace hemelb
           {
             velocityFilePath = path;
           }
+          /**
+           * Hand over the contents of the profile and weights files, so that they need not be
+           * read from disk.
+           * @param contents
+           * @param weightsContents Empty unless weights are read from file
+           */
+          void SetFileContents(const std::string& contents, const std::string& weightsContents)
+          {
+            velocityFileContents = contents;
+            velocityWeightsFileContents = weightsContents;
+          }
 
           LatticeVelocity GetVelocity(const LatticePosition& x, const LatticeTimeStep t) const;
           /*LatticeVelocity GetVelocity2(const util::Vector3D<int64_t> globalCoordinates,
@@ -47,6 +58,8 @@ namespace hemelb
         private:
           std::string velocityFilePath;
           std::string velocityWeightsFilePath;
+          std::string velocityFileContents;
+          std::string velocityWeightsFileContents;
           void CalculateTable(LatticeTimeStep totalTimeSteps, PhysicalTime timeStepLength);
           std::vector<LatticeSpeed> velocityTable;
           const util::UnitConverter* units;
@@ -4,9 +4,12 @@
 // file AUTHORS. This software is provided under the terms of the
 // license in the file LICENSE.
 
+#include <algorithm>
+
 #include "lb/iolets/InOutLetMultiscale.h"
 #include "configuration/SimConfig.h"
 #include "net/IOCommunicator.h"
+#include "net/mpi.h"
 #include "lb/iolets/BoundaryComms.h"
 #include "lb/iolets/BoundaryValues.h"
 
@@ -24,7 +27,9 @@ namespace hemelb
             pressure(this, multiscale_constants::HEMELB_MULTISCALE_REFERENCE_PRESSURE),
             minPressure(this, multiscale_constants::HEMELB_MULTISCALE_REFERENCE_PRESSURE),
             maxPressure(this, multiscale_constants::HEMELB_MULTISCALE_REFERENCE_PRESSURE),
-            velocity(this, multiscale_constants::HEMELB_MULTISCALE_REFERENCE_VELOCITY)
+            flowRate(this, 0.0),
+            velocity(this, multiscale_constants::HEMELB_MULTISCALE_REFERENCE_VELOCITY),
+            couplingLag(0), lagExtrapolation(HOLD), lagPrimed(false)
       {
       }
       /***
@@ -36,7 +41,9 @@ namespace hemelb
       InOutLetMultiscale::InOutLetMultiscale(const InOutLetMultiscale &other) :
         Intercommunicand(other), label(other.label), units(other.units), commsRequired(false),
             pressure(this, other.maxPressure.GetPayload()), minPressure(this, other.minPressure.GetPayload()),
-            maxPressure(this, other.maxPressure.GetPayload()), velocity(this, other.GetVelocity())
+            maxPressure(this, other.maxPressure.GetPayload()), flowRate(this, other.flowRate.GetPayload()),
+            velocity(this, other.GetVelocity()), couplingLag(other.couplingLag),
+            lagExtrapolation(other.lagExtrapolation), lagPrimed(false)
       {
       }
 
@@ -69,23 +76,33 @@ namespace hemelb
       LatticeDensity InOutLetMultiscale::GetDensity(unsigned long timeStep) const
       {
         /* TODO: Fix pressure and GetPressure values (using PressureMax() for now). */
-        return units->ConvertPressureToLatticeUnits(maxPressure.GetPayload()) / Cs2;
+        return units->ConvertPressureToLatticeUnits(GetImposedPressure(2)) / Cs2;
       }
       LatticeDensity InOutLetMultiscale::GetDensityMin() const
       {
-        return units->ConvertPressureToLatticeUnits(minPressure.GetPayload()) / Cs2;
+        return units->ConvertPressureToLatticeUnits(GetImposedPressure(1)) / Cs2;
       }
       LatticeDensity InOutLetMultiscale::GetDensityMax() const
       {
-        return units->ConvertPressureToLatticeUnits(maxPressure.GetPayload()) / Cs2;
+        return units->ConvertPressureToLatticeUnits(GetImposedPressure(2)) / Cs2;
       }
       PhysicalVelocity InOutLetMultiscale::GetVelocity() const
       {
         return velocity;
       }
+
+      double InOutLetMultiscale::GetFlowRate() const
+      {
+        return flowRate.GetPayload();
+      }
+
+      void InOutLetMultiscale::SetFlowRate(double rate)
+      {
+        flowRate.SetPayload(rate);
+      }
       PhysicalPressure InOutLetMultiscale::GetPressure() const
       {
-        return pressure.GetPayload();
+        return GetImposedPressure(0);
       }
 
       multiscale::SharedValue<PhysicalPressure> & InOutLetMultiscale::GetPressureReference()
@@ -117,9 +134,48 @@ namespace hemelb
         commsRequired = b;
       }
 
+      void InOutLetMultiscale::SetCouplingLag(unsigned int lag, LagExtrapolation extrapolation)
+      {
+        couplingLag = lag;
+        lagExtrapolation = extrapolation;
+      }
+
+      unsigned int InOutLetMultiscale::GetCouplingLag() const
+      {
+        return couplingLag;
+      }
+
+      InOutLetMultiscale::LagExtrapolation InOutLetMultiscale::GetLagExtrapolation() const
+      {
+        return lagExtrapolation;
+      }
+
+      PhysicalPressure InOutLetMultiscale::GetImposedPressure(unsigned int index) const
+      {
+        if (lagPrimed)
+        {
+          return imposedPressures[index];
+        }
+        switch (index)
+        {
+          case 0:
+            return pressure.GetPayload();
+          case 1:
+            return minPressure.GetPayload();
+          default:
+            return maxPressure.GetPayload();
+        }
+      }
+
       /* Distribution of internal pressure values */
       void InOutLetMultiscale::DoComms(const BoundaryCommunicator& bcComms, LatticeTimeStep time_step)
       {
+        if (couplingLag > 0)
+        {
+          DoLaggedComms(bcComms);
+          return;
+        }
+
         bool isIoProc = bcComms.IsCurrentProcTheBCProc();
         hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("DoComms in IoletMultiscale triggered: %s",
                                                                               isIoProc
@@ -163,6 +219,39 @@ namespace hemelb
                                                                                 maxPressure.GetPayload());
         }
       }
+
+      /* The pressures the BC proc has now arrived from the coupled codes lag steps after they
+       * were asked for. Every process has every iolet, so they are broadcast over the whole BC
+       * communicator; three doubles are cheap next to the round trip the lag hides. */
+      void InOutLetMultiscale::DoLaggedComms(const BoundaryCommunicator& bcComms)
+      {
+        double received[3];
+        received[0] = pressure.GetPayload();
+        received[1] = minPressure.GetPayload();
+        received[2] = maxPressure.GetPayload();
+        HEMELB_MPI_CALL(MPI_Bcast, (received, 3, MPI_DOUBLE, bcComms.GetBCProcRank(), bcComms));
+
+        if (!lagPrimed)
+        {
+          // Start from the initial pressures, with nothing to extrapolate from.
+          std::copy(received, received + 3, previousPressures);
+          lagPrimed = true;
+        }
+        else
+        {
+          std::copy(latestPressures, latestPressures + 3, previousPressures);
+        }
+        std::copy(received, received + 3, latestPressures);
+
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+          imposedPressures[i] = latestPressures[i];
+          if (lagExtrapolation == LINEAR)
+          {
+            imposedPressures[i] += couplingLag * (latestPressures[i] - previousPressures[i]);
+          }
+        }
+      }
     }
   }
 }
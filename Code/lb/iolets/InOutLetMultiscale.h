@@ -66,6 +66,13 @@ namespace hemelb
           multiscale::SharedValue<PhysicalPressure> & GetPressureReference();
           multiscale::SharedValue<PhysicalVelocity> & GetVelocityReference();
 
+          /***
+           * The volume flow rate out of the simulation domain through this iolet, in m^3/s, for
+           * couplings which need it. Measured by the multiscale simulation master on the BC proc.
+           */
+          double GetFlowRate() const;
+          void SetFlowRate(double rate);
+
           template<class Intercommunicator> void Register(Intercommunicator &intercomms,
                                                           typename Intercommunicator::IntercommunicandTypeT &type)
           {
@@ -78,6 +85,7 @@ namespace hemelb
             type.template RegisterSharedValue<PhysicalPressure> ("pressure");
             type.template RegisterSharedValue<PhysicalPressure> ("minPressure");
             type.template RegisterSharedValue<PhysicalPressure> ("maxPressure");
+            type.template RegisterSharedValue<double> ("flowRate");
             //type.template RegisterSharedValue<PhysicalPressure>("velocity");
           }
           // This should be const, and we should have a setter.
@@ -88,7 +96,33 @@ namespace hemelb
           virtual void SetCommsRequired(bool b);
           void DoComms(const BoundaryCommunicator& bcComms, const LatticeTimeStep timeStep);
 
+          /***
+           * How the pressures imposed while exchanges are in flight are predicted from those
+           * already received.
+           */
+          enum LagExtrapolation
+          {
+            HOLD, //!< Impose the latest pressures received.
+            LINEAR //!< Extrapolate the last two received over the lag.
+          };
+
+          /***
+           * Lag the exchange with the coupled codes by some time steps. The multiscale
+           * simulation master keeps this many exchanges in flight, so the pressures asked for at
+           * step n are only imposed from step n + lag and the LB doesn't wait on the round trip.
+           * All iolets are run at the largest lag configured on any of them. A lag of zero, the
+           * default, completes the exchange before every step.
+           * @param lag
+           * @param extrapolation
+           */
+          void SetCouplingLag(unsigned int lag, LagExtrapolation extrapolation);
+          unsigned int GetCouplingLag() const;
+          LagExtrapolation GetLagExtrapolation() const;
+
         private:
+          void DoLaggedComms(const BoundaryCommunicator& bcComms);
+          PhysicalPressure GetImposedPressure(unsigned int index) const;
+
           std::string label;
           const util::UnitConverter* units;
           bool commsRequired;
@@ -96,7 +130,16 @@ namespace hemelb
           multiscale::SharedValue<PhysicalPressure> pressure;
           multiscale::SharedValue<PhysicalPressure> minPressure;
           multiscale::SharedValue<PhysicalPressure> maxPressure;
+          // Registered after the pressures and before the velocity, to line up with DefineType.
+          multiscale::SharedValue<double> flowRate;
           mutable multiscale::SharedValue<PhysicalVelocity> velocity;
+
+          unsigned int couplingLag;
+          LagExtrapolation lagExtrapolation;
+          bool lagPrimed;
+          double latestPressures[3];
+          double previousPressures[3];
+          double imposedPressures[3];
       };
     }
   }
@@ -17,6 +17,8 @@ namespace hemelb
 {
   namespace lb
   {
+    class MacroscopicPropertyCache;
+
     namespace kernels
     {
 
@@ -51,6 +53,7 @@ namespace hemelb
           template<class LatticeImpl> friend class Entropic;
           template<class LatticeImpl> friend class EntropicAnsumali;
           template<class LatticeImpl> friend class EntropicChik;
+          template<class LatticeImpl> friend class GuoForcingLBGK;
           template<class LatticeImpl> friend class LBGK;
           template<class rheologyModel, class LatticeImpl> friend class LBGKNN;
           template<class LatticeImpl> friend class MRT;
@@ -171,6 +174,10 @@ namespace hemelb
           // The neighbouring data manager, for kernels / collisions / streamers that
           // require data from other cores.
           geometry::neighbouring::NeighbouringDataManager *neighbouringDataManager;
+
+          // The macroscopic property cache. Currently only used in GuoForcingLBGK to read
+          // the body force at each site.
+          const MacroscopicPropertyCache* propertyCache;
       };
 
       /**
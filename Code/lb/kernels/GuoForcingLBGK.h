@@ -0,0 +1,137 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_LB_KERNELS_GUOFORCINGLBGK_H
+#define HEMELB_LB_KERNELS_GUOFORCINGLBGK_H
+
+#include <cstdlib>
+#include "lb/kernels/BaseKernel.h"
+#include "lb/MacroscopicPropertyCache.h"
+#include "units.h"
+
+namespace hemelb
+{
+  namespace lb
+  {
+    namespace kernels
+    {
+      template<class LatticeType>
+      class GuoForcingLBGK;
+
+      /**
+       * The hydrodynamic variables also hold the body force at the site.
+       */
+      template<class LatticeType>
+      struct HydroVars<GuoForcingLBGK<LatticeType> > : HydroVarsBase<LatticeType>
+      {
+        public:
+          HydroVars(const distribn_t* const f) :
+            HydroVarsBase<LatticeType> (f)
+          {
+          }
+
+          LatticeForceVector force;
+      };
+
+      /**
+       * GuoForcingLBGK: the LBGK kernel with a body force at each site, as held in
+       * MacroscopicPropertyCache::bodyForces, applied with the scheme of Guo, Zheng and Shi
+       * (Phys. Rev. E 65, 046308, 2002). The equilibrium uses the velocity
+       * (momentum + F / 2) / density and the collision adds the source term
+       *
+       *   (1 - 1 / (2 tau)) w_i [3 (e_i - u) + 9 (e_i . u) e_i] . F
+       *
+       * With no force this is the same as LBGK.
+       */
+      template<class LatticeType>
+      class GuoForcingLBGK : public BaseKernel<GuoForcingLBGK<LatticeType>, LatticeType>
+      {
+        public:
+          GuoForcingLBGK(InitParams& initParams) :
+            bodyForces(initParams.propertyCache->bodyForces)
+          {
+          }
+
+          inline void DoCalculateDensityMomentumFeq(HydroVars<GuoForcingLBGK>& hydroVars,
+                                                    site_t index)
+          {
+            hydroVars.force = bodyForces[index];
+
+            LatticeType::CalculateDensityAndMomentum(hydroVars.f,
+                                                     hydroVars.density,
+                                                     hydroVars.momentum.x,
+                                                     hydroVars.momentum.y,
+                                                     hydroVars.momentum.z);
+
+            // Half the force's impulse over the time step goes into the momentum.
+            hydroVars.momentum += hydroVars.force * 0.5;
+            hydroVars.velocity = hydroVars.momentum / hydroVars.density;
+
+            LatticeType::CalculateFeq(hydroVars.density,
+                                      hydroVars.momentum.x,
+                                      hydroVars.momentum.y,
+                                      hydroVars.momentum.z,
+                                      hydroVars.f_eq.f);
+
+            for (unsigned int ii = 0; ii < LatticeType::NUMVECTORS; ++ii)
+            {
+              hydroVars.f_neq.f[ii] = hydroVars.f[ii] - hydroVars.f_eq.f[ii];
+            }
+          }
+
+          inline void DoCalculateFeq(HydroVars<GuoForcingLBGK>& hydroVars, site_t index)
+          {
+            // The momentum has been given, so it is not corrected for the force.
+            hydroVars.force = bodyForces[index];
+            hydroVars.velocity = hydroVars.momentum / hydroVars.density;
+
+            LatticeType::CalculateFeq(hydroVars.density,
+                                      hydroVars.momentum.x,
+                                      hydroVars.momentum.y,
+                                      hydroVars.momentum.z,
+                                      hydroVars.f_eq.f);
+
+            for (unsigned int ii = 0; ii < LatticeType::NUMVECTORS; ++ii)
+            {
+              hydroVars.f_neq.f[ii] = hydroVars.f[ii] - hydroVars.f_eq.f[ii];
+            }
+          }
+
+          inline void DoCollide(const LbmParameters* const lbmParams,
+                                HydroVars<GuoForcingLBGK>& hydroVars)
+          {
+            // Note HemeLB defines omega = -1 / tau
+            const distribn_t omega = lbmParams->GetOmega();
+            const distribn_t sourcePrefactor = 1.0 + 0.5 * omega;
+            const LatticeForceVector& force = hydroVars.force;
+            const util::Vector3D<distribn_t>& velocity = hydroVars.velocity;
+            const distribn_t velocityDotForce = velocity.Dot(force);
+
+            for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+            {
+              const distribn_t eDotForce = LatticeType::CX[direction] * force.x
+                  + LatticeType::CY[direction] * force.y + LatticeType::CZ[direction] * force.z;
+              const distribn_t eDotVelocity = LatticeType::CX[direction] * velocity.x
+                  + LatticeType::CY[direction] * velocity.y + LatticeType::CZ[direction] * velocity.z;
+              const distribn_t source = LatticeType::EQMWEIGHTS[direction]
+                  * (3.0 * (eDotForce - velocityDotForce) + 9.0 * eDotVelocity * eDotForce);
+
+              hydroVars.SetFPostCollision(direction,
+                                          hydroVars.f[direction]
+                                              + hydroVars.f_neq.f[direction] * omega
+                                              + sourcePrefactor * source);
+            }
+          }
+
+        private:
+          const std::vector<LatticeForceVector>& bodyForces;
+      };
+
+    }
+  }
+}
+
+#endif /* HEMELB_LB_KERNELS_GUOFORCINGLBGK_H */
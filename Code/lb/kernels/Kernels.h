@@ -9,6 +9,7 @@
 
 #include "lb/kernels/EntropicAnsumali.h"
 #include "lb/kernels/EntropicChik.h"
+#include "lb/kernels/GuoForcingLBGK.h"
 #include "lb/kernels/LBGK.h"
 #include "lb/kernels/LBGKNN.h"
 #include "lb/kernels/MRT.h"
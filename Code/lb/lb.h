@@ -16,6 +16,7 @@
 #include "util/UnitConverter.h"
 #include "configuration/SimConfig.h"
 #include "reporting/Timers.h"
+#include "reporting/KernelCounters.h"
 #include "lb/BuildSystemInterface.h"
 #include <typeinfo>
 
@@ -103,6 +104,16 @@ namespace hemelb
         hemelb::lb::LbmParameters *GetLbmParams();
         lb::MacroscopicPropertyCache& GetPropertyCache();
 
+        /**
+         * Measure each stream-and-collide segment with the given counters, if built with
+         * HEMELB_USE_KERNEL_COUNTERS.
+         * @param counters
+         */
+        void SetKernelCounters(reporting::KernelCounters* counters)
+        {
+          kernelCounters = counters;
+        }
+
       private:
 
         void InitCollisions();
@@ -127,8 +138,15 @@ namespace hemelb
         tOutletWallCollision* mOutletWallCollision;
 
         template<typename Collision>
-        void StreamAndCollide(Collision* collision, const site_t iFirstIndex, const site_t iSiteCount)
+        void StreamAndCollide(Collision* collision, const site_t iFirstIndex, const site_t iSiteCount,
+                              unsigned int segment)
         {
+#ifdef HEMELB_USE_KERNEL_COUNTERS
+          if (kernelCounters != NULL && iSiteCount > 0)
+          {
+            kernelCounters->Start();
+          }
+#endif
           if (mVisControl->IsRendering())
           {
             collision->template StreamAndCollide<true> (iFirstIndex, iSiteCount, &mParams, mLatDat, propertyCache);
@@ -137,6 +155,12 @@ namespace hemelb
           {
             collision->template StreamAndCollide<false> (iFirstIndex, iSiteCount, &mParams, mLatDat, propertyCache);
           }
+#ifdef HEMELB_USE_KERNEL_COUNTERS
+          if (kernelCounters != NULL && iSiteCount > 0)
+          {
+            kernelCounters->Stop(segment, iSiteCount);
+          }
+#endif
         }
 
         template<typename Collision>
@@ -167,6 +191,7 @@ namespace hemelb
         const util::UnitConverter* mUnits;
 
         hemelb::reporting::Timers &timings;
+        reporting::KernelCounters* kernelCounters;
 
         MacroscopicPropertyCache propertyCache;
 
@@ -39,7 +39,7 @@ namespace hemelb
                           geometry::neighbouring::NeighbouringDataManager *neighbouringDataManager) :
       mSimConfig(iSimulationConfig), mNet(net), mLatDat(latDat), mState(simState), 
           mParams(iSimulationConfig->GetTimeStepLength(), iSimulationConfig->GetVoxelSize()), timings(atimings),
-          propertyCache(*simState, *latDat), neighbouringDataManager(neighbouringDataManager)
+          kernelCounters(NULL), propertyCache(*simState, *latDat), neighbouringDataManager(neighbouringDataManager)
     {
       ReadParameters();
     }
@@ -103,6 +103,7 @@ namespace hemelb
       initParams.latDat = mLatDat;
       initParams.lbmParams = &mParams;
       initParams.neighbouringDataManager = neighbouringDataManager;
+      initParams.propertyCache = &propertyCache;
 
       unsigned collId;
       InitInitParamsSiteRanges(initParams, collId);
@@ -207,24 +208,42 @@ namespace hemelb
        */
       site_t offset = mLatDat->GetMidDomainSiteCount();
 
-      StreamAndCollide(mMidFluidCollision, offset, mLatDat->GetDomainEdgeCollisionCount(0));
+      StreamAndCollide(mMidFluidCollision,
+                       offset,
+                       mLatDat->GetDomainEdgeCollisionCount(0),
+                       reporting::KernelCounters::preSend + 0);
       offset += mLatDat->GetDomainEdgeCollisionCount(0);
 
-      StreamAndCollide(mWallCollision, offset, mLatDat->GetDomainEdgeCollisionCount(1));
+      StreamAndCollide(mWallCollision,
+                       offset,
+                       mLatDat->GetDomainEdgeCollisionCount(1),
+                       reporting::KernelCounters::preSend + 1);
       offset += mLatDat->GetDomainEdgeCollisionCount(1);
 
       mInletValues->FinishReceive();
-      StreamAndCollide(mInletCollision, offset, mLatDat->GetDomainEdgeCollisionCount(2));
+      StreamAndCollide(mInletCollision,
+                       offset,
+                       mLatDat->GetDomainEdgeCollisionCount(2),
+                       reporting::KernelCounters::preSend + 2);
       offset += mLatDat->GetDomainEdgeCollisionCount(2);
 
       mOutletValues->FinishReceive();
-      StreamAndCollide(mOutletCollision, offset, mLatDat->GetDomainEdgeCollisionCount(3));
+      StreamAndCollide(mOutletCollision,
+                       offset,
+                       mLatDat->GetDomainEdgeCollisionCount(3),
+                       reporting::KernelCounters::preSend + 3);
       offset += mLatDat->GetDomainEdgeCollisionCount(3);
 
-      StreamAndCollide(mInletWallCollision, offset, mLatDat->GetDomainEdgeCollisionCount(4));
+      StreamAndCollide(mInletWallCollision,
+                       offset,
+                       mLatDat->GetDomainEdgeCollisionCount(4),
+                       reporting::KernelCounters::preSend + 4);
       offset += mLatDat->GetDomainEdgeCollisionCount(4);
 
-      StreamAndCollide(mOutletWallCollision, offset, mLatDat->GetDomainEdgeCollisionCount(5));
+      StreamAndCollide(mOutletWallCollision,
+                       offset,
+                       mLatDat->GetDomainEdgeCollisionCount(5),
+                       reporting::KernelCounters::preSend + 5);
 
       timings[hemelb::reporting::Timers::lb_calc].Stop();
       timings[hemelb::reporting::Timers::lb].Stop();
@@ -246,22 +265,40 @@ namespace hemelb
        */
       site_t offset = 0;
 
-      StreamAndCollide(mMidFluidCollision, offset, mLatDat->GetMidDomainCollisionCount(0));
+      StreamAndCollide(mMidFluidCollision,
+                       offset,
+                       mLatDat->GetMidDomainCollisionCount(0),
+                       reporting::KernelCounters::preReceive + 0);
       offset += mLatDat->GetMidDomainCollisionCount(0);
 
-      StreamAndCollide(mWallCollision, offset, mLatDat->GetMidDomainCollisionCount(1));
+      StreamAndCollide(mWallCollision,
+                       offset,
+                       mLatDat->GetMidDomainCollisionCount(1),
+                       reporting::KernelCounters::preReceive + 1);
       offset += mLatDat->GetMidDomainCollisionCount(1);
 
-      StreamAndCollide(mInletCollision, offset, mLatDat->GetMidDomainCollisionCount(2));
+      StreamAndCollide(mInletCollision,
+                       offset,
+                       mLatDat->GetMidDomainCollisionCount(2),
+                       reporting::KernelCounters::preReceive + 2);
       offset += mLatDat->GetMidDomainCollisionCount(2);
 
-      StreamAndCollide(mOutletCollision, offset, mLatDat->GetMidDomainCollisionCount(3));
+      StreamAndCollide(mOutletCollision,
+                       offset,
+                       mLatDat->GetMidDomainCollisionCount(3),
+                       reporting::KernelCounters::preReceive + 3);
       offset += mLatDat->GetMidDomainCollisionCount(3);
 
-      StreamAndCollide(mInletWallCollision, offset, mLatDat->GetMidDomainCollisionCount(4));
+      StreamAndCollide(mInletWallCollision,
+                       offset,
+                       mLatDat->GetMidDomainCollisionCount(4),
+                       reporting::KernelCounters::preReceive + 4);
       offset += mLatDat->GetMidDomainCollisionCount(4);
 
-      StreamAndCollide(mOutletWallCollision, offset, mLatDat->GetMidDomainCollisionCount(5));
+      StreamAndCollide(mOutletWallCollision,
+                       offset,
+                       mLatDat->GetMidDomainCollisionCount(5),
+                       reporting::KernelCounters::preReceive + 5);
 
       timings[hemelb::reporting::Timers::lb_calc].Stop();
       timings[hemelb::reporting::Timers::lb].Stop();
@@ -0,0 +1,90 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <cstdio>
+
+#include "log/AsyncSink.h"
+
+namespace hemelb
+{
+  namespace log
+  {
+    AsyncSink::AsyncSink(unsigned int capacity, std::FILE* out) :
+        out(out), ring(capacity), pushed(0), written(0), stopping(false)
+    {
+      writer = std::thread(&AsyncSink::WriterLoop, this);
+    }
+
+    AsyncSink::~AsyncSink()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+      }
+      messageAvailable.notify_one();
+      writer.join();
+    }
+
+    void AsyncSink::Push(const std::string& message)
+    {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        messageWritten.wait(lock, [this]
+        {
+          return pushed - written < ring.size();
+        });
+
+        ring[pushed % ring.size()] = message;
+        ++pushed;
+      }
+      messageAvailable.notify_one();
+    }
+
+    void AsyncSink::Flush()
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      messageWritten.wait(lock, [this]
+      {
+        return written == pushed;
+      });
+    }
+
+    void AsyncSink::WriterLoop()
+    {
+      std::string message;
+      std::unique_lock<std::mutex> lock(mutex);
+
+      while (true)
+      {
+        messageAvailable.wait(lock, [this]
+        {
+          return stopping || written != pushed;
+        });
+
+        if (written == pushed)
+        {
+          // Only reached when stopping, with everything written.
+          return;
+        }
+
+        // The slot cannot be reused until written is incremented, so it is safe to write it
+        // out without the lock.
+        message.swap(ring[written % ring.size()]);
+        lock.unlock();
+
+        std::fputs(message.c_str(), out);
+
+        lock.lock();
+        ++written;
+        if (written == pushed)
+        {
+          std::fflush(out);
+        }
+        messageWritten.notify_all();
+      }
+    }
+  }
+}
@@ -0,0 +1,69 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_LOG_ASYNCSINK_H
+#define HEMELB_LOG_ASYNCSINK_H
+
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hemelb
+{
+  namespace log
+  {
+    /**
+     * A ring of formatted log messages, written in order by a background thread.
+     *
+     * Pushing a message only waits if the ring is full, so a burst of logging costs the
+     * formatting but not the write.
+     */
+    class AsyncSink
+    {
+      public:
+        /**
+         * @param capacity The number of messages the ring holds
+         * @param out Where the messages are written, stdout by default
+         */
+        explicit AsyncSink(unsigned int capacity, std::FILE* out = stdout);
+
+        /**
+         * Writes out any messages still in the ring and stops the thread.
+         */
+        ~AsyncSink();
+
+        void Push(const std::string& message);
+
+        /**
+         * Waits until every message pushed so far has been written.
+         */
+        void Flush();
+
+      private:
+        AsyncSink(const AsyncSink&);
+        AsyncSink& operator=(const AsyncSink&);
+
+        void WriterLoop();
+
+        std::FILE* const out;
+        std::vector<std::string> ring;
+        // The number of messages ever pushed and written; the ring holds the difference.
+        unsigned long pushed;
+        unsigned long written;
+        bool stopping;
+
+        std::mutex mutex;
+        std::condition_variable messageAvailable;
+        std::condition_variable messageWritten;
+        std::thread writer;
+    };
+  }
+}
+
+#endif /* HEMELB_LOG_ASYNCSINK_H */
@@ -15,16 +15,46 @@
 #include "util/utilityFunctions.h"
 #include "net/mpi.h"
 #include "log/Logger.h"
+#include "log/AsyncSink.h"
 
 namespace hemelb
 {
   namespace log
   {
-    const LogLevel Logger::currentLogLevel = HEMELB_LOG_LEVEL;
+    constexpr LogLevel Logger::currentLogLevel;
     // Use negative value to indicate uninitialised.
     int Logger::thisRank = -1;
     double Logger::startTime = -1.0;
 
+    namespace
+    {
+#if HEMELB_LOG_BUFFER > 0
+      AsyncSink& GetSink()
+      {
+        static AsyncSink sink(HEMELB_LOG_BUFFER);
+        return sink;
+      }
+#endif
+
+      std::string FormatMessage(const std::string& format, std::va_list args)
+      {
+        std::va_list sizingArgs;
+        va_copy(sizingArgs, args);
+        const int length = std::vsnprintf(NULL, 0, format.c_str(), sizingArgs);
+        va_end(sizingArgs);
+
+        if (length < 0)
+        {
+          return format;
+        }
+
+        std::string message(length + 1, '\0');
+        std::vsnprintf(&message[0], message.size(), format.c_str(), args);
+        message.resize(length);
+        return message;
+      }
+    }
+
     void Logger::Init()
     {
       // If Logger uninitialised
@@ -40,7 +70,7 @@ namespace hemelb
     }
 
     template<>
-    void Logger::LogInternal<OnePerCore>(std::string format, std::va_list args)
+    void Logger::LogInternal<OnePerCore>(const char* format, std::va_list args)
     {
       std::stringstream output;
 
@@ -59,13 +89,11 @@ namespace hemelb
 
       output << "]: " << format << '\n';
 
-      std::string overFormat(output.str());
-
-      std::vprintf(overFormat.c_str(), args);
+      Write(FormatMessage(output.str(), args));
     }
 
     template<>
-    void Logger::LogInternal<Singleton>(std::string format, std::va_list args)
+    void Logger::LogInternal<Singleton>(const char* format, std::va_list args)
     {
       if (thisRank == 0)
       {
@@ -73,9 +101,26 @@ namespace hemelb
         std::sprintf(lead, "![%.1fs]", util::myClock() - startTime);
 
         std::string newFormat = std::string(lead);
-        std::vprintf(newFormat.append(format).append("\n").c_str(), args);
+        Write(FormatMessage(newFormat.append(format).append("\n"), args));
       }
     }
 
+    void Logger::Write(const std::string& message)
+    {
+#if HEMELB_LOG_BUFFER > 0
+      GetSink().Push(message);
+#else
+      std::fputs(message.c_str(), stdout);
+#endif
+    }
+
+    void Logger::Flush()
+    {
+#if HEMELB_LOG_BUFFER > 0
+      GetSink().Flush();
+#endif
+      std::fflush(stdout);
+    }
+
   }
 }
@@ -37,11 +37,19 @@ namespace hemelb
       OnePerCore
     };
 
+    /**
+     * The log level is fixed at compile time (HEMELB_LOG_LEVEL), so a call below it, or code
+     * guarded by ShouldDisplay, compiles to nothing. Guard any call whose arguments are costly
+     * to evaluate, as they are evaluated before Log can discard them.
+     *
+     * With HEMELB_LOG_BUFFER non-zero, each core formats its messages when they are logged and
+     * a background thread writes them out, so logging does not wait on stdout.
+     */
     class Logger
     {
       public:
         template<LogLevel queryLogLevel>
-        static bool ShouldDisplay()
+        static constexpr bool ShouldDisplay()
         {
           return queryLogLevel <= currentLogLevel;
         }
@@ -49,22 +57,42 @@ namespace hemelb
         static void Init();
 
         template<LogLevel queryLogLevel, LogType logType>
-        static void Log(std::string format, ...)
+        static void Log(const char* format, ...)
         {
-          if (queryLogLevel <= currentLogLevel)
+          if (ShouldDisplay<queryLogLevel>())
           {
             va_list args;
             va_start(args, format);
             LogInternal<logType> (format, args);
             va_end(args);
+
+            // The process is about to end; make sure the message gets out first.
+            if (queryLogLevel == Critical)
+            {
+              Flush();
+            }
           }
         }
 
+        // For messages that are not format strings.
+        template<LogLevel queryLogLevel, LogType logType>
+        static void Log(const std::string& message)
+        {
+          Log<queryLogLevel, logType>("%s", message.c_str());
+        }
+
+        /**
+         * Waits until every message logged so far has been written out.
+         */
+        static void Flush();
+
       private:
         template<LogType>
-        static void LogInternal(std::string format, va_list args);
+        static void LogInternal(const char* format, va_list args);
+
+        static void Write(const std::string& message);
 
-        static const LogLevel currentLogLevel;
+        static constexpr LogLevel currentLogLevel = HEMELB_LOG_LEVEL;
         static int thisRank;
         static double startTime;
     };
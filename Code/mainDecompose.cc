@@ -0,0 +1,77 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <memory>
+
+#include "net/mpi.h"
+#include "net/IOCommunicator.h"
+#include "configuration/CommandLine.h"
+#include "configuration/SimConfig.h"
+#include "geometry/GeometryReader.h"
+#include "geometry/LatticeData.h"
+#include "lb/lattices/Lattices.h"
+#include "log/Logger.h"
+#include "reporting/Timers.h"
+#include "steering/SteeringComponent.h"
+#include "Exception.h"
+
+/**
+ * Decompose the geometry of a simulation over the ranks this is run on, build each rank's lattice
+ * data and save it to the file given by <decomposition path="..."/> in the configuration's
+ * <geometry> element. Simulations with that configuration on as many ranks, built for the same
+ * lattice, then load their lattice data from it rather than reading and decomposing the geometry.
+ * Takes the same arguments as hemelb.
+ */
+int main(int argc, char *argv[])
+{
+  hemelb::net::MpiEnvironment mpi(argc, argv);
+  hemelb::log::Logger::Init();
+  try
+  {
+    hemelb::net::MpiCommunicator commWorld = hemelb::net::MpiCommunicator::World();
+    hemelb::net::IOCommunicator hemelbCommunicator(commWorld);
+    try
+    {
+      hemelb::configuration::CommandLine options = hemelb::configuration::CommandLine(argc, argv);
+      std::unique_ptr<hemelb::configuration::SimConfig>
+          simConfig(hemelb::configuration::SimConfig::New(options.GetInputFile(),
+                                                          hemelbCommunicator));
+      if (simConfig->GetDecompositionFilePath().empty())
+      {
+        throw hemelb::Exception() << "No <decomposition> file to save to is given in "
+            << options.GetInputFile();
+      }
+
+      hemelb::reporting::Timers timings(hemelbCommunicator);
+      hemelb::geometry::GeometryReader
+          reader(hemelb::steering::SteeringComponent::RequiresSeparateSteeringCore(),
+                 hemelb::lb::lattices:: HEMELB_LATTICE::GetLatticeInfo(),
+                 timings,
+                 hemelbCommunicator);
+
+      hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("Loading file and decomposing geometry.");
+      hemelb::geometry::Geometry geometry = reader.LoadAndDecompose(simConfig->GetDataFilePath());
+
+      hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("Saving decomposition to %s.",
+                                                                          simConfig->GetDecompositionFilePath().c_str());
+      hemelb::geometry::LatticeData latticeData(hemelb::lb::lattices:: HEMELB_LATTICE::GetLatticeInfo(),
+                                                geometry,
+                                                hemelbCommunicator);
+      latticeData.SaveDecomposition(simConfig->GetDecompositionFilePath());
+    }
+    // Interpose this catch to print usage before propagating the error.
+    catch (hemelb::configuration::CommandLine::OptionError& e)
+    {
+      hemelb::log::Logger::Log<hemelb::log::Critical, hemelb::log::Singleton>(hemelb::configuration::CommandLine::GetUsage());
+      throw;
+    }
+  }
+  catch (std::exception& e)
+  {
+    hemelb::log::Logger::Log<hemelb::log::Critical, hemelb::log::OnePerCore>(e.what());
+    mpi.Abort(-1);
+  }
+}
@@ -0,0 +1,66 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <memory>
+
+#include "configuration/CommandLine.h"
+#include "debug/Debugger.h"
+#include "multiscale/MultiscaleSimulationMaster.h"
+#include "multiscale/reduced/ReducedOrderIntercommunicator.h"
+#include "multiscale/reduced/WindkesselModel.h"
+
+int main(int argc, char *argv[])
+{
+  // Bring up MPI
+  hemelb::net::MpiEnvironment mpi(argc, argv);
+  hemelb::log::Logger::Init();
+  try
+  {
+    hemelb::net::MpiCommunicator commWorld = hemelb::net::MpiCommunicator::World();
+
+    hemelb::net::IOCommunicator hemelbCommunicator(commWorld);
+
+    try
+    {
+      // Parse command line
+      hemelb::configuration::CommandLine options = hemelb::configuration::CommandLine(argc, argv);
+      // Start the debugger (no-op if HEMELB_USE_DEBUGGER is OFF)
+      hemelb::debug::Debugger::Init(options.GetDebug(), argv[0], commWorld);
+
+      // The reduced order model lives next to the input file, and is only run on the BC proc.
+      std::string inputFile = options.GetInputFile();
+      std::string modelFile = inputFile.substr(0, inputFile.find_last_of("/") + 1).append("ReducedOrderModel.xml");
+
+      const bool isBCProc = hemelbCommunicator.Rank()
+          == hemelb::lb::iolets::BoundaryValues::GetBCProcRank();
+      std::unique_ptr<hemelb::multiscale::ReducedOrderModel> model(isBCProc ?
+        hemelb::multiscale::WindkesselModel::Load(modelFile) :
+        new hemelb::multiscale::WindkesselModel());
+
+      hemelb::multiscale::ReducedOrderIntercommunicator intercomms(isBCProc, *model, true);
+
+      hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::OnePerCore>("Constructing MultiscaleSimulationMaster()");
+      hemelb::multiscale::MultiscaleSimulationMaster<hemelb::multiscale::ReducedOrderIntercommunicator> lMaster(options,
+                                                                                                                hemelbCommunicator,
+                                                                                                                intercomms);
+
+      lMaster.RunSimulation();
+    }
+    // Interpose this catch to print usage before propagating the error.
+    catch (hemelb::configuration::CommandLine::OptionError& e)
+    {
+      hemelb::log::Logger::Log<hemelb::log::Critical, hemelb::log::Singleton>(hemelb::configuration::CommandLine::GetUsage());
+      throw;
+    }
+  }
+  catch (std::exception& e)
+  {
+    hemelb::log::Logger::Log<hemelb::log::Critical, hemelb::log::OnePerCore>(e.what());
+    mpi.Abort(-1);
+  }
+  // MPI gets finalised by MpiEnv's d'tor.
+  return (0);
+}
@@ -77,11 +77,49 @@ namespace hemelb
          */
         virtual bool DoMultiscale(double newtime)=0;
 
+        /***
+         * Start sharing multiscale information, as DoMultiscale, without waiting for the partners.
+         * What they send is stored in the intercommunicands by the matching CompleteMultiscale;
+         * exchanges complete in the order they were started. By default the whole exchange is
+         * done here.
+         * @param newtime time advanced to last step.
+         * @return true if HemeLB should advance again.
+         */
+        virtual bool StartMultiscale(double newtime)
+        {
+          return DoMultiscale(newtime);
+        }
+
+        /***
+         * Wait for the oldest exchange started by StartMultiscale, if it hasn't completed yet.
+         */
+        virtual void CompleteMultiscale()
+        {
+        }
+
+        /***
+         * True if StartMultiscale returns before the partners have answered, so HemeLB can carry
+         * on stepping while exchanges are in flight.
+         */
+        virtual bool OverlapsExchanges() const
+        {
+          return false;
+        }
+
         /***
          * Share initial multiscale information to the partners, achieving consistent initial conditions
          */
         virtual void ShareInitialConditions()=0;
 
+        /***
+         * Whether the partners use the iolet flow rates. Measuring them needs a reduction over
+         * all processes every step, so the simulation master only does so when this is true.
+         */
+        virtual bool NeedsFlowRates() const
+        {
+          return false;
+        }
+
         void RegisterIntercommunicand(IntercommunicandTypeT & resolver,
                                       Intercommunicand & intercommunicand,
                                       const std::string &label)
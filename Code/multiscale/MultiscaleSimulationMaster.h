@@ -6,6 +6,7 @@
 
 #ifndef HEMELB_MULTISCALE_MULTISCALESIMULATIONMASTER_H
 #define HEMELB_MULTISCALE_MULTISCALESIMULATIONMASTER_H
+#include <algorithm>
 #include <vector>
 #include "multiscale/Intercommunicator.h"
 #include "SimulationMaster.h"
@@ -26,7 +27,7 @@ namespace hemelb
                                    const net::IOCommunicator& ioComm,
                                    Intercommunicator & aintercomms) :
             SimulationMaster(options, ioComm), intercomms(aintercomms),
-                multiscaleIoletType("inoutlet")
+                multiscaleIoletType("inoutlet"), couplingLag(0), exchangesInFlight(0)
         {
           // We only have one shared object type so far, an iolet.
           lb::iolets::InOutLetMultiscale::DefineType(multiscaleIoletType);
@@ -62,9 +63,6 @@ namespace hemelb
                                                                                                      multiscaleIoletType);
             }
           }
-          // We only have one shared object type so far, an iolet.
-          lb::iolets::InOutLetMultiscale::DefineType(multiscaleIoletType);
-
           /* Process 0 has a list of all the Iolets. The count of all this is highly useful to pre-size all the
            * needed arrays later on, so we are broadcasting this to all the other processes. */
           std::vector<unsigned> GlobalIoletCount;
@@ -192,6 +190,9 @@ namespace hemelb
             }
           }
 
+          FindIoletSites();
+          AlignCouplingLags();
+
           hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("MSMaster ShareICs started...");
           intercomms.ShareInitialConditions();
           hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("MSMaster Init finished!");
@@ -214,7 +215,20 @@ namespace hemelb
 
         void DoTimeStep()
         {
-          bool advance = intercomms.DoMultiscale(GetState()->GetTime());
+          if (intercomms.NeedsFlowRates())
+          {
+            MeasureFlowRates(inletValues, inletSites);
+            MeasureFlowRates(outletValues, outletSites);
+          }
+
+          // The values asked for now are imposed couplingLag steps later.
+          bool advance = intercomms.StartMultiscale(GetState()->GetTime());
+          ++exchangesInFlight;
+          while (exchangesInFlight > couplingLag)
+          {
+            intercomms.CompleteMultiscale();
+            --exchangesInFlight;
+          }
           hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("At time step %i, should advance %i, time %f",
                                                                               GetState()->GetTimeStep(),
                                                                               static_cast<int>(advance),
@@ -227,19 +241,24 @@ namespace hemelb
              * complete all the communications, not just initiate them.
              * This is to prevent any inconsistent state in the coupling
              * (it's hard enough to get the physics right with a consistent
-             * state ;)). */
+             * state ;)). With a coupling lag, what the iolets distribute
+             * here is what the intercommunicator completed above, asked
+             * for lag steps ago. */
 
-            hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("inlet and outlet count: %d and %d",
-                                                                                  inletValues->GetLocalIoletCount(),
-                                                                                  outletValues->GetLocalIoletCount());
-            hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("inlets: %d",
-                                                                                  inletValues->GetLocalIolet(0)->IsCommsRequired(),
-                                                                                  inletValues->GetLocalIolet(0)->GetDensityMax(),
-                                                                                  inletValues->GetLocalIolet(0)->GetPressureMax());
-            hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("outlets: %d",
-                                                                                  outletValues->GetLocalIolet(0)->IsCommsRequired(),
-                                                                                  outletValues->GetLocalIolet(0)->GetDensityMax(),
-                                                                                  outletValues->GetLocalIolet(0)->GetPressureMax());
+            if (hemelb::log::Logger::ShouldDisplay<hemelb::log::Debug>())
+            {
+              hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("inlet and outlet count: %d and %d",
+                                                                                    inletValues->GetLocalIoletCount(),
+                                                                                    outletValues->GetLocalIoletCount());
+              hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("inlets: %d",
+                                                                                    inletValues->GetLocalIolet(0)->IsCommsRequired(),
+                                                                                    inletValues->GetLocalIolet(0)->GetDensityMax(),
+                                                                                    inletValues->GetLocalIolet(0)->GetPressureMax());
+              hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("outlets: %d",
+                                                                                    outletValues->GetLocalIolet(0)->IsCommsRequired(),
+                                                                                    outletValues->GetLocalIolet(0)->GetDensityMax(),
+                                                                                    outletValues->GetLocalIolet(0)->GetPressureMax());
+            }
 
             SetCommsRequired(inletValues, true);
             SetCommsRequired(outletValues, true);
@@ -249,19 +268,22 @@ namespace hemelb
             SetCommsRequired(inletValues, false);
             SetCommsRequired(outletValues, false);
 
-            for (unsigned int i = 0; i < inletValues->GetLocalIoletCount(); i++)
-            {
-              hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("Inlet[%i]: Measured Density is %f. Pressure is %f.",
-                                                                                    i,
-                                                                                    inletValues->GetLocalIolet(i)->GetDensity(GetState()->GetTimeStep()),
-                                                                                    inletValues->GetLocalIolet(i)->GetPressureMax());
-            }
-            for (unsigned int i = 0; i < outletValues->GetLocalIoletCount(); i++)
+            if (hemelb::log::Logger::ShouldDisplay<hemelb::log::Debug>())
             {
-              hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("Outlet[%i]: Measured Density is %f. Pressure is %f.",
-                                                                                    i,
-                                                                                    outletValues->GetLocalIolet(i)->GetDensity(GetState()->GetTimeStep()),
-                                                                                    outletValues->GetLocalIolet(i)->GetPressureMax());
+              for (unsigned int i = 0; i < inletValues->GetLocalIoletCount(); i++)
+              {
+                hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("Inlet[%i]: Measured Density is %f. Pressure is %f.",
+                                                                                      i,
+                                                                                      inletValues->GetLocalIolet(i)->GetDensity(GetState()->GetTimeStep()),
+                                                                                      inletValues->GetLocalIolet(i)->GetPressureMax());
+              }
+              for (unsigned int i = 0; i < outletValues->GetLocalIoletCount(); i++)
+              {
+                hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("Outlet[%i]: Measured Density is %f. Pressure is %f.",
+                                                                                      i,
+                                                                                      outletValues->GetLocalIolet(i)->GetDensity(GetState()->GetTimeStep()),
+                                                                                      outletValues->GetLocalIolet(i)->GetPressureMax());
+              }
             }
 
             /* Temporary Orchestration hardcode for testing 1/100 step ratio
@@ -283,6 +305,105 @@ namespace hemelb
         typename Intercommunicator::IntercommunicandTypeT multiscaleIoletType;
 
       private:
+        typedef std::vector<std::pair<site_t, int> > IoletSites;
+
+        /* Local sites next to an inlet or outlet, with the id of the iolet. */
+        IoletSites inletSites;
+        IoletSites outletSites;
+
+        /* How many exchanges with the coupled codes may be in flight, and how many are. */
+        unsigned int couplingLag;
+        unsigned int exchangesInFlight;
+
+        /* There is one exchange for all the iolets, so they all run at the largest lag any of
+         * them asks for. */
+        void AlignCouplingLags()
+        {
+          std::vector<lb::iolets::InOutLetMultiscale*> iolets;
+          for (unsigned int i = 0; i < inletValues->GetLocalIoletCount(); i++)
+          {
+            iolets.push_back(dynamic_cast<lb::iolets::InOutLetMultiscale*>(inletValues->GetLocalIolet(i)));
+          }
+          for (unsigned int i = 0; i < outletValues->GetLocalIoletCount(); i++)
+          {
+            iolets.push_back(dynamic_cast<lb::iolets::InOutLetMultiscale*>(outletValues->GetLocalIolet(i)));
+          }
+          iolets.erase(std::remove(iolets.begin(), iolets.end(), (lb::iolets::InOutLetMultiscale*) NULL),
+                       iolets.end());
+
+          for (unsigned int i = 0; i < iolets.size(); i++)
+          {
+            couplingLag = std::max(couplingLag, iolets[i]->GetCouplingLag());
+          }
+          if (couplingLag > 0 && !intercomms.OverlapsExchanges())
+          {
+            hemelb::log::Logger::Log<hemelb::log::Warning, hemelb::log::Singleton>("Ignoring the coupling lag of %u steps: this intercommunicator completes every exchange as it starts it.",
+                                                                                   couplingLag);
+            couplingLag = 0;
+          }
+          for (unsigned int i = 0; i < iolets.size(); i++)
+          {
+            iolets[i]->SetCouplingLag(couplingLag, iolets[i]->GetLagExtrapolation());
+          }
+        }
+
+        void FindIoletSites()
+        {
+          for (site_t siteIndex = 0; siteIndex < latticeData->GetLocalFluidSiteCount(); ++siteIndex)
+          {
+            const geometry::Site<geometry::LatticeData> site = latticeData->GetSite(siteIndex);
+            if (site.GetSiteType() == geometry::INLET_TYPE)
+            {
+              inletSites.push_back(std::make_pair(siteIndex, site.GetIoletId()));
+            }
+            else if (site.GetSiteType() == geometry::OUTLET_TYPE)
+            {
+              outletSites.push_back(std::make_pair(siteIndex, site.GetIoletId()));
+            }
+          }
+        }
+
+        /* Sets each multiscale iolet's flow rate out of the domain, on the BC proc. The layer of
+         * sites next to the iolet stands in for its cross-section, each site contributing the
+         * outward component of its velocity times a voxel's area. Every iolet is local to every
+         * process, so the local iolet indices are the iolet ids. */
+        void MeasureFlowRates(hemelb::lb::iolets::BoundaryValues* ioletValues,
+                              const IoletSites& sites)
+        {
+          const PhysicalDistance voxelSize = unitConverter->GetVoxelSize();
+          std::vector<double> flowRates(ioletValues->GetLocalIoletCount(), 0.0);
+
+          for (IoletSites::const_iterator it = sites.begin(); it != sites.end(); ++it)
+          {
+            const geometry::Site<geometry::LatticeData> site = latticeData->GetSite(it->first);
+            distribn_t density;
+            util::Vector3D<distribn_t> momentum;
+            latticeType::CalculateDensityAndMomentum(site.GetFOld<latticeType>(),
+                                                     density,
+                                                     momentum.x,
+                                                     momentum.y,
+                                                     momentum.z);
+            const PhysicalVelocity velocity =
+                unitConverter->ConvertVelocityToPhysicalUnits(momentum / density);
+
+            // The iolet normals point into the domain.
+            flowRates[it->second] -= velocity.Dot(ioletValues->GetLocalIolet(it->second)->GetNormal())
+                * voxelSize * voxelSize;
+          }
+
+          flowRates = ioComms.Reduce(flowRates, MPI_SUM, lb::iolets::BoundaryValues::GetBCProcRank());
+
+          if (ioComms.Rank() == lb::iolets::BoundaryValues::GetBCProcRank())
+          {
+            for (unsigned int i = 0; i < ioletValues->GetLocalIoletCount(); i++)
+            {
+              if (ioletValues->GetLocalIolet(i)->IsRegistrationRequired())
+              {
+                static_cast<lb::iolets::InOutLetMultiscale*>(ioletValues->GetLocalIolet(i))->SetFlowRate(flowRates[i]);
+              }
+            }
+          }
+        }
 
         /* Loops over iolets to set the need for communications. */
         void SetCommsRequired(hemelb::lb::iolets::BoundaryValues* ioletValues, bool b)
@@ -290,14 +411,17 @@ namespace hemelb
           hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("Starting SetCommsRequired.");
           for (unsigned int i = 0; i < ioletValues->GetLocalIoletCount(); i++)
           {
-            hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("In loop: %d",
-                                                                                  ioletValues->GetLocalIoletCount());
-            hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("A: iolet %d %d",
-                                                                                  i,
-                                                                                  (ioletValues->GetLocalIolet(i))->IsCommsRequired());
-            hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("B: iolet %d %d",
-                                                                                  i,
-                                                                                  static_cast<lb::iolets::InOutLetMultiscale*>(ioletValues->GetLocalIolet(i))->IsCommsRequired());
+            if (hemelb::log::Logger::ShouldDisplay<hemelb::log::Debug>())
+            {
+              hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("In loop: %d",
+                                                                                    ioletValues->GetLocalIoletCount());
+              hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("A: iolet %d %d",
+                                                                                    i,
+                                                                                    (ioletValues->GetLocalIolet(i))->IsCommsRequired());
+              hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("B: iolet %d %d",
+                                                                                    i,
+                                                                                    static_cast<lb::iolets::InOutLetMultiscale*>(ioletValues->GetLocalIolet(i))->IsCommsRequired());
+            }
             dynamic_cast<lb::iolets::InOutLetMultiscale*>(ioletValues->GetLocalIolet(i))->SetCommsRequired(b);
             hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("done with SetCommsRequired iteration.");
 
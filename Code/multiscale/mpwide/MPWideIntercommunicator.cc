@@ -14,6 +14,7 @@
 #include "multiscale/mpwide/MPWideIntercommunicator.h"
 #include "net/IOCommunicator.h"
 #include <MPWide.h>
+#include <algorithm>
 #include <cstring>
 
 namespace hemelb
@@ -29,10 +30,24 @@ namespace hemelb
                                                      std::string configFilePathIn) :
         isCommsProc(isCommsRank),
             configFilePath(configFilePathIn), recv_icand_data_size(0), send_icand_data_size(0),
-            doubleContents(buffer), currentTime(0), orchestration(orchestration), channelCount(0)
+            stopping(false), doubleContents(buffer), currentTime(0), orchestration(orchestration),
+            channelCount(0)
     {
     }
 
+    MPWideIntercommunicator::~MPWideIntercommunicator()
+    {
+      if (exchangeThread.joinable())
+      {
+        {
+          std::lock_guard<std::mutex> lock(exchangeMutex);
+          stopping = true;
+        }
+        exchangeQueued.notify_one();
+        exchangeThread.join();
+      }
+    }
+
     void MPWideIntercommunicator::Initialize()
     {
       if (isCommsProc)
@@ -68,22 +83,32 @@ namespace hemelb
         send_icand_data_size = GetRegisteredObjectsSize(registeredObjects);
         recv_icand_data_size = ExchangeICandDataSize(send_icand_data_size);
 
-        hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("PRE-MALLOC, icand sizes are: %i (send) %i (recv)",
+        hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("Icand sizes are: %i (send) %i (recv)",
                                                                               send_icand_data_size,
                                                                               recv_icand_data_size);
 
-        // 2. Allocate exchange buffers. We do this only once at initialization.
-        ICandRecvDataPacked.resize(recv_icand_data_size);
-        ICandSendDataPacked.resize(send_icand_data_size);
+        // 2. From now on, exchanges are made by a thread of their own.
+        if (!exchangeThread.joinable())
+        {
+          exchangeThread = std::thread(&MPWideIntercommunicator::ExchangeLoop, this);
+        }
       }
 
       // Update the time and perform an initial exchange with the multiscale.
       doubleContents["shared_time"] = 0.0;
-      ExchangeWithMultiscale();
+      QueueExchange();
+      CompleteMultiscale();
     }
 
     /* This is run at the start of every time step in the main HemeLB simulation. */
     bool MPWideIntercommunicator::DoMultiscale(double new_time)
+    {
+      bool shouldAdvance = StartMultiscale(new_time);
+      CompleteMultiscale();
+      return shouldAdvance;
+    }
+
+    bool MPWideIntercommunicator::StartMultiscale(double new_time)
     {
       // 1. Update the shared time, if we should take a time step.
       bool shouldAdvance = ShouldAdvance();
@@ -92,30 +117,90 @@ namespace hemelb
         UpdateSharedTime(new_time);
       }
 
-      // 2. Exchange ICands with the other code.
-      ExchangeWithMultiscale();
+      // 2. Start exchanging ICands with the other code.
+      QueueExchange();
 
       // 3. Return the bool telling HemeLB whether to perform a timestep.
       return shouldAdvance;
     }
 
-    void MPWideIntercommunicator::ExchangeWithMultiscale()
+    void MPWideIntercommunicator::QueueExchange()
     {
-      // 1. Pack/Serialize local shared data.
+      if (!isCommsProc)
+      {
+        return;
+      }
+
+      // Pack/Serialize local shared data, as it is now.
       hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("Beginning exchange with multiscale");
-      SerializeRegisteredObjects(&ICandSendDataPacked.front(), registeredObjects);
+      Exchange exchange;
+      exchange.sent.resize(send_icand_data_size);
+      exchange.received.resize(recv_icand_data_size);
+      exchange.done = false;
+      SerializeRegisteredObjects(exchange.sent.data(), registeredObjects);
+
+      {
+        std::lock_guard<std::mutex> lock(exchangeMutex);
+        exchanges.push_back(std::move(exchange));
+      }
+      exchangeQueued.notify_one();
+    }
 
-      // 2. Exchange serialized shared data.
-      hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("Exchanging packaged data");
-      ExchangePackages(&ICandSendDataPacked.front(), &ICandRecvDataPacked.front());
+    void MPWideIntercommunicator::CompleteMultiscale()
+    {
+      if (!isCommsProc)
+      {
+        return;
+      }
 
-      // 3. Unpack and merged the two serialized shared data copies.
+      std::unique_lock<std::mutex> lock(exchangeMutex);
+      if (exchanges.empty())
+      {
+        return;
+      }
+      exchangeDone.wait(lock, [this]
+      { return exchanges.front().done;});
+      Exchange exchange = std::move(exchanges.front());
+      exchanges.pop_front();
+      lock.unlock();
+
+      // Unpack and merged the two serialized shared data copies.
       hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("Unpacking and merging received data");
-      UnpackReceivedData(registeredObjects, &ICandRecvDataPacked.front());
+      UnpackReceivedData(registeredObjects, exchange.received.data());
 
       hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("Exchange with multiscale completed");
     }
 
+    void MPWideIntercommunicator::ExchangeLoop()
+    {
+      std::unique_lock<std::mutex> lock(exchangeMutex);
+      while (true)
+      {
+        std::deque<Exchange>::iterator next = std::find_if(exchanges.begin(),
+                                                           exchanges.end(),
+                                                           [](const Exchange& exchange)
+                                                           { return !exchange.done;});
+        if (next == exchanges.end())
+        {
+          if (stopping)
+          {
+            return;
+          }
+          exchangeQueued.wait(lock);
+          continue;
+        }
+
+        // The main thread only removes exchanges once they are done.
+        Exchange& exchange = *next;
+        lock.unlock();
+        ExchangePackages(exchange.sent.data(), exchange.received.data());
+        lock.lock();
+
+        exchange.done = true;
+        exchangeDone.notify_one();
+      }
+    }
+
     /* TODO: Only public for unit-testing. */
     void MPWideIntercommunicator::UnitTestIncrementSharedTime()
     {
@@ -261,7 +346,7 @@ namespace hemelb
 
         // For every field on the current intercommunicand...
         for (unsigned int sharedFieldIndex = 0;
-            sharedFieldIndex < icandContained.SharedValues().size(); sharedFieldIndex++)
+            sharedFieldIndex < icandType.Fields().size(); sharedFieldIndex++)
         {
           // Get info about it.
           std::string &sharedValueLabel = icandType.Fields()[sharedFieldIndex].first;
@@ -332,7 +417,7 @@ namespace hemelb
 
           // For every shared field...
           for (unsigned int sharedFieldIndex = 0;
-              sharedFieldIndex < icandContained.SharedValues().size(); sharedFieldIndex++)
+              sharedFieldIndex < icandType.Fields().size(); sharedFieldIndex++)
           {
             // Get the size of the current field
             size_t SharedValueSize = GetTypeSize(icandType.Fields()[sharedFieldIndex].second);
@@ -362,12 +447,11 @@ namespace hemelb
           intercommunicandData != registeredObjects.end(); intercommunicandData++)
       {
         // Get the contents of the iterator
-        hemelb::multiscale::Intercommunicand &sharedObject = *intercommunicandData->first;
         IntercommunicandTypeT &icandType = *intercommunicandData->second.first;
 
         // For every field that's shared,
         for (unsigned int sharedFieldIndex = 0;
-            sharedFieldIndex < sharedObject.SharedValues().size(); sharedFieldIndex++)
+            sharedFieldIndex < icandType.Fields().size(); sharedFieldIndex++)
         {
           // add the fields size to the total
           size += GetTypeSize(icandType.Fields()[sharedFieldIndex].second);
@@ -10,7 +10,11 @@
 #include <unistd.h>
 #include <cstdio>
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <functional>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <sstream>
 
@@ -50,6 +54,9 @@ namespace hemelb
      different in size however if they contain vectors individually.
      + We currently think this limitation actually encourages writing proper ICands.
 
+     - Exchanges after the initial one are made in order by a thread of their own on the comms
+     proc, so StartMultiscale only packs the shared values.
+
      This is a very dumb example of an intercommunicator. It stores communicated examples in a string-keyed buffer
      By sharing the same buffer between multiple intercommunicator interfaces, one can mock the behaviour of
      interprocess communication.
@@ -61,11 +68,23 @@ namespace hemelb
                                 std::map<std::string, double> & buffer,
                                 std::map<std::string, bool> &orchestration,
                                 std::string configFilePathIn);
+        /** Finishes the exchanges already started, which the partner expects. */
+        ~MPWideIntercommunicator();
         /** This is run at the start of the HemeLB simulation. */
         void ShareInitialConditions();
         /** This is run at the start of every time step in the main HemeLB simulation. */
         bool DoMultiscale(double new_time);
 
+        /** Packs the shared values and queues their exchange. */
+        bool StartMultiscale(double new_time);
+        /** Waits for the oldest exchange queued and unpacks what the partner sent. */
+        void CompleteMultiscale();
+
+        bool OverlapsExchanges() const
+        {
+          return true;
+        }
+
         /** TODO: Only public for unit-testing. */
         void UnitTestIncrementSharedTime();
 
@@ -83,9 +102,14 @@ namespace hemelb
         void UpdateSharedTime(double new_time);
 
         /**
-         * Performs the multiscale exchange over MPWide.
+         * Packs the shared values and queues their exchange over MPWide.
+         */
+        void QueueExchange();
+
+        /**
+         * Makes the queued exchanges, oldest first, until told to stop with none left.
          */
-        void ExchangeWithMultiscale();
+        void ExchangeLoop();
 
         /**
          * True if we should advance the current time.
@@ -161,12 +185,31 @@ namespace hemelb
         std::string configFilePath;
 
         /**
-         * Data sizes and pointers of shared data recv and send buffers.
+         * Data sizes of shared data recv and send buffers.
          */
         int64_t recv_icand_data_size;
         int64_t send_icand_data_size;
-        std::vector<char> ICandRecvDataPacked;
-        std::vector<char> ICandSendDataPacked;
+
+        /**
+         * An exchange of the packed shared data.
+         */
+        struct Exchange
+        {
+            std::vector<char> sent;
+            std::vector<char> received;
+            bool done;
+        };
+
+        /**
+         * Exchanges queued and not yet unpacked, oldest first. A deque doesn't move its elements
+         * as it grows, so the exchange thread can work on one without holding the lock.
+         */
+        std::deque<Exchange> exchanges;
+        std::thread exchangeThread;
+        std::mutex exchangeMutex;
+        std::condition_variable exchangeQueued;
+        std::condition_variable exchangeDone;
+        bool stopping;
 
         /**
          * Map of string to double for the shared time over the intercommunicand
@@ -0,0 +1,181 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "multiscale/reduced/ReducedOrderIntercommunicator.h"
+
+#include "log/Logger.h"
+
+namespace hemelb
+{
+  namespace multiscale
+  {
+    ReducedOrderIntercommunicator::ReducedOrderIntercommunicator(bool isBCRank,
+                                                                 ReducedOrderModel& model,
+                                                                 bool concurrent) :
+        isBCRank(isBCRank), model(model), concurrent(concurrent), currentTime(0.0), advancing(false),
+            pendingTimeStep(0.0), stopping(false)
+    {
+      if (isBCRank && concurrent)
+      {
+        worker = std::thread(&ReducedOrderIntercommunicator::WorkerLoop, this);
+      }
+    }
+
+    ReducedOrderIntercommunicator::~ReducedOrderIntercommunicator()
+    {
+      if (worker.joinable())
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          stopping = true;
+        }
+        advanceRequested.notify_one();
+        worker.join();
+      }
+    }
+
+    void ReducedOrderIntercommunicator::ShareInitialConditions()
+    {
+      if (!isBCRank)
+      {
+        return;
+      }
+
+      for (ContentsType::iterator it = registeredObjects.begin(); it != registeredObjects.end();
+          ++it)
+      {
+        if (!model.HasBoundary(it->second.second))
+        {
+          log::Logger::Log<log::Warning, log::Singleton>("No reduced order model is coupled to the iolet labelled %s",
+                                                         it->second.second.c_str());
+        }
+      }
+      SetPressures();
+    }
+
+    bool ReducedOrderIntercommunicator::DoMultiscale(double newTime)
+    {
+      if (!isBCRank)
+      {
+        currentTime = newTime;
+        return true;
+      }
+
+      const PhysicalTime timeStep = newTime - currentTime;
+      currentTime = newTime;
+
+      if (concurrent)
+      {
+        // Pick up the pressures from the step the model took alongside the last LB step.
+        WaitForAdvance();
+        SetFlowRates();
+        SetPressures();
+        StartAdvance(timeStep);
+      }
+      else
+      {
+        SetFlowRates();
+        model.Advance(timeStep);
+        SetPressures();
+      }
+      return true;
+    }
+
+    SharedValue<double>* ReducedOrderIntercommunicator::GetField(Intercommunicand& icand,
+                                                                 IntercommunicandTypeT& type,
+                                                                 const std::string& fieldLabel)
+    {
+      for (unsigned int field = 0; field < type.Fields().size(); ++field)
+      {
+        if (type.Fields()[field].first == fieldLabel
+            && type.Fields()[field].second == RuntimeTypeTraits::GetType<double>())
+        {
+          return static_cast<SharedValue<double>*>(icand.SharedValues()[field]);
+        }
+      }
+      return NULL;
+    }
+
+    void ReducedOrderIntercommunicator::SetFlowRates()
+    {
+      for (ContentsType::iterator it = registeredObjects.begin(); it != registeredObjects.end();
+          ++it)
+      {
+        const std::string& label = it->second.second;
+        SharedValue<double>* flowRate = GetField(*it->first, *it->second.first, "flowRate");
+        if (flowRate != NULL && model.HasBoundary(label))
+        {
+          model.SetFlowRate(label, flowRate->GetPayload());
+        }
+      }
+    }
+
+    void ReducedOrderIntercommunicator::SetPressures()
+    {
+      static const char* const pressureFields[] = { "pressure", "minPressure", "maxPressure" };
+
+      for (ContentsType::iterator it = registeredObjects.begin(); it != registeredObjects.end();
+          ++it)
+      {
+        const std::string& label = it->second.second;
+        if (!model.HasBoundary(label))
+        {
+          continue;
+        }
+
+        const PhysicalPressure pressure = model.GetPressure(label);
+        for (unsigned int field = 0; field < 3; ++field)
+        {
+          SharedValue<double>* value = GetField(*it->first, *it->second.first, pressureFields[field]);
+          if (value != NULL)
+          {
+            value->SetPayload(pressure);
+          }
+        }
+      }
+    }
+
+    void ReducedOrderIntercommunicator::StartAdvance(PhysicalTime timeStep)
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        pendingTimeStep = timeStep;
+        advancing = true;
+      }
+      advanceRequested.notify_one();
+    }
+
+    void ReducedOrderIntercommunicator::WaitForAdvance()
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      advanceFinished.wait(lock, [this]
+      { return !advancing;});
+    }
+
+    void ReducedOrderIntercommunicator::WorkerLoop()
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      while (true)
+      {
+        advanceRequested.wait(lock, [this]
+        { return advancing || stopping;});
+        if (!advancing)
+        {
+          return;
+        }
+
+        // The main thread only touches the model once advancing is cleared.
+        const PhysicalTime timeStep = pendingTimeStep;
+        lock.unlock();
+        model.Advance(timeStep);
+        lock.lock();
+
+        advancing = false;
+        advanceFinished.notify_one();
+      }
+    }
+  }
+}
@@ -0,0 +1,107 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_MULTISCALE_REDUCED_REDUCEDORDERINTERCOMMUNICATOR_H
+#define HEMELB_MULTISCALE_REDUCED_REDUCEDORDERINTERCOMMUNICATOR_H
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "multiscale/Intercommunicator.h"
+#include "multiscale/SharedValue.h"
+#include "multiscale/reduced/ReducedOrderModel.h"
+#include "net/mpi.h"
+
+namespace hemelb
+{
+  namespace multiscale
+  {
+    /***
+     * Runtime types as MPI datatypes, as for the MPWide intercommunicator.
+     */
+    struct ReducedOrderRuntimeType
+    {
+        typedef MPI_Datatype RuntimeType;
+        template<class T> static RuntimeType GetType()
+        {
+          return net::MpiDataTypeTraits<T>::GetMpiDataType();
+        }
+    };
+
+    /***
+     * Couples HemeLB's multiscale iolets to a reduced order model in the same process, in place of
+     * exchanging them with another code over MPWide.
+     *
+     * The model runs on the BC rank, which owns the iolet values and hands the pressures on to the
+     * other ranks. Every time step it is given the flow rate out through each coupled iolet (the
+     * intercommunicand's "flowRate" field) and sets the iolet's pressure fields from the model.
+     * There is never anything to wait for, so HemeLB advances on every step.
+     *
+     * If concurrent, the model advances on a thread of its own while the LB takes its step, and
+     * the state it reaches is used on the step after: an explicit coupling lagged by one LB time
+     * step, which is far shorter than the model's time constants. Otherwise it advances in place
+     * and its pressures are used on the same step.
+     */
+    class ReducedOrderIntercommunicator : public Intercommunicator<ReducedOrderRuntimeType>
+    {
+      public:
+        /***
+         * @param isBCRank True on the rank that runs the model
+         * @param model
+         * @param concurrent True to advance the model alongside the LB step
+         */
+        ReducedOrderIntercommunicator(bool isBCRank, ReducedOrderModel& model, bool concurrent);
+        ~ReducedOrderIntercommunicator();
+
+        /** Set the iolets to the model's initial pressures. */
+        void ShareInitialConditions();
+
+        /** Give the model the flow rates and the iolets the model's pressures. */
+        bool DoMultiscale(double newTime);
+
+        /** The model is driven by the flow rates. */
+        bool NeedsFlowRates() const
+        {
+          return true;
+        }
+
+      private:
+        ReducedOrderIntercommunicator(const ReducedOrderIntercommunicator&);
+        ReducedOrderIntercommunicator& operator=(const ReducedOrderIntercommunicator&);
+
+        /**
+         * The double field of an intercommunicand with the given label, or NULL if it has none.
+         */
+        static SharedValue<double>* GetField(Intercommunicand& icand,
+                                             IntercommunicandTypeT& type,
+                                             const std::string& fieldLabel);
+
+        void SetFlowRates();
+        void SetPressures();
+
+        void StartAdvance(PhysicalTime timeStep);
+        void WaitForAdvance();
+        void WorkerLoop();
+
+        const bool isBCRank;
+        ReducedOrderModel& model;
+        const bool concurrent;
+        double currentTime;
+
+        std::thread worker;
+        std::mutex mutex;
+        std::condition_variable advanceRequested;
+        std::condition_variable advanceFinished;
+        bool advancing;
+        PhysicalTime pendingTimeStep;
+        bool stopping;
+    };
+  }
+}
+
+#endif // HEMELB_MULTISCALE_REDUCED_REDUCEDORDERINTERCOMMUNICATOR_H
@@ -0,0 +1,67 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_MULTISCALE_REDUCED_REDUCEDORDERMODEL_H
+#define HEMELB_MULTISCALE_REDUCED_REDUCEDORDERMODEL_H
+
+#include <string>
+
+#include "units.h"
+
+namespace hemelb
+{
+  namespace multiscale
+  {
+    /***
+     * A reduced order (0D or 1D) model of the vasculature beyond some of HemeLB's iolets, run in
+     * the same process as HemeLB rather than as a separate code.
+     *
+     * Each iolet the model is coupled to is known by the label of its multiscale intercommunicand.
+     * HemeLB gives the model the volume flow rate out of the 3D domain through the iolet and takes
+     * back the pressure to impose there. Pressures are in mmHg, as for the multiscale iolets, and
+     * flow rates in m^3/s.
+     *
+     * A model is only used from one thread at a time: Advance may run on a thread of its own, but
+     * the flow rates are set and the pressures read while it isn't running.
+     */
+    class ReducedOrderModel
+    {
+      public:
+        virtual ~ReducedOrderModel()
+        {
+        }
+
+        /***
+         * True if the model is coupled to the iolet with this label.
+         * @param label
+         * @return
+         */
+        virtual bool HasBoundary(const std::string& label) const = 0;
+
+        /***
+         * Set the flow rate out of the 3D domain through an iolet, to be used by the next Advance.
+         * @param label
+         * @param flowRate
+         */
+        virtual void SetFlowRate(const std::string& label, double flowRate) = 0;
+
+        /***
+         * Get the pressure at an iolet, as of the last Advance.
+         * @param label
+         * @return
+         */
+        virtual PhysicalPressure GetPressure(const std::string& label) const = 0;
+
+        /***
+         * Advance the model by a time step, holding the flow rates at their last set values.
+         * @param timeStep
+         */
+        virtual void Advance(PhysicalTime timeStep) = 0;
+    };
+  }
+}
+
+#endif // HEMELB_MULTISCALE_REDUCED_REDUCEDORDERMODEL_H
@@ -0,0 +1,125 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "multiscale/reduced/WindkesselModel.h"
+
+#include <cmath>
+
+#include "Exception.h"
+#include "configuration/SimConfig.h"
+#include "io/xml/XmlAbstractionLayer.h"
+
+namespace hemelb
+{
+  namespace multiscale
+  {
+    WindkesselModel* WindkesselModel::Load(const std::string& path)
+    {
+      io::xml::Document xmlDoc(path);
+      const io::xml::Element root = xmlDoc.GetRoot();
+
+      WindkesselModel* model = new WindkesselModel();
+      for (io::xml::ChildIterator windkesselEl = root.IterChildren("windkessel");
+          !windkesselEl.AtEnd(); ++windkesselEl)
+      {
+        model->AddBoundary((*windkesselEl).GetChildOrThrow("label").GetAttributeOrThrow("value"),
+                           ReadWindkessel(*windkesselEl));
+      }
+      return model;
+    }
+
+    Windkessel WindkesselModel::ReadWindkessel(const io::xml::Element& windkesselEl)
+    {
+      Windkessel windkessel;
+      configuration::GetDimensionalValue(windkesselEl.GetChildOrThrow("proximal_resistance"),
+                                         "mmHg s/m^3",
+                                         windkessel.proximalResistance);
+      configuration::GetDimensionalValue(windkesselEl.GetChildOrThrow("compliance"),
+                                         "m^3/mmHg",
+                                         windkessel.compliance);
+      configuration::GetDimensionalValue(windkesselEl.GetChildOrThrow("distal_resistance"),
+                                         "mmHg s/m^3",
+                                         windkessel.distalResistance);
+
+      const io::xml::Element venousEl = windkesselEl.GetChildOrNull("venous_pressure");
+      if (venousEl != io::xml::Element::Missing())
+      {
+        configuration::GetDimensionalValue(venousEl, "mmHg", windkessel.venousPressure);
+      }
+      const io::xml::Element initialEl = windkesselEl.GetChildOrNull("initial_pressure");
+      if (initialEl != io::xml::Element::Missing())
+      {
+        configuration::GetDimensionalValue(initialEl, "mmHg", windkessel.initialPressure);
+      }
+
+      if (windkessel.proximalResistance < 0.0 || windkessel.compliance < 0.0
+          || windkessel.distalResistance <= 0.0)
+      {
+        throw Exception() << "Invalid Windkessel at " << windkesselEl.GetPath()
+            << ": resistances and compliance must not be negative, and the distal resistance must be positive";
+      }
+      return windkessel;
+    }
+
+    void WindkesselModel::AddBoundary(const std::string& label, const Windkessel& windkessel)
+    {
+      Boundary& boundary = boundaries[label];
+      boundary.windkessel = windkessel;
+      boundary.compliancePressure = windkessel.initialPressure;
+      boundary.flowRate = 0.0;
+    }
+
+    bool WindkesselModel::HasBoundary(const std::string& label) const
+    {
+      return boundaries.count(label) != 0;
+    }
+
+    void WindkesselModel::SetFlowRate(const std::string& label, double flowRate)
+    {
+      GetBoundary(label).flowRate = flowRate;
+    }
+
+    PhysicalPressure WindkesselModel::GetPressure(const std::string& label) const
+    {
+      const Boundary& boundary = GetBoundary(label);
+      return boundary.compliancePressure + boundary.windkessel.proximalResistance * boundary.flowRate;
+    }
+
+    void WindkesselModel::Advance(PhysicalTime timeStep)
+    {
+      for (std::map<std::string, Boundary>::iterator it = boundaries.begin(); it != boundaries.end();
+          ++it)
+      {
+        Boundary& boundary = it->second;
+        const Windkessel& windkessel = boundary.windkessel;
+
+        // C dP/dt = Q - (P - Pv) / Rd relaxes P towards Pv + Rd Q with time constant Rd C.
+        const PhysicalPressure steadyPressure = windkessel.venousPressure
+            + windkessel.distalResistance * boundary.flowRate;
+        const double decay = windkessel.compliance > 0.0 ?
+          std::exp(-timeStep / (windkessel.distalResistance * windkessel.compliance)) :
+          0.0;
+        boundary.compliancePressure = steadyPressure
+            + (boundary.compliancePressure - steadyPressure) * decay;
+      }
+    }
+
+    WindkesselModel::Boundary& WindkesselModel::GetBoundary(const std::string& label)
+    {
+      return const_cast<Boundary&>(static_cast<const WindkesselModel*>(this)->GetBoundary(label));
+    }
+
+    const WindkesselModel::Boundary& WindkesselModel::GetBoundary(const std::string& label) const
+    {
+      std::map<std::string, Boundary>::const_iterator it = boundaries.find(label);
+      if (it == boundaries.end())
+      {
+        throw Exception() << "No Windkessel is coupled to the iolet labelled " << label;
+      }
+      return it->second;
+    }
+  }
+}
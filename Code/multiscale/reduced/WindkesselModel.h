@@ -0,0 +1,107 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_MULTISCALE_REDUCED_WINDKESSELMODEL_H
+#define HEMELB_MULTISCALE_REDUCED_WINDKESSELMODEL_H
+
+#include <map>
+#include <string>
+
+#include "multiscale/reduced/ReducedOrderModel.h"
+
+namespace hemelb
+{
+  namespace io
+  {
+    namespace xml
+    {
+      class Element;
+    }
+  }
+  namespace multiscale
+  {
+    /***
+     * The parameters of a three element (RCR) Windkessel: a proximal resistance in series with a
+     * compliance, which drains through a distal resistance to the venous pressure.
+     *
+     * A compliance of zero leaves the two resistances in series, and a proximal resistance of zero
+     * gives a two element (RC) Windkessel.
+     */
+    struct Windkessel
+    {
+        Windkessel() :
+            proximalResistance(0.0), compliance(0.0), distalResistance(0.0), venousPressure(0.0),
+                initialPressure(0.0)
+        {
+        }
+
+        double proximalResistance; //!< mmHg s / m^3
+        double compliance; //!< m^3 / mmHg
+        double distalResistance; //!< mmHg s / m^3
+        PhysicalPressure venousPressure;
+        PhysicalPressure initialPressure; //!< Across the compliance at the start
+    };
+
+    /***
+     * A separate Windkessel at each coupled iolet.
+     *
+     * The compliance pressure is advanced exactly for a flow rate held constant over the step, so
+     * the model is stable for any time step, however small its time constant.
+     */
+    class WindkesselModel : public ReducedOrderModel
+    {
+      public:
+        /***
+         * Read a model from the <windkessel> elements of a reduced order model file, e.g.
+         *
+         * <reducedordermodel>
+         *   <windkessel>
+         *     <label value="outlet0"/>
+         *     <proximal_resistance value="1e7" units="mmHg s/m^3"/>
+         *     <compliance value="1e-9" units="m^3/mmHg"/>
+         *     <distal_resistance value="1e8" units="mmHg s/m^3"/>
+         *     <venous_pressure value="0" units="mmHg"/>
+         *     <initial_pressure value="80" units="mmHg"/>
+         *   </windkessel>
+         * </reducedordermodel>
+         *
+         * The venous and initial pressures are optional and default to zero.
+         * @param path
+         * @return
+         */
+        static WindkesselModel* Load(const std::string& path);
+
+        /***
+         * Couple a Windkessel to an iolet.
+         * @param label
+         * @param windkessel
+         */
+        void AddBoundary(const std::string& label, const Windkessel& windkessel);
+
+        virtual bool HasBoundary(const std::string& label) const;
+        virtual void SetFlowRate(const std::string& label, double flowRate);
+        virtual PhysicalPressure GetPressure(const std::string& label) const;
+        virtual void Advance(PhysicalTime timeStep);
+
+      private:
+        struct Boundary
+        {
+            Windkessel windkessel;
+            PhysicalPressure compliancePressure;
+            double flowRate;
+        };
+
+        static Windkessel ReadWindkessel(const io::xml::Element& windkesselEl);
+
+        Boundary& GetBoundary(const std::string& label);
+        const Boundary& GetBoundary(const std::string& label) const;
+
+        std::map<std::string, Boundary> boundaries;
+    };
+  }
+}
+
+#endif // HEMELB_MULTISCALE_REDUCED_WINDKESSELMODEL_H
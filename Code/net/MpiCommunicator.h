@@ -98,6 +98,18 @@ namespace hemelb
         template <typename T>
         std::vector<T> AllReduce(const std::vector<T>& vals, const MPI_Op& op) const;
 
+        /**
+         * Exclusive prefix reduction (MPI_Exscan): the reduction of val over all lower ranks.
+         * Rank 0 gets T().
+         * @param val
+         * @param op
+         * @return
+         */
+        template <typename T>
+        T ExScan(const T& val, const MPI_Op& op) const;
+        template <typename T>
+        std::vector<T> ExScan(const std::vector<T>& vals, const MPI_Op& op) const;
+
         template <typename T>
         T Reduce(const T& val, const MPI_Op& op, const int root) const;
         template <typename T>
@@ -105,6 +117,16 @@ namespace hemelb
 
         template <typename T>
         std::vector<T> Gather(const T& val, const int root) const;
+        /**
+         * Gather variable length vectors (MPI_Gatherv): the root gets the
+         * concatenation of vals from every rank, in rank order. Other ranks
+         * get an empty vector.
+         * @param vals
+         * @param root
+         * @return
+         */
+        template <typename T>
+        std::vector<T> GatherV(const std::vector<T>& vals, const int root) const;
 
         template <typename T>
         T Scatter(const std::vector<T>& vals, const int root) const;
@@ -117,6 +139,18 @@ namespace hemelb
         template <typename T>
         std::vector<T> AllToAll(const std::vector<T>& vals) const;
 
+        /**
+         * Personalised all-to-all exchange (MPI_Alltoallv). vals holds the
+         * data for each rank in turn, sendCounts[i] elements for rank i.
+         * @param vals
+         * @param sendCounts
+         * @param recvCounts (out) the number of elements received from each rank
+         * @return the received data, ordered by source rank
+         */
+        template <typename T>
+        std::vector<T> AllToAllV(const std::vector<T>& vals, const std::vector<int>& sendCounts,
+                                 std::vector<int>& recvCounts) const;
+
         template <typename T>
         void Send(const T& val, int dest, int tag=0) const;
         template <typename T>
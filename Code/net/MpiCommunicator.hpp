@@ -6,6 +6,7 @@
 #ifndef HEMELB_NET_MPICOMMUNICATOR_HPP
 #define HEMELB_NET_MPICOMMUNICATOR_HPP
 
+#include <algorithm>
 #include "net/MpiDataType.h"
 #include "net/MpiConstness.h"
 
@@ -52,6 +53,38 @@ namespace hemelb
       return ans;
     }
 
+    template<typename T>
+    T MpiCommunicator::ExScan(const T& val, const MPI_Op& op) const
+    {
+      T ans = T();
+      HEMELB_MPI_CALL(
+          MPI_Exscan,
+          (MpiConstCast(&val), &ans, 1, MpiDataType<T>(), op, *this)
+      );
+      // The receive buffer is undefined on rank 0
+      if (Rank() == 0)
+      {
+        ans = T();
+      }
+      return ans;
+    }
+
+    template<typename T>
+    std::vector<T> MpiCommunicator::ExScan(const std::vector<T>& vals, const MPI_Op& op) const
+    {
+      std::vector<T> ans(vals.size());
+      HEMELB_MPI_CALL(
+          MPI_Exscan,
+          (MpiConstCast(vals.data()), ans.data(), vals.size(), MpiDataType<T>(), op, *this)
+      );
+      // The receive buffer is undefined on rank 0
+      if (Rank() == 0)
+      {
+        std::fill(ans.begin(), ans.end(), T());
+      }
+      return ans;
+    }
+
     template<typename T>
     T MpiCommunicator::Reduce(const T& val, const MPI_Op& op, const int root) const
     {
@@ -105,6 +138,34 @@ namespace hemelb
       return ans;
     }
 
+    template<typename T>
+    std::vector<T> MpiCommunicator::GatherV(const std::vector<T>& vals, const int root) const
+    {
+      const int count = vals.size();
+      const std::vector<int> counts = Gather(count, root);
+
+      std::vector<T> ans;
+      std::vector<int> displacements;
+      if (Rank() == root)
+      {
+        displacements.resize(Size());
+        int total = 0;
+        for (int rank = 0; rank < Size(); ++rank)
+        {
+          displacements[rank] = total;
+          total += counts[rank];
+        }
+        ans.resize(total);
+      }
+      HEMELB_MPI_CALL(
+          MPI_Gatherv,
+          (MpiConstCast(vals.data()), count, MpiDataType<T>(),
+              ans.data(), MpiConstCast(counts.data()), MpiConstCast(displacements.data()),
+              MpiDataType<T>(), root, *this)
+      );
+      return ans;
+    }
+
     template <typename T>
     T MpiCommunicator::Scatter(const std::vector<T>& vals, const int root) const {
       T ans;
@@ -159,6 +220,33 @@ namespace hemelb
       return ans;
     }
 
+    template <typename T>
+    std::vector<T> MpiCommunicator::AllToAllV(const std::vector<T>& vals,
+                                              const std::vector<int>& sendCounts,
+                                              std::vector<int>& recvCounts) const
+    {
+      recvCounts = AllToAll(sendCounts);
+
+      std::vector<int> sendDispls(Size()), recvDispls(Size());
+      int sendTotal = 0, recvTotal = 0;
+      for (int i = 0; i < Size(); ++i)
+      {
+        sendDispls[i] = sendTotal;
+        sendTotal += sendCounts[i];
+        recvDispls[i] = recvTotal;
+        recvTotal += recvCounts[i];
+      }
+
+      std::vector<T> ans(recvTotal);
+      HEMELB_MPI_CALL(
+          MPI_Alltoallv,
+          (MpiConstCast(vals.data()), MpiConstCast(sendCounts.data()), MpiConstCast(sendDispls.data()), MpiDataType<T>(),
+           ans.data(), recvCounts.data(), recvDispls.data(), MpiDataType<T>(),
+           *this)
+      );
+      return ans;
+    }
+
     template <typename T>
     void MpiCommunicator::Send(const T& val, int dest, int tag) const
     {
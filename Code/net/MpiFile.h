@@ -59,6 +59,33 @@ namespace hemelb
         void Write(const std::vector<T>& buffer, MPI_Status* stat = MPI_STATUS_IGNORE);
         template<typename T>
         void WriteAt(MPI_Offset offset, const std::vector<T>& buffer, MPI_Status* stat = MPI_STATUS_IGNORE);
+
+        /**
+         * Collective versions of ReadAt/WriteAt (MPI_File_read_at_all and
+         * MPI_File_write_at_all). Every rank of the communicator must call these,
+         * even those with nothing to transfer.
+         */
+        template<typename T>
+        void ReadAtAll(MPI_Offset offset, T* buffer, int count, MPI_Status* stat = MPI_STATUS_IGNORE);
+        template<typename T>
+        void ReadAtAll(MPI_Offset offset, std::vector<T>& buffer, MPI_Status* stat = MPI_STATUS_IGNORE);
+
+        template<typename T>
+        void WriteAtAll(MPI_Offset offset, const T* buffer, int count, MPI_Status* stat = MPI_STATUS_IGNORE);
+        template<typename T>
+        void WriteAtAll(MPI_Offset offset, const std::vector<T>& buffer, MPI_Status* stat = MPI_STATUS_IGNORE);
+
+        /**
+         * Start a non-blocking write with MPI_File_iwrite_at. The buffer must
+         * not be modified or freed until the returned request has completed.
+         * @param offset
+         * @param buffer
+         * @return The request to wait on
+         */
+        template<typename T>
+        MPI_Request IWriteAt(MPI_Offset offset, const T* buffer, int count);
+        template<typename T>
+        MPI_Request IWriteAt(MPI_Offset offset, const std::vector<T>& buffer);
       protected:
         MpiFile(const MpiCommunicator& parentComm, MPI_File fh);
 
@@ -49,6 +49,50 @@ namespace hemelb
 
     }
 
+    template<typename T>
+    void MpiFile::ReadAtAll(MPI_Offset offset, T* buffer, int count, MPI_Status* stat)
+    {
+      HEMELB_MPI_CALL(
+          MPI_File_read_at_all,
+          (*filePtr, offset, buffer, count, MpiDataType<T>(), stat)
+      );
+    }
+    template<typename T>
+    void MpiFile::ReadAtAll(MPI_Offset offset, std::vector<T>& buffer, MPI_Status* stat)
+    {
+      ReadAtAll(offset, buffer.data(), buffer.size(), stat);
+    }
+
+    template<typename T>
+    void MpiFile::WriteAtAll(MPI_Offset offset, const T* buffer, int count, MPI_Status* stat)
+    {
+      HEMELB_MPI_CALL(
+          MPI_File_write_at_all,
+          (*filePtr, offset, MpiConstCast(buffer), count, MpiDataType<T>(), stat)
+      );
+    }
+    template<typename T>
+    void MpiFile::WriteAtAll(MPI_Offset offset, const std::vector<T>& buffer, MPI_Status* stat)
+    {
+      WriteAtAll(offset, buffer.data(), buffer.size(), stat);
+    }
+
+    template<typename T>
+    MPI_Request MpiFile::IWriteAt(MPI_Offset offset, const T* buffer, int count)
+    {
+      MPI_Request req;
+      HEMELB_MPI_CALL(
+          MPI_File_iwrite_at,
+          (*filePtr, offset, MpiConstCast(buffer), count, MpiDataType<T>(), &req)
+      );
+      return req;
+    }
+    template<typename T>
+    MPI_Request MpiFile::IWriteAt(MPI_Offset offset, const std::vector<T>& buffer)
+    {
+      return IWriteAt(offset, buffer.data(), buffer.size());
+    }
+
   }
 }
 
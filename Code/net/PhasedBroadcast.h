@@ -56,6 +56,7 @@ namespace hemelb
      * This class is made general using template parameters:
      *
      * initialAction = if true, an extra iteration occurs at the start of each broadcast cycle
+     *   (or several, see SetInitialActionLength)
      * splay = the number of consecutive iterations communication between a pair of nodes needs to
      *   go on for. Useful if the passed data is an array of variable length; one node can spend an
      *   iteration telling the other how many elements will be passed then the next iteration
@@ -72,7 +73,7 @@ namespace hemelb
         PhasedBroadcast(Net * iNet,
                         const lb::SimulationState * iSimState,
                         unsigned int spreadFactor) :
-                          mSimState(iSimState), mMyDepth(0), mTreeDepth(0), mNet(iNet)
+                          mSimState(iSimState), mMyDepth(0), mTreeDepth(0), mInitialActionLength(1), mNet(iNet)
         {
           // Calculate the correct values for the depth variables.
           proc_t noSeenToThisDepth = 1;
@@ -200,6 +201,18 @@ namespace hemelb
           }
         }
 
+        /**
+         * Sets the number of iterations between the initial action and the first communication,
+         * so that work started by the initial action can carry on while the simulation steps.
+         * Must not be changed while a broadcast is in progress.
+         *
+         * @param length
+         */
+        void SetInitialActionLength(unsigned long length)
+        {
+          mInitialActionLength = length;
+        }
+
         /**
          * Returns the total number of iterations spent doing a complete traversal -- all the way
          * down the tree and back up again.
@@ -209,7 +222,7 @@ namespace hemelb
         unsigned long GetRoundTripLength() const
         {
           unsigned long delayTime = initialAction
-            ? 1
+            ? mInitialActionLength
             : 0;
 
           unsigned long multiplier = (down
@@ -229,7 +242,7 @@ namespace hemelb
         unsigned long GetFirstDescending() const
         {
           return (initialAction
-            ? 1
+            ? mInitialActionLength
             : 0);
         }
 
@@ -389,6 +402,11 @@ namespace hemelb
         unsigned int mMyDepth;
         unsigned int mTreeDepth;
 
+        /**
+         * The number of iterations taken by the initial action, if there is one.
+         */
+        unsigned long mInitialActionLength;
+
         /**
          * This node's parent rank.
          */
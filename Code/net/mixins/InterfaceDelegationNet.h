@@ -137,6 +137,16 @@ namespace hemelb
           RequestReceiveImpl(pointer, count, rank, MpiDataType<T>());
         }
 
+        /**
+         * Send one element of a derived datatype built by the caller, such as an indexed type
+         * picking scattered elements out of an array. The caller owns the type, which must stay
+         * committed until the send has completed.
+         */
+        void RequestSend(void* pointer, MPI_Datatype type, proc_t rank)
+        {
+          RequestSendImpl(pointer, 1, rank, type);
+        }
+
         /*
          * Blocking gathers are implemented in MPI as a single call for both send/receive
          * But, here we separate send and receive parts, since this interface may one day be used for
@@ -0,0 +1,129 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef HAVE_PERF_EVENTS
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "reporting/HardwareCounters.h"
+
+namespace hemelb
+{
+  namespace reporting
+  {
+    const std::string HardwareCounters::eventNames[HardwareCounters::numberOfEvents] =
+        { "Cycles", "Instructions", "LLC references", "LLC misses" };
+
+    const unsigned int HardwareCounters::cacheLineLength;
+
+#ifdef HAVE_PERF_EVENTS
+    namespace
+    {
+      const uint64_t eventConfigs[HardwareCounters::numberOfEvents] =
+          { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_REFERENCES,
+            PERF_COUNT_HW_CACHE_MISSES };
+
+      int OpenEvent(uint64_t config, int groupLeader)
+      {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = groupLeader < 0;
+        // User space only, which is all the kernels run in and is allowed at the default
+        // perf_event_paranoid level.
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED
+            | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        return syscall(__NR_perf_event_open, &attr, 0, -1, groupLeader, 0);
+      }
+    }
+
+    HardwareCounters::HardwareCounters() :
+        leader(-1), openCount(0)
+    {
+      for (unsigned int event = 0; event < numberOfEvents; ++event)
+      {
+        descriptors[event] = OpenEvent(eventConfigs[event], leader);
+        if (descriptors[event] < 0)
+        {
+          continue;
+        }
+
+        if (leader < 0)
+        {
+          leader = descriptors[event];
+        }
+        positions[event] = openCount++;
+      }
+
+      if (leader >= 0)
+      {
+        ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+      }
+    }
+
+    HardwareCounters::~HardwareCounters()
+    {
+      for (unsigned int event = 0; event < numberOfEvents; ++event)
+      {
+        if (descriptors[event] >= 0)
+        {
+          close(descriptors[event]);
+        }
+      }
+    }
+
+    void HardwareCounters::Read(uint64_t counts[numberOfEvents]) const
+    {
+      // The group read gives the number of events, the times enabled and running, then the
+      // count of each.
+      uint64_t values[3 + numberOfEvents] = { 0 };
+      if (leader < 0 || read(leader, values, sizeof(values)) <= 0)
+      {
+        std::fill(counts, counts + numberOfEvents, 0);
+        return;
+      }
+
+      const double scale = (values[2] > 0 && values[2] < values[1]) ?
+        double(values[1]) / double(values[2]) :
+        1.0;
+
+      for (unsigned int event = 0; event < numberOfEvents; ++event)
+      {
+        counts[event] = IsCounting(Event(event)) ?
+          uint64_t(scale * double(values[3 + positions[event]])) :
+          0;
+      }
+    }
+#else
+    HardwareCounters::HardwareCounters() :
+        leader(-1), openCount(0)
+    {
+      std::fill(descriptors, descriptors + numberOfEvents, -1);
+    }
+
+    HardwareCounters::~HardwareCounters()
+    {
+    }
+
+    void HardwareCounters::Read(uint64_t counts[numberOfEvents]) const
+    {
+      std::fill(counts, counts + numberOfEvents, 0);
+    }
+#endif
+  }
+}
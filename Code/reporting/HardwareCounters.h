@@ -0,0 +1,78 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_REPORTING_HARDWARECOUNTERS_H
+#define HEMELB_REPORTING_HARDWARECOUNTERS_H
+
+#include <cstdint>
+#include <string>
+
+namespace hemelb
+{
+  namespace reporting
+  {
+    /**
+     * The CPU's performance counters for the calling thread, read through Linux perf_event.
+     *
+     * The events are opened as one group, so they are counted over the same interval and read
+     * with a single system call. Events the CPU or kernel won't count (perf_event_paranoid, no
+     * last level cache event, or not Linux at all) read as zero.
+     */
+    class HardwareCounters
+    {
+      public:
+        enum Event
+        {
+          cycles = 0, //!< CPU cycles
+          instructions, //!< Instructions retired
+          cacheReferences, //!< Last level cache references
+          cacheMisses, //!< Last level cache misses, each a line read from memory
+          numberOfEvents
+        };
+
+        static const std::string eventNames[numberOfEvents];
+
+        /**
+         * The bytes moved from memory by each last level cache miss.
+         */
+        static const unsigned int cacheLineLength = 64;
+
+        HardwareCounters();
+        ~HardwareCounters();
+
+        /**
+         * Whether the event is being counted.
+         * @param event
+         * @return
+         */
+        bool IsCounting(Event event) const
+        {
+          return descriptors[event] >= 0;
+        }
+
+        /**
+         * Read the count of each event since the counters were opened. If the kernel has had to
+         * share the counters with other users, the counts are scaled up to the whole interval.
+         * @param counts
+         */
+        void Read(uint64_t counts[numberOfEvents]) const;
+
+      private:
+        HardwareCounters(const HardwareCounters&);
+        HardwareCounters& operator=(const HardwareCounters&);
+
+        // The file descriptor of each event, or -1 if it is not counted. The first one opened
+        // leads the group.
+        int descriptors[numberOfEvents];
+        int leader;
+        // The position of each counted event in a group read.
+        unsigned int positions[numberOfEvents];
+        unsigned int openCount;
+    };
+  }
+}
+
+#endif /* HEMELB_REPORTING_HARDWARECOUNTERS_H */
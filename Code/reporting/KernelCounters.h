@@ -0,0 +1,175 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_REPORTING_KERNELCOUNTERS_H
+#define HEMELB_REPORTING_KERNELCOUNTERS_H
+
+#include <string>
+#include <vector>
+
+#include "units.h"
+#include "reporting/HardwareCounters.h"
+#include "reporting/Policies.h"
+#include "reporting/Reportable.h"
+
+namespace hemelb
+{
+  namespace reporting
+  {
+    /**
+     * Measures each stream-and-collide segment of the lattice Boltzmann step: the sites
+     * updated, the time taken and the hardware counters (see HardwareCounters) over it.
+     *
+     * The report gives, for each segment, the million lattice updates per second per core, the
+     * instructions per cycle, and the bytes read from memory per site update, which is what
+     * decides whether a kernel is memory bound. Each site update must move at least two sets
+     * of distributions, so that is reported for comparison. If HEMELB_PEAK_MEMORY_BANDWIDTH
+     * is set, the bandwidth achieved is also given as a fraction of it.
+     *
+     * @tparam ClockPolicy How to get the current time
+     * @tparam CommsPolicy How to share information between processes
+     */
+    template<class ClockPolicy, class CommsPolicy>
+    class KernelCountersBase : public ClockPolicy, public CommsPolicy, public Reportable
+    {
+      public:
+        /**
+         * The number of collision types, in the order of
+         * LatticeData::GetMidDomainCollisionCount.
+         */
+        static const unsigned int numberOfCollisionTypes = 6;
+
+        /**
+         * The first segment of each phase. The segment of a collision type in a phase is the
+         * phase plus the collision type.
+         */
+        enum Phase
+        {
+          preSend = 0, //!< LBM::PreSend, sites at the domain edge
+          preReceive = numberOfCollisionTypes //!< LBM::PreReceive, sites mid domain
+        };
+
+        static const unsigned int numberOfSegments = 2 * numberOfCollisionTypes;
+
+        static const std::string segmentNames[numberOfSegments];
+
+        /**
+         * @param comms
+         * @param numVectors The number of distributions at each site
+         */
+        KernelCountersBase(const net::IOCommunicator& comms, unsigned int numVectors);
+
+        /**
+         * Start measuring a segment.
+         */
+        void Start()
+        {
+          hardware.Read(startCounts);
+          startTime = ClockPolicy::CurrentTime();
+        }
+
+        /**
+         * Stop measuring, adding what was measured since Start to the segment.
+         * @param segment
+         * @param siteCount The sites updated
+         */
+        void Stop(unsigned int segment, site_t siteCount)
+        {
+          const double time = ClockPolicy::CurrentTime();
+          uint64_t counts[HardwareCounters::numberOfEvents];
+          hardware.Read(counts);
+
+          double* totals = &localTotals[segment * numberOfFields];
+          for (unsigned int event = 0; event < HardwareCounters::numberOfEvents; ++event)
+          {
+            totals[event] += double(counts[event] - startCounts[event]);
+          }
+          totals[siteUpdatesField] += double(siteCount);
+          totals[timeField] += time - startTime;
+        }
+
+        /**
+         * The total site updates of a segment on this process.
+         * @param segment
+         * @return
+         */
+        double GetLocalSiteUpdates(unsigned int segment) const
+        {
+          return localTotals[segment * numberOfFields + siteUpdatesField];
+        }
+
+        /**
+         * The total time spent in a segment on this process.
+         * @param segment
+         * @return
+         */
+        double GetLocalTime(unsigned int segment) const
+        {
+          return localTotals[segment * numberOfFields + timeField];
+        }
+
+        /**
+         * Following Reduce, the million site updates per second per core in a segment.
+         * @param segment
+         * @return
+         */
+        double GetMlups(unsigned int segment) const;
+
+        /**
+         * Following Reduce, the bytes read from memory per site update in a segment, or
+         * zero if last level cache misses are not counted on every process.
+         * @param segment
+         * @return
+         */
+        double GetBytesPerSiteUpdate(unsigned int segment) const;
+
+        /**
+         * Sum the measurements over all processes.
+         */
+        void Reduce();
+
+        void Report(Dict& dictionary);
+
+      private:
+        enum Field
+        {
+          siteUpdatesField = HardwareCounters::numberOfEvents,
+          timeField,
+          numberOfFields
+        };
+
+        double GetTotal(unsigned int segment, unsigned int field) const
+        {
+          return totals[segment * numberOfFields + field];
+        }
+
+        const unsigned int numVectors;
+        HardwareCounters hardware;
+        uint64_t startCounts[HardwareCounters::numberOfEvents];
+        double startTime;
+
+        std::vector<double> localTotals; //! The fields of each segment on this process
+        std::vector<double> totals; //! Sum across processes
+        std::vector<double> counted; //! Whether each event was counted on every process
+    };
+
+    typedef KernelCountersBase<HemeLBClockPolicy, MPICommsPolicy> KernelCounters;
+
+    template<class ClockPolicy, class CommsPolicy>
+    const std::string KernelCountersBase<ClockPolicy, CommsPolicy>::segmentNames[KernelCountersBase<
+        ClockPolicy, CommsPolicy>::numberOfSegments] = { "PreSend mid fluid", "PreSend wall",
+                                                         "PreSend inlet", "PreSend outlet",
+                                                         "PreSend inlet wall",
+                                                         "PreSend outlet wall",
+                                                         "PreReceive mid fluid",
+                                                         "PreReceive wall", "PreReceive inlet",
+                                                         "PreReceive outlet",
+                                                         "PreReceive inlet wall",
+                                                         "PreReceive outlet wall" };
+  }
+}
+
+#endif /* HEMELB_REPORTING_KERNELCOUNTERS_H */
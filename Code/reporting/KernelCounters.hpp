@@ -0,0 +1,155 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_REPORTING_KERNELCOUNTERS_HPP
+#define HEMELB_REPORTING_KERNELCOUNTERS_HPP
+
+#include <algorithm>
+
+#include "reporting/KernelCounters.h"
+#include "net/MpiDataType.h"
+
+namespace hemelb
+{
+  namespace reporting
+  {
+    template<class ClockPolicy, class CommsPolicy>
+    KernelCountersBase<ClockPolicy, CommsPolicy>::KernelCountersBase(const net::IOCommunicator& comms,
+                                                                     unsigned int numVectors) :
+        CommsPolicy(comms), numVectors(numVectors), startTime(0),
+            localTotals(numberOfSegments * numberOfFields, 0.0),
+            totals(numberOfSegments * numberOfFields, 0.0),
+            counted(HardwareCounters::numberOfEvents, 0.0)
+    {
+      std::fill(startCounts, startCounts + HardwareCounters::numberOfEvents, 0);
+    }
+
+    template<class ClockPolicy, class CommsPolicy>
+    void KernelCountersBase<ClockPolicy, CommsPolicy>::Reduce()
+    {
+      CommsPolicy::Reduce(&localTotals[0],
+                          &totals[0],
+                          numberOfSegments * numberOfFields,
+                          net::MpiDataType<double>(),
+                          MPI_SUM,
+                          0);
+
+      std::vector<double> localCounted(HardwareCounters::numberOfEvents);
+      for (unsigned int event = 0; event < HardwareCounters::numberOfEvents; ++event)
+      {
+        localCounted[event] = hardware.IsCounting(HardwareCounters::Event(event)) ?
+          1.0 :
+          0.0;
+      }
+      CommsPolicy::Reduce(&localCounted[0],
+                          &counted[0],
+                          HardwareCounters::numberOfEvents,
+                          net::MpiDataType<double>(),
+                          MPI_MIN,
+                          0);
+    }
+
+    template<class ClockPolicy, class CommsPolicy>
+    double KernelCountersBase<ClockPolicy, CommsPolicy>::GetMlups(unsigned int segment) const
+    {
+      const double time = GetTotal(segment, timeField);
+      return time > 0.0 ?
+        GetTotal(segment, siteUpdatesField) / time / 1e6 :
+        0.0;
+    }
+
+    template<class ClockPolicy, class CommsPolicy>
+    double KernelCountersBase<ClockPolicy, CommsPolicy>::GetBytesPerSiteUpdate(unsigned int segment) const
+    {
+      const double siteUpdates = GetTotal(segment, siteUpdatesField);
+      return (counted[HardwareCounters::cacheMisses] > 0.0 && siteUpdates > 0.0) ?
+        GetTotal(segment, HardwareCounters::cacheMisses) * HardwareCounters::cacheLineLength
+            / siteUpdates :
+        0.0;
+    }
+
+    template<class ClockPolicy, class CommsPolicy>
+    void KernelCountersBase<ClockPolicy, CommsPolicy>::Report(Dict& dictionary)
+    {
+      const bool countedCycles = counted[HardwareCounters::cycles] > 0.0
+          && counted[HardwareCounters::instructions] > 0.0;
+      const bool countedMisses = counted[HardwareCounters::cacheMisses] > 0.0;
+      const double peakBandwidth = HEMELB_PEAK_MEMORY_BANDWIDTH;
+
+      bool anyUpdates = false;
+      for (unsigned int segment = 0; segment < numberOfSegments; ++segment)
+      {
+        anyUpdates = anyUpdates || GetTotal(segment, siteUpdatesField) > 0.0;
+      }
+      if (!anyUpdates)
+      {
+        return;
+      }
+
+      Dict kernels = dictionary.AddSectionDictionary("KERNELS");
+      for (unsigned int segment = 0; segment < numberOfSegments; ++segment)
+      {
+        const double siteUpdates = GetTotal(segment, siteUpdatesField);
+        const double time = GetTotal(segment, timeField);
+        if (siteUpdates == 0.0)
+        {
+          continue;
+        }
+
+        Dict kernel = kernels.AddSectionDictionary("KERNEL");
+        kernel.SetValue("NAME", segmentNames[segment]);
+        kernel.SetFormattedValue("SITE_UPDATES", "%.4g", siteUpdates);
+        kernel.SetFormattedValue("TIME", "%.3g", time);
+        kernel.SetFormattedValue("MLUPS", "%.3g", GetMlups(segment));
+        kernel.SetFormattedValue("MIN_BYTES_PER_SITE",
+                                 "%.3g",
+                                 2.0 * numVectors * sizeof(distribn_t));
+
+        if (countedCycles)
+        {
+          const double cycles = GetTotal(segment, HardwareCounters::cycles);
+          kernel.SetFormattedValue("CYCLES_PER_SITE", "%.3g", cycles / siteUpdates);
+          kernel.SetFormattedValue("IPC",
+                                   "%.3g",
+                                   cycles > 0.0 ?
+                                     GetTotal(segment, HardwareCounters::instructions) / cycles :
+                                     0.0);
+        }
+        else
+        {
+          kernel.SetValue("CYCLES_PER_SITE", "n/a");
+          kernel.SetValue("IPC", "n/a");
+        }
+
+        if (countedMisses)
+        {
+          // Bandwidth per core, in GB/s.
+          const double bandwidth = time > 0.0 ?
+            GetBytesPerSiteUpdate(segment) * siteUpdates / time / 1e9 :
+            0.0;
+          kernel.SetFormattedValue("BYTES_PER_SITE", "%.3g", GetBytesPerSiteUpdate(segment));
+          kernel.SetFormattedValue("BANDWIDTH", "%.3g", bandwidth);
+          if (peakBandwidth > 0.0)
+          {
+            kernel.SetFormattedValue("ROOFLINE", "%.3g", bandwidth / peakBandwidth);
+          }
+          else
+          {
+            kernel.SetValue("ROOFLINE", "n/a");
+          }
+        }
+        else
+        {
+          kernel.SetValue("BYTES_PER_SITE", "n/a");
+          kernel.SetValue("BANDWIDTH", "n/a");
+          kernel.SetValue("ROOFLINE", "n/a");
+        }
+      }
+    }
+  }
+}
+
+#endif /* HEMELB_REPORTING_KERNELCOUNTERS_HPP */
@@ -116,7 +116,8 @@ namespace hemelb
           colloidCalculateForces,
           colloidUpdateCalculations,
           colloidOutput,
-          extractionWriting,
+          extractionWriting, //!< Time spent serialising extraction data and starting its writes
+          extractionWaiting, //!< Time spent waiting for earlier extraction writes to complete
           last
         //!< last, this has to be the last element of the enumeration so it can be used to track cardinality
         };
@@ -221,7 +222,7 @@ namespace hemelb
       "Move Counts Sending", "Move Data Sending", "Populating moves list for decomposition optimisation",
       "Initial geometry reading", "Colloid initialisation", "Colloid position communication",
       "Colloid velocity communication", "Colloid force calculations", "Colloid calculations for updating",
-      "Colloid outputting", "Extraction writing" };
+      "Colloid outputting", "Extraction writing", "Extraction I/O wait" };
   }
 
 }
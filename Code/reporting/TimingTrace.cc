@@ -0,0 +1,126 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "reporting/TimingTrace.h"
+#include "io/formats/formats.h"
+#include "io/formats/trace.h"
+#include "io/writers/xdr/XdrVectorWriter.h"
+#include "net/IOCommunicator.h"
+
+namespace hemelb
+{
+  namespace reporting
+  {
+    namespace fmt = hemelb::io::formats;
+
+    const unsigned int TimingTrace::numberOfTracedTimers;
+
+    const Timers::TimerName TimingTrace::tracedTimers[TimingTrace::numberOfTracedTimers] =
+        { Timers::lb, Timers::lb_calc, Timers::mpiSend, Timers::mpiWait, Timers::monitoring,
+          Timers::visualisation };
+
+    TimingTrace::TimingTrace(const net::IOCommunicator& comms, const std::string& path,
+                             unsigned int stepsPerBlock) :
+        comms(comms), stepsPerBlock(stepsPerBlock),
+            durations(stepsPerBlock * numberOfTracedTimers, 0.0F),
+            lastTotals(numberOfTracedTimers, 0.0), firstStep(0), stepCount(0), blocksWritten(0)
+    {
+      file = net::MpiFile::Open(comms, path, MPI_MODE_WRONLY | MPI_MODE_CREATE);
+      WritePreamble();
+    }
+
+    void TimingTrace::WritePreamble()
+    {
+      if (!comms.OnIORank())
+      {
+        return;
+      }
+
+      io::writers::xdr::XdrVectorWriter headerWriter;
+      headerWriter << uint32_t(fmt::HemeLbMagicNumber) << uint32_t(fmt::trace::MagicNumber)
+          << uint32_t(fmt::trace::VersionNumber);
+      // Placeholder for the byte order marker, which must not be byte swapped.
+      headerWriter << uint32_t(0);
+      headerWriter << uint32_t(comms.Size()) << uint32_t(numberOfTracedTimers)
+          << uint32_t(stepsPerBlock) << uint32_t(0);
+      assert(headerWriter.GetBuf().size() == fmt::trace::PreambleLength);
+
+      std::vector<char> buf = headerWriter.GetBuf();
+      const uint32_t marker = fmt::trace::ByteOrderMarker;
+      std::copy(reinterpret_cast<const char*>(&marker),
+                reinterpret_cast<const char*>(&marker) + sizeof(marker),
+                buf.begin() + 12);
+
+      for (unsigned int i = 0; i < numberOfTracedTimers; ++i)
+      {
+        const std::string& name = Timers::timerNames[tracedTimers[i]];
+        char paddedName[fmt::trace::NameLength] = { 0 };
+        std::strncpy(paddedName, name.c_str(), fmt::trace::NameLength - 1);
+        buf.insert(buf.end(), paddedName, paddedName + fmt::trace::NameLength);
+      }
+
+      file.WriteAt(0, buf);
+    }
+
+    void TimingTrace::Record(LatticeTimeStep timeStep, const Timers& timers)
+    {
+      if (stepCount == 0)
+      {
+        firstStep = timeStep;
+      }
+
+      float* step = &durations[stepCount * numberOfTracedTimers];
+      for (unsigned int i = 0; i < numberOfTracedTimers; ++i)
+      {
+        const double total = timers[tracedTimers[i]].Get();
+        step[i] = float(total - lastTotals[i]);
+        lastTotals[i] = total;
+      }
+
+      if (++stepCount == stepsPerBlock)
+      {
+        Flush();
+      }
+    }
+
+    void TimingTrace::Flush()
+    {
+      if (stepCount == 0)
+      {
+        return;
+      }
+
+      // A part-filled block, at the end of the run, is padded with zeros.
+      std::fill(durations.begin() + stepCount * numberOfTracedTimers, durations.end(), 0.0F);
+
+      const uint64_t blockOffset = fmt::trace::GetFirstBlockOffset(numberOfTracedTimers)
+          + blocksWritten * fmt::trace::GetBlockLength(comms.Size(), numberOfTracedTimers,
+                                                       stepsPerBlock);
+
+      if (comms.OnIORank())
+      {
+        char header[fmt::trace::BlockHeaderLength] = { 0 };
+        const uint64_t first = firstStep;
+        const uint32_t count = stepCount;
+        std::memcpy(header, &first, sizeof(first));
+        std::memcpy(header + sizeof(first), &count, sizeof(count));
+        file.WriteAt(blockOffset, std::vector<char>(header, header + fmt::trace::BlockHeaderLength));
+      }
+
+      file.WriteAtAll(blockOffset + fmt::trace::BlockHeaderLength
+                          + comms.Rank() * fmt::trace::GetSlabLength(numberOfTracedTimers,
+                                                                     stepsPerBlock),
+                      durations);
+
+      ++blocksWritten;
+      stepCount = 0;
+    }
+  }
+}
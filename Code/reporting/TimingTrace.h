@@ -0,0 +1,84 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_REPORTING_TIMINGTRACE_H
+#define HEMELB_REPORTING_TIMINGTRACE_H
+
+#include <string>
+#include <vector>
+
+#include "units.h"
+#include "net/MpiFile.h"
+#include "reporting/Timers.h"
+
+namespace hemelb
+{
+  namespace net
+  {
+    class IOCommunicator;
+  }
+  namespace reporting
+  {
+    /**
+     * Records how long each rank spends in the main per time step timers on every step, so
+     * imbalance that the end of run totals average away (one rank stalling in MPI wait now and
+     * then, say) can be found afterwards.
+     *
+     * The durations are kept in a buffer of a fixed number of steps. When it is full it is
+     * written to a trace file (see io/formats/trace.h) with one collective MPI-IO call, each rank
+     * writing its slab of the block at an offset it knows without communicating.
+     */
+    class TimingTrace
+    {
+      public:
+        static const unsigned int numberOfTracedTimers = 6;
+
+        /**
+         * The timers recorded, in the order they appear in the trace.
+         */
+        static const Timers::TimerName tracedTimers[numberOfTracedTimers];
+
+        /**
+         * Creates the trace file and writes its preamble. Collective on comms.
+         * @param comms
+         * @param path
+         * @param stepsPerBlock The number of time steps buffered between writes
+         */
+        TimingTrace(const net::IOCommunicator& comms, const std::string& path,
+                    unsigned int stepsPerBlock);
+
+        /**
+         * Records the time spent in each traced timer since the last call, as the durations for
+         * the given time step. Collective on comms when it fills the buffer.
+         * @param timeStep
+         * @param timers
+         */
+        void Record(LatticeTimeStep timeStep, const Timers& timers);
+
+        /**
+         * Writes any steps recorded since the last write. Collective on comms.
+         */
+        void Flush();
+
+      private:
+        void WritePreamble();
+
+        const net::IOCommunicator& comms;
+        const unsigned int stepsPerBlock;
+        net::MpiFile file;
+
+        // The durations of each recorded step, step by step.
+        std::vector<float> durations;
+        // The values of the traced timers at the last call to Record.
+        std::vector<double> lastTotals;
+        LatticeTimeStep firstStep;
+        unsigned int stepCount;
+        uint64_t blocksWritten;
+    };
+  }
+}
+
+#endif /* HEMELB_REPORTING_TIMINGTRACE_H */
@@ -8,36 +8,50 @@
 #define HEMELB_STEERING_CLIENTCONNECTION_H
 
 #include <netinet/in.h>
-#include <mutex>
-#include "reporting/Timers.h"
 
 namespace hemelb
 {
   namespace steering
   {
+    /**
+     * The socket steering clients connect to, and the connection to the current client.
+     *
+     * Only used from the steering network's I/O thread.
+     */
     class ClientConnection
     {
       public:
-        ClientConnection(int iSteeringSessionId, reporting::Timers & timings);
+        static const in_port_t MYPORT = 65250;
+
+        ClientConnection(int iSteeringSessionId);
         ~ClientConnection();
 
-        int GetWorkingSocket();
+        /**
+         * The non-blocking socket listening for clients, or -1 if there is none.
+         */
+        int GetListeningSocket() const;
+
+        /**
+         * The non-blocking socket connected to the current client, or -1 if there is none.
+         */
+        int GetWorkingSocket() const;
 
-        void ReportBroken(int iSocketNum);
+        /**
+         * Accepts a waiting client as the current one, if there is one.
+         * @return Whether a client was accepted
+         */
+        bool Accept();
+
+        /**
+         * Closes the connection to the current client.
+         */
+        void Close();
 
       private:
-        static const in_port_t MYPORT = 65250;
         static const unsigned int CONNECTION_BACKLOG = 10;
 
         int mCurrentSocket;
         int mListeningSocket;
-        bool mIsBroken;
-        // Use a semaphore to make sure that we don't create two new connections
-        // when a broken one is reported simultaneously by two separate threads
-        // (for example).
-        std::mutex mIsBusy;
-        reporting::Timers & timers;
-
     };
   }
 }
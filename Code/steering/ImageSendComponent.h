@@ -13,6 +13,7 @@
 #include "lb/LbmParameters.h"
 #include "steering/Network.h"
 #include "steering/basic/SimulationParameters.h"
+#include "steering/common/ImageEncoder.h"
 #include "vis/Control.h"
 
 namespace hemelb
@@ -32,6 +33,11 @@ namespace hemelb
         void SetMaxFramerate(float maxFramerate){
           MaxFramerate=maxFramerate;
         }
+        void SetEncoding(ImageEncoder::Encoding newEncoding, unsigned int newColourBits)
+        {
+          encoding = newEncoding;
+          colourBits = newColourBits;
+        }
         bool ShouldRenderNewNetworkImage();
 
         bool isConnected;
@@ -46,6 +52,13 @@ namespace hemelb
         std::unique_ptr<char[]> xdrSendBuffer;
         double lastRender;
 
+        // How the client has asked for the pixel data to be sent.
+        ImageEncoder::Encoding encoding;
+        unsigned int colourBits;
+        ImageEncoder encoder;
+        std::vector<char> rawPixels;
+        std::string encodedPixels;
+
         // data per pixel is
         // 1 * int (pixel index)
         // 3 * int (pixel RGB)
@@ -54,7 +67,8 @@ namespace hemelb
         // Sent data:
         // 2 * int (pixelsX, pixelsY)
         // 1 * int (bytes of pixel data)
-        // pixel data (variable, up to COLOURED_PIXELS_MAX * bytes_per_pixel_data)
+        // pixel data (variable, up to COLOURED_PIXELS_MAX * bytes_per_pixel_data raw, and less
+        // than that encoded)
         // SimulationParameters::paramsSizeB (metadata - mouse pressure and stress etc)
         static const unsigned int XdrIntLength = 4;
         static const unsigned int maxSendSize = 2 * XdrIntLength + 1 * XdrIntLength
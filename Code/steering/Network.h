@@ -7,45 +7,69 @@
 #ifndef HEMELB_STEERING_NETWORK_H
 #define HEMELB_STEERING_NETWORK_H
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <string>
+#include <thread>
 
 #include "steering/ClientConnection.h"
-#include "net/IteratedAction.h"
+#include "steering/common/HandoffQueue.h"
+#include "reporting/Timers.h"
 
 namespace hemelb
 {
   namespace steering
   {
-
-    class Network : public net::IteratedAction
+    /**
+     * The steering client's connection, run by a thread of its own on the IO proc.
+     *
+     * The thread owns the sockets and waits on them with poll, so the simulation never does
+     * network I/O. Frames to send and bytes received are handed between the threads through
+     * lock-free queues.
+     */
+    class Network
     {
       public:
         Network(int iSteeringSessionId, reporting::Timers & timings);
+        ~Network();
 
-        // Receive a bytestream of known length from a socket into a buffer.
+        // Receive a bytestream of known length from the client into a buffer, if that much
+        // has arrived.
         bool recv_all(char *buf, const int length);
 
-        // Send all bytes from a buffer of known length over a socket.
+        // Queue a buffer of known length to be sent to the client. If the client is too slow to
+        // take it, the buffer is dropped, so that the frames it gets stay current.
         bool send_all(const char *buf, const int length);
 
-        /**
-         * Use the time between MPI send and MPI receives being completed to perform the
-         * Network sends.
-         */
-        void PreReceive();
-
         bool IsConnected();
 
       private:
-        void Break(int socket);
+        static const unsigned int QUEUE_LENGTH = 4;
 
-        long sendInternal(const char* data, long length, int socket);
+        void Run();
+        void Wake();
 
         ClientConnection clientConnection;
+        reporting::Timers & timers;
 
-        // Buffers to keep the data from partial sends and receives.
-        std::string sendBuf;
+        // Simulation thread to I/O thread: whole frames.
+        HandoffQueue<std::string> outgoing;
+        // I/O thread to simulation thread: received bytes. An empty chunk marks a new client.
+        HandoffQueue<std::string> incoming;
+        // Received bytes not yet asked for, on the simulation thread.
         std::string recvBuf;
+
+        std::atomic<bool> connected;
+        std::atomic<bool> stopping;
+        // Written to wake the I/O thread from poll.
+        int wakePipe[2];
+
+        // Only used to wait for a client in wait on connect mode.
+        std::mutex connectionMutex;
+        std::condition_variable connectionChanged;
+
+        std::thread ioThread;
     };
 
   }
@@ -42,7 +42,9 @@ namespace hemelb
       StreaklinePerSimulation = 18,
       StreaklineLength = 19,
       MaxFramerate=20,
-      SetDoRendering = 21
+      ImageEncoding = 21,
+      ImageColourBits = 22,
+      SetDoRendering = 23
     };
 
     /**
@@ -85,7 +87,7 @@ namespace hemelb
       private:
         void AssignValues();
 
-        const static int STEERABLE_PARAMETERS = 21;
+        const static int STEERABLE_PARAMETERS = 23;
         const static unsigned int SPREADFACTOR = 10;
 
         bool isConnected;
@@ -11,6 +11,7 @@
 #include <csignal>
 #include <fcntl.h>
 #include <netinet/in.h>
+#include <sys/socket.h>
 
 #include "log/Logger.h"
 #include "steering/ClientConnection.h"
@@ -20,8 +21,23 @@ namespace hemelb
 {
   namespace steering
   {
-    ClientConnection::ClientConnection(int iSteeringSessionId, reporting::Timers & timings)
-      :mIsBusy(), timers(timings)
+    namespace
+    {
+      void SetNonBlocking(int socket)
+      {
+        int flags = fcntl(socket, F_GETFL, 0);
+        if (flags == -1)
+        {
+          flags = 0;
+        }
+        if (fcntl(socket, F_SETFL, flags | O_NONBLOCK) < 0)
+        {
+          perror("flags");
+        }
+      }
+    }
+
+    ClientConnection::ClientConnection(int iSteeringSessionId)
     {
       // Write the name of this machine to a file.
 
@@ -34,7 +50,6 @@ namespace hemelb
       }
 
       mCurrentSocket = -1;
-      mIsBroken = false;
 
       // Create the socket.
       mListeningSocket = socket(AF_INET, SOCK_STREAM, 0);
@@ -74,91 +89,52 @@ namespace hemelb
         perror("listen");
         exit(1);
       }
+
+      // The I/O thread polls for clients, so accepting should never block.
+      SetNonBlocking(mListeningSocket);
     }
 
     ClientConnection::~ClientConnection()
     {
-      close(mCurrentSocket);
+      Close();
       close(mListeningSocket);
     }
 
-    int ClientConnection::GetWorkingSocket()
+    int ClientConnection::GetListeningSocket() const
     {
-      // Lock the mutex and release it when this goes out of scope
-      std::lock_guard<std::mutex> lock(mIsBusy);
-
-      // If we haven't yet had a socket, or the current one is broken, open a new one.
-      if (mCurrentSocket < 0 || mIsBroken)
-      {
-        // Accept an incoming connection from the client.
-        struct sockaddr_in clientAddress;
-        socklen_t socketSize = sizeof (clientAddress);
-
-        int lOldSocket = mCurrentSocket;
+      return mListeningSocket;
+    }
 
-        // Make the socket non-blocking, just while we try to accept on it, then set
-        // it back to what it was before.
-        {
-          int flags = fcntl(mListeningSocket, F_GETFL, 0);
-          if (flags == -1)
-          {
-            flags = 0;
-          }
-#ifndef HEMELB_WAIT_ON_CONNECT
-          if (fcntl(mListeningSocket, F_SETFL, flags | O_NONBLOCK) < 0)
-          {
-            perror("flags");
-          }
-#else
-          log::Logger::Log<log::Info, log::Singleton>("Waiting for steering client connection");
-          timers[reporting::Timers::steeringWait].Start();
-
-#endif
-          // Try to accept a socket (from the non-blocking socket)
-          mCurrentSocket
-              = accept(mListeningSocket, (struct sockaddr *) &clientAddress, &socketSize);
-#ifdef HEMELB_WAIT_ON_CONNECT
-          timers[reporting::Timers::steeringWait].Stop();
-          log::Logger::Log<log::Debug, log::Singleton>("Continuing after receiving steering connection.");
-#endif
-          // We've got a socket - make that socket non-blocking too.
-          if (mCurrentSocket > 0)
-          {
-            log::Logger::Log<log::Info, log::Singleton>("Steering client connected");
-            flags = fcntl(mCurrentSocket, F_GETFL, 0);
-            if (flags == -1)
-            {
-              flags = 0;
-            }
-            if (fcntl(mCurrentSocket, F_SETFL, flags | O_NONBLOCK) < 0)
-            {
-              perror("flags");
-            }
-          }
-        }
+    int ClientConnection::GetWorkingSocket() const
+    {
+      return mCurrentSocket;
+    }
 
-        // If we had a socket before, close it.
-        if (lOldSocket > 0)
-        {
-          close(lOldSocket);
-        }
+    bool ClientConnection::Accept()
+    {
+      struct sockaddr_in clientAddress;
+      socklen_t socketSize = sizeof (clientAddress);
 
-        // We've only just created the socket so it shouldn't be broken.
-        mIsBroken = false;
+      int newSocket = accept(mListeningSocket, (struct sockaddr *) &clientAddress, &socketSize);
+      if (newSocket < 0)
+      {
+        return false;
       }
 
-      int lRet = mCurrentSocket;
-
-      return lRet;
+      // A new client replaces the old one.
+      Close();
+      log::Logger::Log<log::Info, log::Singleton>("Steering client connected");
+      SetNonBlocking(newSocket);
+      mCurrentSocket = newSocket;
+      return true;
     }
 
-    void ClientConnection::ReportBroken(int iSocketNum)
+    void ClientConnection::Close()
     {
-      // Lock the mutex and release it when this goes out of scope
-      std::lock_guard<std::mutex> lock(mIsBusy);
-      if (mCurrentSocket == iSocketNum)
+      if (mCurrentSocket >= 0)
       {
-        mIsBroken = true;
+        close(mCurrentSocket);
+        mCurrentSocket = -1;
       }
     }
 
@@ -27,7 +27,7 @@ namespace hemelb
       mNetwork(iNetwork), mSimState(iSimState), mVisControl(iControl),
       inletCount(inletCountIn), MaxFramerate(25.0),
       xdrSendBuffer(new char[maxSendSize]),
-      lastRender(0.0)
+      lastRender(0.0), encoding(ImageEncoder::Raw), colourBits(8)
     {
       // Suppress signals from a broken pipe.
       signal(SIGPIPE, SIG_IGN);
@@ -41,6 +41,8 @@ namespace hemelb
 
       if (!isConnected)
       {
+        // A new client has no previous frame to apply a delta to.
+        encoder.Reset();
         return;
       }
 
@@ -51,11 +53,35 @@ namespace hemelb
       // Write the dimensions of the image, in terms of pixel count.
       imageWriter << mVisControl->GetPixelsX() << mVisControl->GetPixelsY();
 
-      // Write the length of the pixel data
-      imageWriter << (int) (pix->GetPixelCount() * bytes_per_pixel_data);
+      if (encoding == ImageEncoder::Raw)
+      {
+        encoder.Reset();
+
+        // Write the length of the pixel data
+        imageWriter << (int) (pix->GetPixelCount() * bytes_per_pixel_data);
 
-      // Write the pixels themselves
-      mVisControl->WritePixels(&imageWriter, *pix, mVisControl->domainStats, mVisControl->visSettings);
+        // Write the pixels themselves
+        mVisControl->WritePixels(&imageWriter, *pix, mVisControl->domainStats, mVisControl->visSettings);
+      }
+      else
+      {
+        // Write the pixels to a scratch buffer and encode them from there.
+        rawPixels.resize(pix->GetPixelCount() * bytes_per_pixel_data);
+        io::writers::xdr::XdrMemWriter pixelWriter(rawPixels.data(), rawPixels.size());
+        mVisControl->WritePixels(&pixelWriter, *pix, mVisControl->domainStats, mVisControl->visSettings);
+
+        const ImageEncoder::Encoding frameEncoding = encoder.Encode(rawPixels.data(),
+                                                                    pix->GetPixelCount(),
+                                                                    mVisControl->GetPixelsX(),
+                                                                    mVisControl->GetPixelsY(),
+                                                                    encoding,
+                                                                    colourBits,
+                                                                    encodedPixels);
+
+        // Write the length of the encoded data: the tag, the encoding and the padded opaque.
+        imageWriter << (int) (3 * XdrIntLength + XdrIntLength * ( (encodedPixels.size() + 3) / XdrIntLength));
+        imageWriter << ImageEncoder::FrameTag << (uint32_t) frameEncoding << encodedPixels;
+      }
 
       // Write the numerical data from the simulation, wanted by the client.
       {
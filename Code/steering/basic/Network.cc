@@ -6,250 +6,259 @@
 
 #include <unistd.h>
 #include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
 #include <sys/types.h>
 #include <sys/socket.h>
-#include <netinet/in.h>
-#include <arpa/inet.h>
-#include <sys/wait.h>
-#include <csignal>
-#include <sys/stat.h>
 #include <cstdio>
 #include <cstring>
 
 #include "log/Logger.h"
 #include "steering/Network.h"
-#include "util/utilityFunctions.h"
+
+// Not every platform can suppress SIGPIPE per send; there we rely on it being ignored.
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
 
 namespace hemelb
 {
   namespace steering
   {
     Network::Network(int steeringSessionId, reporting::Timers & timings) :
-      clientConnection(steeringSessionId, timings)
+        clientConnection(steeringSessionId), timers(timings), outgoing(QUEUE_LENGTH),
+            incoming(16 * QUEUE_LENGTH), connected(false), stopping(false)
+    {
+      if (pipe(wakePipe) == -1)
+      {
+        perror("pipe");
+        exit(1);
+      }
+      for (int end = 0; end < 2; ++end)
+      {
+        fcntl(wakePipe[end], F_SETFL, fcntl(wakePipe[end], F_GETFL, 0) | O_NONBLOCK);
+      }
+
+      ioThread = std::thread(&Network::Run, this);
+    }
+
+    Network::~Network()
     {
+      stopping = true;
+      Wake();
+      ioThread.join();
 
+      close(wakePipe[0]);
+      close(wakePipe[1]);
     }
 
     /**
-     * Receive a bytestream of known length from a socket into a buffer.
+     * Receive a bytestream of known length from the client into a buffer.
      *
-     * @param sockid
      * @param buf
      * @param length
      * @return Returns true if we have successfully provided that much data.
      */
     bool Network::recv_all(char *buf, const int length)
     {
-      // Get a socket
-      int socketToClient = clientConnection.GetWorkingSocket();
-
-      if (socketToClient < 0)
-      {
-        return false;
-      }
-
-      ssize_t bytesGot = 0;
-      // If we have some buffered data to receive, include that in our count.
-      if (recvBuf.length() > 0)
-      {
-        bytesGot += recvBuf.length();
-      }
-
-      log::Logger::Log<log::Trace, log::Singleton>("Steering component will try to receive %d bytes, has %d so far",
-                                                   length,
-                                                   bytesGot);
-      // While some data left to be received...
-      while (bytesGot < length)
+      std::string chunk;
+      while (incoming.TryPop(chunk))
       {
-        // Receive some data (up to the remaining length)
-        ssize_t n = recv(socketToClient, buf + bytesGot, length - bytesGot, 0);
-
-        // If there was an error, report it and return.
-        if (n <= 0)
+        // Anything from a previous client is of no use.
+        if (chunk.empty())
         {
-          // If there was no data and it wasn't simply that the socket would block,
-          // raise an error.
-          if (errno != EAGAIN)
-          {
-            log::Logger::Log<log::Warning, log::Singleton>("Steering component: broken network pipe... (%s)",
-                                                           strerror(errno));
-            Break(socketToClient);
-          }
-          else
-          {
-            // If we'd already received some data, store this in the buffer for the start of the
-            // next receive.
-            if (bytesGot > 0)
-            {
-              // The newly-received-byte count is the total received byte count minus the length
-              // of the buffer.
-              long int numNewBytes = bytesGot - recvBuf.length();
-              recvBuf.append(buf + recvBuf.length(), numNewBytes);
-              log::Logger::Log<log::Trace, log::Singleton>("Steering component: blocked socket");
-            }
-          }
-          log::Logger::Log<log::Trace, log::Singleton>("Steering component exiting after incomplete reception");
-          // We didn't fully receive.
-          return false;
+          recvBuf.clear();
         }
         else
         {
-          bytesGot += n;
-          log::Logger::Log<log::Trace, log::Singleton>("Steering component: received bytes... (New total %d)", bytesGot);
+          recvBuf.append(chunk);
         }
       }
-      log::Logger::Log<log::Debug, log::Singleton>("Steering component is happy with what it has received");
-      // Successfully received what we needed to. Now use the buffer to fill in the gaps, if
-      // we were using the buffer at the front of the received data.
-      if (recvBuf.length() > 0)
-      {
-        // The length of buffer to use is the minimum of the buffer size and the length of
-        // the string.
-        int copyLength = util::NumericalFunctions::min((int) recvBuf.length(), length);
-
-        memcpy(buf, recvBuf.c_str(), copyLength);
 
-        // Empty that much of the buffer.
-        recvBuf.erase(0, copyLength);
+      if (recvBuf.length() < (size_t) length)
+      {
+        return false;
       }
 
+      memcpy(buf, recvBuf.data(), length);
+      recvBuf.erase(0, length);
       return true;
     }
 
-    void Network::PreReceive()
-    {
-      // Calling send_all will attempt to flush the send buffer.
-      send_all(NULL, 0);
-    }
-
     bool Network::IsConnected()
     {
-      int res = clientConnection.GetWorkingSocket();
-      return res > 0;
+#ifdef HEMELB_WAIT_ON_CONNECT
+      if (!connected)
+      {
+        log::Logger::Log<log::Info, log::Singleton>("Waiting for steering client connection");
+        timers[reporting::Timers::steeringWait].Start();
+        {
+          std::unique_lock<std::mutex> lock(connectionMutex);
+          connectionChanged.wait(lock, [this]
+          { return connected.load();});
+        }
+        timers[reporting::Timers::steeringWait].Stop();
+        log::Logger::Log<log::Debug, log::Singleton>("Continuing after receiving steering connection.");
+      }
+#endif
+      return connected;
     }
 
     /**
-     * Send all bytes from a buffer of known length over a socket.
+     * Queue all bytes from a buffer of known length to be sent to the client.
      *
-     * @param sockid
      * @param buf
      * @param length
-     * @return Returns the number of bytes sent or -1 on failure.
+     * @return Returns false if there is no client.
      */
     bool Network::send_all(const char *buf, const int length)
     {
-      // Get a socket.
-      int socketToClient = clientConnection.GetWorkingSocket();
-
-      // If there's no such socket, we don't have a connection. Nothing to do.
-      if (socketToClient < 0)
+      if (!connected)
       {
         return false;
       }
-      log::Logger::Log<log::Trace, log::Singleton>("Steering component will try to send %d new bytes and a buffer of %d",
-                                                   length,
-                                                   sendBuf.length());
-      // If we have buffered strings to be sent, send those first.
-      if (sendBuf.length() > 0)
-      {
-        long sent = sendInternal(sendBuf.c_str(), sendBuf.length(), socketToClient);
-
-        // Broken socket?
-        if (sent < 0)
-        {
-          return false;
-        }
-
-        // Did sending block? We'll try again next time.
-        if (sent < (long) sendBuf.length())
-        {
-          sendBuf.erase(0, sent);
 
-          // If the sending blocks, just ignore this most recent frame. This way, we stop the
-          // memory usage of the steering process spiralling, and keep current the images delivered
-          // to the client.
-          // What we *would* do is sendBuf.append(buf, length);
-
-          log::Logger::Log<log::Trace, log::Singleton>("Steering component could not send all buffer, managed %d bytes",
-                                                       sent);
-          return true;
-        }
-        // If not, we sent the whole buffer.
-        else
-        {
-          sendBuf.clear();
-        }
-      }
-      log::Logger::Log<log::Trace, log::Singleton>("Steering component sent all the buffer, sending new data");
-      // If we sent the whole buffer, try to send the new data.
-      long sent_bytes = sendInternal(buf, length, socketToClient);
-
-      // Is the socket broken?
-      if (sent_bytes < 0)
-      {
-        log::Logger::Log<log::Trace, log::Singleton>("Steering component socket broke sending new bytes");
-        return false;
-      }
-      // Did the socket block? Still return true, because we'll try again next time.
-      else if (sent_bytes < length)
+      std::string frame(buf, length);
+      if (!outgoing.TryPush(frame))
       {
-        log::Logger::Log<log::Trace, log::Singleton>("Steering component socket blocked after sending %d bytes, adding %d bytes to buffer",
-                                                     sent_bytes,
-                                                     length - sent_bytes);
-        sendBuf.append(buf + sent_bytes, length - sent_bytes);
+        log::Logger::Log<log::Trace, log::Singleton>("Steering client is behind, dropping %d bytes",
+                                                     length);
+        return true;
       }
-
-      // Otherwise we sent the whole thing.
+      Wake();
       return true;
     }
 
-    void Network::Break(int socket)
+    void Network::Wake()
     {
-      clientConnection.ReportBroken(socket);
-
-      recvBuf.clear();
-      sendBuf.clear();
+      const char byte = 0;
+      // If the pipe is full, the thread has wake-ups enough already.
+      ssize_t ignored = write(wakePipe[1], &byte, 1);
+      (void) ignored;
     }
 
-    /**
-     * Returns -1 for a broken socket, otherwise the number of bytes we could send before blocking.
-     *
-     * @param data
-     * @param length
-     * @param socket
-     * @return
-     */
-    long Network::sendInternal(const char* data, long length, int socket)
+    void Network::Run()
     {
-      long sent_bytes = 0;
+      // The frame being sent, and how much of it has gone.
+      std::string sendBuf;
+      size_t sent = 0;
+      // Bytes received but not yet handed over, and whether to tell of a new client first.
+      std::string received;
+      bool newClient = false;
+      char chunk[4096];
 
-      while (sent_bytes < length)
+      while (!stopping)
       {
-        long n = send(socket, data + sent_bytes, length - sent_bytes, 0);
+        const int socket = clientConnection.GetWorkingSocket();
+        if (socket >= 0 && sent == sendBuf.length())
+        {
+          sendBuf.clear();
+          sent = 0;
+          outgoing.TryPop(sendBuf);
+        }
 
-        if (n <= 0)
+        struct pollfd fds[2];
+        fds[0].fd = wakePipe[0];
+        fds[0].events = POLLIN;
+        fds[1].fd = socket >= 0 ?
+          socket :
+          clientConnection.GetListeningSocket();
+        fds[1].events = POLLIN | (sent < sendBuf.length() ?
+          POLLOUT :
+          0);
+        fds[0].revents = fds[1].revents = 0;
+
+        // If the simulation hasn't taken what we've received, come back for another go soon.
+        if (poll(fds, 2, (received.empty() && !newClient) ?
+          -1 :
+          10) < 0 && errno != EINTR)
         {
-          // Distinguish between cases where the pipe fails because it'd block
-          // (No problem, we'll try again later) or because the pipe is broken.
-          if (errno == EWOULDBLOCK)
+          log::Logger::Log<log::Warning, log::Singleton>("Steering network poll failed (%s)",
+                                                         strerror(errno));
+          return;
+        }
+
+        if (fds[0].revents & POLLIN)
+        {
+          while (read(wakePipe[0], chunk, sizeof(chunk)) > 0)
           {
-            return sent_bytes;
           }
-          else
+        }
+
+        if (socket < 0)
+        {
+          if ( (fds[1].revents & POLLIN) && clientConnection.Accept())
           {
-            log::Logger::Log<log::Info, log::Singleton>("Network send had broken pipe... (%s)", strerror(errno));
-            Break(socket);
+            // Start the new client afresh.
+            received.clear();
+            newClient = true;
+            while (outgoing.TryPop(sendBuf))
+            {
+            }
+            sendBuf.clear();
+            sent = 0;
 
-            return -1;
+            std::lock_guard<std::mutex> lock(connectionMutex);
+            connected = true;
+            connectionChanged.notify_all();
           }
         }
         else
         {
-          sent_bytes += n;
+          bool broken = false;
+
+          if (fds[1].revents & (POLLIN | POLLHUP | POLLERR))
+          {
+            while (true)
+            {
+              ssize_t n = recv(socket, chunk, sizeof(chunk), 0);
+              if (n > 0)
+              {
+                received.append(chunk, n);
+                continue;
+              }
+              broken = n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK);
+              break;
+            }
+          }
+
+          if (!broken && (fds[1].revents & POLLOUT))
+          {
+            ssize_t n = send(socket, sendBuf.data() + sent, sendBuf.length() - sent, MSG_NOSIGNAL);
+            if (n > 0)
+            {
+              sent += n;
+            }
+            else if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+              broken = true;
+            }
+          }
+
+          if (broken)
+          {
+            log::Logger::Log<log::Info, log::Singleton>("Steering client disconnected");
+            clientConnection.Close();
+            sendBuf.clear();
+            sent = 0;
+
+            std::lock_guard<std::mutex> lock(connectionMutex);
+            connected = false;
+            connectionChanged.notify_all();
+          }
         }
-      }
 
-      return sent_bytes;
+        // Hand over what we've received, once the simulation knows of any new client.
+        std::string empty;
+        if (newClient && incoming.TryPush(empty))
+        {
+          newClient = false;
+        }
+        if (!newClient && !received.empty() && incoming.TryPush(received))
+        {
+          received.clear();
+        }
+      }
     }
 
   }
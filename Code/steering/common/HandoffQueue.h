@@ -0,0 +1,76 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_STEERING_COMMON_HANDOFFQUEUE_H
+#define HEMELB_STEERING_COMMON_HANDOFFQUEUE_H
+
+#include <atomic>
+#include <vector>
+
+namespace hemelb
+{
+  namespace steering
+  {
+    /**
+     * A bounded ring handing items from one thread to one other, without locks.
+     *
+     * Neither side ever waits: pushing to a full ring and popping from an empty one fail, and
+     * the caller decides what to do instead.
+     */
+    template<typename T>
+    class HandoffQueue
+    {
+      public:
+        explicit HandoffQueue(unsigned int capacity) :
+            ring(capacity), pushed(0), popped(0)
+        {
+        }
+
+        /**
+         * Called only by the producer. Moves the item into the ring, unless it is full, leaving
+         * whatever it swapped out in item.
+         * @param item
+         * @return Whether the item was pushed
+         */
+        bool TryPush(T& item)
+        {
+          const unsigned long head = pushed.load(std::memory_order_relaxed);
+          if (head - popped.load(std::memory_order_acquire) == ring.size())
+          {
+            return false;
+          }
+          ring[head % ring.size()].swap(item);
+          pushed.store(head + 1, std::memory_order_release);
+          return true;
+        }
+
+        /**
+         * Called only by the consumer. Moves the oldest item out of the ring, unless it is empty.
+         * @param item
+         * @return Whether an item was popped
+         */
+        bool TryPop(T& item)
+        {
+          const unsigned long tail = popped.load(std::memory_order_relaxed);
+          if (tail == pushed.load(std::memory_order_acquire))
+          {
+            return false;
+          }
+          item.swap(ring[tail % ring.size()]);
+          popped.store(tail + 1, std::memory_order_release);
+          return true;
+        }
+
+      private:
+        std::vector<T> ring;
+        // The number of items ever pushed and popped; the ring holds the difference.
+        std::atomic<unsigned long> pushed;
+        std::atomic<unsigned long> popped;
+    };
+  }
+}
+
+#endif /* HEMELB_STEERING_COMMON_HANDOFFQUEUE_H */
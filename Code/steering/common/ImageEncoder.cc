@@ -0,0 +1,184 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <algorithm>
+#include <zlib.h>
+
+#include "steering/common/ImageEncoder.h"
+#include "Exception.h"
+
+namespace hemelb
+{
+  namespace steering
+  {
+    namespace
+    {
+      const unsigned int ColourBytes = 12;
+      const unsigned int BytesPerRawPixel = 4 + ColourBytes;
+
+      uint32_t GetXdrWord(const char* data)
+      {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+        return (uint32_t(bytes[0]) << 24) | (uint32_t(bytes[1]) << 16) | (uint32_t(bytes[2]) << 8)
+            | uint32_t(bytes[3]);
+      }
+
+      // Scatter the sparse raw pixels into the planes of a white frame, passing each colour
+      // byte through levels.
+      void FillPlanes(const char* pixelData, size_t pixelCount, int width, int height,
+                      const unsigned char levels[256], std::vector<unsigned char>& planes)
+      {
+        const size_t planeSize = size_t(width) * size_t(height);
+        planes.assign(ColourBytes * planeSize, 255);
+
+        for (size_t pixel = 0; pixel < pixelCount; ++pixel)
+        {
+          const char* raw = pixelData + BytesPerRawPixel * pixel;
+          const uint32_t index = GetXdrWord(raw);
+          const uint32_t x = index >> 16;
+          const uint32_t y = index & 0xFFFF;
+
+          // Pixels of an image rendered before a resize may fall outside it.
+          if (x >= uint32_t(width) || y >= uint32_t(height))
+          {
+            continue;
+          }
+
+          const size_t offset = size_t(y) * width + x;
+          for (unsigned int colour = 0; colour < ColourBytes; ++colour)
+          {
+            planes[colour * planeSize + offset] = levels[(unsigned char) raw[4 + colour]];
+          }
+        }
+      }
+    }
+
+    const uint32_t ImageEncoder::FrameTag;
+    const unsigned int ImageEncoder::KeyFrameInterval;
+
+    ImageEncoder::ImageEncoder() :
+        previousWidth(0), previousHeight(0), framesSinceKeyFrame(0)
+    {
+    }
+
+    void ImageEncoder::Reset()
+    {
+      previousFrame.clear();
+    }
+
+    ImageEncoder::Encoding ImageEncoder::Encode(const char* pixelData, unsigned int pixelCount,
+                                                int width, int height, Encoding encoding,
+                                                unsigned int colourBits, std::string& deflated)
+    {
+      const unsigned int bits = std::min(8u, std::max(1u, colourBits));
+      const unsigned int topLevel = (1u << bits) - 1;
+      unsigned char levels[256];
+      for (unsigned int value = 0; value < 256; ++value)
+      {
+        levels[value] = (unsigned char) ( ( (value >> (8 - bits)) * 255 + topLevel / 2) / topLevel);
+      }
+
+      FillPlanes(pixelData, pixelCount, width, height, levels, frame);
+
+      const bool keyFrame = encoding != DeltaDeflate || previousFrame.size() != frame.size()
+          || width != previousWidth || height != previousHeight
+          || framesSinceKeyFrame >= KeyFrameInterval;
+
+      const std::vector<unsigned char>* image = &frame;
+      if (!keyFrame)
+      {
+        delta.resize(frame.size());
+        for (size_t i = 0; i < frame.size(); ++i)
+        {
+          delta[i] = frame[i] ^ previousFrame[i];
+        }
+        image = &delta;
+      }
+
+      uLongf deflatedLength = compressBound(image->size());
+      deflated.resize(deflatedLength);
+      const int ret = compress2(reinterpret_cast<Bytef*>(&deflated[0]),
+                                &deflatedLength,
+                                image->data(),
+                                image->size(),
+                                Z_BEST_SPEED);
+      if (ret != Z_OK)
+      {
+        throw Exception() << "Compression of steering image failed with zlib error " << ret;
+      }
+      deflated.resize(deflatedLength);
+
+      previousFrame.swap(frame);
+      previousWidth = width;
+      previousHeight = height;
+      framesSinceKeyFrame = keyFrame ?
+        1 :
+        framesSinceKeyFrame + 1;
+
+      return keyFrame ?
+        Deflate :
+        DeltaDeflate;
+    }
+
+    void ImageDecoder::Decode(const char* data, size_t length, int width, int height,
+                              std::vector<unsigned char>& planes)
+    {
+      if (length < 4 || GetXdrWord(data) != ImageEncoder::FrameTag)
+      {
+        unsigned char identity[256];
+        for (unsigned int value = 0; value < 256; ++value)
+        {
+          identity[value] = (unsigned char) value;
+        }
+        FillPlanes(data, length / BytesPerRawPixel, width, height, identity, planes);
+        previousFrame = planes;
+        return;
+      }
+
+      if (length < 12)
+      {
+        throw Exception() << "Steering image frame of " << length << " bytes is too short";
+      }
+      const uint32_t encoding = GetXdrWord(data + 4);
+      const uint32_t deflatedLength = GetXdrWord(data + 8);
+      if (12 + size_t(deflatedLength) > length)
+      {
+        throw Exception() << "Steering image frame of " << length << " bytes holds "
+            << deflatedLength << " bytes of image";
+      }
+
+      planes.resize(ColourBytes * size_t(width) * size_t(height));
+      uLongf planesLength = planes.size();
+      const int ret = uncompress(planes.data(),
+                                 &planesLength,
+                                 reinterpret_cast<const Bytef*>(data + 12),
+                                 deflatedLength);
+      if (ret != Z_OK || planesLength != planes.size())
+      {
+        throw Exception() << "Decompression of steering image failed with zlib error " << ret;
+      }
+
+      switch (encoding)
+      {
+        case ImageEncoder::Deflate:
+          break;
+        case ImageEncoder::DeltaDeflate:
+          if (previousFrame.size() != planes.size())
+          {
+            throw Exception() << "Steering image delta frame has no matching previous frame";
+          }
+          for (size_t i = 0; i < planes.size(); ++i)
+          {
+            planes[i] ^= previousFrame[i];
+          }
+          break;
+        default:
+          throw Exception() << "Unknown steering image encoding " << encoding;
+      }
+      previousFrame = planes;
+    }
+  }
+}
@@ -0,0 +1,105 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_STEERING_COMMON_IMAGEENCODER_H
+#define HEMELB_STEERING_COMMON_IMAGEENCODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hemelb
+{
+  namespace steering
+  {
+    /**
+     * Encodes the pixel data of the images streamed to a steering client.
+     *
+     * A raw frame is the sparse list of pixels written by vis::Control::WritePixels: for each,
+     * an XDR word holding (x << 16) + y then its 12 colour bytes. An encoded frame is
+     *
+     *   FrameTag, encoding, deflated image (XDR variable-length opaque)
+     *
+     * where the image is the dense width x height frame stored as 12 planes, one per colour
+     * byte, with pixels not in the list white. For DeltaDeflate it is XORed with the previous
+     * frame first; successive frames of a steered simulation differ little, so this is mostly
+     * zeros. FrameTag can never start a raw frame, as no image is 65536 pixels wide and 18502
+     * high.
+     */
+    class ImageEncoder
+    {
+      public:
+        enum Encoding
+        {
+          Raw = 0,
+          Deflate = 1,
+          DeltaDeflate = 2
+        };
+
+        static const uint32_t FrameTag = 0xFFFF4846;
+
+        // A DeltaDeflate stream sends a whole frame this often, so a client can join it.
+        static const unsigned int KeyFrameInterval = 100;
+
+        ImageEncoder();
+
+        /**
+         * Forget the previous frame, so the next one is sent whole.
+         */
+        void Reset();
+
+        /**
+         * Encode the raw pixel data of a width x height image. Each colour byte is first
+         * rounded to one of 2^colourBits levels spread evenly between 0 and 255.
+         *
+         * @param pixelData
+         * @param pixelCount
+         * @param width
+         * @param height
+         * @param encoding Deflate or DeltaDeflate
+         * @param colourBits in [1, 8]; 8 is lossless
+         * @param deflated the deflated image
+         * @return the encoding used, which is Deflate for key frames
+         */
+        Encoding Encode(const char* pixelData, unsigned int pixelCount, int width, int height,
+                        Encoding encoding, unsigned int colourBits, std::string& deflated);
+
+      private:
+        std::vector<unsigned char> previousFrame;
+        std::vector<unsigned char> frame;
+        std::vector<unsigned char> delta;
+        int previousWidth;
+        int previousHeight;
+        unsigned int framesSinceKeyFrame;
+    };
+
+    /**
+     * The client side of ImageEncoder, which turns a stream of raw or encoded frames back into
+     * dense images.
+     */
+    class ImageDecoder
+    {
+      public:
+        /**
+         * Decode one frame's pixel data into the 12 colour planes of a width x height image.
+         *
+         * @param data
+         * @param length
+         * @param width
+         * @param height
+         * @param planes
+         */
+        void Decode(const char* data, size_t length, int width, int height,
+                    std::vector<unsigned char>& planes);
+
+      private:
+        std::vector<unsigned char> previousFrame;
+    };
+  }
+}
+
+#endif /* HEMELB_STEERING_COMMON_IMAGEENCODER_H */
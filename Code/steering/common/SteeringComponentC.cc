@@ -12,6 +12,9 @@ namespace hemelb
   {
     void SteeringComponent::AssignValues()
     {
+      // Any image still being rendered in the background is using the current settings.
+      mVisControl->WaitForRender();
+
       mVisControl->visSettings.ctr_x += privateSteeringParams[SceneCentreX];
       mVisControl->visSettings.ctr_y += privateSteeringParams[SceneCentreY];
       mVisControl->visSettings.ctr_z += privateSteeringParams[SceneCentreZ];
@@ -87,6 +90,14 @@ namespace hemelb
       if (imageSendComponent != NULL)
       {
         imageSendComponent->SetMaxFramerate(privateSteeringParams[MaxFramerate]);
+
+        int imageEncoding = (int) privateSteeringParams[ImageEncoding];
+        if (imageEncoding < ImageEncoder::Raw || imageEncoding > ImageEncoder::DeltaDeflate)
+        {
+          imageEncoding = ImageEncoder::Raw;
+        }
+        imageSendComponent->SetEncoding((ImageEncoder::Encoding) imageEncoding,
+                                        (unsigned int) privateSteeringParams[ImageColourBits]);
       }
       mVisControl->domainStats.density_threshold_min = lattice_density_min;
       mVisControl->domainStats.density_threshold_minmax_inv = 1.0F / (lattice_density_max - lattice_density_min);
@@ -146,6 +157,10 @@ namespace hemelb
 
       privateSteeringParams[MaxFramerate] = 25.0F;
 
+      // Image encoding (see ImageEncoder) and bits kept per colour
+      privateSteeringParams[ImageEncoding] = (float) ImageEncoder::Raw;
+      privateSteeringParams[ImageColourBits] = 8.0F;
+
       // Value of DoRendering
       privateSteeringParams[SetDoRendering] = 0.0F;
     }
@@ -24,8 +24,8 @@ namespace hemelb
      * @param iSteeringSessionId
      * @return
      */
-    ClientConnection::ClientConnection(int iSteeringSessionId, reporting::Timers & timings):
-        mIsBusy(), timers(timings)
+    ClientConnection::ClientConnection(int iSteeringSessionId) :
+        mCurrentSocket(-1), mListeningSocket(-1)
     {
     }
 
@@ -33,12 +33,22 @@ namespace hemelb
     {
     }
 
-    int ClientConnection::GetWorkingSocket()
+    int ClientConnection::GetListeningSocket() const
     {
       return -1;
     }
 
-    void ClientConnection::ReportBroken(int iSocketNum)
+    int ClientConnection::GetWorkingSocket() const
+    {
+      return -1;
+    }
+
+    bool ClientConnection::Accept()
+    {
+      return false;
+    }
+
+    void ClientConnection::Close()
     {
     }
 
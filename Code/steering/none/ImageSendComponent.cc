@@ -14,7 +14,7 @@ namespace hemelb
                                            vis::Control* iControl,
                                            const lb::LbmParameters* iLbmParams,
                                            Network* iNetwork,
-                                           unsigned int inletCountIn): inletCount(inletCountIn), MaxFramerate(25.0)
+                                           unsigned int inletCountIn): inletCount(inletCountIn), MaxFramerate(25.0), encoding(ImageEncoder::Raw), colourBits(8)
     {
 
     }
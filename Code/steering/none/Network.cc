@@ -24,15 +24,19 @@ namespace hemelb
   namespace steering
   {
     Network::Network(int steeringSessionId, reporting::Timers & timings) :
-      clientConnection(steeringSessionId, timings)
+        clientConnection(steeringSessionId), timers(timings), outgoing(1), incoming(1),
+            connected(false), stopping(false)
     {
 
     }
 
+    Network::~Network()
+    {
+    }
+
     /**
      * Do nothing.
      *
-     * @param sockid
      * @param buf
      * @param length
      * @return Returns true if we have successfully provided that much data.
@@ -42,10 +46,6 @@ namespace hemelb
       return false;
     }
 
-    void Network::PreReceive()
-    {
-    }
-
     bool Network::IsConnected()
     {
       return false;
@@ -54,32 +54,14 @@ namespace hemelb
     /**
      * Do nothing.
      *
-     * @param sockid
      * @param buf
      * @param length
-     * @return Returns the number of bytes sent or -1 on failure.
+     * @return Returns false if there is no client.
      */
     bool Network::send_all(const char *buf, const int length)
     {
       return false;
     }
 
-    void Network::Break(int socket)
-    {
-    }
-
-    /**
-     * Do nothing.
-     *
-     * @param data
-     * @param length
-     * @param socket
-     * @return
-     */
-    long Network::sendInternal(const char* data, long length, int socket)
-    {
-      return -1;
-    }
-
   }
 }
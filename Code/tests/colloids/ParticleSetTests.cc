@@ -0,0 +1,186 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "colloids/ParticleSet.h"
+#include "io/formats/colloids.h"
+#include "io/formats/formats.h"
+#include "io/writers/xdr/XdrMemReader.h"
+#include "io/xml/XmlAbstractionLayer.h"
+#include "lb/LbmParameters.h"
+#include "lb/MacroscopicPropertyCache.h"
+#include "lb/SimulationState.h"
+
+#include "tests/helpers/FourCubeLatticeData.h"
+#include "tests/helpers/FolderTestFixture.h"
+
+namespace hemelb
+{
+  namespace tests
+  {
+    TEST_CASE_METHOD(helpers::FolderTestFixture, "ParticleSetTests") {
+      const proc_t rankCount = Comms().Size();
+      const proc_t rank = Comms().Rank();
+
+      // A cube of fluid cut into slabs along x, one per rank, each thick
+      // enough that the middle of a slab is out of reach of the other ranks.
+      const site_t slabWidth = 6;
+      const site_t sitesPerBlockUnit = slabWidth * rankCount + 2;
+      auto slabOf = [&](site_t x) {
+	return proc_t((x - 1) / slabWidth);
+      };
+
+      geometry::Geometry geometry = FourCubeLatticeData::CreateGeometry(sitesPerBlockUnit);
+      site_t index = 0;
+      for (site_t i = 0; i < sitesPerBlockUnit; ++i)
+	for (site_t j = 0; j < sitesPerBlockUnit; ++j)
+	  for (site_t k = 0; k < sitesPerBlockUnit; ++k, ++index)
+	    if (geometry.Blocks[0].Sites[index].isFluid)
+	      geometry.Blocks[0].Sites[index].targetProcessor = slabOf(i);
+      geometry::LatticeData latticeData(lb::lattices::D3Q15::GetLatticeInfo(), geometry, Comms());
+
+      std::vector<proc_t> neighbourProcessors;
+      if (rank > 0)
+	neighbourProcessors.push_back(rank - 1);
+      if (rank + 1 < rankCount)
+	neighbourProcessors.push_back(rank + 1);
+
+      // The ranks within the colloid region of influence, two sites, of each
+      // local site, as ColloidController finds them for this decomposition.
+      colloids::ParticleSet::HaloRanks haloRanks;
+      for (site_t site = 0; site < latticeData.GetLocalFluidSiteCount(); ++site) {
+	const site_t x = latticeData.GetSite(site).GetGlobalSiteCoords().x;
+	std::vector<proc_t> siteHaloRanks;
+	for (site_t other = std::max(x - 2, site_t(1));
+	     other <= std::min(x + 2, slabWidth * rankCount); ++other) {
+	  const proc_t otherRank = slabOf(other);
+	  if (otherRank != rank
+	      && std::count(siteHaloRanks.begin(), siteHaloRanks.end(), otherRank) == 0)
+	    siteHaloRanks.push_back(otherRank);
+	}
+	if (!siteHaloRanks.empty())
+	  haloRanks[site] = siteHaloRanks;
+      }
+
+      // Three particles in each slab: in the middle, and by each face, within
+      // reach of the neighbour on that side.
+      std::ostringstream xml;
+      xml << "<particles>";
+      for (proc_t slab = 0; slab < rankCount; ++slab)
+	for (int offset = 1; offset <= 3; ++offset) {
+	  const LatticeDistance x = slab * slabWidth + (offset == 1 ? 3.5 : (offset == 2 ? 5.6 : 1.2));
+	  xml << "<subgridParticle ParticleId=\"" << 100 * slab + offset << "\" InputRadiusA0=\"0.1\""
+	      << " HydrostaticRadiusAh=\"0.2\" Mass=\"1.0\">"
+	      << "<initialPosition x=\"" << x << "\" y=\"3.5\" z=\"3.5\"/></subgridParticle>";
+	}
+      xml << "</particles>";
+      io::xml::Document document;
+      document.LoadString(xml.str());
+      io::xml::Element particlesElem = document.GetRoot();
+
+      lb::SimulationState simState(1e-4, 1000);
+      lb::LbmParameters lbmParams(1e-4, 1e-3);
+      lb::MacroscopicPropertyCache cache(simState, latticeData);
+      const std::string outputPath = GetSharedTempPath("particles.dat");
+
+      std::set<unsigned long> expectedLocal { 100ul * rank + 1, 100ul * rank + 2, 100ul * rank + 3 };
+      std::set<unsigned long> expectedReceived;
+      if (rank > 0)
+	expectedReceived.insert(100ul * (rank - 1) + 2);
+      if (rank + 1 < rankCount)
+	expectedReceived.insert(100ul * (rank + 1) + 3);
+
+      {
+	colloids::ParticleSet particleSet(latticeData, particlesElem, cache, &lbmParams,
+					  neighbourProcessors, haloRanks, Comms(), outputPath);
+
+	auto requireNeighbourOnly = [&]() {
+	  std::set<unsigned long> local, received;
+	  for (const colloids::Particle& particle : particleSet.GetParticles())
+	    (particle.GetOwnerRank() == rank ? local : received).insert(particle.GetParticleId());
+	  REQUIRE(expectedLocal == local);
+	  REQUIRE(expectedReceived == received);
+	};
+
+	particleSet.CommunicateParticlePositions();
+	requireNeighbourOnly();
+
+	// Nothing has moved, so the send types are reused.
+	particleSet.CommunicateParticlePositions();
+	requireNeighbourOnly();
+      }
+
+      if (Comms().OnIORank())
+	std::remove(outputPath.c_str());
+
+      // Enough output steps for the buffer to be written out once while the set
+      // is in use and once more when it is destroyed.
+      const std::string trajectoryPath = GetSharedTempPath("trajectory.dat");
+      const unsigned int outputSteps = colloids::ParticleSet::OutputBufferSteps + 3;
+      {
+	colloids::ParticleSet particleSet(latticeData, particlesElem, cache, &lbmParams,
+					  neighbourProcessors, haloRanks, Comms(), trajectoryPath);
+	for (unsigned int step = 0; step < outputSteps; ++step)
+	  particleSet.OutputInformation(10 * step);
+      }
+      MPI_Barrier(Comms());
+
+      std::ifstream trajectoryFile(trajectoryPath.c_str(), std::ios::binary);
+      const std::vector<char> trajectory((std::istreambuf_iterator<char>(trajectoryFile)),
+					 std::istreambuf_iterator<char>());
+
+      // A block for each step: a header, then three records from each rank in rank order.
+      const size_t rankLength = 3 * io::formats::colloids::RecordLength;
+      const size_t blockLength = io::formats::colloids::HeaderLength + rankCount * rankLength;
+      REQUIRE(trajectory.size() == io::formats::colloids::MagicLength + outputSteps * blockLength);
+
+      io::writers::xdr::XdrMemReader magic(trajectory.data(), io::formats::colloids::MagicLength);
+      REQUIRE(magic.read<uint32_t>() == io::formats::HemeLbMagicNumber);
+      REQUIRE(magic.read<uint32_t>() == io::formats::colloids::MagicNumber);
+      REQUIRE(magic.read<uint32_t>() == io::formats::colloids::VersionNumber);
+
+      for (unsigned int step = 0; step < outputSteps; ++step) {
+	const size_t blockStart = io::formats::colloids::MagicLength + step * blockLength;
+	io::writers::xdr::XdrMemReader header(trajectory.data() + blockStart,
+					      io::formats::colloids::HeaderLength);
+	REQUIRE(header.read<uint32_t>() == io::formats::colloids::HeaderLength);
+	REQUIRE(header.read<uint32_t>() == io::formats::colloids::RecordLength);
+	REQUIRE(header.read<uint64_t>() == rankCount * rankLength);
+	REQUIRE(header.read<uint64_t>() == 10 * step);
+
+	// This rank's particles, in the order they were configured.
+	io::writers::xdr::XdrMemReader records(trajectory.data() + blockStart
+					       + io::formats::colloids::HeaderLength
+					       + rank * rankLength,
+					       rankLength);
+	for (int offset = 1; offset <= 3; ++offset) {
+	  REQUIRE(records.read<uint64_t>() == uint64_t(rank));
+	  REQUIRE(records.read<uint64_t>() == 100ul * rank + offset);
+	  REQUIRE(records.read<double>() == Approx(0.1));
+	  REQUIRE(records.read<double>() == Approx(0.2));
+	  const double x = rank * slabWidth + (offset == 1 ? 3.5 : (offset == 2 ? 5.6 : 1.2));
+	  REQUIRE(records.read<double>() == Approx(x));
+	  REQUIRE(records.read<double>() == Approx(3.5));
+	  REQUIRE(records.read<double>() == Approx(3.5));
+	}
+      }
+
+      trajectoryFile.close();
+      MPI_Barrier(Comms());
+      if (Comms().OnIORank())
+	std::remove(trajectoryPath.c_str());
+    }
+  }
+}
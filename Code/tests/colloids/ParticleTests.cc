@@ -0,0 +1,141 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <sstream>
+
+#include <catch2/catch.hpp>
+
+#include "colloids/Particle.h"
+#include "io/xml/XmlAbstractionLayer.h"
+#include "lb/MacroscopicPropertyCache.h"
+
+#include "tests/helpers/ApproxVector.h"
+#include "tests/helpers/FourCubeBasedTestFixture.h"
+
+namespace hemelb
+{
+  namespace tests
+  {
+    using colloids::Particle;
+
+    namespace
+    {
+      // The modified Peskin delta function, evaluated in three dimensions at once
+      // as the per-particle interpolation did.
+      Dimensionless PeskinDelta(const LatticePosition& relativePosition)
+      {
+	Dimensionless delta = 1.0;
+	for (int xyz = 0; xyz < 3; xyz++) {
+	  const LatticeDistance rmod = std::fabs(relativePosition[xyz]);
+	  if (rmod <= 1.0)
+	    delta *= 0.125*(3.0 - 2.0*rmod + std::sqrt(1.0 + 4.0*rmod - 4.0*rmod*rmod));
+	  else if (rmod <= 2.0)
+	    delta *= 0.125*(5.0 - 2.0*rmod - std::sqrt(-7.0 + 12.0*rmod - 4.0*rmod*rmod));
+	  else
+	    delta = 0.0;
+	}
+	return delta;
+      }
+
+      // Interpolate the fluid velocity at a point by looking up every site of
+      // the stencil afresh, as the per-particle interpolation did.
+      LatticeVelocity InterpolateDirectly(const LatticePosition& position,
+					  const geometry::LatticeData& latDat,
+					  const lb::MacroscopicPropertyCache& cache)
+      {
+	LatticeVelocity velocity = LatticeVelocity::Zero();
+	for (site_t x = ((site_t)position.x)-1; x < ((site_t)position.x)+3; x++)
+	  for (site_t y = ((site_t)position.y)-1; y < ((site_t)position.y)+3; y++)
+	    for (site_t z = ((site_t)position.z)-1; z < ((site_t)position.z)+3; z++) {
+	      const util::Vector3D<site_t> site(x, y, z);
+	      proc_t procId;
+	      site_t siteId;
+	      if (!latDat.GetContiguousSiteId(site, procId, siteId) || procId != latDat.GetLocalRank())
+		continue;
+
+	      LatticePosition relativePosition(site);
+	      relativePosition -= position;
+	      velocity += cache.velocityCache.Get(siteId) * PeskinDelta(relativePosition);
+	    }
+	return velocity;
+      }
+    }
+
+    TEST_CASE_METHOD(helpers::FourCubeBasedTestFixture, "ParticleTests") {
+      // Fluid sites from 1 to 6 along each axis, so stencils can sit clear of the walls.
+      auto latticeData = std::unique_ptr<FourCubeLatticeData>{FourCubeLatticeData::Create(Comms(), 8)};
+      lb::MacroscopicPropertyCache cache(*simState, *latticeData);
+      for (site_t i = 0; i < latticeData->GetLocalFluidSiteCount(); ++i) {
+	const util::Vector3D<site_t>& site = latticeData->GetSite(i).GetGlobalSiteCoords();
+	cache.velocityCache.Put(i, util::Vector3D<distribn_t>(0.01 * site.x - 0.02 * site.z,
+							      0.03 * site.y,
+							      0.001 * site.x * site.y));
+      }
+
+      auto makeParticle = [&](unsigned long id, const LatticePosition& position) {
+	std::ostringstream xml;
+	xml << "<SubgridParticle ParticleId=\"" << id << "\" InputRadiusA0=\"0.1\""
+	    << " HydrostaticRadiusAh=\"0.2\" Mass=\"1.0\">"
+	    << "<initialPosition x=\"" << position.x << "\" y=\"" << position.y
+	    << "\" z=\"" << position.z << "\"/></SubgridParticle>";
+	io::xml::Document document;
+	document.LoadString(xml.str());
+	io::xml::Element element = document.GetRoot();
+	return Particle(*latticeData, lbmParams, element);
+      };
+
+      std::vector<Particle> particles;
+      // Clear of the walls, against a corner, and exactly on a site
+      particles.push_back(makeParticle(1, LatticePosition(3.3, 3.5, 3.7)));
+      particles.push_back(makeParticle(2, LatticePosition(1.2, 5.9, 2.5)));
+      particles.push_back(makeParticle(3, LatticePosition(4.0, 4.0, 4.0)));
+
+      auto requireSameAsDirect = [&]() {
+	for (const Particle& particle : particles) {
+	  // No body forces are applied, so this is just the interpolated fluid velocity.
+	  REQUIRE(ApproxV(InterpolateDirectly(particle.GetGlobalPosition(), *latticeData, cache))
+		  == particle.GetVelocity());
+	}
+      };
+
+      SECTION("BatchMatchesPerParticle") {
+	Particle::InterpolateFluidVelocities(particles, *latticeData, cache);
+	requireSameAsDirect();
+      }
+
+      SECTION("CachedStencilFollowsParticles") {
+	Particle::InterpolateFluidVelocities(particles, *latticeData, cache);
+
+	// Move each particle by a set step: first within its cell, so the
+	// cached stencil is reused, then into a different cell.
+	auto moveBy = [&](const LatticePosition& step) {
+	  for (Particle& particle : particles) {
+	    LatticeVelocity adjustment = step - particle.GetVelocity();
+	    particle.AccumulateVelocity(adjustment);
+	    particle.UpdatePosition(*latticeData);
+	  }
+	};
+	moveBy(LatticePosition(0.05, -0.05, 0.1));
+	Particle::InterpolateFluidVelocities(particles, *latticeData, cache);
+	requireSameAsDirect();
+
+	moveBy(LatticePosition(1.1, -0.6, 0.4));
+	Particle::InterpolateFluidVelocities(particles, *latticeData, cache);
+	requireSameAsDirect();
+      }
+
+      SECTION("CachedStencilSurvivesReordering") {
+	Particle::InterpolateFluidVelocities(particles, *latticeData, cache);
+	std::reverse(particles.begin(), particles.end());
+	Particle::InterpolateFluidVelocities(particles, *latticeData, cache);
+	requireSameAsDirect();
+      }
+    }
+  }
+}
@@ -0,0 +1,86 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <fstream>
+#include <sstream>
+
+#include <catch2/catch.hpp>
+
+#include "configuration/InputFiles.h"
+#include "net/IOCommunicator.h"
+#include "resources/Resource.h"
+#include "tests/helpers/HasCommsTestFixture.h"
+
+namespace hemelb
+{
+  namespace tests
+  {
+    using configuration::InputFiles;
+    using resources::Resource;
+
+    namespace
+    {
+      std::string ReadDirectly(const std::string& path)
+      {
+	std::ifstream file(path.c_str());
+	std::ostringstream text;
+	text << file.rdbuf();
+	return text.str();
+      }
+    }
+
+    TEST_CASE_METHOD(helpers::HasCommsTestFixture, "InputFilesTests") {
+      const std::string ioletPath = Resource("iolet.txt").Path();
+      const std::string velocityPath = Resource("velocity_inlet.txt").Path();
+
+      SECTION("ReadFromDisk") {
+	InputFiles files;
+	REQUIRE(!files.Has(ioletPath));
+
+	const std::string& contents = files.Read(ioletPath);
+	REQUIRE(ReadDirectly(ioletPath) == contents);
+	REQUIRE(files.Has(ioletPath));
+	// Read once, then held
+	REQUIRE(&contents == &files.Read(ioletPath));
+
+	REQUIRE_THROWS_AS(files.Read(ioletPath + ".missing"), Exception);
+      }
+
+      SECTION("SerialiseRoundTrip") {
+	InputFiles files;
+	files.Read(ioletPath);
+	files.Read(velocityPath);
+
+	InputFiles copy;
+	copy.Deserialise(files.Serialise());
+	REQUIRE(copy.Has(ioletPath));
+	REQUIRE(copy.Has(velocityPath));
+	REQUIRE(files.Read(ioletPath) == copy.Read(ioletPath));
+	REQUIRE(files.Read(velocityPath) == copy.Read(velocityPath));
+
+	// The copy must not go to the disk for anything it was not sent.
+	REQUIRE_THROWS_AS(copy.Read(Resource("xmltest.xml").Path()), Exception);
+      }
+
+      SECTION("Broadcast") {
+	const net::IOCommunicator& comms = Comms();
+	InputFiles files;
+	if (comms.OnIORank())
+	{
+	  files.Read(ioletPath);
+	}
+
+	files.Broadcast(comms, comms.GetIORank());
+	REQUIRE(files.Has(ioletPath));
+	REQUIRE(ReadDirectly(ioletPath) == files.Read(ioletPath));
+	if (!comms.OnIORank())
+	{
+	  REQUIRE_THROWS_AS(files.Read(velocityPath), Exception);
+	}
+      }
+    }
+  }
+}
@@ -9,6 +9,7 @@
 #include <catch2/catch.hpp>
 
 #include "configuration/SimConfig.h"
+#include "lb/SimulationState.h"
 #include "resources/Resource.h"
 #include "tests/helpers/FolderTestFixture.h"
 #include "tests/helpers/LaddFail.h"
@@ -81,6 +82,26 @@ namespace hemelb
 	REQUIRE(boost::apply_visitor(CfgChecker{}, ICconfig));
       }
 
+      SECTION("BroadcastRead") {
+	LADD_FAIL();
+	// Only the IO rank reads the iolet's profile, but every rank
+	// must end up with it.
+	if (Comms().OnIORank())
+	  CopyResourceToTempdir("iolet.txt");
+	auto config = std::unique_ptr<SimConfig>(SimConfig::New(resources::Resource("config_file_inlet.xml").Path(),
+								Comms()));
+	REQUIRE(40000lu == config->GetTotalTimeSteps());
+
+	const util::UnitConverter& converter = config->GetUnitConverter();
+	auto inlet = dynamic_cast<lb::iolets::InOutLetFile*>(config->GetInlets()[0]);
+	REQUIRE(inlet != nullptr);
+	lb::SimulationState state(config->GetTimeStepLength(), config->GetTotalTimeSteps());
+	inlet->Initialise(&converter);
+	inlet->Reset(state);
+	REQUIRE(Approx(78.0) == converter.ConvertPressureToPhysicalUnits(inlet->GetPressureMin()));
+	REQUIRE(Approx(82.0) == converter.ConvertPressureToPhysicalUnits(inlet->GetPressureMax()));
+      }
+
     }
   }
 }
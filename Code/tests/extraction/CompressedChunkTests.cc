@@ -0,0 +1,78 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "extraction/CompressedChunk.h"
+#include "io/formats/extraction.h"
+
+namespace hemelb
+{
+  namespace tests
+  {
+    namespace {
+      // A smooth field, like most extracted quantities.
+      std::vector<float> MakeValues(size_t n) {
+	std::vector<float> values(n);
+	for (size_t i = 0; i < n; ++i)
+	  values[i] = 1.0f + 1e-3f * std::sin(0.01 * i);
+	return values;
+      }
+
+      uint32_t Codec(const std::vector<char>& chunk) {
+	return io::formats::extraction::GetLittleEndian<uint32_t>(chunk.data());
+      }
+    }
+
+    TEST_CASE("CompressedChunk") {
+      const std::vector<float> values = MakeValues(1000);
+      std::vector<char> chunk;
+
+      SECTION("Lossless") {
+	extraction::CompressChunk(values, 0.0, chunk);
+	REQUIRE(Codec(chunk) == uint32_t(io::formats::extraction::ShuffleDeflate));
+	REQUIRE(chunk.size() < 4 * values.size());
+
+	auto decoded = extraction::DecompressChunk(chunk.data(), chunk.size());
+	REQUIRE(decoded == values);
+      }
+
+      SECTION("Lossy") {
+	const double tolerance = 1e-5;
+	extraction::CompressChunk(values, tolerance, chunk);
+	REQUIRE(Codec(chunk) == uint32_t(io::formats::extraction::QuantisedShuffleDeflate));
+
+	std::vector<char> lossless;
+	extraction::CompressChunk(values, 0.0, lossless);
+	REQUIRE(chunk.size() < lossless.size());
+
+	auto decoded = extraction::DecompressChunk(chunk.data(), chunk.size());
+	REQUIRE(decoded.size() == values.size());
+	for (size_t i = 0; i < values.size(); ++i)
+	  REQUIRE(std::abs(decoded[i] - values[i]) <= tolerance);
+      }
+
+      SECTION("LossyFallsBackToLossless") {
+	std::vector<float> unquantisable = values;
+	unquantisable[3] = std::numeric_limits<float>::infinity();
+	extraction::CompressChunk(unquantisable, 1e-5, chunk);
+	REQUIRE(Codec(chunk) == uint32_t(io::formats::extraction::ShuffleDeflate));
+	REQUIRE(extraction::DecompressChunk(chunk.data(), chunk.size()) == unquantisable);
+      }
+
+      SECTION("Appends") {
+	chunk.assign(8, 'x');
+	extraction::CompressChunk(values, 0.0, chunk);
+	REQUIRE(chunk[7] == 'x');
+	REQUIRE(extraction::DecompressChunk(chunk.data() + 8, chunk.size() - 8) == values);
+      }
+    }
+  }
+}
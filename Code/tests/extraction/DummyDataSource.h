@@ -65,6 +65,11 @@ namespace hemelb
             location = 0 - 1;
           }
 
+          void SeekTo(site_t siteIndex)
+          {
+            location = siteIndex;
+          }
+
           bool ReadNext()
           {
             ++location;
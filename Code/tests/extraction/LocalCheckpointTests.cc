@@ -0,0 +1,109 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <cstdio>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "io/formats/checkpoint.h"
+#include "extraction/CheckpointOutputFile.h"
+#include "extraction/LocalCheckpointInput.h"
+#include "extraction/LocalCheckpointOutput.h"
+
+#include "tests/helpers/FourCubeBasedTestFixture.h"
+
+namespace hemelb
+{
+  namespace tests
+  {
+    namespace {
+      const char* tempChkFileName = "simple.chk";
+      typedef lb::lattices:: HEMELB_LATTICE LatticeType;
+
+      // Values that do not survive a round trip through float.
+      distribn_t MakeF(site_t site, Direction dir, int generation) {
+	return generation + 1.0 / 3.0 + site * 1e-9 + dir * 1e-13;
+      }
+
+      void FillFOld(FourCubeLatticeData* latDat, int generation) {
+	distribn_t fs[LatticeType::NUMVECTORS];
+	for (site_t i = 0; i < latDat->GetLocalFluidSiteCount(); ++i) {
+	  for (Direction dir = 0; dir < LatticeType::NUMVECTORS; ++dir)
+	    fs[dir] = MakeF(i, dir, generation);
+	  latDat->SetFOld<LatticeType>(i, fs);
+	}
+      }
+
+      void CheckFs(FourCubeLatticeData* latDat, int generation) {
+	for (site_t i = 0; i < latDat->GetLocalFluidSiteCount(); ++i) {
+	  const distribn_t* fNew = latDat->GetFNew(i * LatticeType::NUMVECTORS);
+	  for (Direction dir = 0; dir < LatticeType::NUMVECTORS; ++dir)
+	    REQUIRE(fNew[dir] == MakeF(i, dir, generation));
+	}
+      }
+    }
+
+    TEST_CASE_METHOD(helpers::FourCubeBasedTestFixture, "LocalCheckpoint") {
+      // The code won't overwrite any existing file
+      std::remove(tempChkFileName);
+
+      extraction::CheckpointOutputFile outFile{tempChkFileName, 10};
+      {
+	extraction::LocalCheckpointOutput writer(*latDat, outFile, Comms());
+	FillFOld(latDat, 0);
+	// This should NOT write
+	writer.Write(5);
+	writer.Write(10);
+	FillFOld(latDat, 1);
+	writer.Write(20);
+      }
+      FillFOld(latDat, 7);
+
+      REQUIRE(extraction::LocalCheckpointInput::IsCheckpointFile(tempChkFileName, Comms()));
+
+      extraction::LocalCheckpointInput reader(tempChkFileName, Comms());
+
+      SECTION("LatestRecord") {
+	boost::optional<LatticeTimeStep> t;
+	reader.LoadDistribution(latDat, t);
+	// Records hold the step at which to resume
+	REQUIRE(bool(t));
+	REQUIRE(*t == 21U);
+	CheckFs(latDat, 1);
+      }
+
+      SECTION("TargetRecord") {
+	boost::optional<LatticeTimeStep> t = LatticeTimeStep(11);
+	reader.LoadDistribution(latDat, t);
+	REQUIRE(*t == 11U);
+	CheckFs(latDat, 0);
+
+	boost::optional<LatticeTimeStep> missing = LatticeTimeStep(15);
+	REQUIRE_THROWS_AS(reader.LoadDistribution(latDat, missing), Exception);
+      }
+
+      SECTION("Redistributed") {
+	// Corrupt this rank's layout hash so the layout check fails and
+	// the sites must be found by their coordinates.
+	{
+	  FILE* f = std::fopen(tempChkFileName, "r+b");
+	  REQUIRE(f != nullptr);
+	  std::fseek(f, io::formats::checkpoint::PreambleLength + 8, SEEK_SET);
+	  const char junk[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+	  std::fwrite(junk, 1, 8, f);
+	  std::fclose(f);
+	}
+	boost::optional<LatticeTimeStep> t;
+	reader.LoadDistribution(latDat, t);
+	REQUIRE(*t == 21U);
+	CheckFs(latDat, 1);
+      }
+
+      std::remove(tempChkFileName);
+    }
+  }
+}
@@ -6,15 +6,18 @@
 
 #include <string>
 #include <cstdio>
+#include <cstring>
 
 #include <catch2/catch.hpp>
 
 #include "io/formats/extraction.h"
+#include "io/formats/offset.h"
 #include "io/writers/xdr/XdrMemReader.h"
 #include "extraction/PropertyOutputFile.h"
 #include "extraction/OutputField.h"
 #include "extraction/WholeGeometrySelector.h"
 #include "extraction/LocalPropertyOutput.h"
+#include "extraction/CompressedChunk.h"
 
 #include "tests/helpers/HasCommsTestFixture.h"
 #include "tests/extraction/DummyDataSource.h"
@@ -109,6 +112,69 @@ namespace hemelb
       }
     }
 
+    namespace {
+      // Selects the x == 1 face of the dummy cube, counting how often it is asked.
+      class FaceSelector : public extraction::GeometrySelector {
+      public:
+	mutable unsigned calls = 0;
+      protected:
+	bool IsWithinGeometry(const extraction::IterableDataSource&, const util::Vector3D<site_t>& location) const {
+	  ++calls;
+	  return location.x == 1;
+	}
+      };
+    }
+
+    TEST_CASE_METHOD(helpers::HasCommsTestFixture, "LocalPropertyOutputSelection") {
+      std::remove(tempXtrFileName);
+      std::remove(tempOffFileName);
+
+      auto selector = new FaceSelector();
+      auto faceOutFile = extraction::PropertyOutputFile{tempXtrFileName, 1, std::unique_ptr<extraction::GeometrySelector>(selector)};
+      faceOutFile.fields.push_back(extraction::OutputField{"Pressure", extraction::OutputField::Pressure});
+
+      DummyDataSource dataSource;
+      dataSource.FillFields();
+      {
+	extraction::LocalPropertyOutput propertyWriter(dataSource, &faceOutFile, Comms());
+	// The selection is resolved once, up front.
+	REQUIRE(selector->calls == 64U);
+	propertyWriter.Write(1);
+	propertyWriter.Write(2);
+	REQUIRE(selector->calls == 64U);
+      }
+
+      auto writtenFile = open_as_closing(tempXtrFileName, "r");
+      REQUIRE(writtenFile != nullptr);
+      // Main header + one field header of 0x18 bytes, then per record the
+      // timestep and 16 sites of 3 uint coordinates and a float.
+      const long recordLength = 8 + 16 * 16;
+      REQUIRE(0 == std::fseek(writtenFile.get(), 0, SEEK_END));
+      REQUIRE(std::ftell(writtenFile.get()) == io::formats::extraction::MainHeaderLength + 0x18 + 2 * recordLength);
+
+      REQUIRE(0 == std::fseek(writtenFile.get(), -recordLength, SEEK_END));
+      std::vector<char> record(recordLength);
+      REQUIRE(size_t(recordLength) == std::fread(record.data(), 1, recordLength, writtenFile.get()));
+      io::writers::xdr::XdrMemReader reader(record);
+      uint64_t timestep;
+      reader.read(timestep);
+      REQUIRE(timestep == 2U);
+      for (int i = 0; i < 16; ++i) {
+	uint32_t x, y, z;
+	float pressure;
+	reader.read(x);
+	reader.read(y);
+	reader.read(z);
+	reader.read(pressure);
+	REQUIRE(x == 1U);
+	REQUIRE(4U * y + z == unsigned(i));
+      }
+
+      writtenFile.reset();
+      std::remove(tempXtrFileName);
+      std::remove(tempOffFileName);
+    }
+
     TEST_CASE_METHOD(helpers::HasCommsTestFixture, "LocalPropertyOutput") {
       //extraction::LocalPropertyOutput* propertyWriter = nullptr;
       
@@ -209,8 +275,9 @@ namespace hemelb
 	// Now going to write the body.
 	// Create some pseudo-random data
 	simpleDataSource->FillFields();
-	// Write it
+	// Write it and wait for the write to land
 	propertyWriter->Write(0);
+	propertyWriter->Flush();
 
 	CheckDataWriting(simpleDataSource.get(), 0, writtenFile.get());
 
@@ -220,6 +287,7 @@ namespace hemelb
 	propertyWriter->Write(10);
 	// This SHOULD write
 	propertyWriter->Write(100);
+	propertyWriter->Flush();
 
 	// The previous call to CheckDataWriting() sets the EOF indicator in writtenFile,
 	// the previous call to Write() ought to unset it but it isn't working properly in
@@ -229,6 +297,176 @@ namespace hemelb
 	CheckDataWriting(simpleDataSource.get(), 100, writtenFile.get());
       }
 
+      SECTION("OverlappedWrites") {
+	// More writes in flight than there are buffers, so each buffer
+	// must be waited for before it is reused.
+	auto propertyWriter = std::make_unique<extraction::LocalPropertyOutput>(*simpleDataSource, &simpleOutFile, Comms());
+	simpleDataSource->FillFields();
+	for (uint64_t t = 100; t <= 300; t += 100)
+	  propertyWriter->Write(t);
+	propertyWriter->Flush();
+
+	auto writtenFile = open_as_closing(simpleOutFile.filename.c_str(), "r");
+	REQUIRE(writtenFile != nullptr);
+	const long headerLength = io::formats::extraction::MainHeaderLength + fieldHeaderLength;
+	REQUIRE(0 == std::fseek(writtenFile.get(), 0, SEEK_END));
+	const long recordLength = (std::ftell(writtenFile.get()) - headerLength) / 3;
+
+	// Each record must have landed in its own slot...
+	for (uint64_t i = 0; i < 3; ++i) {
+	  REQUIRE(0 == std::fseek(writtenFile.get(), headerLength + i * recordLength, SEEK_SET));
+	  char timestepBuffer[8];
+	  REQUIRE(8U == std::fread(timestepBuffer, 1, 8, writtenFile.get()));
+	  io::writers::xdr::XdrMemReader reader(timestepBuffer, 8);
+	  uint64_t readTimestep;
+	  reader.read(readTimestep);
+	  REQUIRE(100 * (i + 1) == readTimestep);
+	}
+	// ...and the last should be complete.
+	REQUIRE(0 == std::fseek(writtenFile.get(), headerLength + 2 * recordLength, SEEK_SET));
+	CheckDataWriting(simpleDataSource.get(), 300, writtenFile.get());
+      }
+
+      SECTION("Columnar") {
+	simpleOutFile.format = extraction::PropertyOutputFile::Columnar;
+	auto propertyWriter = std::make_unique<extraction::LocalPropertyOutput>(*simpleDataSource, &simpleOutFile, Comms());
+	simpleDataSource->FillFields();
+	propertyWriter->Write(100);
+	simpleDataSource->FillFields();
+	propertyWriter->Write(200);
+	propertyWriter->Flush();
+
+	auto writtenFile = open_as_closing(simpleOutFile.filename.c_str(), "r");
+	REQUIRE(writtenFile != nullptr);
+
+	// Same header as the row format bar the version number
+	REQUIRE(size_t{io::formats::extraction::MainHeaderLength} ==
+		std::fread(writtenMainHeader, 1, io::formats::extraction::MainHeaderLength, writtenFile.get()));
+	io::writers::xdr::XdrMemReader headerReader(writtenMainHeader, io::formats::extraction::MainHeaderLength);
+	uint32_t magic, extractionMagic, version;
+	headerReader.read(magic);
+	headerReader.read(extractionMagic);
+	headerReader.read(version);
+	REQUIRE(version == uint32_t(io::formats::extraction::ColumnarVersionNumber));
+
+	// The coordinates appear once, then each record is the timestep,
+	// 64 pressures and 64 velocities, all little endian.
+	const long siteCount = 64;
+	const long headerLength = io::formats::extraction::MainHeaderLength + fieldHeaderLength;
+	const long recordLength = 8 + siteCount * 4 * (1 + 3);
+	REQUIRE(0 == std::fseek(writtenFile.get(), 0, SEEK_END));
+	REQUIRE(std::ftell(writtenFile.get()) == headerLength + 12 * siteCount + 2 * recordLength);
+
+	auto readLittleEndian = [](const unsigned char* bytes, unsigned n) {
+	  uint64_t ans = 0;
+	  for (unsigned i = 0; i < n; ++i)
+	    ans |= uint64_t(bytes[i]) << (8 * i);
+	  return ans;
+	};
+	auto readFloat = [&](const unsigned char* bytes) {
+	  uint32_t bits = readLittleEndian(bytes, 4);
+	  float ans;
+	  std::memcpy(&ans, &bits, 4);
+	  return ans;
+	};
+
+	std::vector<unsigned char> body(12 * siteCount + 2 * recordLength);
+	REQUIRE(0 == std::fseek(writtenFile.get(), headerLength, SEEK_SET));
+	REQUIRE(body.size() == std::fread(body.data(), 1, body.size(), writtenFile.get()));
+
+	const unsigned char* record = body.data() + 12 * siteCount + recordLength;
+	REQUIRE(readLittleEndian(body.data() + 12 * siteCount, 8) == 100U);
+	REQUIRE(readLittleEndian(record, 8) == 200U);
+	const unsigned char* pressures = record + 8;
+	const unsigned char* velocities = pressures + 4 * siteCount;
+
+	long i = 0;
+	simpleDataSource->Reset();
+	while (simpleDataSource->ReadNext()) {
+	  const LatticeVector grid = simpleDataSource->GetPosition();
+	  REQUIRE(readLittleEndian(&body[12 * i], 4) == uint64_t(grid.x));
+	  REQUIRE(readLittleEndian(&body[12 * i + 4], 4) == uint64_t(grid.y));
+	  REQUIRE(readLittleEndian(&body[12 * i + 8], 4) == uint64_t(grid.z));
+
+	  REQUIRE(apprx(simpleDataSource->GetPressure()) == REFERENCE_PRESSURE_mmHg + double{readFloat(pressures + 4 * i)});
+	  const auto velocity = simpleDataSource->GetVelocity();
+	  REQUIRE(apprx(velocity.x) == readFloat(velocities + 12 * i));
+	  REQUIRE(apprx(velocity.y) == readFloat(velocities + 12 * i + 4));
+	  REQUIRE(apprx(velocity.z) == readFloat(velocities + 12 * i + 8));
+	  ++i;
+	}
+	REQUIRE(i == siteCount);
+      }
+
+      SECTION("Compressed") {
+	simpleOutFile.format = extraction::PropertyOutputFile::Compressed;
+	auto propertyWriter = std::make_unique<extraction::LocalPropertyOutput>(*simpleDataSource, &simpleOutFile, Comms());
+	simpleDataSource->FillFields();
+	propertyWriter->Write(100);
+	simpleDataSource->FillFields();
+	propertyWriter->Write(200);
+	propertyWriter->Flush();
+
+	auto readFile = [](const char* name) {
+	  auto f = open_as_closing(name, "r");
+	  REQUIRE(f != nullptr);
+	  std::fseek(f.get(), 0, SEEK_END);
+	  std::vector<char> contents(std::ftell(f.get()));
+	  std::fseek(f.get(), 0, SEEK_SET);
+	  REQUIRE(contents.size() == std::fread(contents.data(), 1, contents.size(), f.get()));
+	  return contents;
+	};
+	const std::vector<char> xtr = readFile(tempXtrFileName);
+	const std::vector<char> off = readFile(tempOffFileName);
+
+	io::writers::xdr::XdrMemReader headerReader(xtr.data(), io::formats::extraction::MainHeaderLength);
+	uint32_t magic, extractionMagic, version;
+	headerReader.read(magic);
+	headerReader.read(extractionMagic);
+	headerReader.read(version);
+	REQUIRE(version == uint32_t(io::formats::extraction::CompressedVersionNumber));
+
+	// The offset file holds the site range of each rank, then a row of
+	// chunk offsets (plus the end of the record) for each record.
+	io::writers::xdr::XdrMemReader offReader(off.data(), off.size());
+	uint32_t offVersion, nRanks;
+	offReader.read(magic);
+	offReader.read(magic);
+	offReader.read(offVersion);
+	offReader.read(nRanks);
+	REQUIRE(offVersion == uint32_t(io::formats::offset::CompressedVersionNumber));
+	REQUIRE(off.size() == io::formats::offset::HeaderLength + 3 * (nRanks + 1) * sizeof(uint64_t));
+	uint64_t firstSite, endSite, chunk0, end0, chunk1, end1;
+	offReader.read(firstSite);
+	offReader.read(endSite);
+	offReader.read(chunk0);
+	offReader.read(end0);
+	offReader.read(chunk1);
+	offReader.read(end1);
+	REQUIRE(firstSite == 0U);
+	REQUIRE(endSite == 64U);
+	REQUIRE(chunk0 == io::formats::extraction::MainHeaderLength + fieldHeaderLength + 12 * 64 + 8);
+	REQUIRE(chunk1 == end0 + 8);
+	REQUIRE(end1 == xtr.size());
+
+	REQUIRE(io::formats::extraction::GetLittleEndian<uint64_t>(&xtr[chunk0 - 8]) == 100U);
+	REQUIRE(io::formats::extraction::GetLittleEndian<uint64_t>(&xtr[chunk1 - 8]) == 200U);
+
+	// The chunk is the pressure column then the velocity column.
+	const std::vector<float> values = extraction::DecompressChunk(&xtr[chunk1], end1 - chunk1);
+	REQUIRE(values.size() == 64U * 4U);
+	long i = 0;
+	simpleDataSource->Reset();
+	while (simpleDataSource->ReadNext()) {
+	  REQUIRE(values[i] == float(simpleDataSource->GetPressure() - REFERENCE_PRESSURE_mmHg));
+	  const auto velocity = simpleDataSource->GetVelocity();
+	  REQUIRE(values[64 + 3 * i] == float(velocity.x));
+	  REQUIRE(values[64 + 3 * i + 1] == float(velocity.y));
+	  REQUIRE(values[64 + 3 * i + 2] == float(velocity.z));
+	  ++i;
+	}
+      }
+
 
       // tearDown
 
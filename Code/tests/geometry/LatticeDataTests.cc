@@ -4,17 +4,44 @@
 // file AUTHORS. This software is provided under the terms of the
 // license in the file LICENSE.
 
+#include <cstdio>
+
 #include <catch2/catch.hpp>
 
+#include "Exception.h"
 #include "geometry/LatticeData.h"
+#include "lb/lattices/D3Q15.h"
+#include "lb/lattices/D3Q19.h"
 
+#include "tests/helpers/EqualitySiteData.h"
+#include "tests/helpers/FolderTestFixture.h"
 #include "tests/helpers/FourCubeBasedTestFixture.h"
+#include "tests/helpers/FourCubeLatticeData.h"
 
 namespace hemelb
 {
   namespace tests
   {
     using namespace hemelb::geometry;
+
+    namespace
+    {
+      // Opens up the tables a saved decomposition holds.
+      class LatticeDataTables : public LatticeData
+      {
+      public:
+	using LatticeData::LatticeData;
+	using LatticeData::totalSharedFs;
+	using LatticeData::neighbouringProcs;
+	using LatticeData::globalSiteCoords;
+	using LatticeData::siteData;
+	using LatticeData::wallNormalAtSite;
+	using LatticeData::distanceToWall;
+	using LatticeData::neighbourIndices;
+	using LatticeData::streamingIndicesForReceivedDistributions;
+      };
+    }
+
     TEST_CASE_METHOD(helpers::FourCubeBasedTestFixture, "LatticeDataTests") {
       SECTION("TestConvertGlobalId") {
 	// Not really a very good test to use a one-proc geometry.  We
@@ -36,6 +63,70 @@ namespace hemelb
 	REQUIRE(latDat->ProcProvidingSiteByGlobalNoncontiguousId(43) == 0);
       }
     }
+
+    TEST_CASE_METHOD(helpers::FolderTestFixture, "LatticeDataDecompositionTests") {
+      const proc_t rankCount = Comms().Size();
+
+      // The four cube cut into slabs along x, one per rank, so that each
+      // rank but the ends shares distributions with two others.
+      const site_t slabWidth = 3;
+      const site_t sitesPerBlockUnit = slabWidth * rankCount + 2;
+      geometry::Geometry geometry = FourCubeLatticeData::CreateGeometry(sitesPerBlockUnit);
+      site_t index = 0;
+      for (site_t i = 0; i < sitesPerBlockUnit; ++i)
+	for (site_t j = 0; j < sitesPerBlockUnit; ++j)
+	  for (site_t k = 0; k < sitesPerBlockUnit; ++k, ++index)
+	    if (geometry.Blocks[0].Sites[index].isFluid)
+	      geometry.Blocks[0].Sites[index].targetProcessor = proc_t((i - 1) / slabWidth);
+
+      const LatticeDataTables built(lb::lattices::D3Q15::GetLatticeInfo(), geometry, Comms());
+      const std::string decompositionPath = GetSharedTempPath("four_cube.dcmp");
+      built.SaveDecomposition(decompositionPath);
+
+      const LatticeDataTables loaded(lb::lattices::D3Q15::GetLatticeInfo(), decompositionPath, Comms());
+      // Every rank finds the lattice is wrong before reading its section.
+      CHECK_THROWS_AS(LatticeData(lb::lattices::D3Q19::GetLatticeInfo(), decompositionPath, Comms()), Exception);
+      MPI_Barrier(Comms());
+      if (Comms().OnIORank())
+	std::remove(decompositionPath.c_str());
+
+      REQUIRE(loaded.GetBlockDimensions() == built.GetBlockDimensions());
+      REQUIRE(loaded.GetBlockSize() == built.GetBlockSize());
+      for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; ++collisionType) {
+	REQUIRE(loaded.GetMidDomainCollisionCount(collisionType) == built.GetMidDomainCollisionCount(collisionType));
+	REQUIRE(loaded.GetDomainEdgeCollisionCount(collisionType) == built.GetDomainEdgeCollisionCount(collisionType));
+      }
+      REQUIRE(loaded.GetLocalFluidSiteCount() == built.GetLocalFluidSiteCount());
+      REQUIRE(loaded.GetTotalFluidSites() == built.GetTotalFluidSites());
+      for (proc_t rank = 0; rank < rankCount; ++rank)
+	REQUIRE(loaded.GetFluidSiteCountOnProc(rank) == built.GetFluidSiteCountOnProc(rank));
+      REQUIRE(loaded.GetGlobalSiteMins() == built.GetGlobalSiteMins());
+      REQUIRE(loaded.GetGlobalSiteMaxes() == built.GetGlobalSiteMaxes());
+
+      REQUIRE(loaded.totalSharedFs == built.totalSharedFs);
+      REQUIRE(loaded.neighbouringProcs.size() == built.neighbouringProcs.size());
+      for (size_t n = 0; n < built.neighbouringProcs.size(); ++n) {
+	REQUIRE(loaded.neighbouringProcs[n].Rank == built.neighbouringProcs[n].Rank);
+	REQUIRE(loaded.neighbouringProcs[n].SharedDistributionCount == built.neighbouringProcs[n].SharedDistributionCount);
+	REQUIRE(loaded.neighbouringProcs[n].FirstSharedDistribution == built.neighbouringProcs[n].FirstSharedDistribution);
+      }
+
+      for (site_t block = 0; block < built.GetBlockCount(); ++block) {
+	REQUIRE(loaded.GetBlock(block).IsEmpty() == built.GetBlock(block).IsEmpty());
+	if (built.GetBlock(block).IsEmpty())
+	  continue;
+	for (site_t site = 0; site < built.GetSitesPerBlockVolumeUnit(); ++site) {
+	  REQUIRE(loaded.GetBlock(block).GetProcessorRankForSite(site) == built.GetBlock(block).GetProcessorRankForSite(site));
+	  REQUIRE(loaded.GetBlock(block).GetLocalContiguousIndexForSite(site) == built.GetBlock(block).GetLocalContiguousIndexForSite(site));
+	}
+      }
+
+      REQUIRE(loaded.globalSiteCoords == built.globalSiteCoords);
+      REQUIRE(loaded.siteData == built.siteData);
+      REQUIRE(loaded.wallNormalAtSite == built.wallNormalAtSite);
+      REQUIRE(loaded.distanceToWall == built.distanceToWall);
+      REQUIRE(loaded.neighbourIndices == built.neighbourIndices);
+      REQUIRE(loaded.streamingIndicesForReceivedDistributions == built.streamingIndicesForReceivedDistributions);
+    }
   }
 }
-
@@ -9,6 +9,7 @@
 #include <sstream>
 #include <cmath>
 #include <iomanip>
+#include <vector>
 
 #include <catch2/catch.hpp>
 
@@ -29,8 +30,10 @@ namespace hemelb
 	  std::stringstream tempPathStream;
 	  // next line is a hack to get the build working again
 	  // TODO: find a portable uuid solution. BOOST?
+	  // The clock starts with MPI, so add the rank to keep the ranks'
+	  // folders apart.
 	  tempPathStream << util::GetTemporaryDir() << "/" << "HemeLBTest" << std::fixed
-			 << std::floor(util::myClock() * 100000) << std::flush;
+			 << std::floor(util::myClock() * 100000) << "_" << Comms().Rank() << std::flush;
 	  tempPath = tempPathStream.str();
 	}
 	// store current location
@@ -75,6 +78,17 @@ namespace hemelb
       {
 	return tempPath;
       }
+
+      std::string FolderTestFixture::GetSharedTempPath(const std::string& leaf)
+      {
+	std::string path = tempPath + "/" + leaf;
+	std::vector<char> chars(path.begin(), path.end());
+	int length = chars.size();
+	Comms().Broadcast(length, Comms().GetIORank());
+	chars.resize(length);
+	Comms().Broadcast(chars, Comms().GetIORank());
+	return std::string(chars.begin(), chars.end());
+      }
     }
   }
 }
@@ -33,6 +33,9 @@ namespace hemelb
 	void MoveToTempdir();
 	void AssertPresent(const std::string &fname);
 	const std::string & GetTempdir();
+	// A path in the IO rank's temporary directory, the same on every rank,
+	// for files that are opened collectively.
+	std::string GetSharedTempPath(const std::string& leaf);
       };
     }
   }
@@ -10,6 +10,7 @@
 #include "units.h"
 #include "geometry/LatticeData.h"
 #include "io/formats/geometry.h"
+#include "lb/lattices/Lattices.h"
 #include "util/Vector3D.h"
 
 namespace hemelb
@@ -49,7 +50,8 @@ namespace hemelb
      *
      * @return
      */
-    FourCubeLatticeData* FourCubeLatticeData::Create(const net::IOCommunicator& comm, site_t sitesPerBlockUnit, proc_t rankCount)
+    template<class LatticeType>
+    geometry::Geometry FourCubeLatticeData::CreateGeometry(site_t sitesPerBlockUnit)
     {
       hemelb::geometry::Geometry readResult(util::Vector3D<site_t>::Ones(),
 					    sitesPerBlockUnit);
@@ -77,11 +79,11 @@ namespace hemelb
 	    site.isFluid = true;
 	    site.targetProcessor = 0;
 
-	    for (Direction direction = 1; direction < lb::lattices::D3Q15::NUMVECTORS; ++direction)
+	    for (Direction direction = 1; direction < LatticeType::NUMVECTORS; ++direction)
 	      {
-		site_t neighI = i + lb::lattices::D3Q15::CX[direction];
-		site_t neighJ = j + lb::lattices::D3Q15::CY[direction];
-		site_t neighK = k + lb::lattices::D3Q15::CZ[direction];
+		site_t neighI = i + LatticeType::CX[direction];
+		site_t neighJ = j + LatticeType::CY[direction];
+		site_t neighK = k + LatticeType::CZ[direction];
 
 		hemelb::geometry::GeometrySiteLink link;
 
@@ -141,7 +143,18 @@ namespace hemelb
 	}
       }
 
-      FourCubeLatticeData* returnable = new FourCubeLatticeData(readResult, comm);
+      return readResult;
+    }
+
+    template<class LatticeType>
+    FourCubeLatticeData* FourCubeLatticeData::Create(const net::IOCommunicator& comm, site_t sitesPerBlockUnit, proc_t rankCount)
+    {
+      site_t sitesAlongCube = sitesPerBlockUnit - 2;
+      hemelb::geometry::Geometry readResult = CreateGeometry<LatticeType>(sitesPerBlockUnit);
+
+      FourCubeLatticeData* returnable = new FourCubeLatticeData(LatticeType::GetLatticeInfo(),
+								readResult,
+								comm);
       
       // First, fiddle with the fluid site count, for tests that require this set.
       returnable->fluidSitesOnEachProcessor.resize(rankCount);
@@ -154,6 +167,15 @@ namespace hemelb
       return returnable;
     }
 
+    template geometry::Geometry FourCubeLatticeData::CreateGeometry<lb::lattices::D3Q15>(site_t);
+    template geometry::Geometry FourCubeLatticeData::CreateGeometry<lb::lattices::D3Q15i>(site_t);
+    template geometry::Geometry FourCubeLatticeData::CreateGeometry<lb::lattices::D3Q19>(site_t);
+    template geometry::Geometry FourCubeLatticeData::CreateGeometry<lb::lattices::D3Q27>(site_t);
+    template FourCubeLatticeData* FourCubeLatticeData::Create<lb::lattices::D3Q15>(const net::IOCommunicator&, site_t, proc_t);
+    template FourCubeLatticeData* FourCubeLatticeData::Create<lb::lattices::D3Q15i>(const net::IOCommunicator&, site_t, proc_t);
+    template FourCubeLatticeData* FourCubeLatticeData::Create<lb::lattices::D3Q19>(const net::IOCommunicator&, site_t, proc_t);
+    template FourCubeLatticeData* FourCubeLatticeData::Create<lb::lattices::D3Q27>(const net::IOCommunicator&, site_t, proc_t);
+
     void FourCubeLatticeData::SetHasWall(site_t site, Direction direction)
     {
       TestSiteData mutableSiteData(siteData[site]);
@@ -177,7 +199,7 @@ namespace hemelb
 
     void FourCubeLatticeData::SetBoundaryDistance(site_t site, Direction direction, distribn_t distance)
     {
-      distanceToWall[ (lb::lattices::D3Q15::NUMVECTORS - 1) * site + direction - 1] = distance;
+      distanceToWall[ (latticeInfo.GetNumVectors() - 1) * site + direction - 1] = distance;
     }
 
     void FourCubeLatticeData::SetBoundaryNormal(site_t site, util::Vector3D<distribn_t> boundaryNormal)
@@ -185,8 +207,10 @@ namespace hemelb
       wallNormalAtSite[site] = boundaryNormal;
     }
 
-    FourCubeLatticeData::FourCubeLatticeData(hemelb::geometry::Geometry& readResult, const net::IOCommunicator& comms) :
-      hemelb::geometry::LatticeData(lb::lattices::D3Q15::GetLatticeInfo(), readResult, comms)
+    FourCubeLatticeData::FourCubeLatticeData(const lb::lattices::LatticeInfo& latticeInfo,
+					     hemelb::geometry::Geometry& readResult,
+					     const net::IOCommunicator& comms) :
+      hemelb::geometry::LatticeData(latticeInfo, readResult, comms)
     {
     }
   }
@@ -11,6 +11,7 @@
 #include "units.h"
 #include "geometry/LatticeData.h"
 #include "io/formats/geometry.h"
+#include "lb/lattices/D3Q15.h"
 #include "util/Vector3D.h"
 
 namespace hemelb
@@ -35,6 +36,14 @@ namespace hemelb
       // The plane (x,y,0) is an inlet (boundary 0).
       // The plane (x,y,3) is an outlet (boundary 1).
       // The planes (0,y,z), (3,y,z), (x,0,z) and (x,3,z) are all walls.
+      // The links are those of LatticeType, which is instantiated for D3Q15, D3Q15i, D3Q19
+      // and D3Q27.
+      // The geometry that Create builds its lattice from, with every fluid site on rank 0,
+      // for tests that decompose it over the ranks themselves.
+      template<class LatticeType = lb::lattices::D3Q15>
+      static geometry::Geometry CreateGeometry(site_t sitesPerBlockUnit = 6);
+
+      template<class LatticeType = lb::lattices::D3Q15>
       static FourCubeLatticeData* Create(const net::IOCommunicator& comm, site_t sitesPerBlockUnit = 6, proc_t rankCount = 1);
 
       // Not used in setting up the four cube, but used in other tests
@@ -58,7 +67,9 @@ namespace hemelb
         }
 
       protected:
-      FourCubeLatticeData(hemelb::geometry::Geometry& readResult, const net::IOCommunicator& comms);
+      FourCubeLatticeData(const lb::lattices::LatticeInfo& latticeInfo,
+			  hemelb::geometry::Geometry& readResult,
+			  const net::IOCommunicator& comms);
     };
   }
 }
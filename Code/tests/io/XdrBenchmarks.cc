@@ -0,0 +1,61 @@
+// -*- mode: C++ -*-
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "io/writers/xdr/XdrWriter.h"
+#include "io/writers/xdr/XdrMemReader.h"
+
+namespace hemelb
+{
+  namespace tests
+  {
+    // Compare serialising a block of values one at a time through
+    // the Writer interface with doing it as an array. Hidden, so run
+    // them explicitly with
+    //
+    //   hemelb-tests "[benchmark]"
+    TEMPLATE_TEST_CASE("XDR array serialisation", "[.][benchmark]", float, double) {
+      // About the size of a row of extracted fields for a few
+      // thousand sites
+      const size_t n = 1 << 16;
+      std::vector<TestType> values(n);
+      for (size_t i = 0; i < n; ++i)
+	values[i] = TestType(i) / 7;
+      std::vector<char> buffer(n * io::writers::xdr::detail::xdr_serialised_size<TestType>());
+
+      BENCHMARK("Write value by value") {
+	auto writer = io::MakeXdrWriter(buffer.data(), buffer.data() + buffer.size());
+	io::writers::Writer& base = writer;
+	for (auto& v: values)
+	  base << v;
+	return buffer[0];
+      };
+
+      BENCHMARK("Write array") {
+	auto writer = io::MakeXdrWriter(buffer.data(), buffer.data() + buffer.size());
+	writer.writeArray(values.data(), n);
+	return buffer[0];
+      };
+
+      std::vector<TestType> read_values(n);
+      BENCHMARK("Read value by value") {
+	io::writers::xdr::XdrMemReader reader(buffer);
+	for (auto& v: read_values)
+	  reader.read(v);
+	return read_values[0];
+      };
+
+      BENCHMARK("Read array") {
+	io::writers::xdr::XdrMemReader reader(buffer);
+	reader.readArray(read_values.data(), n);
+	return read_values[0];
+      };
+    }
+  }
+}
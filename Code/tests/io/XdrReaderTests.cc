@@ -62,6 +62,18 @@ namespace hemelb
       TestBasic(values, buffer);
     }
 
+    TEMPLATE_TEST_CASE("XdrReader works for arrays", "", int32_t, uint32_t, int64_t, uint64_t, float, double) {
+      auto&& values = test_data<TestType>::unpacked();
+      auto&& buffer = test_data<TestType>::packed();
+
+      auto our_coder = io::writers::xdr::XdrMemReader(buffer.data(), buffer.size());
+      std::vector<TestType> our_values(values.size());
+      our_coder.readArray(our_values.data(), our_values.size());
+
+      REQUIRE(our_coder.GetPosition() == buffer.size());
+      REQUIRE(our_values == values);
+    }
+
     TEST_CASE("XdrReader works for strings") {
       using UPC = std::unique_ptr<char[]>;
       auto make_ones = [](size_t n) -> UPC {
@@ -4,6 +4,8 @@
 // file AUTHORS. This software is provided under the terms of the
 // license in the file LICENSE.
 
+#include <algorithm>
+#include <iterator>
 #include <type_traits>
 
 #include <catch2/catch.hpp>
@@ -79,6 +81,29 @@ namespace hemelb
       TestBasic(values, expected_buffer);
     }
 
+    TEMPLATE_TEST_CASE("XdrWriter works for arrays", "", int32_t, uint32_t, int64_t, uint64_t, float, double) {
+      auto&& values = test_data<TestType>::unpacked();
+      auto&& expected_buffer = test_data<TestType>::packed();
+
+      SECTION("Into memory") {
+	// Offset by a word so that the 64 bit values are misaligned
+	std::vector<char> our_buf(expected_buffer.size() + 4, ~'\0');
+	auto our_coder = hemelb::io::MakeXdrWriter(our_buf.data() + 4, our_buf.data() + our_buf.size());
+	our_coder.writeArray(values.data(), values.size());
+
+	REQUIRE(our_coder.getCurrentStreamPosition() == expected_buffer.size());
+	REQUIRE(std::equal(expected_buffer.begin(), expected_buffer.end(), our_buf.begin() + 4));
+      }
+
+      SECTION("Through an iterator") {
+	std::vector<char> our_buf;
+	auto our_coder = hemelb::io::MakeXdrWriter(std::back_inserter(our_buf));
+	our_coder.writeArray(values.data(), values.size());
+
+	REQUIRE(our_buf == expected_buffer);
+      }
+    }
+
     TEST_CASE("XdrWriter works for strings") {
       using UPC = std::unique_ptr<char[]>;
       auto make_ones = [](size_t n) -> UPC {
@@ -8,6 +8,7 @@
 #include <sstream>
 
 #include "lb/kernels/Kernels.h"
+#include "lb/MacroscopicPropertyCache.h"
 #include "lb/kernels/rheologyModels/RheologyModels.h"
 #include "lb/kernels/momentBasis/DHumieresD3Q15MRTBasis.h"
 #include "lb/kernels/momentBasis/DHumieresD3Q19MRTBasis.h"
@@ -140,6 +141,62 @@ namespace hemelb
       }
     }
 
+    TEST_CASE_METHOD(helpers::FourCubeBasedTestFixture, "GuoForcingLBGKCalculationsAndCollision") {
+      using LATTICE = lb::lattices::D3Q15;
+      static constexpr auto NV = LATTICE::NUMVECTORS;
+      using VEC = util::Vector3D<distribn_t>;
+      const distribn_t allowedError = 1e-10;
+
+      lb::MacroscopicPropertyCache propertyCache(*simState, *latDat);
+      const LatticeForceVector force{0.01, -0.02, 0.03};
+      propertyCache.bodyForces[0] = force;
+      initParams.propertyCache = &propertyCache;
+
+      lb::kernels::GuoForcingLBGK<LATTICE> guo(initParams);
+      lb::kernels::LBGK<LATTICE> lbgk(initParams);
+
+      distribn_t f_original[NV];
+      LbTestsHelper::InitialiseAnisotropicTestData<LATTICE>(0, f_original);
+      const VEC momentum = LbTestsHelper::CalculateMomentum<LATTICE>(f_original);
+
+      SECTION("Unforced site is LBGK") {
+	lb::kernels::HydroVars<lb::kernels::GuoForcingLBGK<LATTICE> > guoVars(f_original);
+	lb::kernels::HydroVars<lb::kernels::LBGK<LATTICE> > lbgkVars(f_original);
+	guo.CalculateDensityMomentumFeq(guoVars, 1);
+	lbgk.CalculateDensityMomentumFeq(lbgkVars, 1);
+	guo.Collide(lbmParams, guoVars);
+	lbgk.Collide(lbmParams, lbgkVars);
+	for (unsigned int ii = 0; ii < NV; ++ii) {
+	  REQUIRE(Approx(lbgkVars.GetFPostCollision()[ii]).margin(allowedError) == guoVars.GetFPostCollision()[ii]);
+	}
+      }
+
+      SECTION("Forced site") {
+	lb::kernels::HydroVars<lb::kernels::GuoForcingLBGK<LATTICE> > hydroVars(f_original);
+	guo.CalculateDensityMomentumFeq(hydroVars, 0);
+
+	// The equilibrium uses the momentum shifted by half the force
+	const VEC expectedMomentum = momentum + force * 0.5;
+	distribn_t expectedFEq[NV];
+	LbTestsHelper::CalculateLBGKEqmF<LATTICE>(hydroVars.density, expectedMomentum, expectedFEq);
+	LbTestsHelper::CompareHydros(12.0, expectedMomentum, expectedFEq, hydroVars, allowedError);
+
+	// The collision conserves mass and adds the whole force to the momentum
+	guo.Collide(lbmParams, hydroVars);
+	distribn_t postDensity = 0.0;
+	VEC postMomentum = VEC::Zero();
+	for (unsigned int ii = 0; ii < NV; ++ii) {
+	  const distribn_t fPost = hydroVars.GetFPostCollision()[ii];
+	  postDensity += fPost;
+	  postMomentum += VEC(LATTICE::CX[ii], LATTICE::CY[ii], LATTICE::CZ[ii]) * fPost;
+	}
+	REQUIRE(Approx(12.0).margin(allowedError) == postDensity);
+	REQUIRE(Approx(momentum.x + force.x).margin(allowedError) == postMomentum.x);
+	REQUIRE(Approx(momentum.y + force.y).margin(allowedError) == postMomentum.y);
+	REQUIRE(Approx(momentum.z + force.z).margin(allowedError) == postMomentum.z);
+      }
+    }
+
     TEST_CASE_METHOD(helpers::FourCubeBasedTestFixture, "LBGKNNCalculationsAndCollision") {
       using LATTICE = lb::lattices::D3Q15;
       static constexpr auto NV = LATTICE::NUMVECTORS;
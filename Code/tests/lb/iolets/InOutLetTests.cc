@@ -4,6 +4,8 @@
 // file AUTHORS. This software is provided under the terms of the
 // license in the file LICENSE.
 
+#include <algorithm>
+
 #include <catch2/catch.hpp>
 
 #include "lb/iolets/InOutLets.h"
@@ -319,6 +321,35 @@ namespace hemelb
 	REQUIRE(ApproxVector<LatticePosition>{0,0,3}.Margin(1e-9) == tmp);
       }
 
+      SECTION("TestMultiscaleLaggedComms") {
+	BoundaryCommunicator bcComms(Comms());
+	// The coupled code's pressure rises by 1 mmHg a step, and reaches the BC proc 2 steps
+	// after it was asked for.
+	auto run = [&](InOutLetMultiscale::LagExtrapolation extrapolation, double behind) {
+	  InOutLetMultiscale iolet;
+	  iolet.SetCouplingLag(2, extrapolation);
+	  if (bcComms.IsCurrentProcTheBCProc())
+	    iolet.GetPressureReference().SetPayload(10.0);
+
+	  // The first exchange starts everyone off from the same pressure.
+	  iolet.DoComms(bcComms, 0);
+	  REQUIRE(iolet.GetPressure() == Approx(10.0));
+
+	  for (int step = 1; step <= 5; ++step) {
+	    if (bcComms.IsCurrentProcTheBCProc())
+	      iolet.GetPressureReference().SetPayload(10.0 + std::max(step - 2, 0));
+	    iolet.DoComms(bcComms, step);
+	    // Nothing new arrives until the lag has passed.
+	    const double expected = step <= 2 ? 10.0 : 10.0 + step - behind;
+	    REQUIRE(iolet.GetPressure() == Approx(expected));
+	  }
+	};
+
+	run(InOutLetMultiscale::HOLD, 2.0);
+	// Linear extrapolation recovers a linear ramp exactly.
+	run(InOutLetMultiscale::LINEAR, 0.0);
+      }
+
     }
   }
 }
@@ -0,0 +1,83 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "log/AsyncSink.h"
+
+#include "tests/helpers/FolderTestFixture.h"
+
+namespace hemelb
+{
+  namespace tests
+  {
+    namespace
+    {
+      std::string Message(int i)
+      {
+	std::ostringstream message;
+	message << "message " << i << "\n";
+	return message.str();
+      }
+
+      std::vector<std::string> ReadLines(const std::string& path)
+      {
+	std::ifstream in(path.c_str());
+	std::vector<std::string> lines;
+	std::string line;
+	while (std::getline(in, line))
+	  lines.push_back(line + "\n");
+	return lines;
+      }
+    }
+
+    TEST_CASE_METHOD(helpers::FolderTestFixture, "AsyncSinkTests") {
+      const std::string path = GetTempdir() + "/log.txt";
+      std::FILE* out = std::fopen(path.c_str(), "w");
+      REQUIRE(out != NULL);
+
+      // Many more messages than the ring holds, so pushing has to wait for the writer.
+      const int count = 100;
+      std::unique_ptr<log::AsyncSink> sink(new log::AsyncSink(4, out));
+
+      SECTION("FlushWritesEverythingInOrder") {
+	for (int i = 0; i < count; ++i)
+	  sink->Push(Message(i));
+	sink->Flush();
+
+	const std::vector<std::string> lines = ReadLines(path);
+	REQUIRE(lines.size() == count);
+	for (int i = 0; i < count; ++i)
+	  REQUIRE(lines[i] == Message(i));
+
+	// Pushing after a flush carries on where it left off.
+	sink->Push(Message(count));
+	sink->Flush();
+	REQUIRE(ReadLines(path).size() == count + 1);
+      }
+
+      SECTION("DestructorDrainsTheRing") {
+	for (int i = 0; i < count; ++i)
+	  sink->Push(Message(i));
+	sink.reset();
+
+	const std::vector<std::string> lines = ReadLines(path);
+	REQUIRE(lines.size() == count);
+	for (int i = 0; i < count; ++i)
+	  REQUIRE(lines[i] == Message(i));
+      }
+
+      sink.reset();
+      std::fclose(out);
+    }
+  }
+}
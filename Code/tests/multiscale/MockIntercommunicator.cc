@@ -59,7 +59,7 @@ namespace hemelb
 	  std::string &label = intercommunicandData->second.second;
 	  IntercommunicandTypeT &resolver = *intercommunicandData->second.first;
 
-	  for (unsigned int sharedFieldIndex = 0; sharedFieldIndex < sharedObject.SharedValues().size();
+	  for (unsigned int sharedFieldIndex = 0; sharedFieldIndex < resolver.Fields().size();
 	       sharedFieldIndex++)
 	    {
 	      Receive(resolver.Fields()[sharedFieldIndex].first,
@@ -78,7 +78,7 @@ namespace hemelb
 	  multiscale::Intercommunicand &sharedObject = *intercommunicandData->first;
 	  std::string &label = intercommunicandData->second.second;
 	  IntercommunicandTypeT &resolver = *intercommunicandData->second.first;
-	  for (unsigned int sharedFieldIndex = 0; sharedFieldIndex < sharedObject.SharedValues().size();
+	  for (unsigned int sharedFieldIndex = 0; sharedFieldIndex < resolver.Fields().size();
 	       sharedFieldIndex++)
 	    {
 	      Send(resolver.Fields()[sharedFieldIndex].first,
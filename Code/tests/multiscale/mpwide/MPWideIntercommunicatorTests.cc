@@ -53,6 +53,30 @@ namespace hemelb
 	  // TODO This test needs writing.
 	}
 
+	SECTION("testMPWideOverlappedExchanges") {
+	  MPWideIntercommunicator intercomms(true, *pbuffer, *LBorchestration, configPath);
+	  MPWideIntercommunicator::IntercommunicandTypeT icandType("inoutlet");
+	  icandType.RegisterSharedValue<double>("pressure");
+	  icandType.RegisterSharedValue<double>("velocity");
+	  MockIntercommunicand icand(81.0, 0.1);
+	  intercomms.RegisterIntercommunicand(icandType, icand, "boundary1");
+	  intercomms.ShareInitialConditions();
+	  REQUIRE(intercomms.OverlapsExchanges());
+
+	  // Each exchange sends what was packed when it was started, and the mock
+	  // partner echoes it back.
+	  intercomms.StartMultiscale(1.0);
+	  icand.SetPressure(90.0);
+	  intercomms.StartMultiscale(2.0);
+	  icand.SetPressure(99.0);
+
+	  // They complete in the order they were started.
+	  intercomms.CompleteMultiscale();
+	  REQUIRE(icand.GetPressure() == Approx(81.0));
+	  intercomms.CompleteMultiscale();
+	  REQUIRE(icand.GetPressure() == Approx(90.0));
+	}
+
 	SECTION("testMPWideApplication") {
 	  int argc;
 	  const char* argv[7];
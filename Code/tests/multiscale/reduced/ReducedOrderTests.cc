@@ -0,0 +1,192 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <cmath>
+#include <fstream>
+#include <memory>
+
+#include <catch2/catch.hpp>
+
+#include "Exception.h"
+#include "multiscale/reduced/ReducedOrderIntercommunicator.h"
+#include "multiscale/reduced/WindkesselModel.h"
+
+#include "tests/helpers/FolderTestFixture.h"
+
+namespace hemelb
+{
+  namespace tests
+  {
+    using namespace multiscale;
+
+    namespace
+    {
+      // An iolet as the reduced order intercommunicator sees it: the
+      // pressures it is given and the flow rate out through it.
+      class MockIoletIcand : public Intercommunicand
+      {
+      public:
+	MockIoletIcand() :
+	  pressure(this, 0.0), minPressure(this, 0.0), maxPressure(this, 0.0), flowRate(this, 0.0)
+	{
+	}
+	SharedValue<double> pressure;
+	SharedValue<double> minPressure;
+	SharedValue<double> maxPressure;
+	SharedValue<double> flowRate;
+      };
+
+      Windkessel MakeWindkessel()
+      {
+	Windkessel windkessel;
+	windkessel.proximalResistance = 1e7;
+	windkessel.compliance = 1e-9;
+	windkessel.distalResistance = 1e8;
+	windkessel.venousPressure = 5.0;
+	windkessel.initialPressure = 80.0;
+	return windkessel;
+      }
+    }
+
+    TEST_CASE("WindkesselModelTests") {
+      WindkesselModel model;
+      const Windkessel windkessel = MakeWindkessel();
+      model.AddBoundary("outlet0", windkessel);
+
+      REQUIRE(model.HasBoundary("outlet0"));
+      REQUIRE(!model.HasBoundary("outlet1"));
+      REQUIRE_THROWS_AS(model.GetPressure("outlet1"), Exception);
+
+      // Time constant Rd C = 0.1 s.
+      const double tau = windkessel.distalResistance * windkessel.compliance;
+      const double flowRate = 1e-7;
+
+      SECTION("Initial pressure includes the proximal drop") {
+	REQUIRE(model.GetPressure("outlet0") == Approx(80.0));
+	model.SetFlowRate("outlet0", flowRate);
+	REQUIRE(model.GetPressure("outlet0") == Approx(80.0 + 1.0));
+      }
+
+      SECTION("Relaxes exponentially to the steady state") {
+	model.SetFlowRate("outlet0", flowRate);
+	const double steady = 5.0 + windkessel.distalResistance * flowRate;
+
+	// Many small steps and one big one agree, since the update is exact.
+	for (int i = 0; i < 100; ++i)
+	  model.Advance(tau / 100);
+	const double expected = steady + (80.0 - steady) * std::exp(-1.0);
+	REQUIRE(model.GetPressure("outlet0") == Approx(expected + 1.0));
+
+	WindkesselModel oneStep;
+	oneStep.AddBoundary("outlet0", windkessel);
+	oneStep.SetFlowRate("outlet0", flowRate);
+	oneStep.Advance(tau);
+	REQUIRE(oneStep.GetPressure("outlet0") == Approx(model.GetPressure("outlet0")));
+
+	// And it settles at Pv + (Rp + Rd) Q, however long the step.
+	model.Advance(1000 * tau);
+	REQUIRE(model.GetPressure("outlet0") == Approx(steady + 1.0));
+      }
+
+      SECTION("No compliance is a pure resistance") {
+	Windkessel resistance = windkessel;
+	resistance.compliance = 0.0;
+	WindkesselModel r;
+	r.AddBoundary("outlet0", resistance);
+	r.SetFlowRate("outlet0", flowRate);
+	r.Advance(1e-6);
+	REQUIRE(r.GetPressure("outlet0") == Approx(5.0 + 11.0));
+      }
+    }
+
+    TEST_CASE_METHOD(helpers::FolderTestFixture, "WindkesselModelLoadTests") {
+      {
+	std::ofstream file("ReducedOrderModel.xml");
+	file << "<reducedordermodel>"
+	     << "<windkessel><label value=\"outlet0\"/>"
+	     << "<proximal_resistance value=\"1e7\" units=\"mmHg s/m^3\"/>"
+	     << "<compliance value=\"1e-9\" units=\"m^3/mmHg\"/>"
+	     << "<distal_resistance value=\"1e8\" units=\"mmHg s/m^3\"/>"
+	     << "<initial_pressure value=\"80\" units=\"mmHg\"/>"
+	     << "</windkessel>"
+	     << "<windkessel><label value=\"outlet1\"/>"
+	     << "<proximal_resistance value=\"0\" units=\"mmHg s/m^3\"/>"
+	     << "<compliance value=\"0\" units=\"m^3/mmHg\"/>"
+	     << "<distal_resistance value=\"2e8\" units=\"mmHg s/m^3\"/>"
+	     << "</windkessel>"
+	     << "</reducedordermodel>";
+      }
+
+      std::unique_ptr<WindkesselModel> model(WindkesselModel::Load("ReducedOrderModel.xml"));
+      REQUIRE(model->HasBoundary("outlet0"));
+      REQUIRE(model->HasBoundary("outlet1"));
+      REQUIRE(model->GetPressure("outlet0") == Approx(80.0));
+      REQUIRE(model->GetPressure("outlet1") == Approx(0.0));
+      model->SetFlowRate("outlet1", 1e-7);
+      model->Advance(0.01);
+      REQUIRE(model->GetPressure("outlet1") == Approx(20.0));
+    }
+
+    TEST_CASE("ReducedOrderIntercommunicatorTests") {
+      WindkesselModel model;
+      const Windkessel windkessel = MakeWindkessel();
+      model.AddBoundary("outlet0", windkessel);
+      const double flowRate = 1e-7;
+      const double dt = 1e-3;
+
+      // What the model gives after advancing by the steps taken.
+      auto expected = [&](int steps) {
+	WindkesselModel reference;
+	reference.AddBoundary("outlet0", windkessel);
+	reference.SetFlowRate("outlet0", flowRate);
+	for (int i = 0; i < steps; ++i)
+	  reference.Advance(dt);
+	return reference.GetPressure("outlet0");
+      };
+
+      MockIoletIcand outlet;
+      MockIoletIcand uncoupled;
+      uncoupled.pressure.SetPayload(3.0);
+
+      auto run = [&](bool concurrent) {
+	ReducedOrderIntercommunicator intercomms(true, model, concurrent);
+	// So the simulation master measures the rates it sends the model.
+	REQUIRE(intercomms.NeedsFlowRates());
+	ReducedOrderIntercommunicator::IntercommunicandTypeT ioletType("inoutlet");
+	ioletType.RegisterSharedValue<double>("pressure");
+	ioletType.RegisterSharedValue<double>("minPressure");
+	ioletType.RegisterSharedValue<double>("maxPressure");
+	ioletType.RegisterSharedValue<double>("flowRate");
+	intercomms.RegisterIntercommunicand(ioletType, outlet, "outlet0");
+	intercomms.RegisterIntercommunicand(ioletType, uncoupled, "inlet0");
+
+	intercomms.ShareInitialConditions();
+	REQUIRE(outlet.pressure.GetPayload() == Approx(80.0));
+	REQUIRE(outlet.maxPressure.GetPayload() == Approx(80.0));
+
+	outlet.flowRate.SetPayload(flowRate);
+	for (int step = 1; step <= 10; ++step)
+	{
+	  REQUIRE(intercomms.DoMultiscale(step * dt));
+	  // Advanced alongside the LB step, the model's pressures
+	  // arrive a step late.
+	  const double pressure = expected(concurrent ? step - 1 : step);
+	  REQUIRE(outlet.pressure.GetPayload() == Approx(pressure));
+	  REQUIRE(outlet.minPressure.GetPayload() == Approx(pressure));
+	  REQUIRE(outlet.maxPressure.GetPayload() == Approx(pressure));
+	}
+	REQUIRE(uncoupled.pressure.GetPayload() == 3.0);
+      };
+
+      SECTION("In place") {
+	run(false);
+      }
+      SECTION("Concurrent") {
+	run(true);
+      }
+    }
+  }
+}
@@ -4,6 +4,8 @@
 // file AUTHORS. This software is provided under the terms of the
 // license in the file LICENSE.
 
+#include <vector>
+
 #include <catch2/catch.hpp>
 
 #include "net/mpi.h"
@@ -46,5 +48,33 @@ namespace hemelb
 	REQUIRE(commWorld2 != commWorld);
       }
     }
+
+    TEST_CASE("MpiGatherV") {
+      MpiCommunicator commWorld = MpiCommunicator::World();
+      const int size = commWorld.Size();
+
+      // Rank r sends r % 3 values, so rank 0 (and every third rank) sends none.
+      auto valuesFrom = [](int rank) {
+	std::vector<int> values;
+	for (int k = 0; k < rank % 3; ++k)
+	  values.push_back(100 * rank + k);
+	return values;
+      };
+
+      // On the first and the last rank.
+      for (int root : { 0, size - 1 }) {
+	const std::vector<int> gathered = commWorld.GatherV(valuesFrom(commWorld.Rank()), root);
+	if (commWorld.Rank() == root) {
+	  std::vector<int> expected;
+	  for (int rank = 0; rank < size; ++rank) {
+	    const std::vector<int> values = valuesFrom(rank);
+	    expected.insert(expected.end(), values.begin(), values.end());
+	  }
+	  REQUIRE(gathered == expected);
+	} else {
+	  REQUIRE(gathered.empty());
+	}
+      }
+    }
   }
 }
@@ -0,0 +1,86 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <catch2/catch.hpp>
+
+#include "reporting/HardwareCounters.h"
+#include "reporting/KernelCounters.h"
+#include "reporting/KernelCounters.hpp"
+
+#include "tests/reporting/Mocks.h"
+#include "tests/helpers/HasCommsTestFixture.h"
+
+namespace hemelb
+{
+  namespace tests
+  {
+    using namespace hemelb::reporting;
+
+    using KernelCountersMock = KernelCountersBase<ClockMock, MPICommsPolicy>;
+
+    TEST_CASE("HardwareCountersTests") {
+      HardwareCounters hardware;
+      uint64_t first[HardwareCounters::numberOfEvents];
+      uint64_t second[HardwareCounters::numberOfEvents];
+
+      hardware.Read(first);
+      volatile double sum = 0.0;
+      for (int i = 0; i < 100000; ++i) {
+	sum = sum + i;
+      }
+      hardware.Read(second);
+
+      for (unsigned int event = 0; event < HardwareCounters::numberOfEvents; ++event) {
+	if (hardware.IsCounting(HardwareCounters::Event(event))) {
+	  REQUIRE(second[event] >= first[event]);
+	} else {
+	  // Events that can't be counted read as zero.
+	  REQUIRE(0U == first[event]);
+	  REQUIRE(0U == second[event]);
+	}
+      }
+    }
+
+    TEST_CASE_METHOD(helpers::HasCommsTestFixture, "KernelCountersTests") {
+      KernelCountersMock counters(Comms(), 15);
+
+      SECTION("TestInitialization") {
+	for (unsigned int segment = 0; segment < KernelCountersMock::numberOfSegments; ++segment) {
+	  REQUIRE(0.0 == counters.GetLocalSiteUpdates(segment));
+	  REQUIRE(0.0 == counters.GetLocalTime(segment));
+	}
+      }
+
+      SECTION("TestStartStop") {
+	counters.Start(); // clock mock at 10.0
+	counters.Stop(KernelCountersMock::preReceive, 1000); // clock mock at 20.0
+	counters.Start(); // clock mock at 30.0
+	counters.Stop(KernelCountersMock::preSend + 1, 500); // clock mock at 40.0
+	counters.Start(); // clock mock at 50.0
+	counters.Stop(KernelCountersMock::preReceive, 1000); // clock mock at 60.0
+
+	REQUIRE(Approx(2000.0) == counters.GetLocalSiteUpdates(KernelCountersMock::preReceive));
+	REQUIRE(Approx(20.0) == counters.GetLocalTime(KernelCountersMock::preReceive));
+	REQUIRE(Approx(500.0) == counters.GetLocalSiteUpdates(KernelCountersMock::preSend + 1));
+	REQUIRE(Approx(10.0) == counters.GetLocalTime(KernelCountersMock::preSend + 1));
+	REQUIRE(0.0 == counters.GetLocalSiteUpdates(KernelCountersMock::preSend));
+      }
+
+      SECTION("TestReduce") {
+	counters.Start();
+	counters.Stop(KernelCountersMock::preReceive, 1000);
+	counters.Reduce();
+
+	if (Comms().Rank() == 0) {
+	  // Every process does the same, so the rate per core is unchanged.
+	  REQUIRE(Approx(1000.0 / 10.0 / 1e6) == counters.GetMlups(KernelCountersMock::preReceive));
+	  REQUIRE(0.0 == counters.GetMlups(KernelCountersMock::preSend));
+	  REQUIRE(counters.GetBytesPerSiteUpdate(KernelCountersMock::preReceive) >= 0.0);
+	}
+      }
+    }
+  }
+}
@@ -0,0 +1,110 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "io/formats/formats.h"
+#include "io/formats/trace.h"
+#include "io/writers/xdr/XdrMemReader.h"
+#include "reporting/TimingTrace.h"
+#include "net/IOCommunicator.h"
+
+#include "tests/helpers/HasCommsTestFixture.h"
+
+namespace hemelb
+{
+  namespace tests
+  {
+    namespace fmt = hemelb::io::formats;
+
+    TEST_CASE_METHOD(helpers::HasCommsTestFixture, "TimingTraceTests") {
+      const char* traceFileName = "timings.trace";
+      const unsigned int stepsPerBlock = 4;
+      const unsigned int nTimers = reporting::TimingTrace::numberOfTracedTimers;
+      if (Comms().OnIORank())
+	std::remove(traceFileName);
+      MPI_Barrier(Comms());
+
+      auto timers = reporting::Timers(Comms());
+
+      {
+	reporting::TimingTrace trace(Comms(), traceFileName, stepsPerBlock);
+	// Six steps: one full block, written by Record, then two by Flush.
+	for (unsigned int step = 1; step <= 6; ++step) {
+	  for (unsigned int i = 0; i < nTimers; ++i) {
+	    auto& timer = timers[reporting::TimingTrace::tracedTimers[i]];
+	    timer.Set(timer.Get() + step + 0.125 * i);
+	  }
+	  trace.Record(step, timers);
+	}
+	trace.Flush();
+      }
+
+      std::FILE* file = std::fopen(traceFileName, "rb");
+      REQUIRE(file != nullptr);
+      std::vector<char> contents;
+      char buf[4096];
+      for (size_t n; (n = std::fread(buf, 1, sizeof(buf), file)) > 0;)
+	contents.insert(contents.end(), buf, buf + n);
+      std::fclose(file);
+      MPI_Barrier(Comms());
+      if (Comms().OnIORank())
+	std::remove(traceFileName);
+
+      const uint64_t firstBlock = fmt::trace::GetFirstBlockOffset(nTimers);
+      const uint64_t blockLength = fmt::trace::GetBlockLength(Comms().Size(), nTimers, stepsPerBlock);
+      REQUIRE(contents.size() == firstBlock + 2 * blockLength);
+
+      io::writers::xdr::XdrMemReader reader(contents.data(), fmt::trace::PreambleLength);
+      uint32_t hlbMagic, traceMagic, version, marker, nRanks, nTraced, steps;
+      reader.read(hlbMagic);
+      reader.read(traceMagic);
+      reader.read(version);
+      reader.read(marker);
+      reader.read(nRanks);
+      reader.read(nTraced);
+      reader.read(steps);
+      REQUIRE(hlbMagic == uint32_t(fmt::HemeLbMagicNumber));
+      REQUIRE(traceMagic == uint32_t(fmt::trace::MagicNumber));
+      REQUIRE(version == uint32_t(fmt::trace::VersionNumber));
+      REQUIRE(nRanks == uint32_t(Comms().Size()));
+      REQUIRE(nTraced == nTimers);
+      REQUIRE(steps == stepsPerBlock);
+
+      std::memcpy(&marker, contents.data() + 12, sizeof(marker));
+      REQUIRE(marker == uint32_t(fmt::trace::ByteOrderMarker));
+
+      REQUIRE(std::string(contents.data() + fmt::trace::PreambleLength) == "Lattice Boltzmann");
+
+      for (unsigned int block = 0; block < 2; ++block) {
+	const char* blockData = contents.data() + firstBlock + block * blockLength;
+	uint64_t firstStep;
+	uint32_t stepCount;
+	std::memcpy(&firstStep, blockData, sizeof(firstStep));
+	std::memcpy(&stepCount, blockData + sizeof(firstStep), sizeof(stepCount));
+	REQUIRE(firstStep == 1 + block * stepsPerBlock);
+	REQUIRE(stepCount == (block == 0 ? 4U : 2U));
+
+	std::vector<float> slab(stepsPerBlock * nTimers);
+	std::memcpy(slab.data(),
+		    blockData + fmt::trace::BlockHeaderLength
+		    + Comms().Rank() * fmt::trace::GetSlabLength(nTimers, stepsPerBlock),
+		    slab.size() * sizeof(float));
+	for (unsigned int s = 0; s < stepsPerBlock; ++s) {
+	  const unsigned int step = 1 + block * stepsPerBlock + s;
+	  for (unsigned int i = 0; i < nTimers; ++i) {
+	    const float expected = s < stepCount ? float(step + 0.125 * i) : 0.0F;
+	    REQUIRE(Approx(expected) == slab[s * nTimers + i]);
+	  }
+	}
+      }
+    }
+  }
+}
@@ -0,0 +1,134 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "steering/common/ImageEncoder.h"
+
+namespace hemelb
+{
+  namespace tests
+  {
+    namespace {
+      const int width = 64;
+      const int height = 48;
+
+      // Raw pixel data, as written by vis::Control::WritePixels, for a disc of pixels whose
+      // colours depend on position and frame.
+      std::vector<char> MakeRawPixels(int frame) {
+	std::vector<char> raw;
+	for (int x = 0; x < width; ++x)
+	  for (int y = 0; y < height; ++y) {
+	    if ((x - 32) * (x - 32) + (y - 24) * (y - 24) > 400)
+	      continue;
+	    const uint32_t index = (uint32_t(x) << 16) + uint32_t(y);
+	    for (int shift = 24; shift >= 0; shift -= 8)
+	      raw.push_back(char(index >> shift));
+	    for (int colour = 0; colour < 12; ++colour)
+	      raw.push_back(char(x * 3 + y * 5 + colour * 7 + (x < 4 + frame ? 60 : 0)));
+	  }
+	return raw;
+      }
+
+      // The frame as sent: tag, encoding, then the deflated image as XDR opaque.
+      std::vector<char> MakeFrame(steering::ImageEncoder::Encoding encoding, const std::string& deflated) {
+	std::vector<char> frame;
+	const uint32_t words[3] = { steering::ImageEncoder::FrameTag, uint32_t(encoding), uint32_t(deflated.size()) };
+	for (auto word : words)
+	  for (int shift = 24; shift >= 0; shift -= 8)
+	    frame.push_back(char(word >> shift));
+	frame.insert(frame.end(), deflated.begin(), deflated.end());
+	frame.resize(12 + 4 * ((deflated.size() + 3) / 4), 0);
+	return frame;
+      }
+    }
+
+    TEST_CASE("ImageEncoder") {
+      using steering::ImageEncoder;
+      steering::ImageEncoder encoder;
+      steering::ImageDecoder rawDecoder;
+      steering::ImageDecoder decoder;
+      std::vector<unsigned char> expected;
+      std::vector<unsigned char> decoded;
+      std::string deflated;
+
+      SECTION("Raw frames decode to white outside the pixels") {
+	auto raw = MakeRawPixels(0);
+	rawDecoder.Decode(raw.data(), raw.size(), width, height, expected);
+	REQUIRE(expected.size() == 12u * width * height);
+	REQUIRE(expected[0] == 255);
+	REQUIRE(expected[24 * width + 32] == (unsigned char) (32 * 3 + 24 * 5));
+      }
+
+      SECTION("Lossless frames round trip") {
+	for (int frame = 0; frame < 5; ++frame) {
+	  auto raw = MakeRawPixels(frame);
+	  auto used = encoder.Encode(raw.data(), raw.size() / 16, width, height,
+				     ImageEncoder::DeltaDeflate, 8, deflated);
+	  REQUIRE(used == (frame == 0 ? ImageEncoder::Deflate : ImageEncoder::DeltaDeflate));
+	  REQUIRE(deflated.size() < raw.size());
+
+	  auto sent = MakeFrame(used, deflated);
+	  decoder.Decode(sent.data(), sent.size(), width, height, decoded);
+	  rawDecoder.Decode(raw.data(), raw.size(), width, height, expected);
+	  REQUIRE(decoded == expected);
+	}
+      }
+
+      SECTION("Deltas are smaller than whole frames") {
+	auto first = MakeRawPixels(0);
+	auto second = MakeRawPixels(1);
+	encoder.Encode(first.data(), first.size() / 16, width, height, ImageEncoder::DeltaDeflate, 8, deflated);
+	encoder.Encode(second.data(), second.size() / 16, width, height, ImageEncoder::DeltaDeflate, 8, deflated);
+	const size_t deltaSize = deflated.size();
+
+	steering::ImageEncoder wholeEncoder;
+	wholeEncoder.Encode(second.data(), second.size() / 16, width, height, ImageEncoder::Deflate, 8, deflated);
+	REQUIRE(deltaSize < deflated.size());
+      }
+
+      SECTION("Resizing and resetting send a key frame") {
+	auto raw = MakeRawPixels(0);
+	REQUIRE(encoder.Encode(raw.data(), raw.size() / 16, width, height, ImageEncoder::DeltaDeflate, 8, deflated)
+		== ImageEncoder::Deflate);
+	REQUIRE(encoder.Encode(raw.data(), raw.size() / 16, width, height + 1, ImageEncoder::DeltaDeflate, 8, deflated)
+		== ImageEncoder::Deflate);
+	REQUIRE(encoder.Encode(raw.data(), raw.size() / 16, width, height + 1, ImageEncoder::DeltaDeflate, 8, deflated)
+		== ImageEncoder::DeltaDeflate);
+	encoder.Reset();
+	REQUIRE(encoder.Encode(raw.data(), raw.size() / 16, width, height + 1, ImageEncoder::DeltaDeflate, 8, deflated)
+		== ImageEncoder::Deflate);
+      }
+
+      SECTION("Fewer colour bits keep black and white and stay close") {
+	auto raw = MakeRawPixels(0);
+	auto used = encoder.Encode(raw.data(), raw.size() / 16, width, height, ImageEncoder::Deflate, 4, deflated);
+	auto sent = MakeFrame(used, deflated);
+	decoder.Decode(sent.data(), sent.size(), width, height, decoded);
+	rawDecoder.Decode(raw.data(), raw.size(), width, height, expected);
+
+	REQUIRE(decoded.size() == expected.size());
+	for (size_t i = 0; i < expected.size(); ++i) {
+	  if (expected[i] == 0 || expected[i] == 255)
+	    REQUIRE(decoded[i] == expected[i]);
+	  REQUIRE(std::abs(int(decoded[i]) - int(expected[i])) <= 17);
+	}
+      }
+
+      SECTION("A delta without its previous frame is rejected") {
+	auto raw = MakeRawPixels(0);
+	encoder.Encode(raw.data(), raw.size() / 16, width, height, ImageEncoder::DeltaDeflate, 8, deflated);
+	encoder.Encode(raw.data(), raw.size() / 16, width, height, ImageEncoder::DeltaDeflate, 8, deflated);
+	auto sent = MakeFrame(ImageEncoder::DeltaDeflate, deflated);
+	REQUIRE_THROWS(decoder.Decode(sent.data(), sent.size(), width, height, decoded));
+      }
+    }
+  }
+}
@@ -0,0 +1,130 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <catch2/catch.hpp>
+
+#include "steering/Network.h"
+#include "tests/helpers/FolderTestFixture.h"
+
+namespace hemelb
+{
+  namespace tests
+  {
+    namespace {
+      // Poll until the condition holds, or give up after a few seconds.
+      template<typename Condition>
+      bool WaitFor(Condition condition) {
+	for (int i = 0; i < 500; ++i) {
+	  if (condition())
+	    return true;
+	  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	return false;
+      }
+
+      // A steering client on the loopback interface.
+      class LoopbackClient {
+      public:
+	LoopbackClient() : sock(socket(AF_INET, SOCK_STREAM, 0)) {
+	  struct timeval timeout = {5, 0};
+	  setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	}
+	~LoopbackClient() {
+	  Close();
+	}
+	bool Connect() {
+	  struct sockaddr_in address;
+	  memset(&address, 0, sizeof(address));
+	  address.sin_family = AF_INET;
+	  address.sin_port = htons(steering::ClientConnection::MYPORT);
+	  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	  return connect(sock, (struct sockaddr*) &address, sizeof(address)) == 0;
+	}
+	std::string Receive(size_t length) {
+	  std::string got;
+	  char buf[256];
+	  while (got.length() < length) {
+	    ssize_t n = recv(sock, buf, std::min(sizeof(buf), length - got.length()), 0);
+	    if (n <= 0)
+	      break;
+	    got.append(buf, n);
+	  }
+	  return got;
+	}
+	void Send(const std::string& data) {
+	  REQUIRE(send(sock, data.data(), data.length(), 0) == ssize_t(data.length()));
+	}
+	void Close() {
+	  if (sock >= 0)
+	    close(sock);
+	  sock = -1;
+	}
+      private:
+	int sock;
+      };
+    }
+
+    TEST_CASE_METHOD(helpers::FolderTestFixture, "SteeringNetworkTests") {
+      // The steering port is fixed, so only one process can listen on it.
+      if (!Comms().OnIORank())
+	return;
+
+      reporting::Timers timings(Comms());
+      steering::Network network(0, timings);
+      REQUIRE(!network.IsConnected());
+      REQUIRE(!network.send_all("x", 1));
+
+      LoopbackClient client;
+      REQUIRE(client.Connect());
+      REQUIRE(WaitFor([&]() { return network.IsConnected(); }));
+
+      SECTION("Frames reach the client whole and in order") {
+	const std::string first(100000, 'a');
+	const std::string second = "second frame";
+	REQUIRE(network.send_all(first.data(), first.length()));
+	REQUIRE(client.Receive(first.length()) == first);
+	REQUIRE(network.send_all(second.data(), second.length()));
+	REQUIRE(client.Receive(second.length()) == second);
+      }
+
+      SECTION("Steering parameters arrive in whole records") {
+	char buf[8];
+	REQUIRE(!network.recv_all(buf, 8));
+	client.Send("0123");
+	client.Send("4567abcd");
+	REQUIRE(WaitFor([&]() { return network.recv_all(buf, 8); }));
+	REQUIRE(std::string(buf, 8) == "01234567");
+	REQUIRE(WaitFor([&]() { return network.recv_all(buf, 4); }));
+	REQUIRE(std::string(buf, 4) == "abcd");
+	REQUIRE(!network.recv_all(buf, 1));
+      }
+
+      SECTION("A new client starts afresh") {
+	client.Send("stale");
+	client.Close();
+	REQUIRE(WaitFor([&]() { return !network.IsConnected(); }));
+	REQUIRE(!network.send_all("x", 1));
+
+	LoopbackClient next;
+	REQUIRE(next.Connect());
+	REQUIRE(WaitFor([&]() { return network.IsConnected(); }));
+	next.Send("fresh");
+	char buf[5];
+	REQUIRE(WaitFor([&]() { return network.recv_all(buf, 5); }));
+	REQUIRE(std::string(buf, 5) == "fresh");
+      }
+    }
+  }
+}
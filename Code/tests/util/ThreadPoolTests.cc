@@ -0,0 +1,51 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "util/ThreadPool.h"
+
+namespace hemelb
+{
+  namespace unittests
+  {
+    using namespace hemelb::util;
+
+    TEST_CASE("ThreadPool runs every task exactly once") {
+      const unsigned int threadCount = GENERATE(1U, 4U);
+      ThreadPool pool(threadCount);
+      REQUIRE(pool.GetThreadCount() == threadCount);
+
+      const unsigned int taskCount = 1000;
+      std::vector<int> runs(taskCount, 0);
+      std::vector<unsigned int> perThread(threadCount, 0);
+
+      // Run several times to check the pool can be reused.
+      for (int repeat = 0; repeat < 3; ++repeat)
+      {
+	pool.Run(taskCount, [&](unsigned int task, unsigned int thread) {
+	    ++runs[task];
+	    ++perThread[thread];
+	  });
+      }
+
+      for (unsigned int task = 0; task < taskCount; ++task)
+	REQUIRE(runs[task] == 3);
+
+      unsigned int total = 0;
+      for (unsigned int thread = 0; thread < threadCount; ++thread)
+	total += perThread[thread];
+      REQUIRE(total == 3 * taskCount);
+
+      // An empty run must return straight away.
+      pool.Run(0, [&](unsigned int, unsigned int) {
+	  FAIL("No tasks should run");
+	});
+    }
+  }
+}
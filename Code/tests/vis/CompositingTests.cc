@@ -0,0 +1,232 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "net/net.h"
+#include "vis/Compositing.h"
+#include "vis/PixelSet.h"
+
+#include "tests/helpers/HasCommsTestFixture.h"
+
+namespace hemelb
+{
+  namespace tests
+  {
+    namespace {
+      // Pixel whose value is the sum of everything combined into it, so the
+      // result doesn't depend on the order pixels are merged in.
+      class SummingPixel
+      {
+	public:
+	  SummingPixel() : i(0), j(0), sum(0)
+	  {
+	  }
+	  SummingPixel(int i, int j, int sum) : i(i), j(j), sum(sum)
+	  {
+	  }
+	  int GetI() const
+	  {
+	    return i;
+	  }
+	  int GetJ() const
+	  {
+	    return j;
+	  }
+	  int GetSum() const
+	  {
+	    return sum;
+	  }
+	  void Combine(const SummingPixel& other)
+	  {
+	    sum += other.sum;
+	  }
+	  bool operator<(const SummingPixel& other) const
+	  {
+	    return std::make_tuple(i, j, sum) < std::make_tuple(other.i, other.j, other.sum);
+	  }
+	  bool operator==(const SummingPixel& other) const
+	  {
+	    return i == other.i && j == other.j && sum == other.sum;
+	  }
+	private:
+	  int i;
+	  int j;
+	  int sum;
+      };
+
+      // A single pixel set with the interface of a Rendering.
+      class Image
+      {
+	public:
+	  void Clear()
+	  {
+	    pixels.Clear();
+	  }
+	  void SendPixelCounts(net::Net* net, proc_t destination)
+	  {
+	    pixels.SendQuantity(net, destination);
+	  }
+	  void SendPixelData(net::Net* net, proc_t destination)
+	  {
+	    pixels.SendPixels(net, destination);
+	  }
+	  void ReceivePixelCounts(net::Net* net, proc_t source)
+	  {
+	    pixels.ReceiveQuantity(net, source);
+	  }
+	  void ReceivePixelData(net::Net* net, proc_t source)
+	  {
+	    pixels.ReceivePixels(net, source);
+	  }
+	  void Combine(const Image& other)
+	  {
+	    pixels.Combine(other.pixels);
+	  }
+	  void MovePixelsOutside(int iBegin, int iEnd, Image& other)
+	  {
+	    pixels.MovePixelsOutside(iBegin, iEnd, other.pixels);
+	  }
+	  void GatherDisjoint(const net::MpiCommunicator& comm, proc_t root)
+	  {
+	    pixels.GatherDisjoint(comm, root);
+	  }
+
+	  vis::PixelSet<SummingPixel> pixels;
+      };
+
+      const int Columns = 50;
+      const int Rows = 20;
+
+      // A different, overlapping image on each rank.
+      void Draw(Image& image, proc_t rank)
+      {
+	for (int i = 0; i < Columns; ++i)
+	  for (int j = 0; j < Rows; ++j)
+	    if ((7 * i + 3 * j + rank) % 4 != 0)
+	      image.pixels.AddPixel(SummingPixel(i, j, 1 + rank + i * j));
+      }
+
+      // The compositing the visualisation used before binary swap: each level
+      // merges pairs of images onto the lower rank, until proc 1 has the whole
+      // image, which it sends to proc 0. Proc 0 used to have no fluid sites, so
+      // its own image is left out.
+      void CompositeSequentially(Image& localImage, Image& receiveImage, net::Net& net)
+      {
+	const net::MpiCommunicator& comm = net.GetCommunicator();
+	for (proc_t deltaRank = 1; deltaRank < comm.Size(); deltaRank <<= 1)
+	{
+	  for (proc_t receivingProc = 1; receivingProc < (comm.Size() - deltaRank);
+	       receivingProc += deltaRank << 1)
+	  {
+	    const proc_t sendingProc = receivingProc + deltaRank;
+	    if (comm.Rank() == sendingProc)
+	    {
+	      localImage.SendPixelCounts(&net, receivingProc);
+	      net.Dispatch();
+	      localImage.SendPixelData(&net, receivingProc);
+	      net.Dispatch();
+	    }
+	    else if (comm.Rank() == receivingProc)
+	    {
+	      receiveImage.Clear();
+	      receiveImage.ReceivePixelCounts(&net, sendingProc);
+	      net.Dispatch();
+	      receiveImage.ReceivePixelData(&net, sendingProc);
+	      net.Dispatch();
+	      localImage.Combine(receiveImage);
+	    }
+	  }
+	}
+
+	if (comm.Rank() == 1)
+	{
+	  localImage.SendPixelCounts(&net, 0);
+	  net.Dispatch();
+	  localImage.SendPixelData(&net, 0);
+	  net.Dispatch();
+	}
+	else if (comm.Rank() == 0 && comm.Size() > 1)
+	{
+	  receiveImage.Clear();
+	  receiveImage.ReceivePixelCounts(&net, 1);
+	  net.Dispatch();
+	  receiveImage.ReceivePixelData(&net, 1);
+	  net.Dispatch();
+	  localImage.Clear();
+	  localImage.Combine(receiveImage);
+	}
+      }
+
+      std::vector<SummingPixel> Sorted(const Image& image)
+      {
+	std::vector<SummingPixel> pixels = image.pixels.GetPixels();
+	std::sort(pixels.begin(), pixels.end());
+	return pixels;
+      }
+    }
+  }
+
+  namespace net
+  {
+    template<>
+    MPI_Datatype MpiDataTypeTraits<tests::SummingPixel>::RegisterMpiDataType()
+    {
+      MPI_Datatype type;
+      HEMELB_MPI_CALL(MPI_Type_contiguous, (3, MPI_INT, &type));
+      HEMELB_MPI_CALL(MPI_Type_commit, (&type));
+      return type;
+    }
+  }
+
+  namespace tests
+  {
+    TEST_CASE_METHOD(helpers::HasCommsTestFixture, "CompositingTests") {
+      // Composite over the first 1, 2, ... ranks, so runs with three or more
+      // ranks include counts that aren't powers of two.
+      for (proc_t procs = 1; procs <= Comms().Size(); ++procs)
+      {
+	std::vector<proc_t> ranks;
+	for (proc_t rank = 0; rank < procs; ++rank)
+	  ranks.push_back(rank);
+	const net::MpiCommunicator comm = Comms().Create(Comms().Group().Include(ranks));
+	if (!comm)
+	  continue;
+
+	net::Net net(comm);
+	Image send, receive;
+
+	// Against the old compositing, with nothing drawn on proc 0 as it assumed.
+	Image swapped, merged;
+	if (comm.Rank() > 0)
+	{
+	  Draw(swapped, comm.Rank());
+	  Draw(merged, comm.Rank());
+	}
+	vis::CompositeByBinarySwap(swapped, send, receive, Columns, net);
+	CompositeSequentially(merged, receive, net);
+	if (comm.Rank() == 0)
+	  CHECK(Sorted(swapped) == Sorted(merged));
+
+	// And with every proc drawing, against all the images merged on proc 0.
+	Image all;
+	Draw(all, comm.Rank());
+	vis::CompositeByBinarySwap(all, send, receive, Columns, net);
+	if (comm.Rank() == 0)
+	{
+	  Image expected;
+	  for (proc_t rank = 0; rank < procs; ++rank)
+	    Draw(expected, rank);
+	  CHECK(all.pixels.GetPixelCount() > 0);
+	  CHECK(Sorted(all) == Sorted(expected));
+	}
+      }
+    }
+  }
+}
@@ -0,0 +1,149 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "lb/MacroscopicPropertyCache.h"
+#include "lb/SimulationState.h"
+#include "net/net.h"
+#include "reporting/Timers.h"
+#include "vis/Control.h"
+
+#include "tests/helpers/FourCubeLatticeData.h"
+#include "tests/helpers/HasCommsTestFixture.h"
+
+namespace hemelb
+{
+  namespace tests
+  {
+    namespace {
+      // Exposes the initial action, so a render can be started without
+      // driving the whole phased broadcast.
+      class TestableControl : public vis::Control
+      {
+      public:
+	using vis::Control::Control;
+	using vis::Control::InitialAction;
+      };
+
+      // Fluid properties that vary across the cube; scale changes all of them.
+      void FillCaches(lb::MacroscopicPropertyCache& cache,
+		      const geometry::LatticeData& latDat, double scale)
+      {
+	for (site_t site = 0; site < latDat.GetLocalFluidSiteCount(); ++site)
+	{
+	  const util::Vector3D<site_t> x = latDat.GetSite(site).GetGlobalSiteCoords();
+	  cache.densityCache.Put(site, 1.0 + 0.002 * scale * (x.x + x.y + x.z));
+	  cache.velocityCache.Put(site, util::Vector3D<distribn_t>(x.x, x.y, x.z) * (0.002 * scale));
+	  cache.wallShearStressMagnitudeCache.Put(site, 0.001 * scale * x.z);
+	  cache.vonMisesStressCache.Put(site, 0.001 * scale * x.x);
+	}
+      }
+
+      typedef std::pair<unsigned, std::array<unsigned char, 12> > EncodedPixel;
+
+      // The pixels as WritePixels would send them, in a canonical order.
+      std::vector<EncodedPixel> Encode(const vis::Control& control,
+				       const vis::PixelSet<vis::ResultPixel>* pixels)
+      {
+	REQUIRE(pixels != NULL);
+	std::vector<EncodedPixel> encoded;
+	for (std::vector<vis::ResultPixel>::const_iterator it = pixels->GetPixels().begin();
+	     it != pixels->GetPixels().end(); ++it)
+	{
+	  EncodedPixel pixel;
+	  pixel.second.fill(0);
+	  it->WritePixel(&pixel.first, pixel.second.data(), control.domainStats, control.visSettings);
+	  encoded.push_back(pixel);
+	}
+	std::sort(encoded.begin(), encoded.end());
+	return encoded;
+      }
+    }
+
+    TEST_CASE_METHOD(helpers::HasCommsTestFixture, "ControlTests") {
+      std::unique_ptr<FourCubeLatticeData> latDat(FourCubeLatticeData::Create(Comms(), 10));
+      lb::SimulationState simState(0.0001, 1000);
+      lb::MacroscopicPropertyCache propertyCache(simState, *latDat);
+      FillCaches(propertyCache, *latDat, 1.0);
+
+      net::Net syncNet(Comms());
+      net::Net backgroundNet(Comms());
+      reporting::Timer syncTimer;
+      reporting::Timer backgroundTimer;
+
+      // The same view rendered the old, synchronous way and on a background
+      // thread with a two step lag.
+      TestableControl synchronous(lb::VonMises, &syncNet, &simState, propertyCache,
+				  latDat.get(), syncTimer, 0);
+      TestableControl background(lb::VonMises, &backgroundNet, &simState, propertyCache,
+				 latDat.get(), backgroundTimer, 2);
+
+      for (TestableControl* control : { &synchronous, &background })
+      {
+	control->visSettings.mode = vis::VisSettings::ISOSURFACESANDGLYPHS;
+	control->visSettings.glyphLength = 1.0F;
+	control->SetSomeParams(1.0F, 1.0, 20.0, 20.0, 50.0);
+	control->SetProjection(64, 64,
+			       control->visSettings.ctr_x,
+			       control->visSettings.ctr_y,
+			       control->visSettings.ctr_z,
+			       45.0F, 45.0F, 1.0F);
+      }
+
+      synchronous.InitialAction(1);
+      const std::vector<EncodedPixel> before = Encode(synchronous, synchronous.GetResult(1));
+      FillCaches(propertyCache, *latDat, 2.0);
+      synchronous.InitialAction(2);
+      const std::vector<EncodedPixel> after = Encode(synchronous, synchronous.GetResult(2));
+      FillCaches(propertyCache, *latDat, 1.0);
+
+      // Otherwise the checks below couldn't tell which data were rendered.
+      // The four cube is all on the first rank.
+      if (latDat->GetLocalFluidSiteCount() > 0)
+	REQUIRE(before != after);
+
+      SECTION("BackgroundRenderMatchesSynchronous") {
+	background.InitialAction(1);
+	REQUIRE(Encode(background, background.GetResult(1)) == before);
+      }
+
+      SECTION("BackgroundRenderUsesSnapshot") {
+	// The simulation carries on while the render is in flight.
+	background.InitialAction(1);
+	FillCaches(propertyCache, *latDat, 2.0);
+	REQUIRE(Encode(background, background.GetResult(1)) == before);
+      }
+
+      SECTION("NextRenderWaitsForSnapshot") {
+	background.InitialAction(1);
+	FillCaches(propertyCache, *latDat, 2.0);
+	// Must not overwrite the snapshot until the first render is done with it.
+	background.InitialAction(2);
+	FillCaches(propertyCache, *latDat, 1.0);
+	REQUIRE(Encode(background, background.GetResult(1)) == before);
+	REQUIRE(Encode(background, background.GetResult(2)) == after);
+      }
+
+      SECTION("SettingsWaitForRender") {
+	background.InitialAction(1);
+	// The ray tracer reads the projection, so changing it must wait.
+	background.SetProjection(64, 64,
+				 background.visSettings.ctr_x,
+				 background.visSettings.ctr_y,
+				 background.visSettings.ctr_z,
+				 10.0F, 80.0F, 2.0F);
+	REQUIRE(Encode(background, background.GetResult(1)) == before);
+      }
+    }
+  }
+}
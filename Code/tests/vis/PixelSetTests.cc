@@ -0,0 +1,115 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <catch2/catch.hpp>
+
+#include "vis/PixelSet.h"
+
+namespace hemelb
+{
+  namespace tests
+  {
+    namespace {
+      // Minimal pixel type that records how many pixels were combined into it.
+      class CountingPixel
+      {
+	public:
+	  CountingPixel(int i, int j) : i(i), j(j), hits(1)
+	  {
+	  }
+	  int GetI() const
+	  {
+	    return i;
+	  }
+	  int GetJ() const
+	  {
+	    return j;
+	  }
+	  int GetHits() const
+	  {
+	    return hits;
+	  }
+	  void Combine(const CountingPixel& other)
+	  {
+	    hits += other.hits;
+	  }
+	private:
+	  int i;
+	  int j;
+	  int hits;
+      };
+
+      const CountingPixel& Find(const vis::PixelSet<CountingPixel>& set, int i, int j)
+      {
+	const std::vector<CountingPixel>& pixels = set.GetPixels();
+	for (std::vector<CountingPixel>::const_iterator it = pixels.begin(); it != pixels.end(); ++it)
+	  if (it->GetI() == i && it->GetJ() == j)
+	    return *it;
+	FAIL("Pixel not found");
+	return pixels.front();
+      }
+    }
+
+    TEST_CASE("PixelSet") {
+      vis::PixelSet<CountingPixel> set;
+
+      SECTION("AddAndCombine") {
+	set.AddPixel(CountingPixel(0, 0));
+	set.AddPixel(CountingPixel(15, 16));
+	// Far enough away to grow the tile grid in both directions
+	set.AddPixel(CountingPixel(1000, 700));
+	set.AddPixel(CountingPixel(15, 16));
+	set.AddPixel(CountingPixel(1000, 700));
+	set.AddPixel(CountingPixel(1000, 700));
+
+	REQUIRE(set.GetPixelCount() == 3);
+	REQUIRE(Find(set, 0, 0).GetHits() == 1);
+	REQUIRE(Find(set, 15, 16).GetHits() == 2);
+	REQUIRE(Find(set, 1000, 700).GetHits() == 3);
+
+	vis::PixelSet<CountingPixel> other;
+	other.AddPixel(CountingPixel(0, 0));
+	other.AddPixel(CountingPixel(3, 4));
+	set.Combine(other);
+	REQUIRE(set.GetPixelCount() == 4);
+	REQUIRE(Find(set, 0, 0).GetHits() == 2);
+	REQUIRE(Find(set, 3, 4).GetHits() == 1);
+      }
+
+      SECTION("ClearAndReuse") {
+	set.AddPixel(CountingPixel(5, 5));
+	set.AddPixel(CountingPixel(40, 2));
+	set.Clear();
+	REQUIRE(set.GetPixelCount() == 0);
+
+	set.AddPixel(CountingPixel(40, 2));
+	set.AddPixel(CountingPixel(6, 5));
+	REQUIRE(set.GetPixelCount() == 2);
+	REQUIRE(Find(set, 40, 2).GetHits() == 1);
+	REQUIRE(Find(set, 6, 5).GetHits() == 1);
+      }
+
+      SECTION("MovePixelsOutside") {
+	for (int i = 0; i < 40; ++i)
+	  set.AddPixel(CountingPixel(i, i % 3));
+
+	vis::PixelSet<CountingPixel> moved;
+	set.MovePixelsOutside(10, 20, moved);
+	REQUIRE(set.GetPixelCount() == 10);
+	REQUIRE(moved.GetPixelCount() == 30);
+
+	// The kept pixels must still be found by the lookup
+	set.AddPixel(CountingPixel(12, 0));
+	REQUIRE(set.GetPixelCount() == 10);
+	REQUIRE(Find(set, 12, 0).GetHits() == 2);
+
+	// And the moved ones must be gone from it
+	set.AddPixel(CountingPixel(25, 1));
+	REQUIRE(set.GetPixelCount() == 11);
+      }
+    }
+  }
+}
@@ -0,0 +1,35 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "lb/lattices/D3Q15.h"
+
+#include "tests/vis/streaklines/CubeRow.h"
+
+namespace hemelb
+{
+  namespace tests
+  {
+    namespace streaklines
+    {
+      geometry::Geometry CreateCubeRow(proc_t cubeCount)
+      {
+	geometry::Geometry geometry(util::Vector3D<site_t>(cubeCount, 1, 1), CubeSize);
+
+	for (proc_t cube = 0; cube < cubeCount; ++cube) {
+	  geometry::BlockReadResult& block = geometry.Blocks[cube];
+	  block.Sites.resize(geometry.GetSitesPerBlock(), geometry::GeometrySite(true));
+
+	  for (geometry::GeometrySite& site: block.Sites) {
+	    site.targetProcessor = cube;
+	    // No cuts: the links out of the row lead nowhere.
+	    site.links.resize(lb::lattices::D3Q15::NUMVECTORS - 1);
+	  }
+	}
+
+	return geometry;
+      }
+    }
+  }
+}
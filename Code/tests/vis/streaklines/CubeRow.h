@@ -0,0 +1,35 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_TESTS_VIS_STREAKLINES_CUBEROW_H
+#define HEMELB_TESTS_VIS_STREAKLINES_CUBEROW_H
+
+#include "geometry/Geometry.h"
+#include "units.h"
+
+namespace hemelb
+{
+  namespace tests
+  {
+    namespace streaklines
+    {
+      // The side of each block, in sites.
+      const site_t CubeSize = 4;
+
+      // A row of cubeCount blocks along x, all fluid, with every site of
+      // block n on rank n. Each rank's sites are next to those of the ranks
+      // either side of it, but no others.
+      geometry::Geometry CreateCubeRow(proc_t cubeCount);
+
+      // The rank owning the site at x in the row.
+      inline proc_t CubeRowRank(site_t x)
+      {
+	return proc_t(x / CubeSize);
+      }
+    }
+  }
+}
+
+#endif // HEMELB_TESTS_VIS_STREAKLINES_CUBEROW_H
@@ -0,0 +1,137 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <map>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "geometry/LatticeData.h"
+#include "lb/MacroscopicPropertyCache.h"
+#include "lb/SimulationState.h"
+#include "lb/lattices/D3Q15.h"
+#include "net/net.h"
+#include "vis/streaklineDrawer/ParticleManager.h"
+
+#include "tests/helpers/HasCommsTestFixture.h"
+#include "tests/vis/streaklines/CubeRow.h"
+
+namespace hemelb
+{
+  namespace tests
+  {
+    using namespace vis::streaklinedrawer;
+    using namespace streaklines;
+
+    TEST_CASE_METHOD(helpers::HasCommsTestFixture, "ParticleManagerTests") {
+      const proc_t rankCount = Comms().Size();
+      const proc_t rank = Comms().Rank();
+
+      geometry::Geometry geometry = CreateCubeRow(rankCount);
+      geometry::LatticeData latDat(lb::lattices::D3Q15::GetLatticeInfo(), geometry, Comms());
+      lb::SimulationState simState(1e-4, 1000);
+      lb::MacroscopicPropertyCache cache(simState, latDat);
+
+      // A uniform flow along the row, half a site per step.
+      const float speed = 0.5F;
+      for (site_t site = 0; site < latDat.GetLocalFluidSiteCount(); ++site)
+	cache.velocityCache.Put(site, util::Vector3D<distribn_t>(speed, 0.0, 0.0));
+
+      VelocityField field(rank, latDat, cache);
+      std::map<proc_t, NeighbouringProcessor> neighbours;
+      field.BuildVelocityField(neighbours);
+      ParticleManager particles(neighbours);
+      net::Net net(Comms());
+
+      // Set up the exchange of the velocities at the faces between the
+      // ranks, then, each step, exchange them with the particles that have
+      // moved into another rank's cells, as the StreaklineDrawer does.
+      for (auto& neighbour: neighbours)
+	neighbour.second.ExchangeSiteIdCounts(net);
+      net.Dispatch();
+      for (auto& neighbour: neighbours)
+	neighbour.second.ExchangeSiteIds(net);
+      net.Dispatch();
+      for (auto& neighbour: neighbours) {
+	const std::vector<util::Vector3D<site_t> >& requested =
+	  neighbour.second.GetSiteCoordsRequestedByNeighbour();
+	std::vector<site_t> fieldIndices;
+	for (auto& location: requested)
+	  fieldIndices.push_back(field.GetFieldIndex(location));
+	neighbour.second.SetFieldIndicesToSend(fieldIndices);
+      }
+
+      auto exchange = [&]() {
+	field.InvalidateAllCalculatedVelocities();
+	particles.CollectParticlesToSend(field, rank);
+	for (auto& neighbour: neighbours) {
+	  const std::vector<site_t>& fieldIndices = neighbour.second.GetFieldIndicesToSend();
+	  for (size_t n = 0; n < fieldIndices.size(); ++n)
+	    neighbour.second.SetVelocityFieldToSend(n, field.GetLocalVelocity(fieldIndices[n]));
+	  neighbour.second.ExchangeVelocitiesAndParticleCounts(net);
+	}
+	net.Dispatch();
+	for (auto& neighbour: neighbours)
+	  neighbour.second.ExchangeParticles(net);
+	net.Dispatch();
+	for (auto& neighbour: neighbours) {
+	  const std::vector<site_t>& fieldIndices = neighbour.second.GetFieldIndicesReceived();
+	  for (size_t n = 0; n < fieldIndices.size(); ++n)
+	    field.SetVelocity(fieldIndices[n], neighbour.second.GetReceivedVelocityField(n));
+	}
+	particles.AddReceivedParticles();
+      };
+
+      // Each rank has a particle in the middle of its cube, tagged with its
+      // rank. Rank 0 also has one just short of the end of its cube, which
+      // crosses into the next in one step.
+      const unsigned int crossingId = 1000;
+      particles.AddParticle(Particle(rank * CubeSize + 1.2F, 1.5F, 2.5F, rank));
+      if (rank == 0)
+	particles.AddParticle(Particle(CubeSize - 0.3F, 1.5F, 2.5F, crossingId));
+
+      exchange();
+      particles.AdvectParticles(field);
+
+      // The crossing particle's cell reaches into the next cube, so it only
+      // moves at full speed if that rank's velocities arrived. With one rank
+      // there is no next cube, and no flow there. These are CHECKs so that
+      // every rank still takes part in the next exchange.
+      const float crossedX = CubeSize - 0.3F + (rankCount > 1 ? speed : 0.3F * speed);
+      CHECK(particles.GetNumberOfLocalParticles() == (rank == 0 ? 2u : 1u));
+      for (size_t n = 0; n < particles.GetNumberOfLocalParticles(); ++n) {
+	const Particle particle = particles.GetParticle(n);
+	if (particle.inletID == crossingId) {
+	  CHECK(particle.position.x == Approx(crossedX));
+	} else {
+	  CHECK(particle.position.x == Approx(rank * CubeSize + 1.2F + speed));
+	}
+      }
+
+      exchange();
+
+      // Now the crossing particle is on the next rank, and only there, and
+      // the others have stayed on their own.
+      const proc_t crossedTo = rankCount > 1 ? 1 : 0;
+      size_t crossingHere = 0;
+      size_t ownHere = 0;
+      for (size_t n = 0; n < particles.GetNumberOfLocalParticles(); ++n) {
+	const Particle particle = particles.GetParticle(n);
+	if (particle.inletID == crossingId) {
+	  ++crossingHere;
+	  REQUIRE(particle.position.x == Approx(crossedX));
+	  REQUIRE(particle.position.y == Approx(1.5F));
+	  REQUIRE(particle.position.z == Approx(2.5F));
+	} else {
+	  REQUIRE(particle.inletID == unsigned(rank));
+	  ++ownHere;
+	}
+      }
+      REQUIRE(ownHere == 1);
+      REQUIRE(crossingHere == (rank == crossedTo ? 1u : 0u));
+      REQUIRE(Comms().AllReduce(crossingHere, MPI_SUM) == 1);
+    }
+  }
+}
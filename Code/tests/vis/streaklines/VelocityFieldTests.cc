@@ -0,0 +1,174 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "geometry/LatticeData.h"
+#include "lb/MacroscopicPropertyCache.h"
+#include "lb/SimulationState.h"
+#include "lb/lattices/D3Q15.h"
+#include "vis/streaklineDrawer/VelocityField.h"
+
+#include "tests/helpers/HasCommsTestFixture.h"
+#include "tests/vis/streaklines/CubeRow.h"
+
+namespace hemelb
+{
+  namespace tests
+  {
+    using namespace vis::streaklinedrawer;
+    using namespace streaklines;
+
+    namespace
+    {
+      // A linear velocity field, which trilinear interpolation reproduces
+      // exactly.
+      util::Vector3D<float> LinearVelocity(float x, float y, float z)
+      {
+	return util::Vector3D<float>(0.01F * x + 0.002F * y,
+				     0.003F * z,
+				     0.005F + 0.001F * x - 0.004F * y);
+      }
+    }
+
+    TEST_CASE_METHOD(helpers::HasCommsTestFixture, "VelocityFieldTests") {
+      const proc_t rankCount = Comms().Size();
+      const proc_t rank = Comms().Rank();
+      const site_t rowLength = CubeSize * rankCount;
+
+      geometry::Geometry geometry = CreateCubeRow(rankCount);
+      geometry::LatticeData latDat(lb::lattices::D3Q15::GetLatticeInfo(), geometry, Comms());
+      lb::SimulationState simState(1e-4, 1000);
+      lb::MacroscopicPropertyCache cache(simState, latDat);
+
+      for (site_t site = 0; site < latDat.GetLocalFluidSiteCount(); ++site) {
+	const util::Vector3D<site_t> x = latDat.GetSite(site).GetGlobalSiteCoords();
+	const util::Vector3D<float> velocity = LinearVelocity(x.x, x.y, x.z);
+	cache.velocityCache.Put(site, util::Vector3D<distribn_t>(velocity.x, velocity.y, velocity.z));
+      }
+
+      VelocityField field(rank, latDat, cache);
+      std::map<proc_t, NeighbouringProcessor> neighbours;
+      field.BuildVelocityField(neighbours);
+
+      // The x of the faces of the cubes either side that touch ours.
+      const site_t leftFace = rank * CubeSize - 1;
+      const site_t rightFace = (rank + 1) * CubeSize;
+
+      SECTION("BuildVelocityField") {
+	// Only the ranks either side are neighbours, each supplying one face.
+	std::set<proc_t> expectedNeighbours;
+	if (rank > 0)
+	  expectedNeighbours.insert(rank - 1);
+	if (rank + 1 < rankCount)
+	  expectedNeighbours.insert(rank + 1);
+
+	std::set<proc_t> actualNeighbours;
+	for (auto& neighbour: neighbours) {
+	  actualNeighbours.insert(neighbour.first);
+	  REQUIRE(neighbour.second.GetFieldIndicesReceived().size() == size_t(CubeSize * CubeSize));
+	}
+	REQUIRE(actualNeighbours == expectedNeighbours);
+
+	// Every site of our cube and of the faces next to it has its own
+	// entry, at the offset of its block plus its index within the block.
+	// No other site has one.
+	std::set<site_t> entries;
+	std::map<proc_t, site_t> blockOffsets;
+	std::map<proc_t, std::set<site_t> > faceEntries;
+	for (site_t x = 0; x < rowLength; ++x)
+	  for (site_t y = 0; y < CubeSize; ++y)
+	    for (site_t z = 0; z < CubeSize; ++z) {
+	      const util::Vector3D<site_t> location(x, y, z);
+	      const site_t index = field.GetFieldIndex(location);
+	      const proc_t owner = CubeRowRank(x);
+
+	      if (owner != rank && x != leftFace && x != rightFace) {
+		REQUIRE(index == VelocityField::NoSite);
+		continue;
+	      }
+
+	      REQUIRE(index != VelocityField::NoSite);
+	      REQUIRE(field.GetRank(index) == owner);
+	      REQUIRE(entries.insert(index).second);
+
+	      const site_t offset = index - latDat.GetLocalSiteIdFromLocalSiteCoords(location % CubeSize);
+	      if (blockOffsets.count(owner) == 0)
+		blockOffsets[owner] = offset;
+	      REQUIRE(blockOffsets[owner] == offset);
+
+	      if (owner != rank)
+		faceEntries[owner].insert(index);
+	    }
+	REQUIRE(field.GetFieldIndex(util::Vector3D<site_t>(rowLength, 0, 0)) == VelocityField::NoSite);
+
+	// The blocks' ranges of entries lie after the one for no data, and
+	// don't overlap.
+	std::set<site_t> offsets;
+	for (auto& blockOffset: blockOffsets)
+	  offsets.insert(blockOffset.second);
+	site_t previousEnd = VelocityField::NoSite + 1;
+	for (site_t offset: offsets) {
+	  REQUIRE(offset >= previousEnd);
+	  previousEnd = offset + CubeSize * CubeSize * CubeSize;
+	}
+
+	// The velocities received from each neighbour go to its face.
+	for (auto& neighbour: neighbours) {
+	  const std::vector<site_t>& received = neighbour.second.GetFieldIndicesReceived();
+	  REQUIRE(std::set<site_t>(received.begin(), received.end()) == faceEntries[neighbour.first]);
+	}
+      }
+
+      SECTION("InterpolateVelocities") {
+	// Fill in the neighbours' faces as the exchange would.
+	for (site_t x: { leftFace, rightFace }) {
+	  if (x < 0 || x >= rowLength)
+	    continue;
+	  for (site_t y = 0; y < CubeSize; ++y)
+	    for (site_t z = 0; z < CubeSize; ++z)
+	      field.SetVelocity(field.GetFieldIndex(util::Vector3D<site_t>(x, y, z)), LinearVelocity(x, y, z));
+	}
+
+	// Particles spread through every cell whose corners we have data for,
+	// including those reaching into the neighbours' faces.
+	const site_t lowest = rank > 0 ? leftFace : 0;
+	const site_t highest = rank + 1 < rankCount ? rightFace : rightFace - 1;
+	const int interior = 40;
+	std::vector<float> positionX, positionY, positionZ;
+	for (int n = 0; n < interior; ++n) {
+	  positionX.push_back(lowest + (highest - lowest) * (n + 0.5F) / interior);
+	  positionY.push_back((CubeSize - 1) * ((7 * n) % interior + 0.5F) / interior);
+	  positionZ.push_back((CubeSize - 1) * ((13 * n) % interior + 0.5F) / interior);
+	}
+	// And some half way from the last sites in y to beyond the lattice,
+	// where there is no data and the velocity counts as zero.
+	for (int n = 0; n < 4; ++n) {
+	  positionX.push_back(rank * CubeSize + 0.25F + 0.75F * n);
+	  positionY.push_back(CubeSize - 0.5F);
+	  positionZ.push_back(0.2F + 0.7F * n);
+	}
+
+	const size_t count = positionX.size();
+	std::vector<float> velocityX(count), velocityY(count), velocityZ(count);
+	field.InterpolateVelocities(count, positionX.data(), positionY.data(), positionZ.data(),
+				    velocityX.data(), velocityY.data(), velocityZ.data());
+
+	for (size_t n = 0; n < count; ++n) {
+	  const util::Vector3D<float> expected = n < size_t(interior) ?
+	    LinearVelocity(positionX[n], positionY[n], positionZ[n]) :
+	    LinearVelocity(positionX[n], CubeSize - 1, positionZ[n]) * 0.5F;
+	  REQUIRE(velocityX[n] == Approx(expected.x).margin(1e-6));
+	  REQUIRE(velocityY[n] == Approx(expected.y).margin(1e-6));
+	  REQUIRE(velocityZ[n] == Approx(expected.z).margin(1e-6));
+	}
+      }
+    }
+  }
+}
@@ -38,6 +38,11 @@ namespace hemelb
          * @param item
          */
         void Put(unsigned long index, const CacheType item);
+        /**
+         * Overwrites the contents of this cache with those of another.
+         * @param other
+         */
+        void CopyFrom(const Cache<CacheType>& other);
 
       protected:
         /**
@@ -30,6 +30,12 @@ namespace hemelb
       items[index] = item;
     }
 
+    template<typename CacheType>
+    void Cache<CacheType>::CopyFrom(const Cache<CacheType>& other)
+    {
+      items = other.items;
+    }
+
     template<typename CacheType>
     void Cache<CacheType>::Reserve(unsigned long size)
     {
@@ -48,6 +48,13 @@ namespace hemelb
          */
         void Put(unsigned long index, const CacheType& item);
 
+        /**
+         * Overwrites the contents of this cache, and the timesteps at which they were
+         * updated, with those of another.
+         * @param other
+         */
+        void CopyFrom(const CheckingCache<CacheType>& other);
+
       protected:
         /**
          * Reserves enough space for the cache.
@@ -43,6 +43,13 @@ namespace hemelb
       Cache<CacheType>::Put(index, item);
     }
 
+    template<typename CacheType>
+    void CheckingCache<CacheType>::CopyFrom(const CheckingCache<CacheType>& other)
+    {
+      lastUpdate = other.lastUpdate;
+      Cache<CacheType>::CopyFrom(other);
+    }
+
     template<typename CacheType>
     void CheckingCache<CacheType>::Reserve(unsigned long size)
     {
@@ -0,0 +1,104 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "util/ThreadPool.h"
+
+namespace hemelb
+{
+  namespace util
+  {
+    ThreadPool::ThreadPool(unsigned int threadCount) :
+        currentTask(NULL), currentTaskCount(0), nextTask(0), busyWorkers(0), generation(0), stopping(false)
+    {
+      for (unsigned int thread = 1; thread < threadCount; ++thread)
+      {
+        workers.push_back(std::thread(&ThreadPool::WorkerLoop, this, thread));
+      }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+      }
+      workAvailable.notify_all();
+
+      for (std::vector<std::thread>::iterator worker = workers.begin(); worker != workers.end(); ++worker)
+      {
+        worker->join();
+      }
+    }
+
+    void ThreadPool::Run(unsigned int taskCount, const Task& task)
+    {
+      if (workers.empty())
+      {
+        for (unsigned int i = 0; i < taskCount; ++i)
+        {
+          task(i, 0);
+        }
+        return;
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentTask = &task;
+        currentTaskCount = taskCount;
+        nextTask = 0;
+        busyWorkers = workers.size();
+        ++generation;
+      }
+      workAvailable.notify_all();
+
+      DoTasks(0);
+
+      std::unique_lock<std::mutex> lock(mutex);
+      workFinished.wait(lock, [this]
+      {
+        return busyWorkers == 0;
+      });
+      currentTask = NULL;
+    }
+
+    void ThreadPool::WorkerLoop(unsigned int thread)
+    {
+      unsigned long lastGeneration = 0;
+      std::unique_lock<std::mutex> lock(mutex);
+
+      while (true)
+      {
+        workAvailable.wait(lock, [this, lastGeneration]
+        {
+          return stopping || generation != lastGeneration;
+        });
+
+        if (stopping)
+        {
+          return;
+        }
+
+        lastGeneration = generation;
+        lock.unlock();
+        DoTasks(thread);
+        lock.lock();
+
+        if (--busyWorkers == 0)
+        {
+          workFinished.notify_one();
+        }
+      }
+    }
+
+    void ThreadPool::DoTasks(unsigned int thread)
+    {
+      for (unsigned int i = nextTask++; i < currentTaskCount; i = nextTask++)
+      {
+        (*currentTask)(i, thread);
+      }
+    }
+  }
+}
@@ -0,0 +1,75 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_UTIL_THREADPOOL_H
+#define HEMELB_UTIL_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hemelb
+{
+  namespace util
+  {
+    /**
+     * A fixed set of worker threads for node-local, MPI-free work.
+     *
+     * The calling thread takes part in every Run as thread 0, so a pool of
+     * one thread starts no workers and runs everything inline.
+     */
+    class ThreadPool
+    {
+      public:
+        typedef std::function<void(unsigned int task, unsigned int thread)> Task;
+
+        explicit ThreadPool(unsigned int threadCount);
+        ~ThreadPool();
+
+        unsigned int GetThreadCount() const
+        {
+          return workers.size() + 1;
+        }
+
+        /**
+         * Calls task(i, thread) for every i in [0, taskCount), handing the indices out
+         * to whichever thread is free, and returns once all of them have finished.
+         *
+         * The thread index is in [0, GetThreadCount()), so tasks can write to
+         * per-thread state without locking.
+         *
+         * @param taskCount
+         * @param task
+         */
+        void Run(unsigned int taskCount, const Task& task);
+
+      private:
+        ThreadPool(const ThreadPool&);
+        ThreadPool& operator=(const ThreadPool&);
+
+        void WorkerLoop(unsigned int thread);
+        void DoTasks(unsigned int thread);
+
+        std::vector<std::thread> workers;
+
+        std::mutex mutex;
+        std::condition_variable workAvailable;
+        std::condition_variable workFinished;
+
+        const Task* currentTask;
+        unsigned int currentTaskCount;
+        std::atomic<unsigned int> nextTask;
+        unsigned int busyWorkers;
+        unsigned long generation;
+        bool stopping;
+    };
+  }
+}
+
+#endif // HEMELB_UTIL_THREADPOOL_H
@@ -0,0 +1,117 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_VIS_COMPOSITING_H
+#define HEMELB_VIS_COMPOSITING_H
+
+#include "net/net.h"
+
+namespace hemelb
+{
+  namespace vis
+  {
+    /**
+     * Composite the image rendered on every proc onto proc 0, by binary swap over columns of
+     * the screen. Collective.
+     *
+     * If the number of procs is not a power of two, the procs above the largest power of two
+     * first pass all their pixels to the proc that many ranks below, where they are merged.
+     * Then, at each level, every remaining proc splits the range of columns it is responsible
+     * for in half with its partner (the proc whose rank differs in one bit), sends the pixels
+     * for the partner's half and merges in the pixels for its own half. After log2(procs)
+     * levels each proc has the finished image for a separate range of columns, and these are
+     * gathered onto proc 0.
+     *
+     * ImageType is a Rendering, or anything with the same interface for sending, receiving,
+     * combining, splitting and gathering pixels.
+     *
+     * @param localImage This proc's image; on proc 0, the composited image afterwards
+     * @param sendImage Scratch image
+     * @param receiveImage Scratch image
+     * @param columns The width of the screen in pixels
+     * @param net
+     */
+    template<class ImageType>
+    void CompositeByBinarySwap(ImageType& localImage, ImageType& sendImage, ImageType& receiveImage,
+                               int columns, net::Net& net)
+    {
+      const net::MpiCommunicator& comm = net.GetCommunicator();
+      const proc_t rank = comm.Rank();
+      proc_t swappingProcs = 1;
+      while ( (swappingProcs << 1) <= comm.Size())
+      {
+        swappingProcs <<= 1;
+      }
+
+      if (rank >= swappingProcs)
+      {
+        localImage.SendPixelCounts(&net, rank - swappingProcs);
+
+        net.Dispatch();
+
+        localImage.SendPixelData(&net, rank - swappingProcs);
+
+        net.Dispatch();
+
+        localImage.Clear();
+      }
+      else
+      {
+        if (rank + swappingProcs < comm.Size())
+        {
+          receiveImage.Clear();
+          receiveImage.ReceivePixelCounts(&net, rank + swappingProcs);
+
+          net.Dispatch();
+
+          receiveImage.ReceivePixelData(&net, rank + swappingProcs);
+
+          net.Dispatch();
+
+          localImage.Combine(receiveImage);
+        }
+
+        int columnsBegin = 0;
+        int columnsEnd = columns;
+
+        for (proc_t bit = swappingProcs >> 1; bit > 0; bit >>= 1)
+        {
+          const proc_t partner = rank ^ bit;
+          const int columnsMiddle = (columnsBegin + columnsEnd) / 2;
+          if ( (rank & bit) == 0)
+          {
+            columnsEnd = columnsMiddle;
+          }
+          else
+          {
+            columnsBegin = columnsMiddle;
+          }
+
+          sendImage.Clear();
+          localImage.MovePixelsOutside(columnsBegin, columnsEnd, sendImage);
+          receiveImage.Clear();
+
+          sendImage.SendPixelCounts(&net, partner);
+          receiveImage.ReceivePixelCounts(&net, partner);
+
+          net.Dispatch();
+
+          sendImage.SendPixelData(&net, partner);
+          receiveImage.ReceivePixelData(&net, partner);
+
+          net.Dispatch();
+
+          localImage.Combine(receiveImage);
+        }
+      }
+
+      // Collect the finished columns on proc 0.
+      localImage.GatherDisjoint(comm, 0);
+    }
+  }
+}
+
+#endif /* HEMELB_VIS_COMPOSITING_H */
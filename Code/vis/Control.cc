@@ -11,6 +11,7 @@
 #include "log/Logger.h"
 #include "util/utilityFunctions.h"
 #include "vis/Control.h"
+#include "vis/Compositing.h"
 #include "vis/rayTracer/RayTracer.h"
 #include "vis/GlyphDrawer.h"
 
@@ -26,10 +27,16 @@ namespace hemelb
                      lb::SimulationState* simState,
                      const lb::MacroscopicPropertyCache& propertyCache,
                      geometry::LatticeData* iLatDat,
-                     reporting::Timer &atimer) :
+                     reporting::Timer &atimer,
+                     unsigned long renderLag) :
         net::PhasedBroadcastIrregular<true, 2, 0, false, true>(netIn, simState, SPREADFACTOR),
-        propertyCache(propertyCache), latticeData(iLatDat), timer(atimer)
+        propertyCache(propertyCache), snapshotState(*simState), snapshot(NULL), backgroundRenderIteration(0), latticeData(iLatDat), timer(atimer)
     {
+      if (renderLag > 0)
+      {
+        snapshot = new lb::MacroscopicPropertyCache(snapshotState, *iLatDat);
+        SetInitialActionLength(1 + renderLag);
+      }
 
       visSettings.mStressType = iStressType;
 
@@ -121,6 +128,8 @@ namespace hemelb
                                 const float &iLatitude,
                                 const float &iZoom)
     {
+      WaitForRender();
+
       float rad = 5.F * vis->system_size;
       float dist = 0.5F * rad;
 
@@ -149,6 +158,8 @@ namespace hemelb
                                 const distribn_t iVelocityThresholdMaxInv,
                                 const distribn_t iStressThresholdMaxInv)
     {
+      WaitForRender();
+
       visSettings.brightness = iBrightness;
       domainStats.density_threshold_min = iDensityThresholdMin;
 
@@ -159,6 +170,7 @@ namespace hemelb
 
     void Control::UpdateImageSize(int pixels_x, int pixels_y)
     {
+      WaitForRender();
       screen.Resize(pixels_x, pixels_y);
     }
 
@@ -191,11 +203,67 @@ namespace hemelb
       localResultsByStartIt.insert(std::pair<unsigned long, Rendering>(startIteration, Rendering(glyph, ray, streak)));
     }
 
+    void Control::StartBackgroundRender(unsigned long startIteration)
+    {
+      log::Logger::Log<log::Debug, log::OnePerCore>("Starting background render.");
+
+      // There is only one snapshot, so the previous render must have finished with it.
+      WaitForRender();
+
+      snapshotState = *mSimState;
+      snapshot->densityCache.CopyFrom(propertyCache.densityCache);
+      snapshot->velocityCache.CopyFrom(propertyCache.velocityCache);
+      snapshot->wallShearStressMagnitudeCache.CopyFrom(propertyCache.wallShearStressMagnitudeCache);
+      snapshot->vonMisesStressCache.CopyFrom(propertyCache.vonMisesStressCache);
+
+      // The pixel set stores aren't thread safe, so take the output sets here.
+      PixelSet<raytracer::RayDataNormal>* ray = normalRayTracer->GetUnusedPixelSet();
+      PixelSet<BasicPixel>* glyph = myGlypher->GetUnusedPixelSet();
+      const bool drawGlyphs = visSettings.mode == VisSettings::ISOSURFACESANDGLYPHS;
+
+      // Streaklines are advanced on this thread every step, so draw them now.
+      PixelSet<streaklinedrawer::StreakPixel> *streak = NULL;
+
+      if (myStreaker != NULL
+          && (visSettings.mStressType == lb::ShearStress || visSettings.mode == VisSettings::WALLANDSTREAKLINES))
+      {
+        streak = myStreaker->Render();
+      }
+
+      backgroundRenderIteration = startIteration;
+      renderThread = std::thread([this, ray, glyph, drawGlyphs]
+      {
+        normalRayTracer->Render(*snapshot, ray);
+
+        if (drawGlyphs)
+        {
+          myGlypher->Render(*snapshot, glyph);
+        }
+      });
+
+      localResultsByStartIt.insert(std::pair<unsigned long, Rendering>(startIteration, Rendering(glyph, ray, streak)));
+    }
+
+    void Control::WaitForRender()
+    {
+      if (renderThread.joinable())
+      {
+        renderThread.join();
+      }
+    }
+
     void Control::InitialAction(unsigned long startIteration)
     {
       timer.Start();
 
-      Render(startIteration);
+      if (snapshot != NULL)
+      {
+        StartBackgroundRender(startIteration);
+      }
+      else
+      {
+        Render(startIteration);
+      }
 
       log::Logger::Log<log::Debug, log::OnePerCore>("Render stored for phased imaging.");
 
@@ -246,22 +314,19 @@ namespace hemelb
 
         pixel.WritePixel(&index, rgb_data, domainStats, visSettings);
 
-        *writer << (uint32_t) index;
-
-        unsigned pix_data[3];
-        pix_data[0] = (rgb_data[0] << (3 * bits_per_char)) + (rgb_data[1] << (2 * bits_per_char))
+        // The index then the packed colours, written as one array.
+        uint32_t pix_data[4];
+        pix_data[0] = index;
+        pix_data[1] = (rgb_data[0] << (3 * bits_per_char)) + (rgb_data[1] << (2 * bits_per_char))
             + (rgb_data[2] << bits_per_char) + rgb_data[3];
 
-        pix_data[1] = (rgb_data[4] << (3 * bits_per_char)) + (rgb_data[5] << (2 * bits_per_char))
+        pix_data[2] = (rgb_data[4] << (3 * bits_per_char)) + (rgb_data[5] << (2 * bits_per_char))
             + (rgb_data[6] << bits_per_char) + rgb_data[7];
 
-        pix_data[2] = (rgb_data[8] << (3 * bits_per_char)) + (rgb_data[9] << (2 * bits_per_char))
+        pix_data[3] = (rgb_data[8] << (3 * bits_per_char)) + (rgb_data[9] << (2 * bits_per_char))
             + (rgb_data[10] << bits_per_char) + rgb_data[11];
 
-        for (int i = 0; i < 3; i++)
-        {
-          *writer << (uint32_t) pix_data[i];
-        }
+        writer->writeArray(pix_data, 4);
         *writer << io::writers::Writer::eol;
       }
     }
@@ -312,6 +377,8 @@ namespace hemelb
     {
       timer.Start();
 
+      WaitForRender();
+
       Rendering& rendering = (*localResultsByStartIt.find(startIteration)).second;
       if (splayNumber == 0)
       {
@@ -341,6 +408,8 @@ namespace hemelb
       }
       if (splayNumber == 1)
       {
+        WaitForRender();
+
         std::pair < std::multimap<unsigned long, Rendering>::iterator , std::multimap<unsigned long, Rendering>::iterator
             > its = childrenResultsByStartIt.equal_range(startIteration);
 
@@ -456,6 +525,12 @@ namespace hemelb
     {
       log::Logger::Log<log::Trace, log::OnePerCore>("Getting image results from it %lu", startIt);
 
+      // With no children or parent, nothing else will have waited for the render.
+      if (startIt == backgroundRenderIteration)
+      {
+        WaitForRender();
+      }
+
       if (renderingsByStartIt.count(startIt) != 0)
       {
         return (*renderingsByStartIt.find(startIt)).second;
@@ -483,101 +558,29 @@ namespace hemelb
 
       log::Logger::Log<log::Debug, log::OnePerCore>("Performing instant imaging.");
 
+      WaitForRender();
       Render(startIteration);
 
-      /*
-       * We do several iterations.
-       *
-       * On the first, every even proc passes data to the odd proc below, where it is merged.
-       * On the second, the difference is two, so proc 3 passes to 1, 7 to 5, 11 to 9 etc.
-       * On the third the differenec is four, so proc 5 passes to 1, 13 to 9 etc.
-       * .
-       * .
-       * .
-       *
-       * This continues until all data is passed back to processor one, which passes it to proc 0.
-       */
-
-      const net::MpiCommunicator& netComm = this->mNet->GetCommunicator();
-      net::Net tempNet(netComm);
-
-      Rendering* localBuffer = localResultsByStartIt.count(startIteration) > 0 ?
-        & (*localResultsByStartIt.find(startIteration)).second :
-        NULL;
+      // Composite the images from every proc onto proc 0.
+      net::Net tempNet(this->mNet->GetCommunicator());
+
+      Rendering& localBuffer = (*localResultsByStartIt.find(startIteration)).second;
       Rendering receiveBuffer(myGlypher->GetUnusedPixelSet(), normalRayTracer->GetUnusedPixelSet(), myStreaker == NULL ?
         NULL :
         myStreaker->GetUnusedPixelSet());
+      Rendering sendBuffer(myGlypher->GetUnusedPixelSet(), normalRayTracer->GetUnusedPixelSet(), myStreaker == NULL ?
+        NULL :
+        myStreaker->GetUnusedPixelSet());
 
-      // Start with a difference in rank of 1, doubling every time.
-      for (proc_t deltaRank = 1; deltaRank < netComm.Size(); deltaRank <<= 1)
-      {
-        // The receiving proc is all the ranks that are 1 modulo (deltaRank * 2)
-        for (proc_t receivingProc = 1; receivingProc < (netComm.Size() - deltaRank);
-            receivingProc += deltaRank << 1)
-        {
-          proc_t sendingProc = receivingProc + deltaRank;
-
-          // If we're the sending proc, do the send.
-          if (netComm.Rank() == sendingProc)
-          {
-            localBuffer->SendPixelCounts(&tempNet, receivingProc);
-
-            tempNet.Dispatch();
-
-            localBuffer->SendPixelData(&tempNet, receivingProc);
-
-            tempNet.Dispatch();
-          }
-
-          // If we're the receiving proc, receive.
-
-          else if (netComm.Rank() == receivingProc)
-          {
-            receiveBuffer.ReceivePixelCounts(&tempNet, sendingProc);
-
-            tempNet.Dispatch();
-
-            receiveBuffer.ReceivePixelData(&tempNet, sendingProc);
-
-            tempNet.Dispatch();
-
-            localBuffer->Combine(receiveBuffer);
-          }
-        }
-      }
-
-      // Send the final image from proc 1 to 0.
-      if (netComm.Rank() == 1)
-      {
-        localBuffer->SendPixelCounts(&tempNet, 0);
-
-        tempNet.Dispatch();
-
-        localBuffer->SendPixelData(&tempNet, 0);
+      CompositeByBinarySwap(localBuffer, sendBuffer, receiveBuffer, GetPixelsX(), tempNet);
 
-        tempNet.Dispatch();
-      }
-      // Receive the final image on proc 0.
-      else if (netComm.Rank() == 0 && netComm.Size() > 1)
+      if (tempNet.Rank() == 0)
       {
-        receiveBuffer.ReceivePixelCounts(&tempNet, 1);
-
-        tempNet.Dispatch();
-
-        receiveBuffer.ReceivePixelData(&tempNet, 1);
-
-        tempNet.Dispatch();
-
-        localResultsByStartIt.erase(startIteration);
-        localResultsByStartIt.insert(std::pair<unsigned long, Rendering>(startIteration, Rendering(receiveBuffer)));
-
         log::Logger::Log<log::Trace, log::OnePerCore>("Inserting image at it %lu.", startIteration);
       }
 
-      if (netComm.Rank() != 0)
-      {
-        receiveBuffer.ReleaseAll();
-      }
+      receiveBuffer.ReleaseAll();
+      sendBuffer.ReleaseAll();
 
       timer.Stop();
     }
@@ -623,6 +626,9 @@ namespace hemelb
 
     Control::~Control()
     {
+      WaitForRender();
+
+      delete snapshot;
       delete myStreaker;
       delete vis;
       delete myGlypher;
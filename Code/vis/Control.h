@@ -8,6 +8,7 @@
 #define HEMELB_VIS_CONTROL_H
 
 #include <stack>
+#include <thread>
 
 #include "geometry/LatticeData.h"
 
@@ -46,6 +47,12 @@ namespace hemelb
      * themselves. No overlap is possible between communications at different depths as the pixels
      * must be merged before they can be passed on. We don't need to pass info top-down, we only
      * pass image components upwards towards the top node.
+     *
+     * If the render lag (HEMELB_VIS_RENDER_LAG unless given to the constructor) is non-zero, the
+     * initial action instead copies the fluid properties needed for rendering into a snapshot and
+     * ray traces it on a background thread, while the simulation carries on for that many
+     * timesteps before the images are composited. Only one background render is in flight at a
+     * time.
      */
     class Control : public net::PhasedBroadcastIrregular<true, 2, 0, false, true>,
                     private PixelSetStore<PixelSet<ResultPixel> >
@@ -56,7 +63,8 @@ namespace hemelb
                 lb::SimulationState* simState,
                 const lb::MacroscopicPropertyCache& propertyCache,
                 geometry::LatticeData* iLatDat,
-                reporting::Timer &atimer);
+                reporting::Timer &atimer,
+                unsigned long renderLag = RENDERLAG);
         ~Control();
 
         void SetSomeParams(const float iBrightness,
@@ -94,6 +102,12 @@ namespace hemelb
 
         bool IsRendering() const;
 
+        /**
+         * Blocks until any background render has finished. Must be called before changing the
+         * public visualisation settings, which the background render reads.
+         */
+        void WaitForRender();
+
         int GetPixelsX() const;
         int GetPixelsY() const;
 
@@ -119,6 +133,10 @@ namespace hemelb
         // This is mainly constrained by the memory available per core.
         static const unsigned int SPREADFACTOR = 2;
 
+        // The number of timesteps a background render has before compositing begins (0 to
+        // render synchronously).
+        static const unsigned long RENDERLAG = HEMELB_VIS_RENDER_LAG;
+
         struct Vis
         {
             util::Vector3D<float> half_dim;
@@ -127,6 +145,7 @@ namespace hemelb
 
         void initLayers();
         void Render(unsigned long startIteration);
+        void StartBackgroundRender(unsigned long startIteration);
 
         mapType localResultsByStartIt;
         multimapType childrenResultsByStartIt;
@@ -137,6 +156,15 @@ namespace hemelb
          */
         const lb::MacroscopicPropertyCache& propertyCache;
 
+        /**
+         * The simulation state and fluid properties at the start of the background render, or
+         * NULL if rendering is synchronous.
+         */
+        lb::SimulationState snapshotState;
+        lb::MacroscopicPropertyCache* snapshot;
+        unsigned long backgroundRenderIteration;
+        std::thread renderThread;
+
         geometry::LatticeData* latticeData;
         Screen screen;
         Vis* vis;
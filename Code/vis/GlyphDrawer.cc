@@ -183,6 +183,13 @@ namespace hemelb
 
       pixelSet->Clear();
 
+      Render(propertyCache, pixelSet);
+
+      return pixelSet;
+    }
+
+    void GlyphDrawer::Render(const lb::MacroscopicPropertyCache& propertyCache, PixelSet<BasicPixel>* pixelSet)
+    {
       // For each glyph...
       for (site_t n = 0; n < (site_t) mGlyphs.size(); n++)
       {
@@ -207,8 +214,6 @@ namespace hemelb
 
         RenderLine(p3, p4, mVisSettings, pixelSet);
       }
-
-      return pixelSet;
     }
   }
 }
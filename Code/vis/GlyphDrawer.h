@@ -40,6 +40,9 @@ namespace hemelb
         // Function to perform the rendering.
         PixelSet<BasicPixel>* Render(const lb::MacroscopicPropertyCache& propertyCache);
 
+        // Renders into the given (cleared) pixel set, without touching the pixel set store.
+        void Render(const lb::MacroscopicPropertyCache& propertyCache, PixelSet<BasicPixel>* pixelSet);
+
       private:
         // A struct to represent a single glyph.
         struct Glyph
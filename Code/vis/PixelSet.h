@@ -7,8 +7,9 @@
 #ifndef HEMELB_VIS_PIXELSET_H
 #define HEMELB_VIS_PIXELSET_H
 
+#include <algorithm>
+#include <cassert>
 #include <vector>
-#include <map>
 
 #include "log/Logger.h"
 #include "net/mpi.h"
@@ -22,8 +23,13 @@ namespace hemelb
   {
     /**
      * Base pixel set implementation, including the functionality that allows storing of pixels
-     * in a vector for speedy MPI usage, but also storing a map of pixels -> Pixel* for efficient
-     * lookup in O(N) time.
+     * in a vector for speedy MPI usage, but also a dense lookup from pixel location to index
+     * into that vector, in O(1) time.
+     *
+     * The lookup is split into square tiles, which are only allocated once a pixel lands in
+     * them, so a sparse image doesn't need a whole screen's worth of memory. Tiles are kept
+     * when the set is cleared, so a pixel set reused for every frame stops allocating once it
+     * has seen the screen area being drawn. Pixel coordinates must not be negative.
      */
     template<typename PixelType>
     class PixelSet
@@ -34,6 +40,9 @@ namespace hemelb
         {
           inUse = false;
           count = 0;
+          tilesX = 0;
+          tilesY = 0;
+          tileCount = 0;
         }
 
         ~PixelSet()
@@ -53,18 +62,16 @@ namespace hemelb
 
         void AddPixel(const PixelType& newPixel)
         {
-          BasicPixel location = BasicPixel(newPixel.GetI(), newPixel.GetJ());
+          int& slot = GetSlot(newPixel.GetI(), newPixel.GetJ());
 
-          if (pixelLookup.count(location) > 0)
+          if (slot != NoPixel)
           {
-            pixels[pixelLookup[location]].Combine(newPixel);
+            pixels[slot].Combine(newPixel);
           }
           else
           {
+            slot = (int) pixels.size();
             pixels.push_back(PixelType(newPixel));
-            pixelLookup.insert(std::pair<BasicPixel, unsigned int>(location,
-                                                                   (unsigned int) (pixels.size()
-                                                                       - 1)));
           }
         }
 
@@ -114,11 +121,59 @@ namespace hemelb
             log::Logger::Log<log::Trace, log::OnePerCore>("Receiving %i pixels from proc %i",
                                                           count,
                                                           (int) source);
+            // The received pixels are not added to the lookup, so this set can only be read.
+            Clear();
             pixels.resize(count);
             net->RequestReceiveV(pixels, source);
           }
         }
 
+        /**
+         * Move the pixels whose I coordinate is outside [iBegin, iEnd) into other,
+         * keeping the rest.
+         * @param iBegin
+         * @param iEnd
+         * @param other
+         */
+        void MovePixelsOutside(int iBegin, int iEnd, PixelSet<PixelType>& other)
+        {
+          std::vector<PixelType> kept;
+          kept.reserve(pixels.size());
+          for (typename std::vector<PixelType>::const_iterator it = pixels.begin(); it != pixels.end(); ++it)
+          {
+            if (it->GetI() >= iBegin && it->GetI() < iEnd)
+            {
+              kept.push_back(*it);
+            }
+            else
+            {
+              other.AddPixel(*it);
+            }
+          }
+
+          Clear();
+          pixels.swap(kept);
+          RebuildLookup();
+        }
+
+        /**
+         * Gather the pixels from every rank onto the root, which must only be used when no
+         * two ranks have a pixel at the same location (e.g. after each rank has composited a
+         * separate region of the screen). Collective.
+         * @param comm
+         * @param root
+         */
+        void GatherDisjoint(const net::MpiCommunicator& comm, proc_t root)
+        {
+          std::vector<PixelType> gathered = comm.GatherV(pixels, root);
+          if (comm.Rank() == root)
+          {
+            Clear();
+            pixels.swap(gathered);
+            RebuildLookup();
+          }
+        }
+
         size_t GetPixelCount() const
         {
           return pixels.size();
@@ -131,16 +186,109 @@ namespace hemelb
 
         void Clear()
         {
-          pixelLookup.clear();
+          // Only reset the lookup entries we have used, rather than every tile.
+          for (typename std::vector<PixelType>::const_iterator it = pixels.begin(); it != pixels.end(); ++it)
+          {
+            int* slot = FindSlot(it->GetI(), it->GetJ());
+            if (slot != NULL)
+            {
+              *slot = NoPixel;
+            }
+          }
           pixels.clear();
         }
 
       private:
-        std::map<BasicPixel, unsigned int> pixelLookup;
+        /**
+         * The width and height in pixels of each tile of the lookup.
+         */
+        static const int TileSize = 16;
+        static const int TileArea = TileSize * TileSize;
+        static const int NoPixel = -1;
+
+        /**
+         * The lookup entry for a location, or NULL if its tile has not been allocated.
+         */
+        int* FindSlot(int i, int j)
+        {
+          const int tileX = i / TileSize;
+          const int tileY = j / TileSize;
+          if (tileX >= tilesX || tileY >= tilesY || tileIndices[tileY * tilesX + tileX] == NoPixel)
+          {
+            return NULL;
+          }
+          return &slots[tileIndices[tileY * tilesX + tileX] * TileArea + (j % TileSize) * TileSize
+              + i % TileSize];
+        }
+
+        /**
+         * The lookup entry for a location, allocating its tile if necessary.
+         */
+        int& GetSlot(int i, int j)
+        {
+          assert(i >= 0 && j >= 0);
+          const int tileX = i / TileSize;
+          const int tileY = j / TileSize;
+          if (tileX >= tilesX || tileY >= tilesY)
+          {
+            GrowTileGrid(std::max(tileX + 1, tilesX), std::max(tileY + 1, tilesY));
+          }
+
+          int& tile = tileIndices[tileY * tilesX + tileX];
+          if (tile == NoPixel)
+          {
+            tile = tileCount++;
+            slots.resize(tileCount * TileArea, NoPixel);
+          }
+          return slots[tile * TileArea + (j % TileSize) * TileSize + i % TileSize];
+        }
+
+        void GrowTileGrid(int newTilesX, int newTilesY)
+        {
+          std::vector<int> newTileIndices(newTilesX * newTilesY, NoPixel);
+          for (int tileY = 0; tileY < tilesY; ++tileY)
+          {
+            for (int tileX = 0; tileX < tilesX; ++tileX)
+            {
+              newTileIndices[tileY * newTilesX + tileX] = tileIndices[tileY * tilesX + tileX];
+            }
+          }
+          tileIndices.swap(newTileIndices);
+          tilesX = newTilesX;
+          tilesY = newTilesY;
+        }
+
+        void RebuildLookup()
+        {
+          for (unsigned int index = 0; index < pixels.size(); ++index)
+          {
+            GetSlot(pixels[index].GetI(), pixels[index].GetJ()) = index;
+          }
+        }
+
+        /**
+         * For each tile of the screen, the index of its block in slots, or NoPixel.
+         */
+        std::vector<int> tileIndices;
+        int tilesX;
+        int tilesY;
+        int tileCount;
+        /**
+         * For each location in each allocated tile, the index of its pixel, or NoPixel.
+         */
+        std::vector<int> slots;
+
         std::vector<PixelType> pixels;
         int count;
         bool inUse;
     };
+
+    template<typename PixelType>
+    const int PixelSet<PixelType>::TileSize;
+    template<typename PixelType>
+    const int PixelSet<PixelType>::TileArea;
+    template<typename PixelType>
+    const int PixelSet<PixelType>::NoPixel;
   }
 }
 
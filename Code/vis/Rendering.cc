@@ -36,6 +36,24 @@ namespace hemelb
       }
     }
 
+    void Rendering::Clear()
+    {
+      if (glyphResult != NULL)
+      {
+        glyphResult->Clear();
+      }
+
+      if (rayResult != NULL)
+      {
+        rayResult->Clear();
+      }
+
+      if (streakResult != NULL)
+      {
+        streakResult->Clear();
+      }
+    }
+
     void Rendering::ReceivePixelCounts(net::Net* inNet, proc_t source)
     {
       if (glyphResult != NULL)
@@ -116,6 +134,38 @@ namespace hemelb
       }
     }
 
+    void Rendering::MovePixelsOutside(int iBegin, int iEnd, Rendering& other)
+    {
+      if (glyphResult != NULL)
+      {
+        glyphResult->MovePixelsOutside(iBegin, iEnd, *other.glyphResult);
+      }
+      if (rayResult != NULL)
+      {
+        rayResult->MovePixelsOutside(iBegin, iEnd, *other.rayResult);
+      }
+      if (streakResult != NULL)
+      {
+        streakResult->MovePixelsOutside(iBegin, iEnd, *other.streakResult);
+      }
+    }
+
+    void Rendering::GatherDisjoint(const net::MpiCommunicator& comm, proc_t root)
+    {
+      if (glyphResult != NULL)
+      {
+        glyphResult->GatherDisjoint(comm, root);
+      }
+      if (rayResult != NULL)
+      {
+        rayResult->GatherDisjoint(comm, root);
+      }
+      if (streakResult != NULL)
+      {
+        streakResult->GatherDisjoint(comm, root);
+      }
+    }
+
     void Rendering::PopulateResultSet(PixelSet<ResultPixel>* resultSet)
     {
       if (glyphResult != NULL)
@@ -29,6 +29,11 @@ namespace hemelb
                   PixelSet<streaklinedrawer::StreakPixel>* streak);
         void ReleaseAll();
 
+        /**
+         * Remove all the pixels from each of the component pixel sets.
+         */
+        void Clear();
+
         void ReceivePixelCounts(net::Net* inNet, proc_t source);
 
         void ReceivePixelData(net::Net* inNet, proc_t source);
@@ -37,6 +42,16 @@ namespace hemelb
 
         void SendPixelData(net::Net* inNet, proc_t destination);
         void Combine(const Rendering& other);
+
+        /**
+         * Move the pixels whose I coordinate is outside [iBegin, iEnd) into other.
+         */
+        void MovePixelsOutside(int iBegin, int iEnd, Rendering& other);
+
+        /**
+         * Gather the pixels, which must not overlap between ranks, onto the root. Collective.
+         */
+        void GatherDisjoint(const net::MpiCommunicator& comm, proc_t root);
         void PopulateResultSet(PixelSet<ResultPixel>* resultSet);
 
       private:
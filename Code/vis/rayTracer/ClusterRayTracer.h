@@ -38,7 +38,8 @@ namespace hemelb
                            const VisSettings& iVisSettings,
                            const hemelb::geometry::LatticeData& iLatticeData,
                            const lb::MacroscopicPropertyCache& propertyCache) :
-              viewpoint(iViewpoint), screen(iScreen), domainStats(iDomainStats), visSettings(iVisSettings), latticeData(iLatticeData), propertyCache(propertyCache)
+              viewpoint(iViewpoint), screen(iScreen), domainStats(iDomainStats), visSettings(iVisSettings), latticeData(iLatticeData), propertyCache(propertyCache),
+                  firstColumn(0), lastColumn(std::numeric_limits<int>::max())
           {
             // TODO: This is absolutely horrible, but neccessary until RayDataNormal is
             // removed. 
@@ -68,6 +69,16 @@ namespace hemelb
             CastRaysForEachPixel(iCluster, pixels);
           }
 
+          /**
+           * Restricts rendering to the screen columns [iFirstColumn, iLastColumn], so that
+           * several tracers can work on disjoint parts of the same image.
+           */
+          void SetColumnRange(int iFirstColumn, int iLastColumn)
+          {
+            firstColumn = iFirstColumn;
+            lastColumn = iLastColumn;
+          }
+
         private:
           void GetRayUnitsFromViewpointToCluster(const Ray<RayDataType> & iRay,
                                                  float & oMaximumRayUnits,
@@ -200,8 +211,8 @@ namespace hemelb
 
           bool SubImageOffScreen()
           {
-            return (lowerLeftPixelCoordinatesOfSubImage.x >= screen.GetPixelsX()
-                || upperRightPixelCoordinatesOfSubImage.x < 0
+            return (lowerLeftPixelCoordinatesOfSubImage.x > GetLastColumn()
+                || upperRightPixelCoordinatesOfSubImage.x < firstColumn
                 || lowerLeftPixelCoordinatesOfSubImage.y >= screen.GetPixelsY()
                 || upperRightPixelCoordinatesOfSubImage.y < 0);
           }
@@ -209,10 +220,10 @@ namespace hemelb
           void CropSubImageToScreen()
           {
             lowerLeftPixelCoordinatesOfSubImage.x = util::NumericalFunctions::max(lowerLeftPixelCoordinatesOfSubImage.x,
-                                                                                  0);
+                                                                                  firstColumn);
 
             upperRightPixelCoordinatesOfSubImage.x =
-                util::NumericalFunctions::min(upperRightPixelCoordinatesOfSubImage.x, screen.GetPixelsX() - 1);
+                util::NumericalFunctions::min(upperRightPixelCoordinatesOfSubImage.x, GetLastColumn());
 
             lowerLeftPixelCoordinatesOfSubImage.y = util::NumericalFunctions::max(lowerLeftPixelCoordinatesOfSubImage.y,
                                                                                   0);
@@ -221,6 +232,11 @@ namespace hemelb
                 util::NumericalFunctions::min(upperRightPixelCoordinatesOfSubImage.y, screen.GetPixelsY() - 1);
           }
 
+          int GetLastColumn() const
+          {
+            return util::NumericalFunctions::min(lastColumn, screen.GetPixelsX() - 1);
+          }
+
           void CalculateVectorsToClusterSpanAndLowerLeftPixel(const ClusterType& iCluster)
           {
             mViewpointCentreToMaxSite = iCluster.GetMaxSite() - viewpoint.GetViewpointLocation();
@@ -741,6 +757,10 @@ namespace hemelb
            */
           const lb::MacroscopicPropertyCache& propertyCache;
 
+          // The range of screen columns this tracer renders into, inclusive.
+          int firstColumn;
+          int lastColumn;
+
           util::Vector3D<float> fromCameraToBottomLeftPixelOfSubImage;
 
           util::Vector3D<float> mLowerSiteCordinatesOfClusterRelativeToViewpoint;
@@ -19,6 +19,7 @@
 #include "lb/LbmParameters.h"
 #include "log/Logger.h"
 #include "net/IOCommunicator.h"
+#include "util/ThreadPool.h"
 #include "util/utilityFunctions.h" 
 #include "util/Vector3D.h"
 #include "vis/DomainStats.h"
@@ -52,7 +53,8 @@ namespace hemelb
                     Viewpoint* iViewpoint,
                     VisSettings* iVisSettings) :
             mClusterBuilder(iLatDat, iLatDat->GetLocalRank()), mLatDat(iLatDat), mDomainStats(iDomainStats),
-                mScreen(iScreen), mViewpoint(iViewpoint), mVisSettings(iVisSettings)
+                mScreen(iScreen), mViewpoint(iViewpoint), mVisSettings(iVisSettings), threadPool(HEMELB_VIS_THREADS),
+                threadPixels(threadPool.GetThreadCount())
           {
             mClusterBuilder.BuildClusters();
           }
@@ -68,6 +70,15 @@ namespace hemelb
                 PixelSetStore<PixelSet<RayDataType> >::GetUnusedPixelSet();
             pixels->Clear();
 
+            Render(propertyCache, pixels);
+
+            return pixels;
+          }
+
+          // Render the current state into the given (cleared) pixel set. This does not use the
+          // pixel set store, so may be called on a thread other than the one managing it.
+          void Render(const lb::MacroscopicPropertyCache& propertyCache, PixelSet<RayDataType>* pixels)
+          {
             ClusterRayTracer<ClusterType, RayDataType> lClusterRayTracer(*mViewpoint,
                                                                          *mScreen,
                                                                          *mDomainStats,
@@ -75,12 +86,41 @@ namespace hemelb
                                                                          *mLatDat,
                                                                          propertyCache);
 
-            for (unsigned int clusterId = 0; clusterId < mClusterBuilder.GetClusters().size(); clusterId++)
+            if (threadPool.GetThreadCount() == 1)
             {
-              lClusterRayTracer.RenderCluster(mClusterBuilder.GetClusters()[clusterId], *pixels);
+              for (unsigned int clusterId = 0; clusterId < mClusterBuilder.GetClusters().size(); clusterId++)
+              {
+                lClusterRayTracer.RenderCluster(mClusterBuilder.GetClusters()[clusterId], *pixels);
+              }
+
+              return;
             }
 
-            return pixels;
+            // Each tile of screen columns is rendered, for every cluster, by a single thread
+            // into that thread's own pixel set. A pixel therefore sees the clusters in the same
+            // order as in the serial loop above, and the per-thread sets are disjoint so
+            // merging them is just a copy.
+            std::vector<ClusterRayTracer<ClusterType, RayDataType> > tracers(threadPool.GetThreadCount(),
+                                                                            lClusterRayTracer);
+            const int columnCount = mScreen->GetPixelsX();
+            const unsigned int tileCount = (columnCount + ColumnsPerTile - 1) / ColumnsPerTile;
+
+            threadPool.Run(tileCount, [this, &tracers](unsigned int tile, unsigned int thread)
+            {
+              ClusterRayTracer<ClusterType, RayDataType>& tracer = tracers[thread];
+              tracer.SetColumnRange(tile * ColumnsPerTile, (tile + 1) * ColumnsPerTile - 1);
+
+              for (unsigned int clusterId = 0; clusterId < mClusterBuilder.GetClusters().size(); clusterId++)
+              {
+                tracer.RenderCluster(mClusterBuilder.GetClusters()[clusterId], threadPixels[thread]);
+              }
+            });
+
+            for (unsigned int thread = 0; thread < threadPixels.size(); ++thread)
+            {
+              pixels->Combine(threadPixels[thread]);
+              threadPixels[thread].Clear();
+            }
           }
 
         private:
@@ -91,6 +131,13 @@ namespace hemelb
           Screen* mScreen;
           Viewpoint* mViewpoint;
           VisSettings* mVisSettings;
+
+          // Width of the column tiles handed out to the render threads. Each thread renders
+          // into its own PixelSet in threadPixels, which are merged once all the tiles are done.
+          static const int ColumnsPerTile = 16;
+
+          util::ThreadPool threadPool;
+          std::vector<PixelSet<RayDataType> > threadPixels;
       };
     }
   }
@@ -17,12 +17,15 @@ namespace hemelb
     namespace streaklinedrawer
     {
 
-      NeighbouringProcessor::NeighbouringProcessor()
+      NeighbouringProcessor::NeighbouringProcessor() :
+        numberOfParticlesToSend(0), numberOfParticlesToReceive(0), numberOfSiteBeingRequestedByNeighbour(0),
+            numberOfSitesRequestedByThisCore(0), neighbourRank(-1)
       {
       }
 
       NeighbouringProcessor::NeighbouringProcessor(proc_t neighbourRankIn) :
-        neighbourRank(neighbourRankIn)
+        numberOfParticlesToSend(0), numberOfParticlesToReceive(0), numberOfSiteBeingRequestedByNeighbour(0),
+            numberOfSitesRequestedByThisCore(0), neighbourRank(neighbourRankIn)
       {
       }
 
@@ -31,28 +34,15 @@ namespace hemelb
         particlesToSend.push_back(particle);
       }
 
-      bool NeighbouringProcessor::ParticlesToBeRetrieved()
+      const std::vector<Particle>& NeighbouringProcessor::GetReceivedParticles() const
       {
-        return (particlesToReceive.size() > 0);
+        return particlesToReceive;
       }
 
-      const Particle& NeighbouringProcessor::PopNextReceivedParticle()
-      {
-        const Particle& lParticle = particlesToReceive.back();
-        particlesToReceive.pop_back();
-        return lParticle;
-      }
-
-      void NeighbouringProcessor::ExchangeParticleCounts(net::Net& net)
-      {
-        numberOfParticlesToSend = particlesToSend.size();
-        net.RequestSendR(numberOfParticlesToSend, neighbourRank);
-        net.RequestReceiveR(numberOfParticlesToReceive, neighbourRank);
-      }
-
-      void NeighbouringProcessor::ClearParticleSendingList()
+      void NeighbouringProcessor::ClearParticles()
       {
         particlesToSend.clear();
+        particlesToReceive.clear();
       }
 
       void NeighbouringProcessor::ExchangeParticles(net::Net& net)
@@ -71,11 +61,22 @@ namespace hemelb
         }
       }
 
-      void NeighbouringProcessor::AddSiteToRequestVelocityDataFor(site_t siteI,
-                                                                  site_t siteJ,
-                                                                  site_t siteK)
+      void NeighbouringProcessor::AddSiteToRequestVelocityDataFor(const util::Vector3D<site_t>& location,
+                                                                  site_t fieldIndex)
+      {
+        siteCoordsRequestedByThisCore.push_back(location);
+        fieldIndicesReceived.push_back(fieldIndex);
+      }
+
+      const std::vector<util::Vector3D<site_t> >& NeighbouringProcessor::GetSiteCoordsRequestedByNeighbour() const
+      {
+        return siteCoordsRequestedByNeighbour;
+      }
+
+      void NeighbouringProcessor::SetFieldIndicesToSend(const std::vector<site_t>& fieldIndices)
       {
-        siteCoordsRequestedByThisCore.push_back(util::Vector3D<site_t>(siteI, siteJ, siteK));
+        fieldIndicesToSend = fieldIndices;
+        velocityFieldDataForNeighbour.resize(fieldIndicesToSend.size());
       }
 
       void NeighbouringProcessor::ExchangeSiteIdCounts(net::Net& net)
@@ -91,7 +92,6 @@ namespace hemelb
         if (numberOfSiteBeingRequestedByNeighbour > 0)
         {
           siteCoordsRequestedByNeighbour.resize(numberOfSiteBeingRequestedByNeighbour);
-          velocityFieldDataForNeighbour.resize(numberOfSiteBeingRequestedByNeighbour);
 
           net.RequestReceive(&siteCoordsRequestedByNeighbour[0],
                              (int) numberOfSiteBeingRequestedByNeighbour,
@@ -107,38 +107,14 @@ namespace hemelb
         }
       }
 
-      void NeighbouringProcessor::ExchangeVelocitiesForRequestedSites(net::Net& net)
+      const std::vector<site_t>& NeighbouringProcessor::GetFieldIndicesToSend() const
       {
-        if (numberOfSitesRequestedByThisCore > 0)
-        {
-          velocityFieldDataFromNeighbour.resize(numberOfSitesRequestedByThisCore);
-
-          net.RequestReceiveV(velocityFieldDataFromNeighbour,
-                             neighbourRank);
-        }
-
-        if (numberOfSiteBeingRequestedByNeighbour > 0)
-        {
-          velocityFieldDataForNeighbour.resize(numberOfSiteBeingRequestedByNeighbour);
-
-          net.RequestSendV(velocityFieldDataForNeighbour,
-                          neighbourRank);
-        }
-      }
-
-      site_t NeighbouringProcessor::GetNumberOfSitesRequestedByNeighbour() const
-      {
-        return siteCoordsRequestedByNeighbour.size();
-      }
-
-      const util::Vector3D<float>& NeighbouringProcessor::GetReceivedVelocityField(const site_t receivedIndex) const
-      {
-        return velocityFieldDataFromNeighbour[receivedIndex];
+        return fieldIndicesToSend;
       }
 
-      const util::Vector3D<site_t>& NeighbouringProcessor::GetSiteCoordsBeingRequestedByNeighbour(const site_t receivedIndex) const
+      const std::vector<site_t>& NeighbouringProcessor::GetFieldIndicesReceived() const
       {
-        return siteCoordsRequestedByNeighbour[receivedIndex];
+        return fieldIndicesReceived;
       }
 
       void NeighbouringProcessor::SetVelocityFieldToSend(const site_t sendIndex,
@@ -147,19 +123,28 @@ namespace hemelb
         velocityFieldDataForNeighbour[sendIndex] = velocityFieldToSend;
       }
 
-      site_t NeighbouringProcessor::GetNumberOfSitesRequestedByThisCore() const
+      const util::Vector3D<float>& NeighbouringProcessor::GetReceivedVelocityField(const site_t receivedIndex) const
       {
-        return siteCoordsRequestedByThisCore.size();
+        return velocityFieldDataFromNeighbour[receivedIndex];
       }
 
-      const util::Vector3D<site_t>& NeighbouringProcessor::GetSendingSiteCoorinates(site_t sendIndex) const
+      void NeighbouringProcessor::ExchangeVelocitiesAndParticleCounts(net::Net& net)
       {
-        return siteCoordsRequestedByThisCore[sendIndex];
-      }
+        numberOfParticlesToSend = particlesToSend.size();
+        net.RequestSendR(numberOfParticlesToSend, neighbourRank);
+        net.RequestReceiveR(numberOfParticlesToReceive, neighbourRank);
 
-      void NeighbouringProcessor::ClearListOfRequestedSites()
-      {
-        siteCoordsRequestedByThisCore.clear();
+        if (numberOfSitesRequestedByThisCore > 0)
+        {
+          net.RequestReceiveV(velocityFieldDataFromNeighbour,
+                             neighbourRank);
+        }
+
+        if (numberOfSiteBeingRequestedByNeighbour > 0)
+        {
+          net.RequestSendV(velocityFieldDataForNeighbour,
+                          neighbourRank);
+        }
       }
 
     }
@@ -19,6 +19,11 @@ namespace hemelb
   {
     namespace streaklinedrawer
     {
+      /**
+       * The data exchanged with one neighbouring rank: the velocities of the sites near the
+       * boundary between the two ranks, which are sent every step, and the particles that move
+       * between them.
+       */
       class NeighbouringProcessor
       {
         public:
@@ -28,29 +33,28 @@ namespace hemelb
 
           // Functions for communicating particles.
           void AddParticleToSend(const Particle& iParticle);
-          bool ParticlesToBeRetrieved();
-          const Particle& PopNextReceivedParticle();
-          void ClearParticleSendingList();
+          const std::vector<Particle>& GetReceivedParticles() const;
+          void ClearParticles();
 
-          void ExchangeParticleCounts(net::Net& net);
           void ExchangeParticles(net::Net& net);
 
-          // Functions for communicating velocity data.
-          void AddSiteToRequestVelocityDataFor(site_t, site_t, site_t);
-          site_t GetNumberOfSitesRequestedByNeighbour() const;
-          const util::Vector3D<float>& GetReceivedVelocityField(const site_t receivedIndex) const;
-          const util::Vector3D<site_t>
-          & GetSiteCoordsBeingRequestedByNeighbour(const site_t receivedIndex) const;
-          void SetVelocityFieldToSend(const site_t sendIndex,
-                                      const util::Vector3D<float>& velocityFieldToSend);
-
-          const util::Vector3D<site_t>& GetSendingSiteCoorinates(site_t sendIndex) const;
-          site_t GetNumberOfSitesRequestedByThisCore() const;
-          void ClearListOfRequestedSites();
+          // Functions for setting up the velocity exchange, done once.
+          void AddSiteToRequestVelocityDataFor(const util::Vector3D<site_t>& location, site_t fieldIndex);
+          const std::vector<util::Vector3D<site_t> >& GetSiteCoordsRequestedByNeighbour() const;
+          void SetFieldIndicesToSend(const std::vector<site_t>& fieldIndices);
 
           void ExchangeSiteIdCounts(net::Net& net);
           void ExchangeSiteIds(net::Net& net);
-          void ExchangeVelocitiesForRequestedSites(net::Net& net);
+
+          // Functions for the velocity exchange, done every step along with the number of
+          // particles to be exchanged.
+          const std::vector<site_t>& GetFieldIndicesToSend() const;
+          const std::vector<site_t>& GetFieldIndicesReceived() const;
+          void SetVelocityFieldToSend(const site_t sendIndex,
+                                      const util::Vector3D<float>& velocityFieldToSend);
+          const util::Vector3D<float>& GetReceivedVelocityField(const site_t receivedIndex) const;
+
+          void ExchangeVelocitiesAndParticleCounts(net::Net& net);
 
         private:
           site_t numberOfParticlesToSend;
@@ -65,6 +69,10 @@ namespace hemelb
           std::vector<util::Vector3D<site_t> > siteCoordsRequestedByThisCore;
           std::vector<util::Vector3D<site_t> > siteCoordsRequestedByNeighbour;
 
+          // Where, in the velocity field, the velocities sent and received live.
+          std::vector<site_t> fieldIndicesToSend;
+          std::vector<site_t> fieldIndicesReceived;
+
           std::vector<util::Vector3D<float> > velocityFieldDataForNeighbour;
           std::vector<util::Vector3D<float> > velocityFieldDataFromNeighbour;
 
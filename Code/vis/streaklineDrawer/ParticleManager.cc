@@ -21,101 +21,160 @@ namespace hemelb
 
       void ParticleManager::AddParticle(const Particle& iParticle)
       {
-        particles.push_back(iParticle);
+        positionX.push_back(iParticle.position.x);
+        positionY.push_back(iParticle.position.y);
+        positionZ.push_back(iParticle.position.z);
+        velocityX.push_back(iParticle.velocity.x);
+        velocityY.push_back(iParticle.velocity.y);
+        velocityZ.push_back(iParticle.velocity.z);
+        speeds.push_back(iParticle.vel);
+        inletIds.push_back(iParticle.inletID);
       }
 
-      std::vector<Particle>& ParticleManager::GetParticles()
+      Particle ParticleManager::GetParticle(size_t iIndex) const
       {
-        return particles;
+        Particle particle(positionX[iIndex], positionY[iIndex], positionZ[iIndex], inletIds[iIndex]);
+        particle.velocity = util::Vector3D<float>(velocityX[iIndex], velocityY[iIndex], velocityZ[iIndex]);
+        particle.vel = speeds[iIndex];
+        return particle;
       }
 
       size_t ParticleManager::GetNumberOfLocalParticles() const
       {
-        return particles.size();
+        return positionX.size();
       }
 
-      void ParticleManager::DeleteParticle(site_t iIndex)
+      void ParticleManager::DeleteParticle(size_t iIndex)
       {
-        assert(particles.size() > static_cast<size_t> (iIndex));
+        assert(GetNumberOfLocalParticles() > iIndex);
 
         //Move the particle at the end to position
-        particles[iIndex] = particles.back();
+        CopyParticle(GetNumberOfLocalParticles() - 1, iIndex);
 
         //Delete the now duplicated particle at the end
-        particles.pop_back();
+        Resize(GetNumberOfLocalParticles() - 1);
       }
 
       void ParticleManager::DeleteAll()
       {
-        particles.clear();
+        Resize(0);
       }
 
-      void ParticleManager::ProcessParticleMovement()
+      void ParticleManager::AdvectParticles(VelocityField& iVelocityField)
       {
-        for (unsigned int i = 0; i < GetNumberOfLocalParticles(); i++)
+        const size_t count = GetNumberOfLocalParticles();
+
+        if (count == 0)
         {
-          // particle coords updating (dt = 1)
-          particles[i].position += particles[i].velocity;
+          return;
         }
-      }
-
-      // Communicate the particles' current state to other processors.
-      void ParticleManager::CommunicateParticles(net::Net& streakNet,
-                                                 const geometry::LatticeData& latticeData,
-                                                 VelocityField& velocityField)
-      {
-        unsigned int particles_temp = GetNumberOfLocalParticles();
 
-        proc_t thisRank = streakNet.Rank();
-
-        for (int n = (int) (particles_temp - 1); n >= 0; n--)
+        iVelocityField.InterpolateVelocities(count,
+                                             &positionX[0],
+                                             &positionY[0],
+                                             &positionZ[0],
+                                             &velocityX[0],
+                                             &velocityY[0],
+                                             &velocityZ[0]);
+
+        // Limit the speed to one lattice unit per step, and compact out the particles that have
+        // stopped.
+        size_t kept = 0;
+        for (size_t n = 0; n < count; ++n)
         {
-          VelocitySiteData* siteVelocityData =
-              velocityField.GetVelocitySiteData(latticeData,
-                                                util::Vector3D<site_t>(particles[n].position));
+          const float speedSquared = velocityX[n] * velocityX[n] + velocityY[n] * velocityY[n]
+              + velocityZ[n] * velocityZ[n];
 
-          // TODO can we get rid of the first test?
-          if (siteVelocityData == NULL || siteVelocityData->proc_id == -1)
-          {
-            continue;
-          }
-          else if (thisRank == siteVelocityData->proc_id)
+          if (speedSquared <= 1.0e-8F)
           {
             continue;
           }
 
-          neighbouringProcessors[siteVelocityData->proc_id].AddParticleToSend(particles[n]);
-          DeleteParticle(n);
+          const float speed = sqrtf(speedSquared);
+          const float scale = speedSquared > 1.0F ?
+            1.0F / speed :
+            1.0F;
+
+          CopyParticle(n, kept);
+          velocityX[kept] *= scale;
+          velocityY[kept] *= scale;
+          velocityZ[kept] *= scale;
+          speeds[kept] = speed * scale;
+          ++kept;
         }
 
-        for (std::map<proc_t, NeighbouringProcessor>::iterator proc =
-            neighbouringProcessors.begin(); proc != neighbouringProcessors.end(); ++proc)
+        Resize(kept);
+
+        // particle coords updating (dt = 1)
+        for (size_t n = 0; n < kept; ++n)
         {
-          (*proc).second.ExchangeParticleCounts(streakNet);
+          positionX[n] += velocityX[n];
+          positionY[n] += velocityY[n];
+          positionZ[n] += velocityZ[n];
         }
-        streakNet.Dispatch();
+      }
 
-        for (std::map<proc_t, NeighbouringProcessor>::iterator proc =
-            neighbouringProcessors.begin(); proc != neighbouringProcessors.end(); ++proc)
+      void ParticleManager::CollectParticlesToSend(const VelocityField& iVelocityField, proc_t iThisRank)
+      {
+        for (size_t n = GetNumberOfLocalParticles(); n-- > 0;)
         {
-          (*proc).second.ExchangeParticles(streakNet);
-        }
+          const proc_t owner =
+              iVelocityField.GetRank(iVelocityField.GetFieldIndex(util::Vector3D<site_t>((site_t) positionX[n],
+                                                                                         (site_t) positionY[n],
+                                                                                         (site_t) positionZ[n])));
+
+          // Particles in cells we have no data for, or in our own cells, stay here.
+          if (owner == SITE_OR_BLOCK_SOLID || owner == iThisRank)
+          {
+            continue;
+          }
 
-        streakNet.Dispatch();
+          neighbouringProcessors[owner].AddParticleToSend(GetParticle(n));
+          DeleteParticle(n);
+        }
+      }
 
-        for (std::map<proc_t, NeighbouringProcessor>::iterator proc =
-            neighbouringProcessors.begin(); proc != neighbouringProcessors.end(); ++proc)
+      void ParticleManager::AddReceivedParticles()
+      {
+        for (std::map<proc_t, NeighbouringProcessor>::iterator proc = neighbouringProcessors.begin();
+            proc != neighbouringProcessors.end(); ++proc)
         {
-          NeighbouringProcessor& neighbourProc = (*proc).second;
-          neighbourProc.ClearParticleSendingList();
+          const std::vector<Particle>& received = (*proc).second.GetReceivedParticles();
 
-          while (neighbourProc.ParticlesToBeRetrieved())
+          for (std::vector<Particle>::const_iterator particle = received.begin(); particle != received.end();
+              ++particle)
           {
-            AddParticle(neighbourProc.PopNextReceivedParticle());
+            AddParticle(*particle);
           }
+
+          (*proc).second.ClearParticles();
         }
       }
 
+      void ParticleManager::Resize(size_t iCount)
+      {
+        positionX.resize(iCount);
+        positionY.resize(iCount);
+        positionZ.resize(iCount);
+        velocityX.resize(iCount);
+        velocityY.resize(iCount);
+        velocityZ.resize(iCount);
+        speeds.resize(iCount);
+        inletIds.resize(iCount);
+      }
+
+      void ParticleManager::CopyParticle(size_t iFrom, size_t iTo)
+      {
+        positionX[iTo] = positionX[iFrom];
+        positionY[iTo] = positionY[iFrom];
+        positionZ[iTo] = positionZ[iFrom];
+        velocityX[iTo] = velocityX[iFrom];
+        velocityY[iTo] = velocityY[iFrom];
+        velocityZ[iTo] = velocityZ[iFrom];
+        speeds[iTo] = speeds[iFrom];
+        inletIds[iTo] = inletIds[iFrom];
+      }
+
     }
   }
 }
@@ -19,7 +19,6 @@
 #include "vis/streaklineDrawer/NeighbouringProcessor.h"
 #include "vis/streaklineDrawer/Particle.h"
 #include "vis/streaklineDrawer/VelocityField.h"
-#include "vis/streaklineDrawer/VelocitySiteData.h"
 
 namespace hemelb
 {
@@ -27,6 +26,10 @@ namespace hemelb
   {
     namespace streaklinedrawer
     {
+      /**
+       * The streakline particles on this rank. Each property is stored in its own array so that
+       * particles are interpolated and moved in batches.
+       */
       class ParticleManager
       {
         public:
@@ -35,21 +38,32 @@ namespace hemelb
 
           // Functions for manipulating the particle store
           void AddParticle(const Particle& iParticle);
-          std::vector<Particle>& GetParticles();
+          Particle GetParticle(size_t iIndex) const;
           size_t GetNumberOfLocalParticles() const;
-          void DeleteParticle(site_t iIndex);
+          void DeleteParticle(size_t iIndex);
           void DeleteAll();
 
-          // Function for updating the particles' positions.
-          void ProcessParticleMovement();
+          // Function for updating the particles' velocities and positions, removing those that
+          // have stopped.
+          void AdvectParticles(VelocityField& iVelocityField);
 
-          // Function for moving the particles between cores.
-          void CommunicateParticles(net::Net& streakNet,
-                                    const geometry::LatticeData& iLatDat,
-                                    VelocityField& iVelocityField);
+          // Functions for moving the particles between cores.
+          void CollectParticlesToSend(const VelocityField& iVelocityField, proc_t iThisRank);
+          void AddReceivedParticles();
 
         private:
-          std::vector<Particle> particles;
+          void Resize(size_t iCount);
+          void CopyParticle(size_t iFrom, size_t iTo);
+
+          std::vector<float> positionX;
+          std::vector<float> positionY;
+          std::vector<float> positionZ;
+          std::vector<float> velocityX;
+          std::vector<float> velocityY;
+          std::vector<float> velocityZ;
+          std::vector<float> speeds;
+          std::vector<unsigned int> inletIds;
+
           std::map<proc_t, NeighbouringProcessor>& neighbouringProcessors;
 
       };
@@ -30,12 +30,12 @@ namespace hemelb
                                          const lb::MacroscopicPropertyCache& propertyCache,
                                          const net::MpiCommunicator& comms) :
           latDat(iLatDat), screen(iScreen), viewpoint(iViewpoint), visSettings(iVisSettings),
-          // propertyCache(propertyCache),
           particleManager(neighbouringProcessors),
-          velocityField(comms.Rank(), neighbouringProcessors, propertyCache),
+          velocityField(comms.Rank(), iLatDat, propertyCache),
           streakNet(new net::Net(comms))
       {
-        velocityField.BuildVelocityField(iLatDat);
+        velocityField.BuildVelocityField(neighbouringProcessors);
+        CommunicateSiteIds();
         ChooseSeedParticles();
       }
 
@@ -72,27 +72,14 @@ namespace hemelb
 
         velocityField.InvalidateAllCalculatedVelocities();
 
-        // Decide which sites we will need velocity data for in order to move particles
-        WorkOutVelocityDataNeededForParticles();
-
-        // Communicate this with other processors.
-        CommunicateSiteIds();
-
-        // Recalculate velocities at the sites requested from this rank.
-        UpdateVelocityFieldForCommunicatedSites();
-
-        // Communicate the velocities back to the sites that requested them.
-        CommunicateVelocities();
+        // Hand any particles that crossed into the territory of another rank last step over to
+        // it, along with the velocities of the sites at the edges of this rank.
+        particleManager.CollectParticlesToSend(velocityField, streakNet->Rank());
+        CommunicateVelocitiesAndParticles();
 
-        // Update our local velocity field is sufficient to update all particles and prune
-        // those that are stationary.
-        UpdateVelocityFieldForAllParticlesAndPrune();
-
-        // Process the particles' movement.
-        particleManager.ProcessParticleMovement();
-
-        // Communicate any particles that have crossed into the territory of another rank.
-        particleManager.CommunicateParticles(*streakNet, latDat, velocityField);
+        // Interpolate the velocity of every particle, prune those that are stationary and move
+        // the rest.
+        particleManager.AdvectParticles(velocityField);
       }
 
       // Render the streaklines
@@ -101,14 +88,14 @@ namespace hemelb
         int pixels_x = screen.GetPixelsX();
         int pixels_y = screen.GetPixelsY();
 
-        const std::vector<Particle>& particles = particleManager.GetParticles();
-
         PixelSet<StreakPixel>* set = GetUnusedPixelSet();
         set->Clear();
 
-        for (unsigned int n = 0; n < particles.size(); n++)
+        for (size_t n = 0; n < particleManager.GetNumberOfLocalParticles(); n++)
         {
-          util::Vector3D<float> p1 = particles[n].position - util::Vector3D<float>(latDat.GetSiteDimensions() / 2);
+          const Particle particle = particleManager.GetParticle(n);
+
+          util::Vector3D<float> p1 = particle.position - util::Vector3D<float>(latDat.GetSiteDimensions() / 2);
 
           util::Vector3D<float> p2 = viewpoint.Project(p1);
 
@@ -116,7 +103,7 @@ namespace hemelb
 
           if (! (x.x < 0 || x.x >= pixels_x || x.y < 0 || x.y >= pixels_y))
           {
-            StreakPixel pixel(x.x, x.y, particles[n].vel, p2.z, particles[n].inletID);
+            StreakPixel pixel(x.x, x.y, particle.vel, p2.z, particle.inletID);
             set->AddPixel(pixel);
           }
         }
@@ -186,101 +173,7 @@ namespace hemelb
         }
       }
 
-      void StreaklineDrawer::WorkOutVelocityDataNeededForParticles()
-      {
-        std::vector<Particle> &particles = particleManager.GetParticles();
-
-        // Note that we iterate through the array back to front because at the end of this
-        // loop we delete a particle. Iterating back to front ensures that we end up
-        // visiting each particle.
-        for (int n = (int) particles.size() - 1; n >= 0; --n)
-        {
-          Particle& particle = particles[n];
-
-          for (int unitGridI = 0; unitGridI <= 1; ++unitGridI)
-          {
-            site_t neighbourI = (site_t) particle.position.x + unitGridI;
-
-            for (int unitGridJ = 0; unitGridJ <= 1; ++unitGridJ)
-            {
-              site_t neighbourJ = (site_t) particle.position.y + unitGridJ;
-
-              for (int unitGridK = 0; unitGridK <= 1; ++unitGridK)
-              {
-                site_t neighbourK = (site_t) particle.position.z + unitGridK;
-
-                proc_t sourceProcessor;
-
-                if (velocityField.NeededFromNeighbour(util::Vector3D<site_t>(neighbourI, neighbourJ, neighbourK),
-                                                      latDat,
-                                                      &sourceProcessor))
-                {
-                  neighbouringProcessors[sourceProcessor].AddSiteToRequestVelocityDataFor(neighbourI,
-                                                                                          neighbourJ,
-                                                                                          neighbourK);
-                }
-              }
-            }
-          }
-        }
-      }
-
-      void StreaklineDrawer::UpdateVelocityFieldForAllParticlesAndPrune()
-      {
-        std::vector<Particle> &particles = particleManager.GetParticles();
-
-        // Note that we iterate through the array back to front because at the end of this
-        // loop we delete a particle. Iterating back to front ensures that we end up
-        // visiting each particle.
-        for (int n = (int) particles.size() - 1; n >= 0; --n)
-        {
-          util::Vector3D<float> localVelocityField[2][2][2];
-
-          velocityField.GetVelocityFieldAroundPoint(util::Vector3D<site_t>(particles[n].position),
-                                                    latDat,
-                                                    localVelocityField);
-
-          util::Vector3D<float> interp_v = velocityField.InterpolateVelocityForPoint(particles[n].position,
-                                                                                     localVelocityField);
-
-          float vel = interp_v.Dot(interp_v);
-
-          if (vel > 1.0F)
-          {
-            particles[n].vel = 1.0F;
-            particles[n].velocity = interp_v * float(1.0 / sqrtf(vel));
-          }
-          else if (vel > 1.0e-8)
-          {
-            particles[n].vel = sqrtf(vel);
-            particles[n].velocity = interp_v;
-          }
-          else
-          {
-            particleManager.DeleteParticle(n);
-          }
-        }
-      }
-
-      void StreaklineDrawer::UpdateVelocityFieldForCommunicatedSites()
-      {
-        for (std::map<proc_t, NeighbouringProcessor>::const_iterator neighProc = neighbouringProcessors.begin();
-            neighProc != neighbouringProcessors.end(); ++neighProc)
-        {
-          const NeighbouringProcessor& proc = (*neighProc).second;
-
-          for (site_t sendingVelocityIndex = 0; sendingVelocityIndex < proc.GetNumberOfSitesRequestedByNeighbour();
-              sendingVelocityIndex++)
-          {
-            const util::Vector3D<site_t>& siteCoords =
-                proc.GetSiteCoordsBeingRequestedByNeighbour(sendingVelocityIndex);
-
-            velocityField.UpdateLocalField(siteCoords, latDat);
-          }
-        }
-      }
-
-      // Communicate site ids to other processors.
+      // Communicate, once, the sites each neighbouring rank needs velocities for.
       void StreaklineDrawer::CommunicateSiteIds()
       {
         for (std::map<proc_t, NeighbouringProcessor>::iterator proc = neighbouringProcessors.begin();
@@ -298,31 +191,47 @@ namespace hemelb
         }
 
         streakNet->Dispatch();
-      }
-
-      // Communicate velocities to other processors.
-      void StreaklineDrawer::CommunicateVelocities()
-      {
 
+        // Work out where in our field the velocities of the requested sites will be.
         for (std::map<proc_t, NeighbouringProcessor>::iterator proc = neighbouringProcessors.begin();
             proc != neighbouringProcessors.end(); ++proc)
         {
-          (*proc).second.ExchangeVelocitiesForRequestedSites(*streakNet);
+          const std::vector<util::Vector3D<site_t> >& requestedCoords =
+              (*proc).second.GetSiteCoordsRequestedByNeighbour();
+
+          std::vector<site_t> fieldIndices(requestedCoords.size());
+          for (size_t n = 0; n < requestedCoords.size(); ++n)
+          {
+            fieldIndices[n] = velocityField.GetFieldIndex(requestedCoords[n]);
+          }
+
+          (*proc).second.SetFieldIndicesToSend(fieldIndices);
         }
+      }
 
+      // Communicate the velocities at the edges of this rank and the particles crossing them.
+      void StreaklineDrawer::CommunicateVelocitiesAndParticles()
+      {
         for (std::map<proc_t, NeighbouringProcessor>::iterator proc = neighbouringProcessors.begin();
             proc != neighbouringProcessors.end(); ++proc)
         {
           NeighbouringProcessor& neighbourProc = (*proc).second;
+          const std::vector<site_t>& fieldIndices = neighbourProc.GetFieldIndicesToSend();
 
-          for (site_t n = 0; n < neighbourProc.GetNumberOfSitesRequestedByNeighbour(); ++n)
+          for (size_t n = 0; n < fieldIndices.size(); ++n)
           {
-            const util::Vector3D<site_t> siteCoords = neighbourProc.GetSiteCoordsBeingRequestedByNeighbour(n);
+            neighbourProc.SetVelocityFieldToSend(n, velocityField.GetLocalVelocity(fieldIndices[n]));
+          }
 
-            const VelocitySiteData* velocityDataForSite = velocityField.GetVelocitySiteData(latDat, siteCoords);
+          neighbourProc.ExchangeVelocitiesAndParticleCounts(*streakNet);
+        }
 
-            neighbourProc.SetVelocityFieldToSend(n, velocityDataForSite->velocity);
-          }
+        streakNet->Dispatch();
+
+        for (std::map<proc_t, NeighbouringProcessor>::iterator proc = neighbouringProcessors.begin();
+            proc != neighbouringProcessors.end(); ++proc)
+        {
+          (*proc).second.ExchangeParticles(*streakNet);
         }
 
         streakNet->Dispatch();
@@ -331,19 +240,15 @@ namespace hemelb
             proc != neighbouringProcessors.end(); ++proc)
         {
           const NeighbouringProcessor& neighbourProc = (*proc).second;
+          const std::vector<site_t>& fieldIndices = neighbourProc.GetFieldIndicesReceived();
 
-          for (site_t n = 0; n < neighbourProc.GetNumberOfSitesRequestedByThisCore(); n++)
+          for (size_t n = 0; n < fieldIndices.size(); ++n)
           {
-            const util::Vector3D<site_t> &coords = neighbourProc.GetSendingSiteCoorinates(n);
-            velocityField.GetVelocitySiteData(latDat, coords)->velocity = neighbourProc.GetReceivedVelocityField(n);
+            velocityField.SetVelocity(fieldIndices[n], neighbourProc.GetReceivedVelocityField(n));
           }
         }
 
-        for (std::map<proc_t, NeighbouringProcessor>::iterator proc = neighbouringProcessors.begin();
-            proc != neighbouringProcessors.end(); ++proc)
-        {
-          (*proc).second.ClearListOfRequestedSites();
-        }
+        particleManager.AddReceivedParticles();
       }
 
     }
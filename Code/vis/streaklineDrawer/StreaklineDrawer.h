@@ -20,7 +20,6 @@
 #include "vis/streaklineDrawer/NeighbouringProcessor.h"
 #include "vis/streaklineDrawer/ParticleManager.h"
 #include "vis/streaklineDrawer/VelocityField.h"
-#include "vis/streaklineDrawer/VelocitySiteData.h"
 #include "vis/Screen.h"
 #include "vis/streaklineDrawer/StreakPixel.h"
 #include "vis/Viewpoint.h"
@@ -56,24 +55,18 @@ namespace hemelb
           PixelSet<StreakPixel>* Render();
 
         private:
-          // Function for updating the velocity field and the particles in it.
-          void UpdateVelocityFieldForAllParticlesAndPrune();
-          void UpdateVelocityFieldForCommunicatedSites();
-
           // Private functions for the creation / deletion of particles.
           void ChooseSeedParticles();
           void CreateParticlesFromSeeds();
 
           // Private functions for inter-proc communication.
           void CommunicateSiteIds();
-          void CommunicateVelocities();
-          void WorkOutVelocityDataNeededForParticles();
+          void CommunicateVelocitiesAndParticles();
 
           const geometry::LatticeData& latDat;
           const Screen& screen;
           const Viewpoint& viewpoint;
           const VisSettings& visSettings;
-          //const lb::MacroscopicPropertyCache& propertyCache;
 
           std::map<proc_t, NeighbouringProcessor> neighbouringProcessors;
           ParticleManager particleManager;
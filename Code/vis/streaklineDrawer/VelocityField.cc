@@ -18,16 +18,21 @@ namespace hemelb
   {
     namespace streaklinedrawer
     {
+      const site_t VelocityField::NoSite;
+
       VelocityField::VelocityField(proc_t localRank_,
-                                   std::map<proc_t, NeighbouringProcessor>& neighbouringProcessorsIn,
+                                   const geometry::LatticeData& latDat,
                                    const lb::MacroscopicPropertyCache& propertyCache) :
-          counter(0), localRank(localRank_), neighbouringProcessors(neighbouringProcessorsIn), propertyCache(propertyCache)
+          counter(0), localRank(localRank_), latDat(latDat), propertyCache(propertyCache)
       {
       }
 
-      void VelocityField::BuildVelocityField(const geometry::LatticeData& latDat)
+      void VelocityField::BuildVelocityField(std::map<proc_t, NeighbouringProcessor>& neighbouringProcessors)
       {
-        velocityField.resize(latDat.GetBlockCount());
+        blockOffsets.assign(latDat.GetBlockCount(), NoSite);
+
+        // Entry 0 is the one for sites with no data.
+        ranks.assign(1, SITE_OR_BLOCK_SOLID);
 
         // Iterate over each block with some sites on this rank.
         geometry::BlockTraverser blockTraverser(latDat);
@@ -49,70 +54,42 @@ namespace hemelb
               continue;
             }
 
-            // Calculate the bounds of the unit cube around the current site (within the lattice)
-            const site_t startI = util::NumericalFunctions::max<site_t>(0,
-                                                                        blockTraverser.GetX()
-                                                                            * blockTraverser.GetBlockSize()
-                                                                            + siteTraverser.GetX() - 1);
-
-            const site_t startJ = util::NumericalFunctions::max<site_t>(0,
-                                                                        blockTraverser.GetY()
-                                                                            * blockTraverser.GetBlockSize()
-                                                                            + siteTraverser.GetY() - 1);
-
-            const site_t startK = util::NumericalFunctions::max<site_t>(0,
-                                                                        blockTraverser.GetZ()
-                                                                            * blockTraverser.GetBlockSize()
-                                                                            + siteTraverser.GetZ() - 1);
-
-            const site_t endI = util::NumericalFunctions::min<site_t>(latDat.GetSiteDimensions().x - 1,
-                                                                      blockTraverser.GetX()
-                                                                          * blockTraverser.GetBlockSize()
-                                                                          + siteTraverser.GetX() + 1);
-
-            const site_t endJ = util::NumericalFunctions::min<site_t>(latDat.GetSiteDimensions().y - 1,
-                                                                      blockTraverser.GetY()
-                                                                          * blockTraverser.GetBlockSize()
-                                                                          + siteTraverser.GetY() + 1);
-
-            const site_t endK = util::NumericalFunctions::min<site_t>(latDat.GetSiteDimensions().z - 1,
-                                                                      blockTraverser.GetZ()
-                                                                          * blockTraverser.GetBlockSize()
-                                                                          + siteTraverser.GetZ() + 1);
-
-            // Iterate over the sites in the unit cube.
-            for (site_t neighbourI = startI; neighbourI <= endI; neighbourI++)
+            const util::Vector3D<site_t> siteLocation = blockTraverser.GetCurrentLocation()
+                * blockTraverser.GetBlockSize() + siteTraverser.GetCurrentLocation();
+
+            // Iterate over the sites in the unit cube around the current site (within the
+            // lattice).
+            for (site_t neighbourI = util::NumericalFunctions::max<site_t>(0, siteLocation.x - 1);
+                neighbourI <= util::NumericalFunctions::min<site_t>(latDat.GetSiteDimensions().x - 1,
+                                                                    siteLocation.x + 1); neighbourI++)
             {
-              for (site_t neighbourJ = startJ; neighbourJ <= endJ; neighbourJ++)
+              for (site_t neighbourJ = util::NumericalFunctions::max<site_t>(0, siteLocation.y - 1);
+                  neighbourJ <= util::NumericalFunctions::min<site_t>(latDat.GetSiteDimensions().y - 1,
+                                                                      siteLocation.y + 1); neighbourJ++)
               {
-                for (site_t neighbourK = startK; neighbourK <= endK; neighbourK++)
+                for (site_t neighbourK = util::NumericalFunctions::max<site_t>(0, siteLocation.z - 1);
+                    neighbourK <= util::NumericalFunctions::min<site_t>(latDat.GetSiteDimensions().z - 1,
+                                                                        siteLocation.z + 1); neighbourK++)
                 {
+                  const util::Vector3D<site_t> neighbour(neighbourI, neighbourJ, neighbourK);
+
                   // Get the rank that the neighbour lives on.
-                  const proc_t neigh_proc_id = latDat.GetProcIdFromGlobalCoords(util::Vector3D<site_t>(neighbourI,
-                                                                                                       neighbourJ,
-                                                                                                       neighbourK));
+                  const proc_t neighbourRank = latDat.GetProcIdFromGlobalCoords(neighbour);
 
-                  // If we have data for it, we should initialise a block in the velocity field
-                  // for the neighbour site.
-                  if (neigh_proc_id == SITE_OR_BLOCK_SOLID)
+                  if (neighbourRank == SITE_OR_BLOCK_SOLID)
                   {
                     continue;
                   }
 
-                  InitializeVelocityFieldBlock(latDat,
-                                               util::Vector3D<site_t>(neighbourI, neighbourJ, neighbourK),
-                                               neigh_proc_id);
-
-                  // If the neighbour is on this rank, ignore it.
-                  if (localRank == neigh_proc_id)
+                  site_t fieldIndex;
+                  if (AddSite(neighbour, neighbourRank, fieldIndex) && neighbourRank != localRank)
                   {
-                    continue;
-                  }
+                    if (neighbouringProcessors.count(neighbourRank) == 0)
+                    {
+                      neighbouringProcessors[neighbourRank] = NeighbouringProcessor(neighbourRank);
+                    }
 
-                  if (neighbouringProcessors.count(neigh_proc_id) == 0)
-                  {
-                    NeighbouringProcessor newProc(neigh_proc_id);
-                    neighbouringProcessors[neigh_proc_id] = newProc;
+                    neighbouringProcessors[neighbourRank].AddSiteToRequestVelocityDataFor(neighbour, fieldIndex);
                   }
                 }
               }
@@ -122,218 +99,141 @@ namespace hemelb
         }
         while (blockTraverser.TraverseOne());
 
-        // Iterate over the blocks, updating the value of the counter variable wherever
-        // there is velocity field data.
-        for (site_t block = 0; block < latDat.GetBlockCount(); block++)
+        // Record the local contiguous id of each site on this rank.
+        siteIds.assign(ranks.size(), SITE_OR_BLOCK_SOLID);
+        for (site_t blockId = 0; blockId < latDat.GetBlockCount(); ++blockId)
         {
-          if (velocityField[block].empty())
-          {
-            continue;
-          }
-
-          if (latDat.GetBlock(block).IsEmpty())
+          if (blockOffsets[blockId] == NoSite)
           {
             continue;
           }
 
-          // Update the site id on each velocity field unit as required.
+          const geometry::Block& block = latDat.GetBlock(blockId);
           for (site_t localSiteId = 0; localSiteId < latDat.GetSitesPerBlockVolumeUnit(); localSiteId++)
           {
-            velocityField[block][localSiteId].site_id =
-                latDat.GetBlock(block).GetLocalContiguousIndexForSite(localSiteId);
+            if (ranks[blockOffsets[blockId] + localSiteId] == localRank)
+            {
+              siteIds[blockOffsets[blockId] + localSiteId] = block.GetLocalContiguousIndexForSite(localSiteId);
+            }
           }
         }
-      }
 
-      bool VelocityField::BlockContainsData(size_t blockNumber) const
-      {
-        return !velocityField[blockNumber].empty();
+        updatedAt.assign(ranks.size(), -1);
+        velocityX.assign(ranks.size(), 0.0F);
+        velocityY.assign(ranks.size(), 0.0F);
+        velocityZ.assign(ranks.size(), 0.0F);
       }
 
-      VelocitySiteData& VelocityField::GetSiteData(site_t blockNumber, site_t siteNumber)
+      bool VelocityField::AddSite(const util::Vector3D<site_t>& location, proc_t rank, site_t& fieldIndex)
       {
-        return velocityField[blockNumber][siteNumber];
-      }
+        const site_t blockId = latDat.GetBlockIdFromBlockCoords(location / latDat.GetBlockSize());
 
-      // Returns the velocity site data for a given index, or NULL if the index isn't valid / has
-      // no data.
-      VelocitySiteData* VelocityField::GetVelocitySiteData(const geometry::LatticeData& latDat,
-                                                           const util::Vector3D<site_t>& location)
-      {
-        if (!latDat.IsValidLatticeSite(location))
+        if (blockOffsets[blockId] == NoSite)
         {
-          return NULL;
+          blockOffsets[blockId] = ranks.size();
+          ranks.resize(ranks.size() + latDat.GetSitesPerBlockVolumeUnit(), SITE_OR_BLOCK_SOLID);
         }
 
-        util::Vector3D<site_t> blockCoords, siteCoords;
-        latDat.GetBlockAndLocalSiteCoords(location, blockCoords, siteCoords);
+        fieldIndex = blockOffsets[blockId] + latDat.GetLocalSiteIdFromLocalSiteCoords(location % latDat.GetBlockSize());
 
-        site_t block_id = latDat.GetBlockIdFromBlockCoords(blockCoords);
-
-        if (!BlockContainsData(static_cast<size_t>(block_id)))
-        {
-          return NULL;
-        }
-
-        site_t site_id = latDat.GetLocalSiteIdFromLocalSiteCoords(siteCoords);
-
-        return &GetSiteData(block_id, site_id);
+        const bool isNew = ranks[fieldIndex] == SITE_OR_BLOCK_SOLID;
+        ranks[fieldIndex] = rank;
+        return isNew;
       }
 
-      // Function to initialise the velocity field at given coordinates.
-      void VelocityField::InitializeVelocityFieldBlock(const geometry::LatticeData& latDat,
-                                                       const util::Vector3D<site_t> location,
-                                                       const proc_t proc_id)
+      util::Vector3D<float> VelocityField::GetLocalVelocity(site_t fieldIndex)
       {
-        util::Vector3D<site_t> blockCoords, siteCoords;
-        latDat.GetBlockAndLocalSiteCoords(location, blockCoords, siteCoords);
-
-        site_t blockId = latDat.GetBlockIdFromBlockCoords(blockCoords);
-
-        if (!BlockContainsData(blockId))
+        if (updatedAt[fieldIndex] != counter)
         {
-          for (site_t localSiteId = 0; localSiteId < latDat.GetSitesPerBlockVolumeUnit(); ++localSiteId)
-          {
-            velocityField[blockId].push_back(VelocitySiteData());
-          }
+          UpdateLocalVelocity(fieldIndex);
         }
 
-        site_t localSiteId = latDat.GetLocalSiteIdFromLocalSiteCoords(siteCoords);
-        velocityField[blockId][localSiteId].proc_id = proc_id;
+        return util::Vector3D<float>(velocityX[fieldIndex], velocityY[fieldIndex], velocityZ[fieldIndex]);
       }
 
-      // Populate the matrix v with all the velocity field data at each index.
-      // Returns true if this the area resides entirely on this core.
-      void VelocityField::GetVelocityFieldAroundPoint(const util::Vector3D<site_t> location,
-                                                      const geometry::LatticeData& latDat,
-                                                      util::Vector3D<float> localVelocityField[2][2][2])
+      void VelocityField::SetVelocity(site_t fieldIndex, const util::Vector3D<float>& velocity)
       {
-        for (int unitGridI = 0; unitGridI <= 1; ++unitGridI)
-        {
-          site_t neighbourI = location.x + unitGridI;
-
-          for (int unitGridJ = 0; unitGridJ <= 1; ++unitGridJ)
-          {
-            site_t neighbourJ = location.y + unitGridJ;
-
-            for (int unitGridK = 0; unitGridK <= 1; ++unitGridK)
-            {
-              site_t neighbourK = location.z + unitGridK;
-
-              util::Vector3D<site_t> neighbour(neighbourI, neighbourJ, neighbourK);
-
-              if (!latDat.IsValidLatticeSite(neighbour))
-              {
-                // it is a solid site and the velocity is
-                // assumed to be zero
-                localVelocityField[unitGridI][unitGridJ][unitGridK] = util::Vector3D<float>::Zero();
-                continue;
-              }
-
-              VelocitySiteData *vel_site_data_p = GetVelocitySiteData(latDat,
-                                                                      util::Vector3D<site_t>(neighbourI,
-                                                                                             neighbourJ,
-                                                                                             neighbourK));
-
-              if (vel_site_data_p == NULL || vel_site_data_p->proc_id == -1)
-              {
-                // it is a solid site and the velocity is
-                // assumed to be zero
-                localVelocityField[unitGridI][unitGridJ][unitGridK] = util::Vector3D<float>::Zero();
-                continue;
-              }
-
-              if (vel_site_data_p->counter != counter)
-              {
-                UpdateLocalField(vel_site_data_p, latDat);
-              }
-
-              localVelocityField[unitGridI][unitGridJ][unitGridK] = vel_site_data_p->velocity;
-            }
-          }
-        }
+        velocityX[fieldIndex] = velocity.x;
+        velocityY[fieldIndex] = velocity.y;
+        velocityZ[fieldIndex] = velocity.z;
       }
 
-      bool VelocityField::NeededFromNeighbour(const util::Vector3D<site_t> location,
-                                              const geometry::LatticeData& latDat,
-                                              proc_t* sourceProcessor)
+      void VelocityField::UpdateLocalVelocity(site_t fieldIndex)
       {
-        if (!latDat.IsValidLatticeSite(location))
-        {
-          return false;
-        }
-
-        VelocitySiteData *vel_site_data_p = GetVelocitySiteData(latDat, location);
-
-        if (vel_site_data_p == NULL || vel_site_data_p->proc_id == -1 || vel_site_data_p->proc_id == localRank
-            || vel_site_data_p->counter == counter)
-        {
-          return false;
-        }
-
-        vel_site_data_p->counter = counter;
-        *sourceProcessor = vel_site_data_p->proc_id;
+        updatedAt[fieldIndex] = counter;
 
-        return true;
+        const util::Vector3D<distribn_t>& velocity = propertyCache.velocityCache.Get(siteIds[fieldIndex]);
+        velocityX[fieldIndex] = (float) velocity.x;
+        velocityY[fieldIndex] = (float) velocity.y;
+        velocityZ[fieldIndex] = (float) velocity.z;
       }
 
-      void VelocityField::UpdateLocalField(const util::Vector3D<site_t>& position, const geometry::LatticeData& latDat)
+      void VelocityField::InterpolateVelocities(size_t count,
+                                                const float* positionX,
+                                                const float* positionY,
+                                                const float* positionZ,
+                                                float* outVelocityX,
+                                                float* outVelocityY,
+                                                float* outVelocityZ)
       {
-        VelocitySiteData *localVelocitySiteData = GetVelocitySiteData(latDat, position);
+        stencilIndices.resize(8 * count);
 
-        if (log::Logger::ShouldDisplay<log::Debug>())
+        // First find the entries of the corners of each particle's cell, reading the velocities
+        // of local sites from the cache the first time they are used this step.
+        for (size_t n = 0; n < count; ++n)
         {
-          if (localRank != localVelocitySiteData->proc_id)
-          {
-            log::Logger::Log<log::Warning, log::OnePerCore>("Got a request for velocity data "
-                                                          "that actually seems to be on rank %i",
-                                                          localVelocitySiteData->proc_id);
-          }
-        }
+          const util::Vector3D<site_t> cell((site_t) positionX[n], (site_t) positionY[n], (site_t) positionZ[n]);
 
-        UpdateLocalField(localVelocitySiteData, latDat);
-      }
-
-      void VelocityField::UpdateLocalField(VelocitySiteData* localVelocitySiteData, const geometry::LatticeData& latDat)
-      {
-        // the local counter is set equal to the global one
-        // and the local velocity is calculated
-        localVelocitySiteData->counter = counter;
-
-        const util::Vector3D<distribn_t>& velocity = propertyCache.velocityCache.Get(localVelocitySiteData->site_id);
-        localVelocitySiteData->velocity.x = (float) velocity.x;
-        localVelocitySiteData->velocity.y = (float) velocity.y;
-        localVelocitySiteData->velocity.z = (float) velocity.z;
-      }
+          for (int corner = 0; corner < 8; ++corner)
+          {
+            const site_t fieldIndex = GetFieldIndex(cell
+                + util::Vector3D<site_t>( (corner >> 2) & 1, (corner >> 1) & 1, corner & 1));
 
-      // Interpolates a velocity field to get the velocity at the position of a particle.
-      util::Vector3D<float> VelocityField::InterpolateVelocityForPoint(const util::Vector3D<float> point,
-                                                                       const util::Vector3D<float> localVelocityField[2][2][2]) const
-      {
-        float dummy;
+            if (ranks[fieldIndex] == localRank && updatedAt[fieldIndex] != counter)
+            {
+              UpdateLocalVelocity(fieldIndex);
+            }
 
-        // Get the fractional parts of each of x, y, z
-        float dx = modff(point.x, &dummy);
-        float dy = modff(point.y, &dummy);
-        float dz = modff(point.z, &dummy);
+            stencilIndices[8 * n + corner] = fieldIndex;
+          }
+        }
 
-        util::Vector3D<float> yInterpolatedVelocity[2];
+        // Then interpolate trilinearly. Sites with no data use entry 0, whose velocity is zero,
+        // so this loop has no branches.
+        const float* vx = &velocityX[0];
+        const float* vy = &velocityY[0];
+        const float* vz = &velocityZ[0];
+        const site_t* stencil = &stencilIndices[0];
 
-        for (int unitX = 0; unitX <= 1; unitX++)
+        for (size_t n = 0; n < count; ++n)
         {
-          util::Vector3D<float> zInterpolatedVelocityForThisX[2];
-
-          for (int unitY = 0; unitY <= 1; unitY++)
+          // The fractional parts of each of x, y, z
+          const float dx = positionX[n] - (float) (site_t) positionX[n];
+          const float dy = positionY[n] - (float) (site_t) positionY[n];
+          const float dz = positionZ[n] - (float) (site_t) positionZ[n];
+
+          const float weights[8] = { (1.F - dx) * (1.F - dy) * (1.F - dz),
+                                     (1.F - dx) * (1.F - dy) * dz,
+                                     (1.F - dx) * dy * (1.F - dz),
+                                     (1.F - dx) * dy * dz,
+                                     dx * (1.F - dy) * (1.F - dz),
+                                     dx * (1.F - dy) * dz,
+                                     dx * dy * (1.F - dz),
+                                     dx * dy * dz };
+
+          float sumX = 0.F, sumY = 0.F, sumZ = 0.F;
+          for (int corner = 0; corner < 8; ++corner)
           {
-            zInterpolatedVelocityForThisX[unitY] = localVelocityField[unitX][unitY][0] * (1.F - dz)
-                + localVelocityField[unitX][unitY][1] * dz;
+            const site_t fieldIndex = stencil[8 * n + corner];
+            sumX += weights[corner] * vx[fieldIndex];
+            sumY += weights[corner] * vy[fieldIndex];
+            sumZ += weights[corner] * vz[fieldIndex];
           }
 
-          yInterpolatedVelocity[unitX] = zInterpolatedVelocityForThisX[0] * (1.F - dy)
-              + zInterpolatedVelocityForThisX[1] * dy;
+          outVelocityX[n] = sumX;
+          outVelocityY[n] = sumY;
+          outVelocityZ[n] = sumZ;
         }
-
-        return yInterpolatedVelocity[0] * (1.F - dx) + yInterpolatedVelocity[1] * dx;
       }
 
       void VelocityField::InvalidateAllCalculatedVelocities()
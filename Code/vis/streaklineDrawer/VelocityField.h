@@ -18,7 +18,6 @@
 #include "net/IOCommunicator.h"
 
 #include "vis/streaklineDrawer/NeighbouringProcessor.h"
-#include "vis/streaklineDrawer/VelocitySiteData.h"
 
 namespace hemelb
 {
@@ -26,53 +25,124 @@ namespace hemelb
   {
     namespace streaklinedrawer
     {
+      /**
+       * The velocities of the fluid sites on this rank and of the sites on other ranks that
+       * are within one lattice unit of them, which is everything needed to interpolate the
+       * velocity of a particle in a cell of this rank.
+       *
+       * The data is kept in flat arrays: each block holding any of these sites owns a contiguous
+       * range of entries, one per site of the block, found through a per-block offset table.
+       * Entry 0 stands for every site we have no data for (solid, outside the geometry or too far
+       * away) and always has zero velocity, so interpolation needs no branches.
+       */
       class VelocityField
       {
         public:
+          // The entry used for sites with no data.
+          static const site_t NoSite = 0;
+
           VelocityField(proc_t localRank,
-                        std::map<proc_t, NeighbouringProcessor>& iNeighbouringProcessors,
+                        const geometry::LatticeData& latDat,
                         const lb::MacroscopicPropertyCache& propertyCache);
 
-          void BuildVelocityField(const geometry::LatticeData& latDat);
-
-          bool BlockContainsData(size_t iBlockNumber) const;
-
-          VelocitySiteData* GetVelocitySiteData(const geometry::LatticeData& latDat,
-                                                const util::Vector3D<site_t>& location);
-
-          void GetVelocityFieldAroundPoint(const util::Vector3D<site_t> location,
-                                           const geometry::LatticeData& latDat,
-                                           util::Vector3D<float> localVelocityField[2][2][2]);
-
-          util::Vector3D<float>
-          InterpolateVelocityForPoint(const util::Vector3D<float> position,
-                                      const util::Vector3D<float> localVelocityField[2][2][2]) const;
+          /**
+           * Finds the sites in the field and lays out the arrays. Each other rank owning some
+           * of the sites is added to neighbouringProcessors, with the sites of its that this
+           * rank needs velocities for.
+           *
+           * @param neighbouringProcessors
+           */
+          void BuildVelocityField(std::map<proc_t, NeighbouringProcessor>& neighbouringProcessors);
+
+          /**
+           * Gets the index of the entry for the site at the given location, or NoSite if there
+           * is no fluid site there in the field.
+           *
+           * @param location
+           * @return
+           */
+          site_t GetFieldIndex(const util::Vector3D<site_t>& location) const
+          {
+            if (!latDat.IsValidLatticeSite(location))
+            {
+              return NoSite;
+            }
+
+            const site_t blockSize = latDat.GetBlockSize();
+            const site_t blockOffset =
+                blockOffsets[latDat.GetBlockIdFromBlockCoords(location / blockSize)];
+
+            if (blockOffset == NoSite)
+            {
+              return NoSite;
+            }
+
+            const site_t index = blockOffset
+                + latDat.GetLocalSiteIdFromLocalSiteCoords(location % blockSize);
+            return ranks[index] == SITE_OR_BLOCK_SOLID ?
+              NoSite :
+              index;
+          }
+
+          /**
+           * The rank owning the site of the given entry, SITE_OR_BLOCK_SOLID for NoSite.
+           */
+          proc_t GetRank(site_t fieldIndex) const
+          {
+            return ranks[fieldIndex];
+          }
+
+          /**
+           * Gets the velocity of a site on this rank, reading it from the property cache if that
+           * has not happened yet this step.
+           */
+          util::Vector3D<float> GetLocalVelocity(site_t fieldIndex);
+
+          /**
+           * Sets the velocity of a site owned by another rank.
+           */
+          void SetVelocity(site_t fieldIndex, const util::Vector3D<float>& velocity);
+
+          /**
+           * Interpolates the velocity at each of count positions, given as separate arrays of
+           * coordinates, into the arrays of velocity components.
+           */
+          void InterpolateVelocities(size_t count,
+                                     const float* positionX,
+                                     const float* positionY,
+                                     const float* positionZ,
+                                     float* velocityX,
+                                     float* velocityY,
+                                     float* velocityZ);
 
           void InvalidateAllCalculatedVelocities();
 
-          void UpdateLocalField(const util::Vector3D<site_t>& position, const geometry::LatticeData& latDat);
-
-          bool NeededFromNeighbour(const util::Vector3D<site_t> location,
-                                   const geometry::LatticeData& latDat,
-                                   proc_t* sourceProcessor);
-
         private:
-          void UpdateLocalField(VelocitySiteData* localVelocitySiteData, const geometry::LatticeData& latDat);
+          // Adds the site to the field, returning its entry and whether it is new.
+          bool AddSite(const util::Vector3D<site_t>& location, proc_t rank, site_t& fieldIndex);
+          void UpdateLocalVelocity(site_t fieldIndex);
 
-          // Counter to make sure the velocity field blocks are correct for the current iteration.
+          // Counter to make sure the local velocities are correct for the current iteration.
           site_t counter;
 
-          VelocitySiteData& GetSiteData(site_t iBlockNumber, site_t iSiteNumber);
-
-          void InitializeVelocityFieldBlock(const geometry::LatticeData& latDat,
-                                            const util::Vector3D<site_t> location,
-                                            const proc_t proc_id);
-
           const proc_t localRank;
-          // Vector containing VelocityFields
-          std::vector<std::vector<VelocitySiteData> > velocityField;
-          std::map<proc_t, NeighbouringProcessor>& neighbouringProcessors;
+          const geometry::LatticeData& latDat;
           const lb::MacroscopicPropertyCache& propertyCache;
+
+          // The first entry of each block, or NoSite for blocks not in the field.
+          std::vector<site_t> blockOffsets;
+
+          // The owner rank, local contiguous site id (for local sites), step of last update (for
+          // local sites) and velocity of each entry.
+          std::vector<proc_t> ranks;
+          std::vector<site_t> siteIds;
+          std::vector<site_t> updatedAt;
+          std::vector<float> velocityX;
+          std::vector<float> velocityY;
+          std::vector<float> velocityZ;
+
+          // The entries of the eight stencil sites for each particle being interpolated.
+          std::vector<site_t> stencilIndices;
       };
     }
   }
@@ -20,6 +20,7 @@ logger=logging.getLogger('parsing')
 
 from helpers import *
 from extraction import *
+from timing_trace import *
 
 class FileModel(object):
     def __init__(self, relative_path, loader):
@@ -289,6 +290,7 @@ def add_properties_to_class(cls, config):
   cls.define_file_properties(config.get('ssv_files'), ssv_loader, column_parser)
   cls.define_file_properties(config.get('csv_files'), ssv_loader, column_parser)
   cls.define_file_properties(config.get('extraction_files'), extraction_loader, extraction_parser)
+  cls.define_file_properties(config.get('trace_files'), trace_loader, trace_parser)
 
 def result_model(config):
     class Result(object):
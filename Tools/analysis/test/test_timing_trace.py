@@ -0,0 +1,60 @@
+
+# This file is part of HemeLB and is Copyright (C)
+# the HemeLB team and/or their institutions, as detailed in the
+# file AUTHORS. This software is provided under the terms of the
+# license in the file LICENSE.
+
+import os
+import struct
+import tempfile
+import unittest
+import numpy as np
+
+from ..timing_trace import TimingTrace
+
+names = ['Lattice Boltzmann', 'MPI Wait']
+
+def write_trace(path, durations, stepsPerBlock):
+    """Write a trace of durations, indexed by (step, rank, timer), starting
+    at step 1, as a little-endian machine would."""
+    steps, ranks, timers = durations.shape
+    out = open(path, 'wb')
+    out.write(struct.pack('>III', 0x686c6221, 0x74726304, 1))
+    out.write(struct.pack('<I', 0x01020304))
+    out.write(struct.pack('>IIII', ranks, timers, stepsPerBlock, 0))
+    for name in names:
+        out.write(name.encode('ascii').ljust(32, b'\0'))
+    for first in range(0, steps, stepsPerBlock):
+        block = durations[first:first + stepsPerBlock]
+        out.write(struct.pack('<QII', first + 1, len(block), 0))
+        padded = np.zeros((stepsPerBlock, ranks, timers), dtype='<f4')
+        padded[:len(block)] = block
+        out.write(padded.transpose(1, 0, 2).tobytes())
+    out.close()
+
+class TestTimingTrace(unittest.TestCase):
+    def setUp(self):
+        # Three ranks, ten steps; rank 2 waits for longer on step 7.
+        self.durations = np.ones((10, 3, 2))
+        self.durations[6, 2, 1] = 4.0
+        handle, self.path = tempfile.mkstemp()
+        os.close(handle)
+        write_trace(self.path, self.durations, 4)
+        self.trace = TimingTrace(self.path)
+    def tearDown(self):
+        os.remove(self.path)
+    def test_header(self):
+        self.assertEqual(3, self.trace.rankCount)
+        self.assertEqual(4, self.trace.stepsPerBlock)
+        self.assertEqual(names, self.trace.timerNames)
+    def test_durations(self):
+        self.assertEqual(list(range(1, 11)), list(self.trace.steps))
+        self.assertTrue(np.array_equal(self.durations, self.trace.durations))
+    def test_imbalance(self):
+        starts, ratios = self.trace.imbalance('MPI Wait', 5)
+        self.assertEqual([1, 6], list(starts))
+        self.assertAlmostEqual(0.0, ratios[0])
+        self.assertAlmostEqual((8.0 - 6.0) / 6.0, ratios[1])
+        self.assertEqual([0, 2], list(self.trace.slowest_ranks('MPI Wait', 5)))
+        starts, ratios = self.trace.imbalance('Lattice Boltzmann')
+        self.assertTrue(np.allclose(0.0, ratios))
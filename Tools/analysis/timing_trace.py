@@ -0,0 +1,143 @@
+
+# This file is part of HemeLB and is Copyright (C)
+# the HemeLB team and/or their institutions, as detailed in the
+# file AUTHORS. This software is provided under the terms of the
+# license in the file LICENSE.
+
+"""Reader for the per time step timing traces written by HemeLB built with
+HEMELB_TIMING_TRACE_STEPS > 0 (see Code/io/formats/trace.h).
+
+Run as a script to print how the load imbalance between ranks changes over
+the run:
+
+    python timing_trace.py results/timings.trace [steps per window]
+"""
+
+import struct
+import sys
+import numpy as np
+
+HemeLbMagicNumber = 0x686c6221
+TraceMagicNumber = 0x74726304
+TraceVersionNumber = 1
+ByteOrderMarker = 0x01020304
+PreambleLength = 32
+NameLength = 32
+BlockHeaderLength = 16
+
+class TimingTrace(object):
+    """The durations of the traced timers on each rank in each time step.
+
+    durations is indexed by (step, rank, timer), with steps in the order
+    given by steps.
+    """
+    def __init__(self, filename):
+        data = open(filename, 'rb').read()
+
+        magic, traceMagic, version = struct.unpack('>III', data[0:12])
+        if magic != HemeLbMagicNumber or traceMagic != TraceMagicNumber:
+            raise ValueError("%s is not a HemeLB timing trace" % filename)
+        if version != TraceVersionNumber:
+            raise ValueError("%s has trace version %d, expected %d" %
+                             (filename, version, TraceVersionNumber))
+
+        # The body is in the byte order of the machine that wrote it.
+        if struct.unpack('<I', data[12:16])[0] == ByteOrderMarker:
+            native = '<'
+        elif struct.unpack('>I', data[12:16])[0] == ByteOrderMarker:
+            native = '>'
+        else:
+            raise ValueError("%s has an unknown byte order marker" % filename)
+
+        self.rankCount, self.timerCount, self.stepsPerBlock = struct.unpack('>III', data[16:28])
+        self.timerNames = [
+            data[PreambleLength + i * NameLength:PreambleLength + (i + 1) * NameLength]
+            .split(b'\0')[0].decode('ascii')
+            for i in range(self.timerCount)
+        ]
+
+        firstBlock = PreambleLength + self.timerCount * NameLength
+        slabLength = self.stepsPerBlock * self.timerCount * 4
+        blockLength = BlockHeaderLength + self.rankCount * slabLength
+        blockCount = (len(data) - firstBlock) // blockLength
+
+        steps = []
+        durations = []
+        for block in range(blockCount):
+            start = firstBlock + block * blockLength
+            firstStep, stepCount = struct.unpack(native + 'QI', data[start:start + 12])
+            slabs = np.frombuffer(data, dtype=native + 'f4',
+                                  count=self.rankCount * self.stepsPerBlock * self.timerCount,
+                                  offset=start + BlockHeaderLength)
+            slabs = slabs.reshape(self.rankCount, self.stepsPerBlock, self.timerCount)
+            steps.extend(range(firstStep, firstStep + stepCount))
+            durations.append(slabs[:, :stepCount, :].transpose(1, 0, 2))
+
+        self.steps = np.array(steps)
+        if durations:
+            self.durations = np.concatenate(durations).astype(float)
+        else:
+            self.durations = np.zeros((0, self.rankCount, self.timerCount))
+
+    def timer(self, name):
+        """The durations of the named timer, indexed by (step, rank)."""
+        return self.durations[:, :, self.timerNames.index(name)]
+
+    def imbalance(self, name, window=1):
+        """The imbalance of the named timer in each window of steps: the
+        maximum over ranks of the time spent in the window, less the mean,
+        over the mean. Returns the first step of each window and the
+        imbalances; windows where no time was spent have imbalance zero.
+        """
+        times = self.timer(name)
+        windowCount = (len(times) + window - 1) // window
+        starts = self.steps[::window]
+        sums = np.array([times[i * window:(i + 1) * window].sum(axis=0)
+                         for i in range(windowCount)]).reshape(windowCount, self.rankCount)
+        means = sums.mean(axis=1)
+        excess = sums.max(axis=1) - means
+        ratios = np.zeros(windowCount)
+        busy = means > 0
+        ratios[busy] = excess[busy] / means[busy]
+        return starts, ratios
+
+    def slowest_ranks(self, name, window=1):
+        """The rank spending longest in the named timer in each window."""
+        times = self.timer(name)
+        windowCount = (len(times) + window - 1) // window
+        return np.array([times[i * window:(i + 1) * window].sum(axis=0).argmax()
+                         for i in range(windowCount)], dtype=int)
+
+def trace_loader(filename):
+    return TimingTrace(filename)
+
+def trace_parser(content, pattern):
+    """Patterns are header attributes, or a timer name to get the
+    imbalance of that timer over the whole run."""
+    if pattern in ['rankCount', 'timerCount', 'stepsPerBlock', 'timerNames', 'steps']:
+        return getattr(content, pattern)
+    return content.imbalance(pattern, max(1, len(content.steps)))[1][0]
+
+def summarise(trace, window, out=sys.stdout):
+    out.write("%d ranks, steps %d to %d, %d steps per window\n" %
+              (trace.rankCount, trace.steps[0], trace.steps[-1], window))
+    out.write("Imbalance ((max - mean) / mean over ranks), slowest rank in brackets\n")
+    columns = [name for name in trace.timerNames]
+    out.write("%10s" % "step" + "".join("%22s" % name for name in columns) + "\n")
+
+    starts = None
+    table = []
+    for name in columns:
+        starts, ratios = trace.imbalance(name, window)
+        table.append((ratios, trace.slowest_ranks(name, window)))
+
+    for row, start in enumerate(starts):
+        out.write("%10d" % start)
+        for ratios, ranks in table:
+            out.write("%14.3f (%5d)" % (ratios[row], ranks[row]))
+        out.write("\n")
+
+if __name__ == '__main__':
+    trace = TimingTrace(sys.argv[1])
+    window = int(sys.argv[2]) if len(sys.argv) > 2 else trace.stepsPerBlock
+    summarise(trace, window)
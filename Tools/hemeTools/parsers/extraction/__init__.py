@@ -5,7 +5,9 @@
 # license in the file LICENSE.
 
 import os.path
+import struct
 import xdrlib
+import zlib
 import numpy as np
 
 from .. import HemeLbMagicNumber
@@ -13,6 +15,13 @@ from .. import HemeLbMagicNumber
 ExtractionMagicNumber = 0x78747204
 MainHeaderLength = 60
 TimeStepDataLength = 8
+ColumnarVersionNumber = 5
+CompressedVersionNumber = 6
+OffsetHeaderLength = 16
+ChunkHeaderLength = 16
+ShuffleDeflate = 1
+QuantisedShuffleDeflate = 2
+CoordinateLength = 12
 
 class FieldSpec(object):
     """Represent the data type of a single record in both XDR format and
@@ -30,9 +39,9 @@ class FieldSpec(object):
          
     """
 
-    def __init__(self, memspec):
+    def __init__(self, memspec, gridType='>i4'):
         # name, XDR dtype, in-memory dtype, length, offset
-        self._filespec = [('grid', '>i4', np.uint32, (3,), 0)]
+        self._filespec = [('grid', gridType, np.uint32, (3,), 0)]
         
         self._memspec = memspec
         return
@@ -132,11 +141,91 @@ class ExtractedPropertyV4Parser(object):
             return data + operand
         pass
 
+class ExtractedPropertyV5Parser(ExtractedPropertyV4Parser):
+    """Columnar files: the grid coordinates are stored once, after the
+    headers, and each record holds one little-endian column per field.
+    """
+    def parse(self, filename, coordinateOffset, dataOffset):
+        result = np.recarray(self._siteCount, dtype=self._fieldSpec.GetMem())
+
+        result.grid = np.memmap(filename, dtype=np.dtype(('<u4', (3,))),
+                                mode='r', offset=coordinateOffset, shape=(self._siteCount,))
+
+        start = dataOffset
+        for ((name, fileType, memType, length, offset), fieldOffset) in zip(list(self._fieldSpec)[1:], self._dataOffset[1:]):
+            dtype = np.dtype(fileType) if length == 1 else np.dtype((fileType, length))
+            column = np.memmap(filename, dtype=dtype, mode='r', offset=start, shape=(self._siteCount,))
+            field = getattr(result, name)
+            setattr(result, name, (column + fieldOffset).reshape(field.shape))
+            start += column.nbytes
+            continue
+        return result
+
+    def ParseFieldHeader(self, decoder):
+        self._fieldSpec = FieldSpec([('id', None, np.uint64, 1, None),
+                               ('position', None, np.float32, (3,), None)],
+                                    gridType='<u4')
+        self._dataOffset = [0]
+
+        for iField in xrange(self._fieldCount):
+            name = decoder.unpack_string()
+            length = decoder.unpack_uint()
+            self._dataOffset.append(decoder.unpack_double())
+            self._fieldSpec.Append(name, length, '<f4', np.float32)
+            continue
+        return self._fieldSpec
+
+class ExtractedPropertyV6Parser(ExtractedPropertyV5Parser):
+    """Compressed files: as columnar, but each record is made of one
+    independently compressed chunk per rank, located via the offset file.
+    """
+    def parse(self, filename, coordinateOffset, siteRanges, chunkOffsets):
+        result = np.recarray(self._siteCount, dtype=self._fieldSpec.GetMem())
+
+        result.grid = np.memmap(filename, dtype=np.dtype(('<u4', (3,))),
+                                mode='r', offset=coordinateOffset, shape=(self._siteCount,))
+
+        fields = list(self._fieldSpec)[1:]
+        columns = [[] for field in fields]
+        with open(filename, 'rb') as f:
+            for iRank in xrange(len(chunkOffsets) - 1):
+                nSites = siteRanges[iRank + 1] - siteRanges[iRank]
+                if nSites == 0:
+                    continue
+                f.seek(chunkOffsets[iRank])
+                values = self._Decompress(f.read(chunkOffsets[iRank + 1] - chunkOffsets[iRank]))
+                start = 0
+                for iField, (name, fileType, memType, length, offset) in enumerate(fields):
+                    shape = (nSites,) if length == 1 else (nSites,) + length
+                    count = int(np.prod(shape))
+                    columns[iField].append(values[start:start + count].reshape(shape))
+                    start += count
+                    continue
+                continue
+
+        for ((name, fileType, memType, length, offset), fieldOffset, column) in zip(fields, self._dataOffset[1:], columns):
+            field = getattr(result, name)
+            setattr(result, name, (np.concatenate(column) + fieldOffset).reshape(field.shape))
+            continue
+        return result
+
+    @staticmethod
+    def _Decompress(chunk):
+        codec, count, quantum = struct.unpack('<IId', chunk[:ChunkHeaderLength])
+        shuffled = np.frombuffer(zlib.decompress(chunk[ChunkHeaderLength:]), dtype=np.uint8)
+        # Undo the byte shuffle: the low bytes of every value come first.
+        raw = shuffled.reshape(4, count).T.copy()
+        if codec == ShuffleDeflate:
+            return raw.view('<f4').reshape(count)
+        elif codec == QuantisedShuffleDeflate:
+            return (raw.view('<i4').reshape(count) * quantum).astype(np.float32)
+        raise ValueError("Unknown extraction chunk codec {}".format(codec))
+
 class ExtractedProperty(object):
     """Represent the contents of a HemeLB property extraction file.
     
     """
-    HandledVersions = [3,4]
+    HandledVersions = [3,4,5,6]
 
     def __init__(self, filename):
         """Read the file's headers and determine how many times and which times
@@ -168,7 +257,7 @@ class ExtractedProperty(object):
         decoder = xdrlib.Unpacker(mainHeader)
         assert decoder.unpack_uint() == HemeLbMagicNumber, "Incorrect HemeLB magic number"
         assert decoder.unpack_uint() == ExtractionMagicNumber, "Incorrect extraction magic number"
-        version = decoder.unpack_uint()
+        self.version = version = decoder.unpack_uint()
         assert version in self.HandledVersions, "Incorrect extraction format version number"
 
         self.voxelSizeMetres = decoder.unpack_double()
@@ -182,6 +271,10 @@ class ExtractedProperty(object):
             self.parser = ExtractedPropertyV3Parser(self.fieldCount, self.siteCount)
         elif version == 4:
             self.parser = ExtractedPropertyV4Parser(self.fieldCount, self.siteCount)
+        elif version == ColumnarVersionNumber:
+            self.parser = ExtractedPropertyV5Parser(self.fieldCount, self.siteCount)
+        elif version == CompressedVersionNumber:
+            self.parser = ExtractedPropertyV6Parser(self.fieldCount, self.siteCount)
         return
 
     def _ReadFieldHeader(self):
@@ -202,7 +295,13 @@ class ExtractedProperty(object):
         self._fieldSpec = self.parser.ParseFieldHeader(decoder)
 
         self._rowLength = self._fieldSpec.GetRecordLength()
-        self._recordLength = TimeStepDataLength + self._rowLength * self.siteCount
+        if self.version in (ColumnarVersionNumber, CompressedVersionNumber):
+            # The grid is stored once, not in every record
+            self._coordinateLength = CoordinateLength * self.siteCount
+            self._recordLength = TimeStepDataLength + (self._rowLength - CoordinateLength) * self.siteCount
+        else:
+            self._coordinateLength = 0
+            self._recordLength = TimeStepDataLength + self._rowLength * self.siteCount
 
         return
 
@@ -210,8 +309,11 @@ class ExtractedProperty(object):
         """Examine the file to find out how many time steps worth of data and
         which times are contained within it.
         """
+        if self.version == CompressedVersionNumber:
+            return self._DetermineCompressedTimes()
+
         filesize = os.path.getsize(self.filename)
-        self._totalHeaderLength = MainHeaderLength + self._fieldHeaderLength
+        self._totalHeaderLength = MainHeaderLength + self._fieldHeaderLength + self._coordinateLength
         bodysize = filesize - self._totalHeaderLength
         assert bodysize % self._recordLength == 0, \
             "Extraction file appears to have partial record(s), residual %s / %s , bodysize %s"%(bodysize % self._recordLength,self._recordLength,bodysize)
@@ -222,7 +324,10 @@ class ExtractedProperty(object):
             pos = self._totalHeaderLength + iT * self._recordLength
             self._file.seek(pos)
             timeBuf = self._file.read(TimeStepDataLength)
-            times[iT] = xdrlib.Unpacker(timeBuf).unpack_uhyper()
+            if self.version == ColumnarVersionNumber:
+                times[iT] = np.frombuffer(timeBuf, dtype='<u8')[0]
+            else:
+                times[iT] = xdrlib.Unpacker(timeBuf).unpack_uhyper()
             continue
 
         assert np.alltrue(np.argsort(times) == np.arange(len(times))), \
@@ -231,6 +336,37 @@ class ExtractedProperty(object):
 
         return
 
+    def _DetermineCompressedTimes(self):
+        """Records in compressed files vary in length, so find them, and each
+        rank's chunk within them, from the offset file.
+        """
+        self._totalHeaderLength = MainHeaderLength + self._fieldHeaderLength + self._coordinateLength
+        offsetFilename = os.path.splitext(self.filename)[0] + '.off'
+        with open(offsetFilename, 'rb') as f:
+            decoder = xdrlib.Unpacker(f.read(OffsetHeaderLength))
+            assert decoder.unpack_uint() == HemeLbMagicNumber, "Incorrect HemeLB magic number"
+            decoder.unpack_uint()
+            decoder.unpack_uint()
+            nRanks = decoder.unpack_uint()
+            table = np.fromfile(f, dtype='>u8').astype(np.uint64)
+        assert table.size % (nRanks + 1) == 0, \
+            "Offset file '{}' appears to have partial record(s)".format(offsetFilename)
+        table = table.reshape(-1, nRanks + 1)
+
+        self._siteRanges = table[0]
+        self._chunkOffsets = table[1:]
+
+        times = np.zeros(len(self._chunkOffsets), dtype=int)
+        for iT in xrange(len(times)):
+            self._file.seek(int(self._chunkOffsets[iT][0]) - TimeStepDataLength)
+            times[iT] = np.frombuffer(self._file.read(TimeStepDataLength), dtype='<u8')[0]
+            continue
+
+        assert np.alltrue(np.argsort(times) == np.arange(len(times))), \
+            "Times in extraction file are not monotonically increasing!"
+        self.times = times
+        return
+
     def GetByIndex(self, idx):
         """Get the fields by time index. 
         """
@@ -272,9 +408,17 @@ class ExtractedProperty(object):
         
         Fields are as specified in the file with the addition of 
         """
-        mapped = self._MemMap(idx)
-
-        answer = self.parser.parse(mapped)
+        if self.version == CompressedVersionNumber:
+            answer = self.parser.parse(self.filename,
+                                       MainHeaderLength + self._fieldHeaderLength,
+                                       self._siteRanges, self._chunkOffsets[idx])
+        elif self.version == ColumnarVersionNumber:
+            answer = self.parser.parse(self.filename,
+                                       MainHeaderLength + self._fieldHeaderLength,
+                                       self._totalHeaderLength + idx * self._recordLength + TimeStepDataLength)
+        else:
+            mapped = self._MemMap(idx)
+            answer = self.parser.parse(mapped)
         
         answer.id = np.arange(self.siteCount)
         answer.position = self.voxelSizeMetres * answer.grid + self.originMetres
@@ -11,6 +11,8 @@ except ImportError:
     from ordereddict import OrderedDict
     
 import numpy as N
+import xdrlib
+import zlib
 
 
 """
@@ -48,3 +50,66 @@ class Image(object):
     fields=["%s_%s" % (subimage, color) for subimage in subimages for color in colors ]
     bytes_per_pixel=2*2 + 3*4 #each of three colors with four sub-images per color and two two-byte coordinates
     pixel=N.dtype({'names': ['x', 'y'] + fields, 'formats': [N.dtype('>H')] * 2 + [N.uint8] * len(subimages) * len(colors)})
+
+
+"""
+Image data streamed by HemeLB in one of its encoded forms: the whole frame, as one plane of bytes per color of each sub-image
+"""
+class DenseImage(object):
+
+    def __init__(self, width, height, planes):
+        self.width = width
+        self.height = height
+        self.given_pixel_count = width * height
+        self.full_pixel_count = width * height
+        self.planes = planes.reshape(len(Image.fields), height, width)
+
+    def pil(self, component='velocity'):
+        """
+        Transform the data to python image library format
+        """
+        try:
+            from PIL import Image as PILImage
+        except ImportError:
+            import Image as PILImage
+        first = Image.subimages.index(component) * len(Image.colors)
+        rgb = N.dstack(self.planes[first : first + len(Image.colors)])
+        return PILImage.fromstring("RGB", (self.width,self.height), rgb.tostring())
+
+
+"""
+Raised for a delta frame with no matching previous frame to apply it to, as when joining a stream between whole frames
+"""
+class MissingKeyFrame(ValueError):
+    pass
+
+
+"""
+Turns the pixel data of successive frames, raw or encoded, back into images
+"""
+class FrameDecoder(object):
+
+    def __init__(self):
+        self.previous = None
+
+    def decode(self, width, height, data):
+        unpacker = xdrlib.Unpacker(data)
+        if len(data) < 4 or unpacker.unpack_uint() != FrameDecoder.frame_tag:
+            self.previous = None
+            return Image(width, height, len(data) / Image.bytes_per_pixel, xdrlib.Unpacker(data))
+        encoding = unpacker.unpack_uint()
+        planes = N.frombuffer(zlib.decompress(unpacker.unpack_opaque()), dtype=N.uint8)
+        if encoding == FrameDecoder.delta_deflate:
+            if self.previous is None or self.previous.size != planes.size:
+                self.previous = None
+                raise MissingKeyFrame("Steering image delta frame has no matching previous frame")
+            planes = planes ^ self.previous
+        elif encoding != FrameDecoder.deflate:
+            raise ValueError("Unknown image encoding %d" % encoding)
+        self.previous = planes
+        return DenseImage(width, height, planes)
+
+    # Constants matching steering::ImageEncoder
+    frame_tag = 0xFFFF4846
+    deflate = 1
+    delta_deflate = 2
@@ -6,7 +6,7 @@
 
 from paged_socket import PagedSocket
 from steered_parameter import SteeredParameter
-from image import Image
+from image import FrameDecoder, MissingKeyFrame
 from config import config
 import xdrlib
 
@@ -27,6 +27,7 @@ class RemoteHemeLB(object):
             additional_receive_length_function=RemoteHemeLB._calculate_receive_length)
         self.latitude = 0
         self.image = None
+        self.decoder = FrameDecoder()
         for steered_parameter in self.steered_parameters:
             steered_parameter.initialise_in_instance(self, config['steered_parameter_defaults'][steered_parameter.name])
 
@@ -58,7 +59,11 @@ class RemoteHemeLB(object):
         self.width = unpacker.unpack_int()
         self.height = unpacker.unpack_int()
         self.frame = unpacker.unpack_int()
-        self.image = Image(self.width, self.height, self.frame / Image.bytes_per_pixel, unpacker)
+        try:
+            self.image = self.decoder.decode(self.width, self.height, unpacker.unpack_fopaque(self.frame))
+        except MissingKeyFrame:
+            # Joined between whole frames; keep the last image until the next one.
+            pass
         self.time_step = unpacker.unpack_int()
         self.time = unpacker.unpack_double()
         unpacker.unpack_int() # throw away cycle
@@ -9,8 +9,11 @@
 import unittest
 import mock
 import xdrlib
+import zlib
 
-from hemelb_steering.image import Image
+import numpy as N
+
+from hemelb_steering.image import Image, DenseImage, FrameDecoder, MissingKeyFrame
 
 #Tests the SPARSE image model we use
 class TestImage(unittest.TestCase):
@@ -32,6 +35,47 @@ class TestImage(unittest.TestCase):
     def test_display(self):
         pass
         self.image.pil('velocity').show()
-        
-        
-        
\ No newline at end of file
+
+
+#Tests decoding the encoded frames, whole and as deltas
+class TestFrameDecoder(unittest.TestCase):
+
+    def setUp(self):
+        self.decoder = FrameDecoder()
+        self.first = N.arange(12 * 4 * 2, dtype=N.uint8)
+        self.second = self.first.copy()
+        self.second[5] = 200
+
+    def encoded(self, encoding, planes):
+        fixture = xdrlib.Packer()
+        fixture.pack_uint(FrameDecoder.frame_tag)
+        fixture.pack_uint(encoding)
+        fixture.pack_opaque(zlib.compress(planes.tostring()))
+        return fixture.get_buffer()
+
+    def test_whole_then_delta(self):
+        image = self.decoder.decode(4, 2, self.encoded(FrameDecoder.deflate, self.first))
+        self.assertTrue(isinstance(image, DenseImage))
+        self.assertEqual(list(image.planes.flatten()), list(self.first))
+        image = self.decoder.decode(4, 2, self.encoded(FrameDecoder.delta_deflate, self.first ^ self.second))
+        self.assertEqual(list(image.planes.flatten()), list(self.second))
+
+    def test_delta_without_previous(self):
+        delta = self.encoded(FrameDecoder.delta_deflate, self.first ^ self.second)
+        self.assertRaises(MissingKeyFrame, self.decoder.decode, 4, 2, delta)
+        # Picks up again from the next whole frame.
+        self.decoder.decode(4, 2, self.encoded(FrameDecoder.deflate, self.first))
+        image = self.decoder.decode(4, 2, delta)
+        self.assertEqual(list(image.planes.flatten()), list(self.second))
+
+    def test_delta_after_resize(self):
+        self.decoder.decode(4, 2, self.encoded(FrameDecoder.deflate, self.first))
+        larger = N.zeros(12 * 4 * 4, dtype=N.uint8)
+        self.assertRaises(MissingKeyFrame, self.decoder.decode, 4, 4, self.encoded(FrameDecoder.delta_deflate, larger))
+
+    def test_raw(self):
+        fixture = xdrlib.Packer()
+        fixture.pack_int((1 << 16) + 1)
+        fixture.pack_fopaque(12, 'abcdefghijkl')
+        image = self.decoder.decode(4, 2, fixture.get_buffer())
+        self.assertEqual(1, image.given_pixel_count)